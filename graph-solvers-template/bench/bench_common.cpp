@@ -0,0 +1,42 @@
+#include "bench_common.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "geometry/triangulation.h"
+
+namespace {
+
+std::vector<Point> randomPoints(int n, std::uint64_t seed)
+{
+    std::mt19937_64 gen(seed ^ (std::uint64_t)n);
+    std::uniform_real_distribution<double> coord(0.0, 10.0 * std::sqrt((double)n));
+
+    // Coincident points would break the triangulation; redraw until all are unique.
+    std::vector<Point> points;
+    points.reserve(n);
+    while ((int)points.size() < n) {
+        while ((int)points.size() < n) points.push_back({ coord(gen), coord(gen) });
+        std::sort(points.begin(), points.end());
+        points.erase(std::unique(points.begin(), points.end(),
+            [](const Point& a, const Point& b) { return a.x == b.x && a.y == b.y; }), points.end());
+    }
+    std::shuffle(points.begin(), points.end(), gen);
+    return points;
+}
+
+} // namespace
+
+const BenchInstance& benchInstance(int n)
+{
+    static std::map<int, std::unique_ptr<BenchInstance>> cache;
+
+    auto& slot = cache[n];
+    if (!slot) {
+        auto points = randomPoints(n, benchSeed);
+        DelaunayGraph delaunay = buildDelaunayGraph(points);
+        slot = std::make_unique<BenchInstance>(BenchInstance{ std::move(points), std::move(delaunay.triangles), std::move(delaunay.graph) });
+    }
+    return *slot;
+}
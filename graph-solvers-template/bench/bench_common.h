@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+#include "common/types.h"
+#include "common/graph.h"
+
+/**
+ * @brief Benchmark instance: random points, their Delaunay triangulation and the CSR graph.
+ *
+ * Points are drawn uniformly from a square whose side grows with sqrt(n), so the density
+ * (and therefore the per-node work) is the same at every size.
+ */
+struct BenchInstance
+{
+    std::vector<Point> points;
+    std::vector<std::array<int, 3>> triangles;
+    Graph graph;
+};
+
+/// Fixed seed of every generated instance.
+constexpr std::uint64_t benchSeed = 20240601;
+
+/**
+ * @brief Returns the instance with @p n points, generating it on first use.
+ *
+ * Instances are cached for the lifetime of the process so that setup is not repeated for
+ * every benchmark that runs on the same size.
+ */
+const BenchInstance& benchInstance(int n);
+
+/**
+ * @brief Silences std::cout for its lifetime (the solver prints its routes).
+ */
+class MuteStdout
+{
+public:
+    MuteStdout() : previous_(std::cout.rdbuf(nullptr)) {}
+    ~MuteStdout() { std::cout.rdbuf(previous_); }
+
+    MuteStdout(const MuteStdout&) = delete;
+    MuteStdout& operator=(const MuteStdout&) = delete;
+
+private:
+    std::streambuf* previous_;
+};
@@ -0,0 +1,33 @@
+#include <benchmark/benchmark.h>
+
+#include "bench_common.h"
+#include "model/solver.h"
+
+// End-to-end route generation: args are (n, threads), with threads = 0 meaning all cores.
+static void BM_SolveMultipleRoutes(benchmark::State& state)
+{
+    const auto& instance = benchInstance((int)state.range(0));
+
+    MultiRouteOptions options;
+    options.seed = benchSeed;
+    options.threads = (unsigned)state.range(1);
+
+    size_t routes = 0;
+    for (auto _ : state) {
+        MuteStdout mute;
+        auto result = solveMultipleRoutes(instance.points, instance.graph, 20, options);
+        routes = result.size();
+        benchmark::DoNotOptimize(result);
+    }
+    state.counters["routes"] = (double)routes;
+}
+BENCHMARK(BM_SolveMultipleRoutes)
+    ->ArgsProduct({ { 100, 1000, 10000, 100000, 1000000 }, { 1, 0 } })
+    ->ArgNames({ "n", "threads" })
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime()
+    ->Iterations(1)
+    ->Repetitions(3)
+    ->ReportAggregatesOnly(true);
+
+BENCHMARK_MAIN();
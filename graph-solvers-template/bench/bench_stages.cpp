@@ -0,0 +1,199 @@
+#include <benchmark/benchmark.h>
+
+#include <filesystem>
+#include <random>
+#include <set>
+#include <sstream>
+
+#include "bench_common.h"
+#include "common/point_set.h"
+#include "common/simd.h"
+#include "common/thread_pool.h"
+#include "geometry/triangulation.h"
+#include "geometry/visualization.h"
+#include "model/route_io.h"
+#include "model/savings.h"
+#include "model/shortest_path.h"
+#include "model/solver.h"
+
+// Delaunay triangulation and edge extraction.
+static void BM_Triangulation(benchmark::State& state)
+{
+    const auto& instance = benchInstance((int)state.range(0));
+    for (auto _ : state) {
+        auto result = computeTriangulationAndEdges(instance.points);
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Triangulation)->RangeMultiplier(10)->Range(100, 100000)->Unit(benchmark::kMillisecond);
+
+// Tiled triangulation straight into the CSR graph; second argument is the strip count
+// (each strip on its own worker).
+static void BM_DelaunayGraph(benchmark::State& state)
+{
+    const auto& instance = benchInstance((int)state.range(0));
+    ThreadPool pool((unsigned)state.range(1));
+    TriangulationOptions options;
+    options.tiles = (int)state.range(1);
+    options.pool = &pool;
+    for (auto _ : state) {
+        auto result = buildDelaunayGraph(instance.points, options);
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DelaunayGraph)->ArgsProduct({ { 10000, 100000, 1000000 }, { 1, 4, 8 } })->Unit(benchmark::kMillisecond);
+
+// Batched edge lengths; second argument is the SIMD level (0 = scalar, 1 = AVX2, 2 = AVX-512),
+// third the precision (0 = double, 1 = single).
+static void BM_EdgeLengths(benchmark::State& state)
+{
+    auto level = (SimdLevel)state.range(1);
+    if ((int)level > (int)detectSimdLevel()) {
+        state.SkipWithError("SIMD level not supported by this CPU");
+        return;
+    }
+    const auto& instance = benchInstance((int)state.range(0));
+    PointSet points(instance.points, state.range(2) == 0 ? Precision::Double : Precision::Single);
+    std::vector<double> lengths(instance.graph.edgeCount());
+    setSimdLevel(level);
+    for (auto _ : state) {
+        points.edgeLengths(instance.graph.edges(), lengths);
+        benchmark::DoNotOptimize(lengths.data());
+    }
+    setSimdLevel(detectSimdLevel());
+    state.SetItemsProcessed(state.iterations() * instance.graph.edgeCount());
+}
+BENCHMARK(BM_EdgeLengths)->ArgsProduct({ { 10000, 1000000 }, { 0, 1, 2 }, { 0, 1 } })->Unit(benchmark::kMicrosecond);
+
+// Depot distances and savings values of every edge; second argument is the SIMD level.
+static void BM_SavingsKernel(benchmark::State& state)
+{
+    auto level = (SimdLevel)state.range(1);
+    if ((int)level > (int)detectSimdLevel()) {
+        state.SkipWithError("SIMD level not supported by this CPU");
+        return;
+    }
+    const auto& instance = benchInstance((int)state.range(0));
+    PointSet points(instance.points);
+    std::vector<double> depot(instance.points.size()), savings(instance.graph.edgeCount());
+    setSimdLevel(level);
+    for (auto _ : state) {
+        points.distancesFrom(instance.points[0], depot);
+        computeSavings(depot, instance.graph.edges(), savings);
+        benchmark::DoNotOptimize(savings.data());
+    }
+    setSimdLevel(detectSimdLevel());
+    state.SetItemsProcessed(state.iterations() * instance.graph.edgeCount());
+}
+BENCHMARK(BM_SavingsKernel)->ArgsProduct({ { 10000, 1000000 }, { 0, 1, 2 } })->Unit(benchmark::kMicrosecond);
+
+// Base savings computation followed by consuming every saving in decreasing order.
+static void BM_Savings(benchmark::State& state)
+{
+    const auto& instance = benchInstance((int)state.range(0));
+    const int n = (int)instance.points.size();
+    SavingsQueue queue;
+    for (auto _ : state) {
+        SavingsList list(instance.points, instance.graph, 0, n - 1);
+        queue.reset(list);
+        Saving s;
+        while (queue.pop(s)) benchmark::DoNotOptimize(s);
+    }
+    state.SetItemsProcessed(state.iterations() * instance.graph.edgeCount());
+}
+BENCHMARK(BM_Savings)->RangeMultiplier(10)->Range(100, 100000)->Unit(benchmark::kMillisecond);
+
+// Clarke-Wright merge loop on precomputed savings.
+static void BM_MergeLoop(benchmark::State& state)
+{
+    const auto& instance = benchInstance((int)state.range(0));
+    const int n = (int)instance.points.size();
+    SavingsList list(instance.points, instance.graph, 0, n - 1);
+    SavingsQueue queue;
+    for (auto _ : state) {
+        queue.reset(list);
+        auto routes = solveProblem(instance.points, instance.graph, list, queue, 1);
+        benchmark::DoNotOptimize(routes);
+    }
+    state.SetItemsProcessed(state.iterations() * list.size());
+}
+BENCHMARK(BM_MergeLoop)->RangeMultiplier(10)->Range(100, 100000)->Unit(benchmark::kMillisecond);
+
+// Fallback shortest path avoiding 5% of the nodes, with a reused search workspace.
+static void BM_FindAlternativePath(benchmark::State& state)
+{
+    const auto& instance = benchInstance((int)state.range(0));
+    const int n = (int)instance.points.size();
+    ShortestPathEngine engine(instance.points, instance.graph);
+
+    std::mt19937 gen(benchSeed);
+    std::uniform_int_distribution<int> node(1, n - 2);
+    std::set<int> avoid;
+    for (int k = 0; k < n / 20; ++k) avoid.insert(node(gen));
+
+    for (auto _ : state) {
+        auto path = findAlternativePath(instance.points, engine, avoid);
+        benchmark::DoNotOptimize(path);
+    }
+}
+BENCHMARK(BM_FindAlternativePath)->RangeMultiplier(10)->Range(100, 100000)->Unit(benchmark::kMicrosecond);
+
+// Jaccard similarity of two routes of the given length sharing half of their edges.
+static void BM_RouteSimilarity(benchmark::State& state)
+{
+    const int length = (int)state.range(0);
+    std::vector<std::pair<int, int>> a, b;
+    for (int k = 0; k < length; ++k) {
+        a.push_back({ k, k + 1 });
+        b.push_back(k % 2 == 0 ? std::pair<int, int>{ k, k + 1 } : std::pair<int, int>{ k + length, k + length + 1 });
+    }
+    for (auto _ : state) benchmark::DoNotOptimize(routeSimilarity(a, b));
+    state.SetItemsProcessed(state.iterations() * length);
+}
+BENCHMARK(BM_RouteSimilarity)->RangeMultiplier(8)->Range(16, 4096);
+
+// SVG output of the triangulation and a few routes.
+static void BM_DrawSVG(benchmark::State& state)
+{
+    const auto& instance = benchInstance((int)state.range(0));
+    std::vector<std::vector<std::pair<int, int>>> routes;
+    {
+        MuteStdout mute;
+        MultiRouteOptions options;
+        options.seed = benchSeed;
+        routes = solveMultipleRoutes(instance.points, instance.graph, 3, options);
+    }
+
+    auto path = (std::filesystem::temp_directory_path() / "cw_bench.svg").string();
+    for (auto _ : state) {
+        MuteStdout mute;
+        drawSVG(instance.points, routes, instance.triangles, path);
+    }
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_DrawSVG)->RangeMultiplier(10)->Range(100, 10000)->Unit(benchmark::kMillisecond);
+
+// Route export in every format (0 = text, 1 = binary, 2 = JSON, 3 = CSV, 4 = GeoJSON).
+static void BM_WriteRoutes(benchmark::State& state)
+{
+    const auto& instance = benchInstance((int)state.range(0));
+    std::vector<std::vector<std::pair<int, int>>> routes;
+    {
+        MultiRouteOptions options;
+        options.seed = benchSeed;
+        options.printRoutes = false;
+        routes = solveMultipleRoutes(instance.points, instance.graph, 20, options);
+    }
+
+    std::ostringstream out;
+    for (auto _ : state) {
+        out.str({});
+        RouteWriter writer(out, (RouteFormat)state.range(1), instance.graph, &instance.points);
+        for (const auto& route : routes) writer.write(route);
+        writer.finish();
+    }
+    state.SetBytesProcessed((std::int64_t)state.iterations() * (std::int64_t)out.str().size());
+}
+BENCHMARK(BM_WriteRoutes)->ArgsProduct({ { 1000, 100000 }, { 0, 1, 2, 3, 4 } })->Unit(benchmark::kMicrosecond);
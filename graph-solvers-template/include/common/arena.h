@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+/**
+ * @brief Monotonic memory resource whose chunks survive reset().
+ *
+ * Allocations bump a pointer through a list of chunks obtained from the upstream resource;
+ * deallocation is a no-op. reset() rewinds to the first chunk without returning memory, so
+ * once the arena has grown to the peak footprint of a workload, repeating that workload
+ * performs no upstream (heap) allocations at all. This differs from
+ * std::pmr::monotonic_buffer_resource, whose release() frees every chunk.
+ *
+ * Intended for per-attempt scratch: containers built on a std::pmr::polymorphic_allocator
+ * over the arena must be discarded (or reassigned to an empty container on the same arena)
+ * before reset(). An arena is not thread-safe; use one per worker or per task slot.
+ */
+class Arena : public std::pmr::memory_resource
+{
+public:
+    /**
+     * @param initialChunk Size in bytes of the first chunk; later chunks double.
+     * @param upstream     Resource the chunks are taken from.
+     */
+    explicit Arena(std::size_t initialChunk = 64 * 1024,
+        std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+
+    ~Arena() override;
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+     * @brief Makes all memory available again; every previous allocation becomes invalid.
+     */
+    void reset();
+
+    /// @return Bytes handed out since the last reset().
+    std::size_t bytesUsed() const { return used_; }
+
+    /// @return Total size of the chunks owned by the arena.
+    std::size_t capacity() const { return capacity_; }
+
+    /// @return Number of chunks requested from the upstream resource over the arena's lifetime.
+    std::uint64_t upstreamAllocations() const { return upstreamAllocations_; }
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void*, std::size_t, std::size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+private:
+    struct Chunk
+    {
+        std::byte* data;
+        std::size_t size;
+    };
+
+    std::pmr::memory_resource* upstream_;
+    std::size_t nextChunkSize_;
+    std::vector<Chunk> chunks_;
+    std::size_t current_ = 0;   ///< Chunk currently bumped.
+    std::size_t offset_ = 0;    ///< First free byte in the current chunk.
+    std::size_t used_ = 0;
+    std::size_t capacity_ = 0;
+    std::uint64_t upstreamAllocations_ = 0;
+};
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "common/types.h"
+#include "common/graph.h"
+#include "common/point_set.h"
+
+/**
+ * @brief Source of travel costs between the nodes of an instance.
+ *
+ * All solver stages read distances through this interface, so the same code runs on plain
+ * Euclidean coordinates, on a precomputed matrix (e.g. road-network travel times) or on a
+ * cached view of an expensive source. Implementations must be safe to query concurrently.
+ */
+class DistanceProvider
+{
+public:
+    virtual ~DistanceProvider() = default;
+
+    /// @return Number of nodes.
+    virtual int size() const = 0;
+
+    /// @return Distance from node @p i to node @p j.
+    virtual double distance(int i, int j) const = 0;
+
+    /**
+     * @brief Distances from node @p from to every node in @p to.
+     *
+     * Backends override this to amortize per-call overhead (locking, tile lookup) and to let
+     * the compiler vectorize the inner loop.
+     *
+     * @param from Source node.
+     * @param to   Target nodes.
+     * @param out  Receives one distance per target; must have the same size as @p to.
+     */
+    virtual void distances(int from, std::span<const int> to, std::span<double> out) const;
+
+    /**
+     * @brief Distances from node @p from to all nodes.
+     *
+     * @param out Receives size() distances.
+     */
+    virtual void row(int from, std::span<double> out) const;
+
+    /**
+     * @brief Distances from all nodes to node @p to.
+     *
+     * @param out Receives size() distances.
+     */
+    virtual void column(int to, std::span<double> out) const;
+
+    /// @return Bytes held by the provider, used to budget caches of prepared instances.
+    virtual std::size_t memoryBytes() const = 0;
+};
+
+/**
+ * @brief Euclidean distances computed on the fly from coordinates.
+ *
+ * Coordinates are kept in a PointSet, so batched queries run on its SIMD kernels. Needs
+ * O(n) memory; single precision halves it at the cost of ~1e-7 relative error.
+ */
+class EuclideanDistances : public DistanceProvider
+{
+public:
+    explicit EuclideanDistances(const std::vector<Point>& points, Precision precision = Precision::Double);
+
+    int size() const override { return points_.size(); }
+    double distance(int i, int j) const override { return points_.distance(i, j); }
+    void distances(int from, std::span<const int> to, std::span<double> out) const override;
+    void row(int from, std::span<double> out) const override;
+    void column(int to, std::span<double> out) const override { row(to, out); }
+    std::size_t memoryBytes() const override;
+
+    /// @return The coordinates the distances are computed from.
+    const PointSet& points() const { return points_; }
+
+private:
+    PointSet points_;
+};
+
+/**
+ * @brief Dense n × n matrix of single-precision distances.
+ *
+ * Suited to small instances and to externally computed matrices (road networks), which do
+ * not have to be symmetric. Uses 4·n² bytes.
+ */
+class DenseDistanceMatrix : public DistanceProvider
+{
+public:
+    /**
+     * @brief Wraps a precomputed row-major matrix.
+     *
+     * @throws std::invalid_argument If @p values does not hold n·n entries.
+     */
+    DenseDistanceMatrix(int n, std::vector<float> values);
+
+    /**
+     * @brief Materializes every distance of @p source.
+     */
+    explicit DenseDistanceMatrix(const DistanceProvider& source);
+
+    int size() const override { return n_; }
+    double distance(int i, int j) const override { return values_[(std::size_t)i * n_ + j]; }
+    void distances(int from, std::span<const int> to, std::span<double> out) const override;
+    void row(int from, std::span<double> out) const override;
+    std::size_t memoryBytes() const override { return values_.size() * sizeof(float); }
+
+private:
+    int n_ = 0;
+    std::vector<float> values_;
+};
+
+/**
+ * @brief Lazily filled, tile-cached view of another provider.
+ *
+ * The matrix is split into square tiles of @p tileSize × @p tileSize entries. A tile is
+ * computed from the source on first access and kept in a least-recently-used cache holding
+ * at most @p maxTiles tiles, so memory stays bounded by maxTiles · tileSize² · 8 bytes no
+ * matter how large the instance is. Solver access patterns (neighbouring nodes, rows from
+ * the depot) touch few tiles, so most queries hit the cache. Tiles keep the source's values
+ * in double precision, so the cache returns exactly what the source would.
+ *
+ * The cache is guarded by a mutex; prefer the batched queries, which lock once per tile.
+ */
+class TiledDistanceCache : public DistanceProvider
+{
+public:
+    /**
+     * @param source   Provider the tiles are filled from; must outlive the cache.
+     * @param tileSize Edge length of a tile in nodes.
+     * @param maxTiles Maximum number of tiles kept in memory (at least 1).
+     */
+    TiledDistanceCache(const DistanceProvider& source, int tileSize = 64, std::size_t maxTiles = 1024);
+
+    /**
+     * @brief Same as above, with the cache owning its source.
+     */
+    TiledDistanceCache(std::unique_ptr<const DistanceProvider> source, int tileSize = 64, std::size_t maxTiles = 1024);
+
+    int size() const override { return source_.size(); }
+    double distance(int i, int j) const override;
+    void distances(int from, std::span<const int> to, std::span<double> out) const override;
+    void row(int from, std::span<double> out) const override;
+
+    /// @return Bytes of the source plus a full cache, the most the provider grows to.
+    std::size_t memoryBytes() const override;
+
+    /// @return Number of tiles currently cached.
+    std::size_t cachedTiles() const;
+
+    /// @return Number of tile lookups served from the cache.
+    std::uint64_t hits() const;
+
+    /// @return Number of tiles computed from the source.
+    std::uint64_t misses() const;
+
+private:
+    using Tile = std::shared_ptr<const std::vector<double>>;
+
+    struct Entry
+    {
+        Tile tile;
+        std::list<std::uint64_t>::iterator lru;
+    };
+
+    /// Returns the tile with the given row/column tile indices, filling it if needed.
+    /// Must be called with mutex_ held.
+    Tile tile(int tileRow, int tileCol) const;
+
+    std::unique_ptr<const DistanceProvider> owned_;  ///< Source when the cache owns it; null otherwise.
+    const DistanceProvider& source_;
+    int tileSize_;
+    int tilesPerRow_;
+    std::size_t maxTiles_;
+
+    mutable std::mutex mutex_;
+    mutable std::unordered_map<std::uint64_t, Entry> tiles_;
+    mutable std::list<std::uint64_t> lru_;  ///< Tile keys, most recently used first.
+    mutable std::uint64_t hits_ = 0;
+    mutable std::uint64_t misses_ = 0;
+};
+
+/**
+ * @brief Chooses a backend for coordinates.
+ *
+ * Returns an EuclideanDistances in double precision, which needs O(n) memory and yields
+ * exactly the Euclidean edge costs. From @p tiledFrom nodes on, it is wrapped in a
+ * TiledDistanceCache whose 256 tiles of 64 × 64 entries cap the cache at 8 MB, so the
+ * repeated row, column and neighbourhood queries of large instances are served from memory.
+ *
+ * @param points    Node coordinates.
+ * @param tiledFrom Node count from which the tile cache is used.
+ */
+std::unique_ptr<DistanceProvider> makeDistanceProvider(const std::vector<Point>& points, int tiledFrom = 5000);
+
+/**
+ * @brief Overwrites every edge cost of @p graph with the distance between its endpoints.
+ *
+ * Lets candidate graphs take their costs from the same provider as the rest of the solver.
+ * Distances are queried in one batch per vertex; edge {u, v} with u < v gets distance(u, v).
+ *
+ * @throws std::invalid_argument If the graph and the provider differ in size.
+ */
+void setEdgeCosts(Graph& graph, const DistanceProvider& distances);
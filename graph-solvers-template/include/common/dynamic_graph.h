@@ -0,0 +1,117 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "common/types.h"
+#include "common/graph.h"
+
+/**
+ * @brief Undirected, weighted graph in CSR form with slack, so edges can be added and removed in place.
+ *
+ * Same layout and queries as Graph, except that every vertex owns a block of adjacency slots
+ * larger than its degree. Adding an edge shifts the sorted neighbours of its two endpoints
+ * inside their blocks; a full block is moved to the end of the arrays with twice the room, and
+ * the arrays are compacted once more than half of them is abandoned blocks. Both updates cost
+ * O(degree) amortized.
+ *
+ * Edge ids are stable until the edge is removed; removed ids are recycled by later additions.
+ * Ids therefore range over [0, idBound()) with gaps, and isEdge() tells live ids apart.
+ */
+class DynamicGraph
+{
+public:
+    /// Edge id returned by edgeId() when the two vertices are not adjacent.
+    static constexpr int npos = -1;
+
+    /**
+     * @brief Creates an empty graph with no vertices.
+     */
+    DynamicGraph() = default;
+
+    /**
+     * @brief Copies a graph, keeping its vertex and edge ids.
+     */
+    explicit DynamicGraph(const Graph& graph);
+
+    /// @return Number of vertices.
+    int vertexCount() const { return (int)degree_.size(); }
+
+    /// @return Number of live edges.
+    int edgeCount() const { return edgeCount_; }
+
+    /// @return One past the largest edge id in use.
+    int idBound() const { return (int)edges_.size(); }
+
+    /// @return Number of neighbours of vertex @p u.
+    int degree(int u) const { return degree_[u]; }
+
+    /// @return Neighbours of @p u in ascending order.
+    std::span<const int> neighbours(int u) const
+    {
+        return { targets_.data() + begin_[u], (std::size_t)degree_[u] };
+    }
+
+    /// @return Edge ids incident to @p u, aligned with neighbours(u).
+    std::span<const int> incidentEdges(int u) const
+    {
+        return { edgeIds_.data() + begin_[u], (std::size_t)degree_[u] };
+    }
+
+    /**
+     * @brief Looks up the id of the undirected edge {u, v}.
+     *
+     * @return The edge id, or DynamicGraph::npos if u and v are not adjacent.
+     */
+    int edgeId(int u, int v) const;
+
+    /// @return true if u and v are connected by an edge.
+    bool hasEdge(int u, int v) const { return edgeId(u, v) != npos; }
+
+    /// @return true if @p id is the id of a live edge.
+    bool isEdge(int id) const { return id >= 0 && id < idBound() && edges_[id].u >= 0; }
+
+    /// @return The edge with the given id (u < v).
+    const Edge& edge(int id) const { return edges_[id]; }
+
+    /// @return Cost of the edge with the given id.
+    double cost(int id) const { return edges_[id].cost; }
+
+    /// @brief Overwrites the cost of an edge in place.
+    void setCost(int id, double cost) { edges_[id].cost = cost; }
+
+    /**
+     * @brief Appends an isolated vertex.
+     *
+     * @return Its index.
+     */
+    int addVertex();
+
+    /**
+     * @brief Adds the edge {u, v}, or returns the id of the existing one (whose cost is kept).
+     *
+     * @throws std::invalid_argument If an endpoint is out of range or u == v.
+     */
+    int addEdge(int u, int v, double cost);
+
+    /**
+     * @brief Removes a live edge; its id may be reused by a later addEdge().
+     */
+    void removeEdge(int id);
+
+private:
+    void insertSlot(int u, int v, int id);
+    void eraseSlot(int u, int v);
+    void grow(int u);
+    void compact();
+
+    std::vector<int> begin_;      ///< First adjacency slot of each vertex.
+    std::vector<int> degree_;     ///< Used slots of each vertex.
+    std::vector<int> capacity_;   ///< Slots owned by each vertex.
+    std::vector<int> targets_;    ///< Neighbour vertex for each adjacency slot.
+    std::vector<int> edgeIds_;    ///< Edge id for each adjacency slot.
+    std::vector<Edge> edges_;     ///< Canonical edges (u < v) by id; u == -1 marks a free id.
+    std::vector<int> freeIds_;    ///< Removed edge ids, reused first.
+    int edgeCount_ = 0;
+    std::size_t abandoned_ = 0;   ///< Slots of blocks left behind by grow().
+};
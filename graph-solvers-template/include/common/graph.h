@@ -0,0 +1,98 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "common/types.h"
+
+/**
+ * @brief Undirected, weighted graph stored in compressed-sparse-row (CSR) form.
+ *
+ * The graph is built once from an edge list (typically the Delaunay edges produced by
+ * `computeTriangulationAndEdges`) and then shared, read-only, by every solver stage.
+ * Each undirected edge receives a stable id in [0, edgeCount()), assigned in
+ * lexicographical (u, v) order with u < v. The adjacency of every vertex is stored
+ * contiguously and sorted by neighbour index, so edge lookups are O(log deg).
+ *
+ * Topology is immutable after construction; only edge weights may be overwritten
+ * in place (see setCost()), which lets callers reuse one graph for many perturbed runs
+ * without reallocating anything.
+ */
+class Graph
+{
+public:
+    /// Edge id returned by edgeId() when the two vertices are not adjacent.
+    static constexpr int npos = -1;
+
+    /**
+     * @brief Creates an empty graph with no vertices.
+     */
+    Graph() = default;
+
+    /**
+     * @brief Builds the CSR structure from an edge list.
+     *
+     * Edge orientation is ignored, self-loops are dropped and duplicate (u, v) pairs keep
+     * only the first occurrence (and its cost).
+     *
+     * @param vertexCount Number of vertices; every edge endpoint must lie in [0, vertexCount).
+     * @param edges       Undirected edges with their costs.
+     *
+     * @throws std::invalid_argument If an edge references a vertex outside the valid range.
+     */
+    Graph(int vertexCount, const std::vector<Edge>& edges);
+
+    /// @return Number of vertices.
+    int vertexCount() const { return offsets_.empty() ? 0 : (int)offsets_.size() - 1; }
+
+    /// @return Number of undirected edges.
+    int edgeCount() const { return (int)edges_.size(); }
+
+    /// @return Number of neighbours of vertex @p u.
+    int degree(int u) const { return offsets_[u + 1] - offsets_[u]; }
+
+    /// @return Neighbours of @p u in ascending order.
+    std::span<const int> neighbours(int u) const
+    {
+        return { targets_.data() + offsets_[u], targets_.data() + offsets_[u + 1] };
+    }
+
+    /// @return Edge ids incident to @p u, aligned with neighbours(u).
+    std::span<const int> incidentEdges(int u) const
+    {
+        return { edgeIds_.data() + offsets_[u], edgeIds_.data() + offsets_[u + 1] };
+    }
+
+    /**
+     * @brief Looks up the id of the undirected edge {u, v}.
+     *
+     * @return The edge id, or Graph::npos if u and v are not adjacent.
+     */
+    int edgeId(int u, int v) const;
+
+    /// @return true if u and v are connected by an edge.
+    bool hasEdge(int u, int v) const { return edgeId(u, v) != npos; }
+
+    /// @return The edge with the given id (u < v).
+    const Edge& edge(int id) const { return edges_[id]; }
+
+    /// @return All edges indexed by edge id.
+    const std::vector<Edge>& edges() const { return edges_; }
+
+    /// @return Cost of the edge with the given id.
+    double cost(int id) const { return edges_[id].cost; }
+
+    /**
+     * @brief Overwrites the cost of an edge in place.
+     *
+     * @param id   Edge id.
+     * @param cost New cost.
+     */
+    void setCost(int id, double cost) { edges_[id].cost = cost; }
+
+private:
+    std::vector<int> offsets_;   ///< offsets_[u]..offsets_[u + 1] delimit u's adjacency.
+    std::vector<int> targets_;   ///< Neighbour vertex for each adjacency slot.
+    std::vector<int> edgeIds_;   ///< Edge id for each adjacency slot.
+    std::vector<Edge> edges_;    ///< Canonical edges (u < v) indexed by edge id.
+};
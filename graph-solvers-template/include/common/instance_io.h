@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "common/types.h"
+
+/**
+ * @brief Problem instance in structure-of-arrays layout.
+ *
+ * Coordinates and demands are stored in separate contiguous arrays so that loaders can
+ * stream values straight into them and vectorized kernels can read them without gathering.
+ */
+struct Instance
+{
+    std::string name;                                            ///< Instance name (from the file header or path).
+    std::vector<double> x;                                       ///< X-coordinate per node.
+    std::vector<double> y;                                       ///< Y-coordinate per node.
+    std::vector<double> demand;                                  ///< Demand per node; empty if the file has none.
+    std::vector<double> readyTime;                               ///< Earliest start of service per node; empty without time windows.
+    std::vector<double> dueTime;                                 ///< Latest start of service per node, aligned with @ref readyTime.
+    std::vector<double> serviceTime;                             ///< Service duration per node; empty if the file has none.
+    std::vector<int> depots;                                     ///< Depot node indices (0-based), if given.
+    double capacity = std::numeric_limits<double>::infinity();   ///< Vehicle capacity, if given.
+
+    /// @return Number of nodes.
+    int size() const { return (int)x.size(); }
+
+    /**
+     * @brief Converts the coordinates to the array-of-structures form used by the solver.
+     */
+    std::vector<Point> points() const;
+};
+
+/**
+ * @brief On-disk formats understood by loadInstance().
+ */
+enum class InstanceFormat
+{
+    Auto,    ///< Chosen from the file extension (.vrp/.tsp, .csv/.txt, .cwb) or the binary magic.
+    Tsplib,  ///< TSPLIB / CVRPLIB text with NODE_COORD_SECTION, DEMAND_SECTION, DEPOT_SECTION and optionally
+             ///< TIME_WINDOW_SECTION and SERVICE_TIME_SECTION.
+    Csv,     ///< One node per line: x, y[, demand]; comma, semicolon, tab or space separated.
+    Binary   ///< Compact little-endian format written by saveBinaryInstance().
+};
+
+/**
+ * @brief Read-only memory mapping of a whole file.
+ *
+ * Uses mmap on POSIX systems and a file mapping object on Windows. The mapping is released
+ * when the object is destroyed.
+ */
+class MappedFile
+{
+public:
+    /**
+     * @brief Maps @p path into memory.
+     *
+     * @throws std::runtime_error If the file cannot be opened or mapped.
+     */
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /// @return The file contents.
+    std::string_view view() const { return { data_, size_ }; }
+
+private:
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#endif
+};
+
+/**
+ * @brief Loads an instance from a memory-mapped file.
+ *
+ * Text formats are parsed in place with std::from_chars, without copying lines or tokens;
+ * the binary format is copied straight from the mapping into the coordinate arrays.
+ * Every loaded instance is checked for duplicate coordinates (see validateUniquePoints()).
+ *
+ * @param path   File to read.
+ * @param format File format, or InstanceFormat::Auto to detect it.
+ * @return Instance The parsed instance.
+ *
+ * @throws std::runtime_error On I/O errors, malformed input or duplicate points.
+ */
+Instance loadInstance(const std::string& path, InstanceFormat format = InstanceFormat::Auto);
+
+/**
+ * @brief Parses an instance held in memory.
+ *
+ * @param data   File contents.
+ * @param format File format; InstanceFormat::Auto detects only the binary magic and otherwise
+ *               tries TSPLIB when a NODE_COORD_SECTION is present, CSV if not.
+ * @param name   Name used in error messages and for formats without a name field.
+ */
+Instance parseInstance(std::string_view data, InstanceFormat format, const std::string& name = "instance");
+
+/**
+ * @brief Writes an instance in the compact binary format.
+ *
+ * Layout: magic "CWB1", uint32 flags (bit 0: demands present), uint64 node count,
+ * uint64 depot count, double capacity, then x[n], y[n], optional demand[n] as doubles and
+ * depots[] as int32. Time windows are not stored.
+ *
+ * @throws std::runtime_error If the file cannot be written.
+ */
+void saveBinaryInstance(const Instance& instance, const std::string& path);
+
+/**
+ * @brief Checks that no two nodes share the same coordinates.
+ *
+ * Uses a hash table keyed by the exact coordinate bits, so the check is O(n) expected time.
+ *
+ * @throws std::runtime_error Naming the first duplicated pair of node indices.
+ */
+void validateUniquePoints(const Instance& instance);
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @file instrumentation.h
+ * @brief Scoped stage timers and event counters for the solver hot paths.
+ *
+ * Instrumentation is enabled by compiling with CW_INSTRUMENTATION=1 (CMake option
+ * CW_ENABLE_INSTRUMENTATION). Otherwise the CW_PROFILE_SCOPE and CW_COUNT macros expand to
+ * nothing and instrumented code carries no overhead.
+ */
+
+#ifndef CW_INSTRUMENTATION
+#define CW_INSTRUMENTATION 0
+#endif
+
+/**
+ * @brief Events counted across the whole process.
+ */
+enum class Counter
+{
+    Attempts,             ///< Route generation attempts.
+    Merges,               ///< Savings that merged two routes.
+    RejectedSavings,      ///< Savings skipped by the merge loop (not endpoints, same route, limits).
+    FallbackPaths,        ///< Shortest-path fallbacks (findAlternativePath calls).
+    DiversityRejections,  ///< Candidates rejected as too similar to accepted routes.
+    UsedNodesResets,      ///< Random partial resets of the used-node set.
+    ArenaGrowth,          ///< Chunks allocated by arenas; stays flat once attempts reach steady state.
+    Count                 ///< Number of counters (not a counter).
+};
+
+/// @return Snake-case name of @p counter as used in the reports.
+const char* counterName(Counter counter);
+
+/**
+ * @brief Process-wide collector of counters and timed stage spans.
+ *
+ * Counters are relaxed atomics. Every finished span is appended to an event log (for the
+ * Chrome trace) and folded into per-stage totals (for the JSON report) under a mutex, so
+ * scopes should wrap stages and attempts rather than single loop iterations.
+ *
+ * Bytes per stage are the bytes requested through operator new on the thread that ran the
+ * scope while it was open; allocations made by pool workers are attributed to the scopes
+ * those workers open themselves.
+ */
+class Instrumentation
+{
+public:
+    /// @return The global collector.
+    static Instrumentation& instance();
+
+    /// Adds @p n to @p counter.
+    void add(Counter counter, std::uint64_t n = 1)
+    {
+        counters_[(int)counter].fetch_add(n, std::memory_order_relaxed);
+    }
+
+    /// @return Current value of @p counter.
+    std::uint64_t count(Counter counter) const
+    {
+        return counters_[(int)counter].load(std::memory_order_relaxed);
+    }
+
+    /// @return Nanoseconds since the collector was created.
+    std::int64_t now() const;
+
+    /**
+     * @brief Records a finished span of stage @p stage.
+     *
+     * @param stage      Stage name; must outlive the collector (string literals).
+     * @param startNs    Start time as returned by now().
+     * @param durationNs Duration in nanoseconds.
+     * @param bytes      Bytes allocated by the calling thread during the span.
+     */
+    void record(const char* stage, std::int64_t startNs, std::int64_t durationNs, std::uint64_t bytes);
+
+    /// @return Number of finished spans of @p stage since the last reset().
+    std::uint64_t stageCalls(const std::string& stage) const;
+
+    /// @return Bytes allocated inside the spans of @p stage since the last reset().
+    std::uint64_t stageBytes(const std::string& stage) const;
+
+    /// Clears all counters, stage totals and events.
+    void reset();
+
+    /**
+     * @brief Summary as JSON: counters, and per stage the call count, total and maximum
+     *        time in milliseconds, and allocated bytes.
+     */
+    std::string reportJson() const;
+
+    /**
+     * @brief Writes reportJson() to @p path.
+     *
+     * @throws std::runtime_error If the file cannot be written.
+     */
+    void writeReport(const std::string& path) const;
+
+    /**
+     * @brief Writes the recorded spans and final counter values in Chrome trace event format
+     *        (open in chrome://tracing or Perfetto).
+     *
+     * @throws std::runtime_error If the file cannot be written.
+     */
+    void writeChromeTrace(const std::string& path) const;
+
+    /// @return Bytes allocated through operator new by the calling thread so far (0 when compiled out).
+    static std::uint64_t threadAllocatedBytes();
+
+    /// Maximum number of spans kept for the trace; later spans only update the stage totals.
+    static constexpr std::size_t maxEvents = 1 << 20;
+
+private:
+    Instrumentation();
+
+    struct Event
+    {
+        const char* stage;
+        std::int64_t start;
+        std::int64_t duration;
+        std::uint64_t bytes;
+        int thread;
+    };
+
+    struct StageTotals
+    {
+        std::uint64_t calls = 0;
+        std::int64_t totalNs = 0;
+        std::int64_t maxNs = 0;
+        std::uint64_t bytes = 0;
+    };
+
+    std::chrono::steady_clock::time_point epoch_;
+    std::array<std::atomic<std::uint64_t>, (int)Counter::Count> counters_{};
+
+    mutable std::mutex mutex_;
+    std::vector<Event> events_;
+    std::map<std::string, StageTotals> stages_;
+    std::uint64_t droppedEvents_ = 0;
+};
+
+/**
+ * @brief Times the enclosing scope and records it as one span of a stage.
+ */
+class ScopedTimer
+{
+public:
+    explicit ScopedTimer(const char* stage)
+        : stage_(stage),
+          start_(Instrumentation::instance().now()),
+          bytes_(Instrumentation::threadAllocatedBytes())
+    {
+    }
+
+    ~ScopedTimer()
+    {
+        auto& instrumentation = Instrumentation::instance();
+        instrumentation.record(stage_, start_, instrumentation.now() - start_,
+            Instrumentation::threadAllocatedBytes() - bytes_);
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    const char* stage_;
+    std::int64_t start_;
+    std::uint64_t bytes_;
+};
+
+#define CW_INSTRUMENTATION_CONCAT_(a, b) a##b
+#define CW_INSTRUMENTATION_CONCAT(a, b) CW_INSTRUMENTATION_CONCAT_(a, b)
+
+#if CW_INSTRUMENTATION
+/// Times the rest of the enclosing scope as stage @p name (a string literal).
+#define CW_PROFILE_SCOPE(name) ScopedTimer CW_INSTRUMENTATION_CONCAT(cwProfileScope_, __LINE__)(name)
+/// Adds @p n to counter Counter::@p counter.
+#define CW_COUNT(counter, n) Instrumentation::instance().add(Counter::counter, (n))
+#else
+#define CW_PROFILE_SCOPE(name) ((void)0)
+#define CW_COUNT(counter, n) ((void)0)
+#endif
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "common/types.h"
+#include "common/simd.h"
+
+/**
+ * @brief Storage precision of PointSet coordinates.
+ */
+enum class Precision
+{
+    Double,  ///< 8-byte coordinates; results match euclidean() bit for bit.
+    Single   ///< 4-byte coordinates; half the memory traffic and twice the lanes, ~1e-7 relative error.
+};
+
+/**
+ * @brief Points in structure-of-arrays layout with batched distance kernels.
+ *
+ * The x and y coordinates are stored in two separate arrays, so the kernels load whole
+ * vectors of coordinates (or gather them by index) instead of de-interleaving Point structs.
+ * Every kernel exists in a scalar, an AVX2 and an AVX-512 variant and dispatches on
+ * simdLevel() at run time.
+ *
+ * In double precision each distance is computed as sqrt(dx·dx + dy·dy) without fused
+ * multiply-add, exactly like euclidean(), so switching levels never changes a result. Single
+ * precision computes in float and widens the results to double.
+ */
+class PointSet
+{
+public:
+    /**
+     * @brief Creates an empty set.
+     */
+    PointSet() = default;
+
+    /**
+     * @brief Copies @p points into separate coordinate arrays.
+     */
+    explicit PointSet(std::span<const Point> points, Precision precision = Precision::Double);
+
+    /// @return Number of points.
+    int size() const { return size_; }
+
+    /// @return Precision the coordinates are stored in.
+    Precision precision() const { return precision_; }
+
+    /// @return Point @p i (rounded to the storage precision).
+    Point operator[](int i) const;
+
+    /// @return Distance between points @p i and @p j.
+    double distance(int i, int j) const;
+
+    /**
+     * @brief Distances from @p origin to every point of the set, e.g. the depot distances c0i.
+     *
+     * @param out Receives size() distances.
+     */
+    void distancesFrom(const Point& origin, std::span<double> out) const;
+
+    /**
+     * @brief Distances from point @p from to the points listed in @p to.
+     *
+     * @param out Receives one distance per entry of @p to.
+     */
+    void distancesFrom(int from, std::span<const int> to, std::span<double> out) const;
+
+    /**
+     * @brief Lengths of the segments between the endpoints of @p edges (their costs are ignored).
+     *
+     * @param out Receives one length per edge.
+     */
+    void edgeLengths(std::span<const Edge> edges, std::span<double> out) const;
+
+private:
+    int size_ = 0;
+    Precision precision_ = Precision::Double;
+    std::vector<double> xs_;  ///< Double-precision coordinates (empty in single precision).
+    std::vector<double> ys_;
+    std::vector<float> xf_;   ///< Single-precision coordinates (empty in double precision).
+    std::vector<float> yf_;
+};
+
+/**
+ * @brief Clarke-Wright savings c0u + c0v - cuv of a batch of edges.
+ *
+ * Gathers the depot distances of both endpoints and subtracts the edge cost in the same
+ * order as the scalar formula, so every SIMD level gives identical values.
+ *
+ * @param depotDistances c0i for every vertex.
+ * @param edges          Edges with their costs cuv.
+ * @param out            Receives one saving per edge.
+ */
+void computeSavings(std::span<const double> depotDistances, std::span<const Edge> edges, std::span<double> out);
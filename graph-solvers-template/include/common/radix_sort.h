@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+class ThreadPool;
+
+/**
+ * @brief Stable LSD radix sort of 64-bit keys carrying an int payload.
+ *
+ * Sorts one byte per pass and skips the passes in which every key has the same byte, so
+ * keys that only use their low 32 bits cost four passes. With a pool each pass splits the
+ * input into blocks: the blocks count their digits in parallel, the counts are turned into
+ * scatter offsets in block order, and the blocks scatter in parallel. Because the offsets
+ * follow block order the sort stays stable, and the result does not depend on the number
+ * of threads.
+ *
+ * @param keys   Keys, sorted in place in ascending order.
+ * @param values Payload aligned with @p keys, permuted alongside (same size).
+ * @param pool   Pool running the blocks; the sort runs serially when null.
+ * @throws std::invalid_argument If the sizes differ.
+ */
+void radixSort(std::span<std::uint64_t> keys, std::span<int> values, ThreadPool* pool = nullptr);
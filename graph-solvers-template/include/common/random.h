@@ -0,0 +1,125 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+/**
+ * @brief Philox4x32-10 block function (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3").
+ *
+ * Maps a 128-bit counter and a 64-bit key to 128 random bits with ten rounds of
+ * multiply-xor mixing. There is no state: the same (counter, key) always gives the same block,
+ * and different counters give independent blocks, so any element of a random sequence can be
+ * computed directly and in any order.
+ */
+struct Philox4x32
+{
+    using Counter = std::array<std::uint32_t, 4>;
+    using Key = std::array<std::uint32_t, 2>;
+
+    static Counter generate(Counter counter, Key key)
+    {
+        for (int round = 0; round < 10; ++round) {
+            if (round > 0) {
+                key[0] += 0x9E3779B9u;
+                key[1] += 0xBB67AE85u;
+            }
+            std::uint64_t p0 = (std::uint64_t)0xD2511F53u * counter[0];
+            std::uint64_t p1 = (std::uint64_t)0xCD9E8D57u * counter[2];
+            counter = { (std::uint32_t)(p1 >> 32) ^ counter[1] ^ key[0], (std::uint32_t)p1,
+                        (std::uint32_t)(p0 >> 32) ^ counter[3] ^ key[1], (std::uint32_t)p0 };
+        }
+        return counter;
+    }
+};
+
+/**
+ * @brief Stateless random numbers addressed by (seed, stream, index).
+ *
+ * The seed is the Philox key and the counter holds the stream and the index, so the value at
+ * an index is a pure function of the three numbers. The solver uses the attempt number as the
+ * stream and the graph edge id as the index: every edge perturbation of every attempt can be
+ * recomputed on its own, by any thread and in any order, and a run is replayed bit-exactly
+ * from its seed. Each index yields two independent uniforms (one Philox block).
+ */
+class CounterRng
+{
+public:
+    explicit CounterRng(std::uint64_t seed, std::uint64_t stream = 0)
+        : key_{ (std::uint32_t)seed, (std::uint32_t)(seed >> 32) }, stream_(stream)
+    {
+    }
+
+    /// @return 128 random bits for @p index.
+    Philox4x32::Counter block(std::uint64_t index) const
+    {
+        return Philox4x32::generate({ (std::uint32_t)index, (std::uint32_t)(index >> 32),
+            (std::uint32_t)stream_, (std::uint32_t)(stream_ >> 32) }, key_);
+    }
+
+    /// @return 64 random bits for @p index.
+    std::uint64_t bits(std::uint64_t index) const
+    {
+        auto b = block(index);
+        return ((std::uint64_t)b[1] << 32) | b[0];
+    }
+
+    /// @return Two independent uniforms in [0, 1) for @p index.
+    std::array<double, 2> uniform2(std::uint64_t index) const
+    {
+        auto b = block(index);
+        return { toUnit(b[0], b[1]), toUnit(b[2], b[3]) };
+    }
+
+    /// @return A uniform in [0, 1) for @p index (the first value of uniform2()).
+    double uniform(std::uint64_t index) const { return uniform2(index)[0]; }
+
+    /**
+     * @brief Fills the uniforms of indices first, first + 1, … in one pass.
+     *
+     * The loop has no dependencies between iterations, so the compiler can vectorize the
+     * Philox rounds across indices. Results equal uniform2(first + i).
+     *
+     * @param first  Index of out0[0] and out1[0].
+     * @param out0   Receives the first uniform of each index.
+     * @param out1   Receives the second uniform of each index; must have the size of @p out0.
+     */
+    void fill(std::uint64_t first, std::span<double> out0, std::span<double> out1) const;
+
+    /// Converts two 32-bit words to a double in [0, 1) with 53 random bits.
+    static double toUnit(std::uint32_t lo, std::uint32_t hi)
+    {
+        return (double)((((std::uint64_t)hi << 32) | lo) >> 11) * 0x1.0p-53;
+    }
+
+private:
+    Philox4x32::Key key_;
+    std::uint64_t stream_;
+};
+
+/**
+ * @brief UniformRandomBitGenerator that walks the indices of a CounterRng stream.
+ *
+ * Drop-in replacement for std::mt19937_64 in sequential code (std::shuffle, distributions):
+ * the n-th call returns CounterRng(seed, stream).bits(n).
+ */
+class CounterEngine
+{
+public:
+    using result_type = std::uint64_t;
+
+    explicit CounterEngine(std::uint64_t seed, std::uint64_t stream = 0) : rng_(seed, stream) {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() { return rng_.bits(next_++); }
+
+    /// @return Number of values drawn so far (the index of the next one).
+    std::uint64_t position() const { return next_; }
+
+private:
+    CounterRng rng_;
+    std::uint64_t next_ = 0;
+};
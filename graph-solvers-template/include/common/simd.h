@@ -0,0 +1,40 @@
+#pragma once
+
+/**
+ * @brief Instruction sets the batched geometry kernels (see PointSet) can run on.
+ */
+enum class SimdLevel
+{
+    Scalar,  ///< Portable loops; every platform.
+    Avx2,    ///< 256-bit vectors with gathers (x86-64).
+    Avx512   ///< 512-bit vectors (x86-64 with AVX-512F).
+};
+
+/**
+ * @brief Best level supported by both this build and the CPU (and the OS saving its registers).
+ *
+ * Evaluated once; the kernels for every level are compiled into the binary regardless of the
+ * compiler flags, so one executable uses AVX-512 where available and falls back elsewhere.
+ */
+SimdLevel detectSimdLevel();
+
+/// @return Level the kernels currently dispatch to; detectSimdLevel() unless overridden.
+SimdLevel simdLevel();
+
+/**
+ * @brief Overrides the dispatch level, e.g. to compare kernels in tests and benchmarks.
+ *
+ * Levels above detectSimdLevel() are clamped to it. Affects all threads; set it before
+ * starting work.
+ */
+void setSimdLevel(SimdLevel level);
+
+/// @return "scalar", "avx2" or "avx512".
+const char* simdLevelName(SimdLevel level);
+
+/**
+ * @brief Parses a name returned by simdLevelName().
+ *
+ * @throws std::invalid_argument For any other name.
+ */
+SimdLevel parseSimdLevel(const char* name);
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed-size pool of worker threads used to run independent solver tasks.
+ *
+ * A pool created with a single thread (or zero worker threads on a single-core machine)
+ * spawns nothing and runs every task inline on the calling thread, so callers can use the
+ * same code path for serial and parallel execution.
+ *
+ * Tasks receive the index of the worker executing them, in [0, size()), which lets callers
+ * keep per-worker scratch buffers without any locking.
+ */
+class ThreadPool
+{
+public:
+    /**
+     * @brief Starts the worker threads.
+     *
+     * @param threads Number of workers; 0 selects std::thread::hardware_concurrency().
+     */
+    explicit ThreadPool(unsigned threads = 0);
+
+    /**
+     * @brief Waits for queued tasks to finish and joins all workers.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// @return Number of worker slots (at least 1).
+    unsigned size() const { return workers_.empty() ? 1u : (unsigned)workers_.size(); }
+
+    /**
+     * @brief Runs body(index, worker) for every index in [0, count) and blocks until all are done.
+     *
+     * Indices are handed out dynamically, so the mapping of index to worker is not deterministic;
+     * callers that need reproducible results must write each result into a slot owned by its index.
+     * If any invocation throws, the first exception is rethrown on the calling thread.
+     * Must not be called from inside a task running on the same pool.
+     *
+     * The pool queues references to a frame on the caller's stack, so after the first call a
+     * parallelFor() does not allocate. Pass a lambda with many captures as std::ref(lambda),
+     * which std::function stores without copying it to the heap.
+     *
+     * @param count Number of iterations.
+     * @param body  Callable invoked with the iteration index and the worker index.
+     */
+    void parallelFor(int count, const std::function<void(int, unsigned)>& body);
+
+private:
+    void workerLoop(unsigned worker);
+
+    std::vector<std::thread> workers_;
+    std::vector<std::function<void(unsigned)>> tasks_;  ///< Queued tasks from taskHead_ on; keeps its capacity.
+    std::size_t taskHead_ = 0;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cmath>
+#include <cstdint>
 #include <vector>
 
 /**
@@ -81,3 +82,11 @@ double euclidean(const Point& a, const Point& b);
  *         A vector of unique points in ascending order (as defined by Point::operator<).
  */
 std::vector<Point> generateUniquePoints(int n, double minX = 0.0, double minY = 0.0, double maxX = 40.0, double maxY = 40.0);
+
+/**
+ * @brief Same as above, with the samples drawn from a CounterRng keyed by @p seed.
+ *
+ * Sample k takes its coordinates from index k of the stream, so the result depends only on
+ * the arguments and is identical on every platform and standard library.
+ */
+std::vector<Point> generateUniquePoints(int n, double minX, double minY, double maxX, double maxY, std::uint64_t seed);
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "common/types.h"
+
+/**
+ * @brief Delaunay triangulation that inserts and removes points in place.
+ *
+ * The triangles are kept with their neighbour links inside a large super-triangle (like CDT
+ * before eraseSuperTriangle()), so every real point is an interior vertex and both updates are
+ * local. Insertion (Bowyer-Watson) locates the point with a jump-and-walk from the nearest of a
+ * few sampled vertices, removes the triangles whose circumcircle holds it and connects it to the
+ * border of that cavity. Removal retriangulates the star of the vertex by clipping Delaunay ears.
+ * Both cost O(log n) expected for the point location plus O(degree) for the update, and report
+ * exactly the edges they created and deleted, so a graph built on the triangulation can be
+ * patched instead of rebuilt.
+ *
+ * Vertex ids are stable: a point keeps its id until it is removed, removed ids are not reused
+ * and new points get the next free id. Points outside the region the super-triangle was sized
+ * for trigger a rebuild of the whole triangulation (reported by Delta::rebuilt).
+ *
+ * As with CDT's super-triangle, a few sliver triangles on the convex hull may be missing.
+ */
+class DynamicTriangulation
+{
+public:
+    /// Edges created and deleted by one update, as (u, v) vertex ids with u < v.
+    struct Delta
+    {
+        std::vector<std::pair<int, int>> added;
+        std::vector<std::pair<int, int>> removed;
+        bool rebuilt = false;  ///< The update rebuilt the whole triangulation.
+
+        void clear()
+        {
+            added.clear();
+            removed.clear();
+            rebuilt = false;
+        }
+    };
+
+    /**
+     * @brief Creates an empty triangulation sized for points in [0, 1] x [0, 1].
+     */
+    DynamicTriangulation();
+
+    /**
+     * @brief Triangulates a point set; point i gets id i.
+     *
+     * Points are inserted along a Hilbert curve, so each walk starts next to its target.
+     *
+     * @throws std::invalid_argument If two points coincide.
+     */
+    explicit DynamicTriangulation(const std::vector<Point>& points);
+
+    /**
+     * @brief Inserts a point.
+     *
+     * @param p     The new point.
+     * @param delta Receives the edge changes (cleared first).
+     * @return The id of the new vertex.
+     *
+     * @throws std::invalid_argument If @p p coincides with a vertex.
+     */
+    int insert(const Point& p, Delta& delta);
+
+    /**
+     * @brief Removes a vertex.
+     *
+     * @param id    Id of a live vertex.
+     * @param delta Receives the edge changes (cleared first).
+     *
+     * @throws std::invalid_argument If @p id is not a live vertex.
+     */
+    void remove(int id, Delta& delta);
+
+    /// @return Number of ids issued so far (live and removed).
+    int idCount() const { return (int)points_.size() - superCount; }
+
+    /// @return Number of live vertices.
+    int size() const { return alive_; }
+
+    /// @return true if @p id is a live vertex.
+    bool contains(int id) const
+    {
+        return id >= 0 && id < idCount() && vertexTri_[id + superCount] >= 0;
+    }
+
+    /// @return Coordinates of vertex @p id (also valid for removed ids).
+    const Point& point(int id) const { return points_[id + superCount]; }
+
+    /// @return Every edge between live vertices once, as (u, v) with u < v, sorted.
+    std::vector<std::pair<int, int>> edges() const;
+
+    /// @return Triangles whose three vertices are live points, counter-clockwise.
+    std::vector<std::array<int, 3>> triangles() const;
+
+    /**
+     * @brief Checks the empty-circumcircle property of every pair of adjacent triangles.
+     *
+     * Intended for tests; costs O(n).
+     */
+    bool isDelaunay() const;
+
+private:
+    static constexpr int superCount = 3;  ///< Internal indices 0..2 are the super-triangle corners.
+
+    /// Triangle with counter-clockwise vertices; n[i] is the neighbour across the side opposite v[i].
+    struct Triangle
+    {
+        std::array<int, 3> v;
+        std::array<int, 3> n;
+    };
+
+    /// Side of the cavity or hole being retriangulated, with the triangle outside it.
+    struct Side
+    {
+        int a;
+        int b;
+        int outer;
+    };
+
+    void reset(double minX, double minY, double maxX, double maxY);
+    void rebuild(Delta& delta);
+    void insertOrdered(const std::vector<int>& vertices);
+    void insertVertex(int vertex, int first, Delta* delta);
+    int locate(const Point& p, int hint) const;
+    int startVertex(const Point& p);
+    bool inside(const Point& p) const;
+
+    int newTriangle(int a, int b, int c);
+    void freeTriangle(int t);
+    int side(int t, int a, int b) const;
+    void link(int t, int a, int b, int other);
+    void record(std::vector<std::pair<int, int>>& out, int a, int b) const;
+
+    std::vector<Point> points_;      ///< Super-triangle corners, then the points by id.
+    std::vector<int> vertexTri_;     ///< A triangle incident to each vertex, -1 once removed.
+    std::vector<Triangle> tris_;     ///< Triangle slots; v[0] == -1 marks a free slot.
+    std::vector<int> freeTris_;      ///< Free triangle slots.
+    int alive_ = 0;
+
+    double centreX_ = 0.5;           ///< Centre of the region the super-triangle covers.
+    double centreY_ = 0.5;
+    double reach_ = 1.0;             ///< Points within this distance of the centre (per axis) fit.
+
+    std::uint64_t draws_ = 0;        ///< Index of the next sample of the jump-and-walk.
+    int lastVertex_ = -1;            ///< Most recently inserted vertex, a cheap walk start.
+
+    std::uint32_t stamp_ = 0;
+    std::vector<std::uint32_t> mark_;       ///< Equals stamp_ for triangles in the current cavity.
+    std::vector<int> cavity_;
+    std::vector<Side> sides_;
+    std::vector<std::pair<int, int>> fan_;  ///< (first side vertex, new triangle) of an insertion.
+};
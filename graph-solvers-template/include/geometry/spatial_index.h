@@ -0,0 +1,107 @@
+#pragma once
+
+#include <vector>
+
+#include "common/types.h"
+#include "common/graph.h"
+
+class ThreadPool;
+
+/**
+ * @brief Uniform grid over a point set answering nearest-neighbour and radius queries.
+ *
+ * The bounding box of the points is split into square cells sized so that each cell holds
+ * about @p pointsPerCell points. Cell contents are stored contiguously (CSR layout, points of
+ * a cell copied next to each other), so a query touches a few short, cache-friendly runs.
+ * k-nearest queries expand rings of cells around the query until no unvisited cell can hold
+ * a closer point, which costs O(k) expected time on roughly uniform inputs.
+ *
+ * The index keeps a copy of the coordinates and is immutable after construction; concurrent
+ * queries are safe.
+ */
+class SpatialGrid
+{
+public:
+    /**
+     * @brief Builds the grid.
+     *
+     * @param points        Points to index; query results refer to their positions in this vector.
+     * @param pointsPerCell Target average occupancy of a cell.
+     */
+    explicit SpatialGrid(const std::vector<Point>& points, double pointsPerCell = 2.0);
+
+    /// @return Number of indexed points.
+    int size() const { return (int)ids_.size(); }
+
+    /**
+     * @brief Finds the k points closest to @p query, nearest first.
+     *
+     * @param query   Query location.
+     * @param k       Number of neighbours requested.
+     * @param out     Receives up to @p k point indices (cleared first).
+     * @param exclude Index to skip, typically the query point itself (-1 for none).
+     */
+    void kNearest(const Point& query, int k, std::vector<int>& out, int exclude = -1) const;
+
+    /**
+     * @brief Finds every point within distance @p radius of @p query, in no particular order.
+     *
+     * @param query  Query location.
+     * @param radius Search radius (inclusive).
+     * @param out    Receives the point indices (cleared first).
+     */
+    void withinRadius(const Point& query, double radius, std::vector<int>& out) const;
+
+    /**
+     * @brief Finds the point closest to @p query.
+     *
+     * @return The point index, or -1 if the grid is empty.
+     */
+    int nearest(const Point& query) const;
+
+private:
+    int cellX(double x) const;
+    int cellY(double y) const;
+
+    double minX_ = 0.0;
+    double minY_ = 0.0;
+    double cellSize_ = 1.0;
+    int cols_ = 1;
+    int rows_ = 1;
+    std::vector<int> cellStart_;   ///< cellStart_[c]..cellStart_[c + 1] delimit the points of cell c.
+    std::vector<int> ids_;         ///< Original point index per slot.
+    std::vector<double> xs_;       ///< X coordinate per slot.
+    std::vector<double> ys_;       ///< Y coordinate per slot.
+};
+
+/**
+ * @brief Builds a granular candidate edge list linking every point to its k nearest neighbours.
+ *
+ * The result is suitable as input to Graph (which merges the two directions of mutual
+ * neighbours), giving a sparse candidate graph with O(n·k) edges that can replace the
+ * Delaunay triangulation for savings generation on very large inputs.
+ *
+ * @param points Point coordinates.
+ * @param grid   Spatial index built over @p points.
+ * @param k      Neighbours per point.
+ * @param pool   Optional pool used to run the queries in parallel.
+ * @return std::vector<Edge> Directed candidate edges (i, neighbour) with Euclidean costs.
+ */
+std::vector<Edge> nearestNeighbourEdges(const std::vector<Point>& points, const SpatialGrid& grid, int k,
+    ThreadPool* pool = nullptr);
+
+/**
+ * @brief Adds the k-nearest-neighbour edges of every point to a candidate graph.
+ *
+ * Delaunay graphs miss savings between close points that are not triangle neighbours, e.g.
+ * across a dense cluster; the added edges give every point at least @p k candidate savings
+ * partners while the graph stays O(n·(deg + k)). Existing edges keep their costs; added
+ * edges are weighted by Euclidean length. Edge ids are renumbered, so rebuild anything
+ * indexed by them (such as a SavingsList) from the returned graph.
+ *
+ * @param graph  Candidate graph over @p points, typically DelaunayGraph::graph.
+ * @param points Point coordinates.
+ * @param k      Neighbours per point; 0 returns a copy of @p graph.
+ * @param pool   Optional pool for the neighbour queries.
+ */
+Graph withNearestNeighbours(const Graph& graph, const std::vector<Point>& points, int k, ThreadPool* pool = nullptr);
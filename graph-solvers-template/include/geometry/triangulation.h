@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <utility>
+#include <vector>
+
+#include "common/types.h"
+#include "common/graph.h"
+
+class ThreadPool;
+
+/**
+ * @brief Parallelism settings of buildDelaunayGraph().
+ */
+struct TriangulationOptions
+{
+    int tiles = 0;               ///< Vertical strips triangulated independently; 0 picks from the pool and point count.
+    int minTilePoints = 50000;   ///< Fewest points per strip when @ref tiles is chosen automatically.
+    ThreadPool* pool = nullptr;  ///< Pool running the strips; they run serially when null.
+};
+
+/**
+ * @brief Delaunay triangles of a point set and the CSR graph of their sides.
+ */
+struct DelaunayGraph
+{
+    std::vector<std::array<int, 3>> triangles;  ///< Vertex index triples.
+    Graph graph;                                ///< One edge per triangle side, weighted by Euclidean length.
+};
+
+/**
+ * @brief Builds the Delaunay candidate graph of a point set, optionally in parallel strips.
+ *
+ * Points are split at x-quantiles into vertical strips. Each strip is triangulated (via CDT)
+ * together with a halo of points on either side and owns the triangles whose leftmost vertex
+ * lies in its own x-range. An owned triangle is kept when it is certainly Delaunay in the
+ * whole point set: the strip holds every point, or no point outside the strip and its halo
+ * can lie in its circumcircle. Owned triangles that fail this test (long triangles along the
+ * hull, artefacts of the strip's own hull) are dropped, and fillGaps() recreates the missing
+ * triangles between the stitched strips. The stitched result must then be a triangulated
+ * convex polygon (Euler's formula plus a convex boundary). If a seam side is claimed by more
+ * than two triangles or that check fails (e.g. cocircular points resolved differently by two
+ * strips), every halo is doubled and all strips are triangulated again. The loop ends at the
+ * latest once every strip holds all points, when each strip's triangulation is exact.
+ *
+ * Shared sides are detected from the triangle neighbour links, so inside a strip every edge is
+ * emitted once without sorting; only the sides on strip seams and the hull are deduplicated by
+ * a sort. Costs are computed in one pass over the final edges.
+ *
+ * @param vertices The points to triangulate; they must be pairwise distinct.
+ * @param options  Strip count and pool.
+ * @return DelaunayGraph The triangles and the graph. The result does not depend on the pool size.
+ */
+DelaunayGraph buildDelaunayGraph(const std::vector<Point>& vertices, const TriangulationOptions& options = {});
+
+/**
+ * @brief Computes the Delaunay triangulation of a point set (via CDT library) and its unique edges.
+ *
+ * Every triangle side becomes one undirected edge (u < v) weighted by the Euclidean distance
+ * between its endpoints; sides shared by two triangles are reported once. Serial form of
+ * buildDelaunayGraph() that returns a plain edge list.
+ *
+ * @param vertices The points to triangulate.
+ * @return std::pair<std::vector<std::array<int, 3>>, std::vector<Edge>>
+ *         The triangles as vertex index triples and the edges sorted by (u, v).
+ */
+std::pair<std::vector<std::array<int, 3>>, std::vector<Edge>>
+computeTriangulationAndEdges(const std::vector<Point>& vertices);
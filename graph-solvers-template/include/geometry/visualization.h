@@ -1,10 +1,121 @@
 #pragma once
 
-#include <vector>
+#include <array>
+#include <cstddef>
+#include <iosfwd>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "common/graph.h"
 #include "common/types.h"
 
+class ThreadPool;
+
+/// Routes as lists of consecutive edges, as returned by solveMultipleRoutes().
+using RouteEdges = std::vector<std::vector<std::pair<int, int>>>;
+
+/**
+ * @brief Drawing and level-of-detail settings of SvgRenderer.
+ */
+struct RenderOptions
+{
+    double scale = 25.0;                 ///< Pixels per coordinate unit of a full image.
+    double margin = 50.0;                ///< Blank border around the points, in pixels.
+    int maxLabeledNodes = 500;           ///< Up to this many nodes are drawn as numbered circles, above as dots.
+    std::size_t maxDetailEdges = 100000; ///< Background edges drawn at full detail; above this the LOD grid kicks in.
+    double lodCellPixels = 0.0;          ///< LOD grid cell in pixels; 0 derives it from @ref maxDetailEdges.
+    ThreadPool* pool = nullptr;          ///< Pool for renderFiles() and renderTiles(); serial when null.
+};
+
+/**
+ * @brief Tile pyramid settings of SvgRenderer::renderTiles().
+ */
+struct TileOptions
+{
+    int levels = 4;        ///< Zoom levels 0 … levels-1; level z has 2^z × 2^z tiles.
+    int tileSize = 256;    ///< Tile edge in pixels.
+};
+
+/**
+ * @brief Streaming SVG renderer of a graph, its nodes and solver routes.
+ *
+ * Everything that does not depend on the routes (node positions, the candidate graph in grey,
+ * node markers) is prepared once in the constructor, so rendering many files for the same
+ * graph only formats the routes again. Output is assembled in memory with std::to_chars and
+ * written in one block per file.
+ *
+ * - Every graph edge is emitted once, and the whole background is a single `<path>`.
+ * - Level of detail: when the graph has more than RenderOptions::maxDetailEdges edges, edge
+ *   endpoints and nodes are snapped to a grid of RenderOptions::lodCellPixels; edges inside
+ *   one cell are dropped and edges joining the same pair of cells are drawn once. Output
+ *   size is then bounded by the image area instead of the node count. Routes are never
+ *   decimated.
+ * - Routes sharing an edge are offset side by side; shared edges are found with a hash map.
+ * - Each route is its own `<g id='route-i'>` layer; clicking its legend entry hides or shows it.
+ *
+ * The renderer is immutable after construction and may be used from several threads.
+ */
+class SvgRenderer
+{
+public:
+    /**
+     * @param points  Node positions; must outlive the renderer.
+     * @param graph   Background graph (e.g. the Delaunay candidate graph) over @p points; must outlive the renderer.
+     * @param options Scale and level-of-detail settings.
+     */
+    SvgRenderer(const std::vector<Point>& points, const Graph& graph, const RenderOptions& options = {});
+
+    /**
+     * @brief Writes one SVG with the background and a toggleable layer per route.
+     */
+    void render(std::ostream& out, const RouteEdges& routes) const;
+
+    /**
+     * @brief Writes render() output to @p filename.
+     *
+     * @throws std::runtime_error If the file cannot be written.
+     */
+    void renderFile(const std::string& filename, const RouteEdges& routes) const;
+
+    /**
+     * @brief Writes one file per entry of @p filenames, with the matching entry of @p routeSets.
+     *
+     * Files are rendered in parallel on RenderOptions::pool.
+     *
+     * @throws std::invalid_argument If the two lists differ in length.
+     * @throws std::runtime_error If a file cannot be written.
+     */
+    void renderFiles(const std::vector<std::string>& filenames, const std::vector<RouteEdges>& routeSets) const;
+
+    /**
+     * @brief Writes a pyramid of SVG tiles to `directory/z/x/y.svg`.
+     *
+     * Level 0 is one tile showing the bounding square of the points; every further level
+     * halves the tile extent. Each tile holds only the edges, nodes and route segments that
+     * touch it, decimated for its own zoom, so a viewer can load the parts it displays.
+     * Empty tiles are not written. Tiles are rendered in parallel on RenderOptions::pool.
+     *
+     * @return int Number of tiles written.
+     *
+     * @throws std::runtime_error If a tile cannot be written.
+     */
+    int renderTiles(const std::string& directory, const RouteEdges& routes, const TileOptions& tiles = {}) const;
+
+    /// @return Number of background edges kept after level-of-detail decimation.
+    std::size_t backgroundEdges() const { return backgroundEdges_; }
+
+private:
+    const std::vector<Point>& points_;
+    const Graph& graph_;
+    RenderOptions options_;
+    double minX_ = 0.0, minY_ = 0.0, maxX_ = 0.0, maxY_ = 0.0;
+    double width_ = 0.0, height_ = 0.0;
+    std::string edgeLayer_;    ///< Pre-rendered grey edges of a full image.
+    std::string nodeLayer_;    ///< Pre-rendered nodes and their labels of a full image.
+    std::size_t backgroundEdges_ = 0;
+};
+
 /**
  * @brief Generates an SVG file that visualizes the input point set, the Delaunay triangulation
  *        (via CDT library), and the resulting output edges.
@@ -16,7 +127,8 @@
  *
  * Coordinates are scaled and flipped vertically to display properly in SVG coordinate space.
  * This function provides a geometric interpretation of the solver solution in the context of
- * the point layout and Delaunay structure.
+ * the point layout and Delaunay structure. It builds an SvgRenderer for a single file; use
+ * the renderer directly to draw several files of the same graph.
  *
  * @param points     A vector of Point structs representing node positions in 2D space.
  * @param output_edges  A vector of edges (pairs of vertex indices) selected by the solver.
@@ -27,4 +139,3 @@ void drawSVG(const std::vector<Point>& points,
     const std::vector<std::vector<std::pair<int, int>>>& all_routes_edges,
     const std::vector<std::array<int, 3>>& triangles,
     const std::string& filename = "visualization.svg");
-
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "common/distance.h"
+#include "common/types.h"
+#include "geometry/triangulation.h"
+#include "model/solver.h"
+
+class ThreadPool;
+
+/**
+ * @brief One line of a batch manifest.
+ *
+ * A job line is a whitespace-separated list of key=value tokens:
+ * `id=a instance=path/to/file.vrp routes=20 seed=7 batch=8 capacity=100 max_length=500 local_search=1`.
+ * Instead of `instance=` a job may give `random=N` (and optionally `points_seed=S`) to solve
+ * N uniform points in [0, 40]². Empty lines and lines starting with '#' are ignored.
+ */
+struct BatchJob
+{
+    std::string id;                 ///< Echoed in the result; defaults to the line number.
+    std::string instance;           ///< Instance file; empty for a random instance.
+    int randomPoints = 0;           ///< Node count of a random instance.
+    std::uint64_t pointsSeed = 0;   ///< Seed of the random instance.
+    int routes = 20;                ///< Number of routes to generate.
+    std::uint64_t seed = 0;         ///< Seed of the solver.
+    int batchSize = 8;              ///< Attempts per batch (see MultiRouteOptions::batchSize).
+    double capacity = std::numeric_limits<double>::infinity();   ///< Overrides the instance capacity when finite.
+    double maxLength = std::numeric_limits<double>::infinity();  ///< Maximum route length.
+    bool localSearch = false;       ///< Run the local-search post-optimizer on every attempt.
+
+    /// @return Key of the instance in the InstanceCache.
+    std::string instanceKey() const;
+};
+
+/**
+ * @brief Parses one manifest line.
+ *
+ * @param line       The line without its terminator.
+ * @param lineNumber 1-based line number, used as the default id and in error messages.
+ * @param job        Receives the job.
+ * @return bool False if the line is empty or a comment.
+ *
+ * @throws std::invalid_argument On unknown keys, malformed values or a job without an instance.
+ */
+bool parseBatchJob(std::string_view line, int lineNumber, BatchJob& job);
+
+/**
+ * @brief Everything the solver needs about an instance that does not depend on the job parameters.
+ */
+struct PreparedInstance
+{
+    std::vector<Point> points;
+    DelaunayGraph delaunay;                       ///< Candidate graph with costs from @ref distances.
+    std::unique_ptr<DistanceProvider> distances;
+    std::vector<double> demands;                  ///< Demand per node; empty if the instance has none.
+    std::vector<double> readyTimes;               ///< Earliest start of service per node; empty without time windows.
+    std::vector<double> dueTimes;                 ///< Latest start of service per node; empty without time windows.
+    std::vector<double> serviceTimes;             ///< Service duration per node; empty if the instance has none.
+    std::vector<int> depots;                      ///< Depot nodes from the instance file; empty for random instances.
+    double capacity = std::numeric_limits<double>::infinity();
+
+    /// @return Approximate heap bytes held by the instance.
+    std::size_t memoryBytes() const;
+};
+
+/**
+ * @brief Loads (or generates) an instance, triangulates it and sets up its distance provider.
+ *
+ * @param job  Job naming the instance.
+ * @param pool Pool for the triangulation; null runs it on the calling thread.
+ *
+ * @throws std::runtime_error If the instance cannot be loaded or has fewer than three nodes.
+ */
+std::shared_ptr<const PreparedInstance> prepareInstance(const BatchJob& job, ThreadPool* pool = nullptr);
+
+/**
+ * @brief Thread-safe least-recently-used cache of prepared instances.
+ *
+ * Jobs on the same instance (e.g. a parameter sweep) load and triangulate it once. Concurrent
+ * requests for an instance that is still being prepared wait for the first one instead of
+ * preparing it again. An instance whose preparation failed is not cached.
+ *
+ * The cache is bounded both by the number of instances and by their total memoryBytes(), so
+ * a few large instances cannot pin gigabytes between jobs. An instance larger than the whole
+ * budget is returned to its jobs but not kept.
+ */
+class InstanceCache
+{
+public:
+    /**
+     * @param capacity     Number of instances kept; 0 disables caching.
+     * @param memoryBudget Total bytes the kept instances may hold.
+     */
+    explicit InstanceCache(std::size_t capacity = 16, std::size_t memoryBudget = std::size_t(256) << 20);
+
+    /**
+     * @brief Returns the prepared instance of @p job, preparing it on a miss.
+     *
+     * @throws The exception of prepareInstance() if preparation fails.
+     */
+    std::shared_ptr<const PreparedInstance> get(const BatchJob& job);
+
+    /// @return Number of requests served from the cache.
+    std::uint64_t hits() const;
+
+    /// @return Number of instances prepared.
+    std::uint64_t misses() const;
+
+    /// @return Bytes held by the cached instances that finished preparing.
+    std::size_t cachedBytes() const;
+
+private:
+    struct Entry;
+
+    /// Drops the least recently used entries until both limits hold. Must be called with mutex_ held.
+    void evict();
+
+    std::size_t capacity_;
+    std::size_t memoryBudget_;
+    std::size_t cachedBytes_ = 0;
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::shared_ptr<Entry>> entries_;
+    std::list<std::string> lru_;  ///< Instance keys, most recently used first.
+    std::uint64_t hits_ = 0;
+    std::uint64_t misses_ = 0;
+};
+
+/**
+ * @brief Settings of BatchRunner.
+ */
+struct BatchOptions
+{
+    ThreadPool* pool = nullptr;   ///< Pool running the jobs; one is created when null.
+    unsigned threads = 0;         ///< Worker threads when no pool is given (0 = hardware concurrency).
+    std::size_t cacheSize = 16;   ///< Prepared instances kept between jobs.
+    std::size_t cacheBytes = std::size_t(256) << 20;  ///< Memory budget of the kept instances.
+};
+
+/**
+ * @brief Counts of a BatchRunner::run() call.
+ */
+struct BatchSummary
+{
+    int jobs = 0;     ///< Jobs read.
+    int failed = 0;   ///< Jobs that reported an error.
+};
+
+/**
+ * @brief Solves many instances in one process.
+ *
+ * Jobs are read from a stream (a manifest file, stdin or a named pipe) by a dedicated reader
+ * thread and pushed to a single FIFO queue shared by all pool workers, so a worker that
+ * finishes a small job picks up the next one immediately and results stream out while input
+ * is still arriving. Jobs are coarse compared to one queue operation, so the shared queue
+ * balances load as well as per-worker work-stealing deques would, without their complexity,
+ * and keeps jobs starting in manifest order. Every job
+ * is solved single-threaded on its worker with that worker's MultiRouteScratch; instances,
+ * their triangulations and distance providers come from an InstanceCache. All of these live
+ * as long as the runner, so repeated run() calls reuse them.
+ *
+ * Each finished job writes one JSON line and flushes the stream:
+ * `{"id":"a","instance":"x.vrp","status":"ok","nodes":50,"routes":[[0,4,...,49],...],"lengths":[...],"ms":1.2}`
+ * or `{"id":"a","status":"error","message":"..."}`. Lines appear in completion order; results
+ * for a fixed job do not depend on the pool size.
+ */
+class BatchRunner
+{
+public:
+    explicit BatchRunner(const BatchOptions& options = {});
+    ~BatchRunner();
+
+    BatchRunner(const BatchRunner&) = delete;
+    BatchRunner& operator=(const BatchRunner&) = delete;
+
+    /**
+     * @brief Runs every job of @p jobs and writes the results to @p results.
+     *
+     * Malformed lines are reported as errors and do not stop the run.
+     */
+    BatchSummary run(std::istream& jobs, std::ostream& results);
+
+    /// @return The instance cache shared by all runs.
+    InstanceCache& cache() { return cache_; }
+
+private:
+    std::unique_ptr<ThreadPool> ownPool_;
+    ThreadPool* pool_;
+    InstanceCache cache_;
+    std::vector<MultiRouteScratch> scratch_;  ///< One per pool worker.
+};
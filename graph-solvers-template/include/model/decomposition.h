@@ -0,0 +1,110 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "common/types.h"
+#include "common/graph.h"
+#include "common/distance.h"
+#include "model/route_store.h"
+
+class ThreadPool;
+
+/**
+ * @brief How solveDecomposed() splits the interior nodes.
+ */
+enum class PartitionKind
+{
+    Sweep,   ///< Angular sectors around the start terminal (the classic sweep).
+    Cluster  ///< Runs of the Hilbert curve over the bounding box: compact spatial clusters.
+};
+
+/**
+ * @brief Parameters of solveDecomposed().
+ */
+struct DecompositionOptions
+{
+    PartitionKind partition = PartitionKind::Sweep;
+    int partitions = 0;            ///< Number of partitions; 0 picks one per @ref partitionSize nodes.
+    int partitionSize = 20000;     ///< Interior nodes per partition when @ref partitions is chosen automatically.
+    bool boundaryMerge = true;     ///< Merge routes across partition borders after the partitions are solved.
+    ThreadPool* pool = nullptr;    ///< Pool running the partitions and the sort; they run serially when null.
+    RouteConstraints constraints;  ///< Capacity, length, orientation and time-window rules, as in mergeRoutes().
+    Terminals terminals;           ///< Start and end node of every route; the first and last vertex by default.
+    const DistanceProvider* distances = nullptr;  ///< Depot distances for the savings; Euclidean when null.
+};
+
+/**
+ * @brief Clarke-Wright on very large instances by decomposition.
+ *
+ * The interior nodes (all but the terminals) are ordered by a sort key (the
+ * angle around the start, or the Hilbert index) with a parallel radix sort and cut into
+ * partitions of equal size. Every partition is solved independently, in parallel, by the
+ * merge loop of solveProblem() (mergeRoutes()) on its induced subgraph, with the savings
+ * queue and route store local to the partition.
+ *
+ * The boundary merge then revisits the borders in two rounds of windows over neighbouring
+ * partitions, {2i, 2i + 1} and then {2i + 1, 2i + 2} (sweep sectors wrap around). Each window
+ * runs the same merge loop on a contracted instance: routes become single links carrying
+ * their load and internal cost, while routes using less than 3/4 of every finite limit are
+ * dissolved into their nodes and merged afresh, and the candidate savings are the graph
+ * edges between piece endpoints. The windows of a round are disjoint and run in parallel;
+ * only the bookkeeping between the rounds is serial. With time windows a contracted route keeps
+ * the time summaries of its whole piece, so border merges are checked exactly as in the
+ * partitions, and every route is finally driven in a direction that keeps the windows.
+ *
+ * Sweep sectors follow the radial shape of Clarke-Wright routes and lose less at the
+ * borders; clusters suit instances whose start lies outside the customers. Larger
+ * partitions cost less quality and expose less parallelism.
+ *
+ * Partitions depend only on the instance and the options, never on the thread count, so the
+ * routes are identical for any pool. With a single partition the call reduces to plain
+ * Clarke-Wright (mergeRoutes()) on the whole graph.
+ *
+ * @param vertices The list of points (nodes) in the graph.
+ * @param graph    CSR graph over @p vertices; its costs are the route link costs.
+ * @param options  Partitioning, constraints and threading.
+ * @return Node sequences start, ..., end that together visit every interior node once.
+ */
+std::vector<std::vector<int>> solveDecomposed(const std::vector<Point>& vertices, const Graph& graph,
+    const DecompositionOptions& options = {});
+
+/**
+ * @brief Parameters of solveMultiDepot().
+ */
+struct MultiDepotOptions
+{
+    ThreadPool* pool = nullptr;    ///< Pool running the depot subproblems; they run serially when null.
+    RouteConstraints constraints;  ///< Capacity, length, orientation and time-window rules, as in mergeRoutes().
+    const DistanceProvider* distances = nullptr;  ///< Terminal distances; Euclidean when null.
+};
+
+/**
+ * @brief Routes of a multi-depot instance, grouped by depot.
+ */
+struct MultiDepotSolution
+{
+    std::vector<int> depotOf;  ///< Depot serving each node; -1 for the terminals.
+    std::vector<std::vector<std::vector<int>>> routes;  ///< Per depot, node sequences start, ..., end.
+};
+
+/**
+ * @brief Clarke-Wright for a fleet running out of several depots, on one shared graph.
+ *
+ * Every node that is not a terminal is served by its nearest depot: the one minimizing
+ * the round trip start -> node -> end. The savings of each depot are computed from its own
+ * terminal distances over the subgraph induced by its customers, and the depots are then
+ * solved independently, in parallel, by the merge loop of solveProblem() (mergeRoutes()).
+ * The triangulation and the graph are shared, so adding a depot costs one distance row and
+ * column plus its own subproblem. The result does not depend on the number of threads.
+ *
+ * @param vertices The list of points (nodes) in the graph.
+ * @param graph    CSR graph over @p vertices; its costs are the route link costs.
+ * @param depots   Start and end node of each depot (equal for round trips).
+ * @param options  Constraints, distances and threading.
+ * @return Depot of every node and the routes of every depot, in the order of @p depots.
+ *
+ * @throws std::invalid_argument If @p depots is empty or names a node outside @p vertices.
+ */
+MultiDepotSolution solveMultiDepot(const std::vector<Point>& vertices, const Graph& graph,
+    std::span<const Terminals> depots, const MultiDepotOptions& options = {});
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/types.h"
+#include "common/graph.h"
+#include "common/dynamic_graph.h"
+#include "geometry/dynamic_triangulation.h"
+#include "model/route_store.h"
+#include "model/shortest_path.h"
+#include "model/solver.h"
+
+/**
+ * @brief Settings of a DynamicInstance.
+ */
+struct DynamicOptions
+{
+    RouteConstraints constraints;  ///< Capacity, length and time windows kept by repairs; demands and windows are indexed by vertex id.
+    int maxSearchNodes = 4096;     ///< Nodes one detour search may settle before it gives up.
+};
+
+/**
+ * @brief What one DynamicInstance update changed.
+ */
+struct UpdateStats
+{
+    int edgesAdded = 0;      ///< Graph edges created.
+    int edgesRemoved = 0;    ///< Graph edges deleted.
+    int routesRepaired = 0;  ///< Routes whose node sequence changed.
+    int routesDropped = 0;   ///< Routes removed because no repair kept them feasible.
+    int settledNodes = 0;    ///< Nodes settled by detour searches (the work beyond the triangulation).
+    bool covered = false;    ///< insertPoint(): the new stop was placed on a route.
+    bool rebuilt = false;    ///< The point lay outside the triangulated region, which was rebuilt.
+};
+
+/**
+ * @brief Instance and route set kept up to date under small changes, without re-solving.
+ *
+ * Holds the points, their Delaunay triangulation, the candidate graph over it and a set of
+ * start-to-end routes (as found by solve() or given with setRoutes()). Each update changes the
+ * triangulation locally (see DynamicTriangulation), applies the reported edge changes to the
+ * graph in place and then repairs only the routes that used a changed edge:
+ *
+ * - insertPoint(): a route link deleted by the retriangulation is rerouted through the new
+ *   point when both new links exist, otherwise around it; a new point no link was rerouted
+ *   through is inserted where it lengthens a route the least (cheapest insertion over the
+ *   links between its graph neighbours). When the point takes one of two consecutive deleted
+ *   links and no detour replaces the other, the node between them is cut out and inserted
+ *   again the same way.
+ * - removePoint(): the point is cut out of every route visiting it, and the two nodes around it
+ *   are joined directly or by a detour.
+ * - setEdgeCost(): routes using the edge change length; when the cost grows they take a
+ *   cheaper detour if one exists (an infinite cost blocks the edge).
+ *
+ * Detours are bounded A* searches over the graph that avoid the route's other nodes and the
+ * terminals. Routes that cannot be repaired within the capacity, maximum length and time
+ * windows are dropped; each route keeps the TimeSegment summaries of its prefixes and
+ * suffixes, so a splice is checked against the windows in the length of the new part only. Apart from the point location, an update therefore costs O(degree) for the
+ * triangulation and graph plus the length of the affected routes, independent of the size of
+ * the instance. Savings are not stored between updates: repairs splice routes directly, and
+ * solve() computes them afresh.
+ *
+ * Vertex ids are stable (see DynamicTriangulation); the start and end terminals are the first
+ * and last input points and cannot be removed. Edge costs are Euclidean unless overridden with
+ * setEdgeCost(); an override stays attached to the vertex pair if a later update deletes and
+ * recreates the edge.
+ */
+class DynamicInstance
+{
+public:
+    /// Compact copy of the instance in the layout solveMultipleRoutes() expects.
+    struct Snapshot
+    {
+        std::vector<Point> points;  ///< Live points; the start first and the end last.
+        Graph graph;                ///< Candidate graph over @ref points.
+        std::vector<int> ids;       ///< Vertex id of every snapshot index.
+    };
+
+    /**
+     * @brief Triangulates @p points; the first and last are the start and end terminals.
+     *
+     * @throws std::invalid_argument If there are fewer than two points, two coincide or the
+     *         time windows do not cover every point.
+     */
+    explicit DynamicInstance(const std::vector<Point>& points, const DynamicOptions& options = {});
+
+    /**
+     * @brief Adds a stop.
+     *
+     * With time windows the stop is open at any time and needs no service time.
+     *
+     * @param p      Location of the stop.
+     * @param demand Demand counted against the route capacity.
+     * @return The vertex id of the stop.
+     *
+     * @throws std::invalid_argument If @p p coincides with a live point.
+     */
+    int insertPoint(const Point& p, double demand = 0.0);
+
+    /**
+     * @brief Cancels a stop.
+     *
+     * @throws std::invalid_argument If @p id is not a live interior vertex.
+     */
+    void removePoint(int id);
+
+    /**
+     * @brief Changes the cost of the edge {u, v}, e.g. to a large value or infinity for a blocked road.
+     *
+     * @throws std::invalid_argument If u and v are not adjacent or @p cost is negative or NaN.
+     */
+    void setEdgeCost(int u, int v, double cost);
+
+    /// @return What the last update changed.
+    const UpdateStats& lastUpdate() const { return stats_; }
+
+    /**
+     * @brief Replaces the routes.
+     *
+     * @param routes Node sequences from the start to the end terminal over graph edges.
+     *
+     * @throws std::invalid_argument If a route is not such a sequence.
+     */
+    void setRoutes(std::vector<std::vector<int>> routes);
+
+    /**
+     * @brief Solves the current instance from scratch with solveMultipleRoutes() and keeps the routes.
+     *
+     * Runs on a snapshot(), so it costs as much as a full solve. The constraints of the
+     * instance, demands and windows moved to the snapshot indices, replace those in @p options,
+     * and nothing is printed.
+     *
+     * @param n_of_roads Number of routes to generate.
+     * @param options    Seed, batch size and threading.
+     */
+    void solve(int n_of_roads, MultiRouteOptions options = {});
+
+    /// @return The routes as node sequences of vertex ids.
+    const std::vector<std::vector<int>>& routes() const { return routes_; }
+
+    /// @return The routes as lists of edges, the format of solveMultipleRoutes().
+    std::vector<std::vector<std::pair<int, int>>> routeEdges() const;
+
+    /// @return Length of route @p r under the current edge costs.
+    double routeLength(int r) const { return lengths_[r]; }
+
+    /// @return Copy of the instance for solvers and renderers; costs O(n).
+    Snapshot snapshot() const;
+
+    /// @return Start terminal.
+    int start() const { return start_; }
+
+    /// @return End terminal.
+    int end() const { return end_; }
+
+    /// @return true if @p id is a live vertex.
+    bool contains(int id) const { return triangulation_.contains(id); }
+
+    /// @return Coordinates of vertex @p id.
+    const Point& point(int id) const { return triangulation_.point(id); }
+
+    /// @return The candidate graph, indexed by vertex id.
+    const DynamicGraph& graph() const { return graph_; }
+
+    /// @return The triangulation behind the graph.
+    const DynamicTriangulation& triangulation() const { return triangulation_; }
+
+private:
+    bool isTerminal(int v) const { return v == start_ || v == end_; }
+    double demand(int v) const;
+    double linkCost(int u, int v) const { return graph_.cost(graph_.edgeId(u, v)); }
+    double edgeCostFor(int u, int v) const;
+    std::uint64_t pairKey(int u, int v) const;
+
+    void applyDelta();
+    void beginUpdate();
+    void finishUpdate();
+
+    int position(int r, int node) const;
+    int findLink(int r, int a, int b) const;
+    void routesAt(int node, std::vector<int>& out) const;
+    double linkTime(int u, int v) const;
+    bool fits(int r, int i, int j, std::span<const int> via, double length) const;
+    void updateTimes(int r);
+    void replaceSegment(int r, int i, int j, std::span<const int> via, double length);
+    void drop(int r);
+
+    void repairLink(int a, int b, double oldCost, int via);
+    bool insertCheapest(int node);
+    bool findDetour(int r, int a, int b, std::vector<int>& path, double& cost);
+
+    int start_ = 0;
+    int end_ = 0;
+    DynamicTriangulation triangulation_;
+    DynamicGraph graph_;
+    RouteConstraints constraints_;
+    int maxSearchNodes_ = 4096;
+    std::unordered_map<std::uint64_t, double> overrides_;  ///< Costs set by setEdgeCost(), by vertex pair.
+    double heuristicScale_ = 1.0;    ///< Lower bound of cost / Euclidean length over all edges.
+
+    std::vector<std::vector<int>> routes_;
+    std::vector<double> lengths_;
+    std::vector<double> loads_;
+    std::vector<std::vector<int>> routesAt_;  ///< Routes visiting each interior vertex.
+    std::vector<std::vector<TimeSegment>> forwardTimes_;   ///< Per route, the time summary of each prefix; empty without windows.
+    std::vector<std::vector<TimeSegment>> backwardTimes_;  ///< Per route, the time summary of each suffix.
+
+    UpdateStats stats_;
+    DynamicTriangulation::Delta delta_;
+    std::vector<double> removedCosts_;  ///< Costs of delta_.removed before the edges were deleted.
+    std::vector<char> touched_;         ///< Route changed in the current update.
+    std::vector<char> dropped_;         ///< Route dropped in the current update.
+    std::vector<int> candidates_;
+    std::vector<int> skipped_;          ///< Nodes cut out of a route while repairing an insertion.
+
+    // Detour search workspace
+    std::uint32_t generation_ = 0;
+    std::vector<std::uint32_t> blocked_;
+    std::vector<std::uint32_t> seen_;
+    std::vector<std::uint32_t> closed_;
+    std::vector<double> dist_;
+    std::vector<int> parent_;
+    BinaryHeap heap_;
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "common/types.h"
+#include "common/graph.h"
+#include "common/distance.h"
+#include "model/mip.h"
+#include "model/route_store.h"
+
+/**
+ * @brief Parameters of solveRoutesExact().
+ */
+struct ExactOptions
+{
+    int maxRoutes = 0;             ///< Maximum number of routes (0 = unlimited).
+    RouteConstraints constraints;  ///< Demands, capacity and maximum length; orientations are always free, time windows unsupported.
+    Terminals terminals;           ///< Start and end node of every route; the first and last vertex by default.
+    const DistanceProvider* distances = nullptr;  ///< Terminal leg costs; Euclidean when null.
+    bool terminalEdgesOnly = false;  ///< Legs start-first and last-end must be graph edges, as in solveProblem().
+    std::string backend;           ///< makeMipBackend() name; empty for the best available.
+    double timeLimit = 60.0;       ///< Wall-clock seconds of the MIP solve.
+    double relativeGap = 1e-6;     ///< Stop once the certified gap drops below this.
+    long long nodeLimit = -1;      ///< Branch-and-bound nodes (-1 = unlimited).
+    unsigned threads = 1;          ///< Worker threads, for backends that use them.
+    bool warmStart = true;         ///< Start from the Clarke-Wright partition (mergeRoutes()) after LocalSearch.
+    bool verbose = false;          ///< Print the backend's progress log.
+};
+
+/**
+ * @brief Routes found by solveRoutesExact() and the bound that certifies them.
+ */
+struct ExactResult
+{
+    std::vector<std::vector<int>> routes;  ///< Node sequences start, ..., end covering every interior node.
+    double cost = 0.0;                     ///< Total length of @ref routes, legs included.
+    double bound = 0.0;                    ///< Proven lower bound on the optimal total length.
+    MipStatus status = MipStatus::NoSolution;
+    long long nodes = 0;                   ///< Branch-and-bound nodes.
+    int cuts = 0;                          ///< Lazy constraints and cuts added.
+    double seconds = 0.0;                  ///< Wall-clock time of the MIP solve.
+    std::string backend;                   ///< Backend that solved the model.
+
+    /// @return (cost - bound) / cost; infinity without routes.
+    double gap() const;
+};
+
+/**
+ * @brief Covers all interior nodes with minimum-length start-to-end routes, with a certified bound.
+ *
+ * Solves the problem the Clarke-Wright heuristic approximates: every node other than the
+ * @ref ExactOptions::terminals (by default the first and last vertex; a single depot serves
+ * as both for round trips) lies on exactly one route, consecutive interior nodes are
+ * joined by graph edges (at their current costs), and the terminal legs cost the start and
+ * end distances of the SavingsList. Capacity, maximum length and @ref ExactOptions::maxRoutes
+ * are respected.
+ *
+ * The model is a two-index MIP with one column per interior graph edge and per terminal leg
+ * and only the degree rows stated up front. Subtours, wrongly oriented paths, capacity and
+ * length violations are cut off lazily on integral points by tracing the connected
+ * components of the solution, and fractional points are tightened with connectivity and
+ * rounded capacity cuts found through components and max-flow min-cuts, so no family of
+ * subsets is ever enumerated. The Clarke-Wright partition, improved by LocalSearch, serves as
+ * the starting incumbent, and the same heuristic re-run with savings biased toward the LP
+ * solution supplies better ones during the search.
+ *
+ * @param vertices The list of points (nodes) in the graph.
+ * @param graph    CSR graph over @p vertices.
+ * @param options  Constraints, backend and limits.
+ * @return Best routes found with their lower bound; check @ref ExactResult::status.
+ * @throws std::invalid_argument For an unknown backend, or constraints with time windows.
+ */
+ExactResult solveRoutesExact(const std::vector<Point>& vertices, const Graph& graph, const ExactOptions& options = {});
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <chrono>
+#include <span>
+#include <vector>
+
+#include "common/graph.h"
+#include "model/route_store.h"
+
+class ThreadPool;
+
+/**
+ * @brief Settings of the post-optimization stage run on Clarke-Wright routes.
+ */
+struct LocalSearchOptions
+{
+    bool enabled = false;         ///< Run the stage at all (solveProblem() skips it by default).
+    bool twoOpt = true;           ///< Intra-route 2-opt (segment reversal).
+    bool orOpt = true;            ///< Intra-route Or-opt (move a segment of up to @ref maxSegment nodes).
+    bool relocate = true;         ///< Inter-route relocation of a single node.
+    bool swap = true;             ///< Inter-route exchange of two nodes.
+    int maxSegment = 3;           ///< Longest segment moved by Or-opt.
+    double timeLimitMs = 5.0;     ///< Wall-clock budget of one run; 0 or less means unlimited.
+    ThreadPool* pool = nullptr;   ///< Optional pool for the intra-route phase (one task per route).
+};
+
+/**
+ * @brief Counts of the moves applied by one LocalSearch::run() call.
+ */
+struct LocalSearchStats
+{
+    int twoOptMoves = 0;
+    int orOptMoves = 0;
+    int relocateMoves = 0;
+    int swapMoves = 0;
+    double gain = 0.0;      ///< Total decrease of the summed route lengths.
+    bool timedOut = false;  ///< The time limit stopped the search before a local optimum.
+};
+
+/**
+ * @brief First-improvement local search over start-to-end routes on a sparse graph.
+ *
+ * Routes are node sequences start, v1, ..., vk, end whose consecutive nodes are joined by
+ * graph edges, and every move keeps them that way: candidate moves are generated from the
+ * graph neighbours of a node (the Delaunay or k-nearest candidate edges), and each new link
+ * is checked with Graph::hasEdge(). The change in length of a move only involves the edges it
+ * removes and adds, so it is evaluated in O(1) from node positions before the route is
+ * touched; only improving moves pay the O(route length) update.
+ *
+ * Don't-look bits skip nodes whose neighbourhood produced no improvement until one of their
+ * route neighbours changes. The intra-route phase (2-opt, Or-opt) treats routes
+ * independently and can run them in parallel; the inter-route phase (relocate, swap) is
+ * sequential and respects the capacity and maximum length of @ref RouteConstraints. With time
+ * windows, an improving move is first replayed on a copy of the routes it changes and applied
+ * only if their schedules still keep every window. Both phases alternate until no move
+ * improves or the time limit expires.
+ *
+ * The object only holds scratch buffers, which are reused between runs; use one per thread.
+ */
+class LocalSearch
+{
+public:
+    /**
+     * @brief Improves @p routes in place.
+     *
+     * Inter-route moves never empty a route, so the number of routes is preserved.
+     *
+     * @param graph       Graph whose edges the routes follow; its costs are the route lengths.
+     * @param routes      Routes as node sequences sharing the same start and end terminals.
+     * @param constraints Demands, capacity and maximum length checked by inter-route moves;
+     *                    time windows checked by every move.
+     * @param options     Enabled moves, time limit and parallelism.
+     * @return LocalSearchStats The applied moves.
+     */
+    LocalSearchStats run(const Graph& graph, std::span<std::vector<int>> routes,
+        const RouteConstraints& constraints, const LocalSearchOptions& options);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    bool improveRoute(int r, LocalSearchStats& stats);
+    bool improveBetweenRoutes(LocalSearchStats& stats);
+
+    bool tryTwoOpt(int r, int i, LocalSearchStats& stats);
+    bool tryOrOpt(int r, int i, LocalSearchStats& stats);
+    bool tryRelocate(int node, LocalSearchStats& stats);
+    bool trySwap(int node, LocalSearchStats& stats);
+
+    double cost(int u, int v) const;
+    bool expired() const;
+    void reindex(int r, int from, int to);
+    void wake(int node);
+    double routeLength(int r) const;
+    bool keepsWindows(std::span<const int> route) const;
+
+    const Graph* graph_ = nullptr;
+    std::span<std::vector<int>> routes_;
+    const RouteConstraints* constraints_ = nullptr;
+    const LocalSearchOptions* options_ = nullptr;
+    Clock::time_point deadline_;
+    bool limited_ = false;
+
+    std::vector<int> routeOf_;     ///< Route index of every interior node, -1 for others.
+    std::vector<int> position_;    ///< Index of every interior node in its route.
+    std::vector<char> dontLook_;   ///< Don't-look bit per node.
+    std::vector<double> load_;     ///< Summed demand per route.
+    std::vector<double> length_;   ///< Length per route.
+    std::vector<LocalSearchStats> routeStats_;  ///< Per-route counts of the parallel phase.
+};
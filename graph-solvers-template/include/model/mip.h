@@ -0,0 +1,194 @@
+#pragma once
+
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Sparse linear row lower <= Σ value[k] · x[index[k]] <= upper.
+ *
+ * Used both for the rows of a MipModel and for the cuts a MipSeparator returns. Use
+ * ±infinity for a missing side and lower == upper for an equation.
+ */
+struct MipRow
+{
+    std::vector<int> index;     ///< Column indices.
+    std::vector<double> value;  ///< Coefficients aligned with @ref index.
+    double lower;               ///< Left-hand side (-infinity if none).
+    double upper;               ///< Right-hand side (+infinity if none).
+
+    /// @return Σ value[k] · x[index[k]].
+    double activity(std::span<const double> x) const;
+
+    /// @return How far @p x lies outside [lower, upper]; 0 if inside.
+    double violation(std::span<const double> x) const;
+};
+
+/**
+ * @brief Minimization problem min cᵀx subject to rows and column bounds.
+ *
+ * The model holds only the rows known up front; constraints with too many members to
+ * state explicitly (subtour elimination, capacity) are generated on demand by a MipSeparator.
+ * Every column must have finite bounds.
+ */
+struct MipModel
+{
+    std::vector<double> cost;   ///< Objective coefficient of every column.
+    std::vector<double> lower;  ///< Lower bound of every column.
+    std::vector<double> upper;  ///< Upper bound of every column.
+    std::vector<char> integer;  ///< Whether the column must take an integral value.
+    std::vector<MipRow> rows;   ///< Explicit constraints.
+
+    /// @return Number of columns.
+    int columnCount() const { return (int)cost.size(); }
+
+    /**
+     * @brief Appends a column.
+     *
+     * @return Its index.
+     */
+    int addColumn(double cost, double lower, double upper, bool integer);
+
+    /**
+     * @brief Appends an explicit row.
+     *
+     * @throws std::invalid_argument If an index is out of range or the sizes differ.
+     */
+    void addRow(MipRow row);
+};
+
+/**
+ * @brief Problem-specific callbacks consulted by a MipBackend while it solves: constraint
+ *        generation and an optional primal heuristic.
+ *
+ * Backends call the separator from one thread at a time.
+ */
+class MipSeparator
+{
+public:
+    virtual ~MipSeparator() = default;
+
+    /**
+     * @brief Lazy constraints: checks an integral point that satisfies every row known so far.
+     *
+     * Must append at least one row violated by @p x if @p x is infeasible for the full
+     * problem, and nothing otherwise. Appended rows become part of the model.
+     */
+    virtual void separateIntegral(std::span<const double> x, std::vector<MipRow>& cuts) = 0;
+
+    /**
+     * @brief User cuts: rows violated by a fractional LP point, to tighten the bound.
+     *
+     * Optional; appended rows must be valid for every feasible integral point.
+     */
+    virtual void separateFractional(std::span<const double> x, std::vector<MipRow>& cuts)
+    {
+        (void)x;
+        (void)cuts;
+    }
+
+    /**
+     * @brief Primal heuristic: may build a solution guided by a fractional LP point.
+     *
+     * Optional. The backend checks a suggested solution like a warm start (bounds,
+     * integrality, rows and separateIntegral()) before accepting it.
+     *
+     * @return true if @p solution was filled.
+     */
+    virtual bool suggestSolution(std::span<const double> x, std::vector<double>& solution)
+    {
+        (void)x;
+        (void)solution;
+        return false;
+    }
+};
+
+/**
+ * @brief Outcome of a MipBackend::solve() call.
+ */
+enum class MipStatus
+{
+    Optimal,     ///< Proven optimal within the requested relative gap.
+    Feasible,    ///< A limit was hit; @ref MipResult::x holds the best solution found.
+    Infeasible,  ///< The problem has no solution.
+    NoSolution   ///< A limit was hit before any solution was found.
+};
+
+/**
+ * @brief Limits and warm start of a MIP solve.
+ */
+struct MipOptions
+{
+    double timeLimit = 60.0;     ///< Wall-clock seconds.
+    double relativeGap = 1e-6;   ///< Stop once (objective - bound) / |objective| drops below this.
+    long long nodeLimit = -1;    ///< Branch-and-bound nodes (-1 = unlimited).
+    unsigned threads = 1;        ///< Worker threads, for backends that use them.
+    std::vector<double> start;   ///< Feasible solution to start from (empty = none).
+    bool verbose = false;        ///< Print the backend's progress log.
+};
+
+/**
+ * @brief Result of a MIP solve: best solution and a certified lower bound.
+ */
+struct MipResult
+{
+    MipStatus status = MipStatus::NoSolution;
+    double objective = 0.0;  ///< Cost of @ref x (upper bound); +infinity without a solution.
+    double bound = 0.0;      ///< Proven lower bound on the optimum.
+    std::vector<double> x;   ///< Best solution found; empty without one.
+    long long nodes = 0;     ///< Branch-and-bound nodes processed.
+    int cuts = 0;            ///< Rows added by the separator.
+    double seconds = 0.0;    ///< Wall-clock time of the solve.
+
+    /// @return (objective - bound) / max(|objective|, 1e-10); infinity without a solution.
+    double gap() const;
+};
+
+/**
+ * @brief Exchangeable MIP solver.
+ *
+ * Implementations solve a MipModel to optimality or until a limit, separating the
+ * constraints the model leaves out through the given MipSeparator. Create one with
+ * makeMipBackend().
+ */
+class MipBackend
+{
+public:
+    virtual ~MipBackend() = default;
+
+    /// @return Name under which makeMipBackend() creates this backend.
+    virtual const char* name() const = 0;
+
+    /**
+     * @brief Solves @p model.
+     *
+     * @param separator Source of lazy constraints and cuts.
+     * @param options   Limits and optional warm start; an infeasible start is ignored.
+     */
+    virtual MipResult solve(const MipModel& model, MipSeparator& separator, const MipOptions& options) = 0;
+};
+
+/**
+ * @brief Creates a backend by name.
+ *
+ * - "bundled": built-in branch-and-cut on a bounded dual simplex; always available, suited
+ *   to models with up to a few thousand columns.
+ * - "cplex": IBM CPLEX through its generic callbacks; only in builds with CW_HAVE_CPLEX.
+ * - "": the best available (CPLEX if built, otherwise the bundled backend).
+ *
+ * @throws std::invalid_argument For an unknown or unavailable backend.
+ */
+std::unique_ptr<MipBackend> makeMipBackend(std::string_view name = {});
+
+/// @return Names accepted by makeMipBackend() in this build.
+std::vector<std::string> availableMipBackends();
+
+/// @brief Creates the built-in branch-and-cut backend ("bundled").
+std::unique_ptr<MipBackend> makeBranchAndCutBackend();
+
+#ifdef CW_HAVE_CPLEX
+/// @brief Creates the CPLEX backend ("cplex").
+std::unique_ptr<MipBackend> makeCplexBackend();
+#endif
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/arena.h"
+#include "common/graph.h"
+
+/**
+ * @brief Compact edge-set signature of a route used for similarity tests.
+ *
+ * A route is reduced to the set of graph edge ids it uses, stored as a dense bitset over the
+ * CSR edge indexing. Only the window of words between the smallest and largest used id is
+ * kept, so the exact Jaccard similarity of two routes is a popcount over the AND of their
+ * overlapping words, counted by an AVX2 kernel when simdLevel() allows it. Edge orientation
+ * is ignored and node pairs that are not graph edges are skipped.
+ *
+ * Each fingerprint also carries a MinHash signature, which estimates the Jaccard similarity
+ * in O(1) and feeds the locality-sensitive index of DiversityFilter.
+ */
+class RouteFingerprint
+{
+public:
+    /// Number of MinHash values per signature.
+    static constexpr int signatureSize = 32;
+
+    /**
+     * @brief Creates the fingerprint of an empty route.
+     */
+    RouteFingerprint() = default;
+
+    /**
+     * @brief Builds the fingerprint of a route given as a list of edges.
+     *
+     * @param graph    Graph providing the edge ids.
+     * @param route    Consecutive node pairs of the route.
+     * @param resource Memory resource for the bitset (e.g. a per-attempt Arena). Copies of the
+     *                 fingerprint use the default resource unless one is passed to the copy.
+     */
+    RouteFingerprint(const Graph& graph, std::span<const std::pair<int, int>> route,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    /**
+     * @brief Copies @p other into memory from @p resource.
+     */
+    RouteFingerprint(const RouteFingerprint& other, std::pmr::memory_resource* resource);
+
+    RouteFingerprint(const RouteFingerprint&) = default;
+    RouteFingerprint(RouteFingerprint&&) noexcept = default;
+    RouteFingerprint& operator=(const RouteFingerprint&) = default;
+    RouteFingerprint& operator=(RouteFingerprint&&) noexcept = default;
+
+    /// @return Number of distinct edges in the route.
+    int edgeCount() const { return count_; }
+
+    /// @return Index of the first stored bitset word.
+    int firstWord() const { return firstWord_; }
+
+    /// @return Stored bitset words, starting at firstWord().
+    std::span<const std::uint64_t> words() const { return words_; }
+
+    /// @return MinHash signature (all ones for an empty route).
+    const std::array<std::uint32_t, signatureSize>& signature() const { return signature_; }
+
+private:
+    int count_ = 0;
+    int firstWord_ = 0;
+    std::pmr::vector<std::uint64_t> words_;
+    std::array<std::uint32_t, signatureSize> signature_{};
+};
+
+/**
+ * @brief Exact Jaccard similarity |A ∩ B| / |A ∪ B| of two route edge sets.
+ *
+ * @return Similarity in [0, 1]; 0 when both routes are empty.
+ */
+double jaccard(const RouteFingerprint& a, const RouteFingerprint& b);
+
+/**
+ * @brief MinHash estimate of the Jaccard similarity of two route edge sets.
+ */
+double estimateJaccard(const RouteFingerprint& a, const RouteFingerprint& b);
+
+/**
+ * @brief Accepted-route set that answers "is this candidate different enough?" queries.
+ *
+ * Candidates are compared against accepted routes by exact Jaccard similarity. Pairs whose
+ * edge counts alone bound the similarity below the limit are skipped without touching the
+ * bitsets. Once the filter holds at least @p lshThreshold routes, a MinHash banding index
+ * narrows the exact comparisons to routes that share at least one band with the candidate.
+ * With 16 bands of 2 rows, a pair at similarity 0.6 is still examined with probability above
+ * 99.9%, but the filter is no longer exact in that regime: a candidate whose only too-similar
+ * accepted route shares no band with it is accepted although its similarity exceeds the limit.
+ * The index never rejects a candidate that the exact comparison would accept.
+ *
+ * Accepted fingerprints and the index live in an Arena that clear() rewinds, so a filter
+ * reused across solves stops allocating once it has held its largest route set. Queries share
+ * an internal buffer: a filter must not be queried from several threads at once.
+ */
+class DiversityFilter
+{
+public:
+    /**
+     * @param lshThreshold Number of accepted routes from which the banding index is used.
+     */
+    explicit DiversityFilter(int lshThreshold = 64) : lshThreshold_(lshThreshold) {}
+
+    /// @return Number of accepted routes.
+    int size() const { return (int)routes_.size(); }
+
+    /**
+     * @brief Checks a candidate against every accepted route.
+     *
+     * @param candidate              Fingerprint of the candidate route.
+     * @param minDifferenceThreshold Required dissimilarity; the candidate is rejected if its
+     *                               similarity to any accepted route exceeds 1 - threshold.
+     * @return true if the candidate is sufficiently different from all accepted routes.
+     */
+    bool isDifferent(const RouteFingerprint& candidate, double minDifferenceThreshold) const;
+
+    /**
+     * @brief Accepts a route.
+     *
+     * The filter stores its own copy, so @p fingerprint may live in scratch memory.
+     */
+    void add(const RouteFingerprint& fingerprint);
+
+    /**
+     * @brief Forgets all accepted routes, keeping the memory for the next use.
+     */
+    void clear();
+
+private:
+    static constexpr int bandRows = 2;
+    static constexpr int bandCount = RouteFingerprint::signatureSize / bandRows;
+
+    static std::uint64_t bandKey(const RouteFingerprint& fingerprint, int band);
+    bool exceeds(const RouteFingerprint& candidate, const RouteFingerprint& accepted, double limit) const;
+
+    int lshThreshold_;
+    Arena arena_;  ///< Backs the accepted fingerprints and the index; declared before them.
+    std::pmr::vector<RouteFingerprint> routes_{ &arena_ };
+    std::pmr::unordered_map<std::uint64_t, std::pmr::vector<int>> buckets_{ &arena_ };
+    mutable std::vector<int> nearby_;  ///< Routes sharing a band with the candidate, reused between queries.
+};
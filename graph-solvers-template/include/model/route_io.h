@@ -0,0 +1,138 @@
+#pragma once
+
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/graph.h"
+#include "common/types.h"
+
+/**
+ * @brief Output formats of RouteWriter.
+ */
+enum class RouteFormat
+{
+    Text,     ///< Human-readable listing ("Trasa i: a -> b -> ... | Dlugosc: x"), as printed by the solver.
+    Binary,   ///< Compact varint-delta node sequences (see RouteWriter).
+    Json,     ///< {"routes":[{"route":0,"length":...,"nodes":[...]},...]}
+    Csv,      ///< One route per line: route,length,nodes (nodes separated by spaces).
+    GeoJson   ///< FeatureCollection with one LineString per route; needs the node coordinates.
+};
+
+/**
+ * @brief Picks the format from a file extension: .cwr, .json, .csv, .geojson; Text otherwise.
+ */
+RouteFormat routeFormatFromPath(const std::string& path);
+
+/**
+ * @brief Converts a route given as consecutive edges into its node sequence.
+ */
+std::vector<int> routeNodes(const std::vector<std::pair<int, int>>& route);
+
+/**
+ * @brief Sums the costs of the route edges; edges missing from @p graph count as zero.
+ *
+ * Every edge is looked up by Graph::edgeId(), so the cost is O(L · log deg) instead of a scan
+ * of the edge list per route edge.
+ */
+double routeLength(const Graph& graph, const std::vector<std::pair<int, int>>& route);
+
+/**
+ * @brief Streaming, buffered writer of solver routes.
+ *
+ * Routes are appended one at a time with write() and serialized into an internal buffer that
+ * is handed to the stream in large blocks, so exporting many long routes costs a few write
+ * calls instead of one formatted insertion per node. Numbers are formatted with
+ * std::to_chars. finish() writes the closing part of the format (JSON brackets, the text
+ * footer) and flushes; the destructor calls it if it has not been called.
+ *
+ * The binary format starts with the magic "CWR1" followed by one record per route:
+ * varint node count, the route length as a little-endian double and the nodes as zigzag
+ * varint deltas from the previous node (the first from 0). Node indices along a route are
+ * usually close, so most deltas take one or two bytes. The record count is not stored, so the
+ * format can be streamed; readBinaryRoutes() reads until the end of the stream.
+ */
+class RouteWriter
+{
+public:
+    /**
+     * @param out    Destination stream; must outlive the writer.
+     * @param format Output format.
+     * @param graph  Graph the route costs are read from.
+     * @param points Node coordinates; required for RouteFormat::GeoJson only.
+     *
+     * @throws std::invalid_argument If the format needs coordinates and @p points is null.
+     */
+    RouteWriter(std::ostream& out, RouteFormat format, const Graph& graph, const std::vector<Point>* points = nullptr);
+    ~RouteWriter();
+
+    RouteWriter(const RouteWriter&) = delete;
+    RouteWriter& operator=(const RouteWriter&) = delete;
+
+    /**
+     * @brief Appends one route given as consecutive edges.
+     *
+     * @throws std::out_of_range If a node has no coordinates in GeoJSON output.
+     */
+    void write(const std::vector<std::pair<int, int>>& route);
+
+    /**
+     * @brief Completes the output and flushes the stream. Later calls do nothing.
+     *
+     * @throws std::runtime_error If the stream reports an error.
+     */
+    void finish();
+
+    /// @return Number of routes written so far.
+    int routesWritten() const { return count_; }
+
+private:
+    void begin();
+    void flush();
+    void appendInt(long long value);
+    void appendDouble(double value);
+    void appendFixed(double value, int precision);
+    void appendVarint(unsigned long long value);
+
+    std::ostream& out_;
+    RouteFormat format_;
+    const Graph& graph_;
+    const std::vector<Point>* points_;
+    std::string buffer_;
+    int count_ = 0;
+    bool finished_ = false;
+};
+
+/**
+ * @brief Writes all @p routes to @p path in one call.
+ *
+ * @param format Output format; by default chosen with routeFormatFromPath().
+ *
+ * @throws std::runtime_error If the file cannot be written.
+ */
+void writeRoutes(const std::string& path,
+    const std::vector<std::vector<std::pair<int, int>>>& routes,
+    const Graph& graph,
+    const std::vector<Point>& points);
+void writeRoutes(const std::string& path,
+    const std::vector<std::vector<std::pair<int, int>>>& routes,
+    const Graph& graph,
+    const std::vector<Point>& points,
+    RouteFormat format);
+
+/**
+ * @brief Route read back from the binary format.
+ */
+struct StoredRoute
+{
+    std::vector<int> nodes;
+    double length = 0.0;
+};
+
+/**
+ * @brief Reads every route of a binary route stream.
+ *
+ * @throws std::runtime_error On a wrong magic or a truncated record.
+ */
+std::vector<StoredRoute> readBinaryRoutes(std::istream& in);
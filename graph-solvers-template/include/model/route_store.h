@@ -0,0 +1,218 @@
+#pragma once
+
+#include <array>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include "model/time_windows.h"
+
+/**
+ * @brief Feasibility limits applied while merging Clarke-Wright routes.
+ *
+ * With the defaults every merge is allowed, which reproduces the unconstrained heuristic.
+ * Time windows apply to the start of service at every node, terminals included; travel
+ * times equal the link costs, and a vehicle arriving early waits.
+ */
+struct RouteConstraints
+{
+    std::vector<double> demands;                                  ///< Demand per node; empty means zero demand.
+    double capacity = std::numeric_limits<double>::infinity();    ///< Maximum summed demand of a route.
+    double maxLength = std::numeric_limits<double>::infinity();   ///< Maximum route length, terminal legs included.
+    bool allOrientations = true;                                  ///< Join any pair of endpoints, not only tail-to-head.
+    std::vector<double> readyTimes;                               ///< Earliest start of service per node; empty means no time windows.
+    std::vector<double> dueTimes;                                 ///< Latest start of service per node, aligned with @ref readyTimes.
+    std::vector<double> serviceTimes;                             ///< Service duration per node; empty means zero.
+
+    /// @return true if routes must keep the time windows.
+    bool hasTimeWindows() const { return !readyTimes.empty(); }
+
+    /// @return Window and service time of @p node as a one-node segment (unconstrained without windows).
+    TimeSegment segment(int node) const
+    {
+        if (!hasTimeWindows()) return {};
+        return TimeSegment::node(readyTimes[node], dueTimes[node], serviceTimes.empty() ? 0.0 : serviceTimes[node]);
+    }
+
+    /**
+     * @brief Whether @p chain keeps every window when driven between two terminals.
+     *
+     * @param start Start terminal, left at the earliest after its ready time.
+     * @param lead  Travel time from @p start to the first node of @p chain.
+     * @param chain Summary of the interior nodes in driving order.
+     * @param trail Travel time from the last node of @p chain to @p end.
+     * @param end   End terminal, reached at the latest at its due time.
+     */
+    bool fitsWindows(int start, double lead, const TimeSegment& chain, double trail, int end) const
+    {
+        return concatenate(concatenate(segment(start), lead, chain), trail, segment(end)).feasible;
+    }
+};
+
+/**
+ * @brief Start and end node shared by the routes of one depot.
+ *
+ * The defaults give the classic layout, with the start first and the end last among the
+ * vertices. Start and end may be the same node, for routes that return to their depot.
+ */
+struct Terminals
+{
+    int start = 0;  ///< Node every route leaves from.
+    int end = -1;   ///< Node every route arrives at; negative means the last vertex.
+
+    /// @return These terminals with a negative end replaced by the last of @p n vertices.
+    Terminals resolved(int n) const { return { start, end < 0 ? n - 1 : end }; }
+};
+
+/**
+ * @brief Clarke-Wright route container with constant-time merges.
+ *
+ * Every route runs from a fixed start terminal through a chain of interior nodes to a fixed
+ * end terminal. Only the interior chain is stored: two undirected link slots per node, the
+ * head and tail of each route, its running load and internal cost, and a disjoint-set forest
+ * that maps a node to its route. Links carry no direction, so reversing a route only swaps
+ * its head and tail; joining two routes in any orientation relinks a single pair of nodes and
+ * unites two sets. Each merge and each endpoint or membership query is O(1) amortized.
+ *
+ * With time windows (see the RouteConstraints overload of reset()) every route also keeps
+ * the TimeSegment summaries of its two directions. A merge combines them in O(1), so a
+ * candidate merge is checked against every window without walking either route.
+ *
+ * Routes are identified by the representative node of their set; ids change after a merge,
+ * so they should be re-queried with routeOf() rather than cached.
+ */
+class RouteStore
+{
+public:
+    /// Link value marking the absence of a neighbouring interior node.
+    static constexpr int none = -1;
+
+    /**
+     * @brief Starts a fresh solution in which every interior node has its own route.
+     *
+     * Buffers are reused when the store is reset repeatedly for the same vertex count.
+     *
+     * @param vertexCount Number of vertices.
+     * @param start       Start terminal (not part of any chain).
+     * @param end         End terminal (not part of any chain).
+     * @param demands     Optional demand per node, used as the initial route loads.
+     */
+    void reset(int vertexCount, int start, int end, std::span<const double> demands = {});
+
+    /**
+     * @brief Same as above, with the demands and the time windows of @p constraints.
+     *
+     * @throws std::invalid_argument If the time-window arrays do not cover every vertex.
+     */
+    void reset(int vertexCount, int start, int end, const RouteConstraints& constraints);
+
+    /// @return Number of routes that are still separate.
+    int routeCount() const { return routeCount_; }
+
+    /// @return true if @p node belongs to some route (i.e. it is not a terminal).
+    bool contains(int node) const { return parent_[node] != none; }
+
+    /**
+     * @brief Returns the id of the route containing @p node.
+     *
+     * @param node An interior node.
+     * @return The representative of the node's set.
+     */
+    int routeOf(int node);
+
+    /// @return true if @p node is the head or the tail of its route.
+    bool isEndpoint(int node) const { return links_[node][0] == none || links_[node][1] == none; }
+
+    /// @return true if @p node is the first interior node of its route.
+    bool isFirst(int node) { return head_[routeOf(node)] == node; }
+
+    /// @return true if @p node is the last interior node of its route.
+    bool isLast(int node) { return tail_[routeOf(node)] == node; }
+
+    /// @return First interior node of @p route.
+    int head(int route) const { return head_[route]; }
+
+    /// @return Last interior node of @p route.
+    int tail(int route) const { return tail_[route]; }
+
+    /// @return Number of interior nodes of @p route.
+    int size(int route) const { return size_[route]; }
+
+    /// @return Summed demand of @p route.
+    double load(int route) const { return load_[route]; }
+
+    /// @return Summed cost of the links between interior nodes of @p route.
+    double cost(int route) const { return cost_[route]; }
+
+    /// @return true if the store tracks time windows (see reset()).
+    bool timed() const { return timed_; }
+
+    /// @return Time-window summary of @p route from head to tail; valid when timed().
+    const TimeSegment& forward(int route) const { return forward_[route]; }
+
+    /// @return Time-window summary of @p route from tail to head; valid when timed().
+    const TimeSegment& backward(int route) const { return backward_[route]; }
+
+    /**
+     * @brief Overrides the time-window summaries of @p route.
+     *
+     * For routes that stand for longer ones, such as contracted pieces whose interior nodes
+     * are not in the store.
+     */
+    void setTimes(int route, const TimeSegment& forward, const TimeSegment& backward);
+
+    /**
+     * @brief Reverses the direction of a route in O(1).
+     *
+     * @param route Route id.
+     */
+    void reverse(int route);
+
+    /**
+     * @brief Joins the routes of endpoints @p a and @p b with the link a-b.
+     *
+     * The routes are reoriented as needed so that the result runs from the far end of
+     * @p a's route, through a and b, to the far end of @p b's route. The caller is responsible
+     * for checking that both nodes are endpoints of different routes and that the join is
+     * feasible.
+     *
+     * @param a        Endpoint of the route that ends up in front.
+     * @param b        Endpoint of the route that is appended.
+     * @param linkCost Cost of the new link, added to the route's internal cost; also its
+     *                 travel time when time windows are tracked.
+     * @return The id of the merged route.
+     */
+    int merge(int a, int b, double linkCost = 0.0);
+
+    /**
+     * @brief Ids of all current routes, ordered by their smallest endpoint.
+     *
+     * @param out Receives the route ids (cleared first).
+     */
+    void routes(std::vector<int>& out);
+
+    /**
+     * @brief Writes the full node sequence start, head..tail, end of a route.
+     *
+     * @param route Route id.
+     * @param out   Receives the sequence (cleared first).
+     */
+    void materialize(int route, std::vector<int>& out) const;
+
+private:
+    void link(int a, int b) { links_[a][links_[a][0] == none ? 0 : 1] = b; }
+
+    int start_ = 0;
+    int end_ = 0;
+    int routeCount_ = 0;
+    bool timed_ = false;
+    std::vector<std::array<int, 2>> links_;  ///< Neighbouring interior nodes, or none.
+    std::vector<int> parent_;                ///< Disjoint-set parent, or none for terminals.
+    std::vector<int> head_;                  ///< First node of the route, valid for representatives.
+    std::vector<int> tail_;                  ///< Last node of the route, valid for representatives.
+    std::vector<int> size_;                  ///< Interior node count, valid for representatives.
+    std::vector<double> load_;               ///< Summed demand, valid for representatives.
+    std::vector<double> cost_;               ///< Internal link cost, valid for representatives.
+    std::vector<TimeSegment> forward_;       ///< Head-to-tail time summary, valid for representatives.
+    std::vector<TimeSegment> backward_;      ///< Tail-to-head time summary, valid for representatives.
+};
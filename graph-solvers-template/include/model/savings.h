@@ -0,0 +1,161 @@
+#pragma once
+
+#include <algorithm>
+#include <span>
+#include <vector>
+
+#include "common/types.h"
+#include "common/graph.h"
+#include "common/distance.h"
+
+/**
+ * @brief A single Clarke-Wright saving for joining customers i and j.
+ */
+struct Saving
+{
+    int i;         ///< First customer (lower index of the edge).
+    int j;         ///< Second customer (higher index of the edge).
+    double value;  ///< Saving c0i + c0j - cij.
+    int edge;      ///< Id of the graph edge {i, j}.
+};
+
+/**
+ * @brief Base savings of an instance, computed once and shared by every solver attempt.
+ *
+ * The distances c0i from the start terminal (and from every vertex to the end terminal) are
+ * evaluated once for all vertices, and one saving is stored for
+ * every graph edge that does not touch the start or end terminal. The list is immutable after
+ * construction and can be read concurrently; per-attempt ordering lives in SavingsQueue.
+ */
+class SavingsList
+{
+public:
+    /**
+     * @brief Creates an empty savings list.
+     */
+    SavingsList() = default;
+
+    /**
+     * @brief Computes depot distances and base savings over the edges of @p graph.
+     *
+     * @param vertices Node coordinates.
+     * @param graph    Candidate graph; its current edge costs are used as cij.
+     * @param start    Start terminal (the depot savings are measured from).
+     * @param end      End terminal; edges touching it produce no saving.
+     */
+    SavingsList(const std::vector<Point>& vertices, const Graph& graph, int start, int end);
+
+    /**
+     * @brief Same as above, with the depot distances read from @p distances.
+     *
+     * Use this when costs are not Euclidean (e.g. a road-network matrix). The distances are
+     * fetched as one batched row from @p start and one column to @p end.
+     */
+    SavingsList(const DistanceProvider& distances, const Graph& graph, int start, int end);
+
+    /**
+     * @brief Same as above, with depot distances computed elsewhere.
+     *
+     * Lets a subproblem on renumbered nodes (e.g. one partition of solveDecomposed()) reuse
+     * the distances of the full instance instead of evaluating them again.
+     *
+     * @param depotDistances c0i for every vertex of @p graph.
+     * @param endDistances   Distance to the end terminal for every vertex of @p graph.
+     */
+    SavingsList(std::vector<double> depotDistances, std::vector<double> endDistances,
+        const Graph& graph, int start, int end);
+
+    /// @return Number of base savings.
+    int size() const { return (int)base_.size(); }
+
+    /// @return The k-th base saving.
+    const Saving& operator[](int k) const { return base_[k]; }
+
+    /// @return Cost cij of the edge behind the k-th saving.
+    double edgeCost(int k) const { return costs_[k]; }
+
+    /// @return Distance from the start terminal to every vertex.
+    std::span<const double> depotDistances() const { return depotDistances_; }
+
+    /// @return Distance from every vertex to the end terminal.
+    std::span<const double> endDistances() const { return endDistances_; }
+
+    /// @return The start terminal the savings were computed for.
+    int start() const { return start_; }
+
+    /// @return The end terminal the savings were computed for.
+    int end() const { return end_; }
+
+private:
+    void computeBase(const Graph& graph, int start, int end);
+
+    int start_ = 0;                       ///< Start terminal.
+    int end_ = 0;                         ///< End terminal.
+
+    std::vector<double> depotDistances_;  ///< c0i for every vertex.
+    std::vector<double> endDistances_;    ///< Distance to the end terminal for every vertex.
+    std::vector<Saving> base_;            ///< Unperturbed savings.
+    std::vector<double> costs_;           ///< cij aligned with base_.
+};
+
+/**
+ * @brief Per-attempt ordering of savings, consumed lazily in decreasing order.
+ *
+ * The queue is a binary max-heap built in O(E) from a SavingsList; every pop() costs
+ * O(log E), so an attempt only pays for the prefix of savings the merge loop actually reads.
+ * The buffer is reused across reset() calls, so steady-state attempts do not allocate.
+ */
+class SavingsQueue
+{
+public:
+    /**
+     * @brief Loads the unperturbed savings of @p list.
+     */
+    void reset(const SavingsList& list)
+    {
+        reset(list, [](int) { return 1.0; });
+    }
+
+    /**
+     * @brief Loads the savings of @p list with edge costs scaled by a per-saving multiplier.
+     *
+     * Scaling cij by m changes the saving by cij * (1 - m), so the perturbation is applied as
+     * a delta on the precomputed base value without touching the depot distances.
+     *
+     * @param list       Base savings.
+     * @param multiplier Callable mapping a saving index to its cost multiplier.
+     */
+    template <typename Multiplier>
+    void reset(const SavingsList& list, Multiplier&& multiplier)
+    {
+        heap_.resize(list.size());
+        for (int k = 0; k < list.size(); ++k) {
+            heap_[k] = list[k];
+            heap_[k].value += list.edgeCost(k) * (1.0 - multiplier(k));
+        }
+        std::make_heap(heap_.begin(), heap_.end(), less);
+    }
+
+    /// @return true if every saving has been consumed.
+    bool empty() const { return heap_.empty(); }
+
+    /**
+     * @brief Removes the largest remaining saving.
+     *
+     * @param out Receives the saving.
+     * @return false if the queue was already empty.
+     */
+    bool pop(Saving& out)
+    {
+        if (heap_.empty()) return false;
+        std::pop_heap(heap_.begin(), heap_.end(), less);
+        out = heap_.back();
+        heap_.pop_back();
+        return true;
+    }
+
+private:
+    static bool less(const Saving& a, const Saving& b) { return a.value < b.value; }
+
+    std::vector<Saving> heap_;
+};
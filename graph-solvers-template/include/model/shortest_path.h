@@ -0,0 +1,155 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "common/types.h"
+#include "common/graph.h"
+
+/**
+ * @brief Priority queue used by ShortestPathEngine.
+ */
+enum class HeapKind
+{
+    Binary,  ///< Binary heap over (key, node) pairs.
+    Radix    ///< Monotone radix heap; pops in amortized O(log C) with no comparisons between keys.
+};
+
+/**
+ * @brief Min-heap of (key, node) pairs backed by a reusable vector.
+ */
+class BinaryHeap
+{
+public:
+    void clear() { items_.clear(); }
+    bool empty() const { return items_.empty(); }
+    void push(double key, int node);
+    double minKey() const { return items_.front().first; }
+    std::pair<double, int> pop();
+
+private:
+    std::vector<std::pair<double, int>> items_;
+};
+
+/**
+ * @brief Monotone radix heap over non-negative double keys.
+ *
+ * Keys are compared through their IEEE-754 bit patterns, which order like unsigned integers
+ * for non-negative values. Items live in 65 buckets indexed by the highest bit in which their
+ * key differs from the last popped key, so each item is moved at most 64 times over its
+ * lifetime. Pushed keys must not be smaller than the last popped key; slightly smaller keys
+ * caused by rounding are clamped to it.
+ */
+class RadixHeap
+{
+public:
+    void clear();
+    bool empty() const { return size_ == 0; }
+    void push(double key, int node);
+    double minKey();
+    std::pair<double, int> pop();
+
+private:
+    static int bucketOf(std::uint64_t key, std::uint64_t last);
+    void refill();
+
+    std::array<std::vector<std::pair<std::uint64_t, int>>, 65> buckets_;
+    std::uint64_t last_ = 0;
+    std::size_t size_ = 0;
+};
+
+/**
+ * @brief Reusable point-to-point shortest-path search over a Euclidean graph.
+ *
+ * The engine owns a workspace (distances, parents and blocked marks for both search
+ * directions) that is allocated once and invalidated between queries by bumping a
+ * generation counter, so repeated queries cost only the work of the search itself.
+ *
+ * Queries run a bidirectional A* with the balanced Euclidean potential
+ * p(v) = s * (|v t| - |s v|) / 2, where s is the largest factor for which every edge cost is at
+ * least s times its Euclidean length. The potential is consistent in both directions, so the
+ * search stops as soon as the two frontier keys sum to the best path found so far.
+ *
+ * An engine is not thread-safe; use one per thread.
+ */
+class ShortestPathEngine
+{
+public:
+    /**
+     * @brief Prepares the workspace and derives the admissible heuristic scale from the edge costs.
+     *
+     * Both references must outlive the engine (or its next rebind()).
+     *
+     * @param vertices Node coordinates.
+     * @param graph    Graph whose edge costs are searched.
+     * @param heap     Priority queue used by the search.
+     */
+    ShortestPathEngine(const std::vector<Point>& vertices, const Graph& graph, HeapKind heap = HeapKind::Binary);
+
+    /**
+     * @brief Points the engine at another instance (or at changed costs of the same one).
+     *
+     * The workspace and heaps keep their capacity, so an engine kept in a solver's scratch
+     * does not allocate during the searches of later solves.
+     */
+    void rebind(const std::vector<Point>& vertices, const Graph& graph);
+
+    /**
+     * @brief Finds a shortest path from @p source to @p target that avoids @p blocked nodes.
+     *
+     * @param source  Start node.
+     * @param target  Destination node.
+     * @param blocked Nodes that must not be visited (any range of ints; terminals are never blocked).
+     * @param path    Receives the node sequence source..target, or is cleared if no path exists.
+     * @return true if a path was found.
+     */
+    template <typename Range>
+    bool findPath(int source, int target, const Range& blocked, std::vector<int>& path)
+    {
+        beginQuery();
+        for (int node : blocked) {
+            if (node >= 0 && node < (int)blockStamp_.size())
+                blockStamp_[node] = generation_;
+        }
+        return search(source, target, path);
+    }
+
+    /**
+     * @brief Finds a shortest path from @p source to @p target over the whole graph.
+     */
+    bool findPath(int source, int target, std::vector<int>& path)
+    {
+        beginQuery();
+        return search(source, target, path);
+    }
+
+    /// @return Length of the path returned by the last successful query.
+    double lastDistance() const { return lastDistance_; }
+
+    /// @return Scale applied to Euclidean distances in the heuristic (0 disables it).
+    double heuristicScale() const { return scale_; }
+
+private:
+    void beginQuery();
+    bool search(int source, int target, std::vector<int>& path);
+    template <typename Heap>
+    bool searchWith(Heap& forward, Heap& backward, int source, int target, std::vector<int>& path);
+
+    const std::vector<Point>* vertices_;
+    const Graph* graph_;
+    HeapKind heapKind_;
+    double scale_ = 0.0;
+    double lastDistance_ = 0.0;
+
+    std::uint32_t generation_ = 0;
+    std::vector<std::uint32_t> blockStamp_;   ///< Equals generation_ when the node is blocked.
+    std::array<std::vector<std::uint32_t>, 2> seenStamp_;    ///< Equals generation_ when dist_ is valid.
+    std::array<std::vector<std::uint32_t>, 2> closedStamp_;  ///< Equals generation_ once settled.
+    std::array<std::vector<double>, 2> dist_;
+    std::array<std::vector<int>, 2> parent_;
+
+    BinaryHeap binary_[2];
+    RadixHeap radix_[2];
+};
@@ -2,8 +2,84 @@
 
 #include <vector>
 #include <utility>
+#include <set>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <span>
 
 #include "common/types.h"
+#include "common/graph.h"
+#include "model/savings.h"
+#include "model/route_store.h"
+#include "model/local_search.h"
+#include "model/shortest_path.h"
+
+class ThreadPool;
+
+/// Route as a list of edges whose storage comes from a memory resource (typically an Arena).
+using ArenaRoute = std::pmr::vector<std::pair<int, int>>;
+
+/**
+ * @brief Reusable scratch buffers of solveProblem() and findAlternativePath().
+ *
+ * The buffers keep their capacity between calls, so once a workspace has served an attempt
+ * on an instance, further attempts on that instance do not allocate. Use one per thread.
+ */
+struct RouteWorkspace
+{
+    RouteStore routes;            ///< Linked-list route state of the merge loop.
+    std::vector<int> candidates;  ///< Route ids that survive the final feasibility checks.
+    std::vector<int> nodes;       ///< Node sequence of the route being materialized.
+    std::vector<std::vector<int>> sequences;  ///< Node sequences handed to the local search.
+    std::vector<int> order;       ///< Indices of @ref sequences sorted by size.
+    LocalSearch localSearch;      ///< Post-optimizer with its own reusable buffers.
+};
+
+/**
+ * @brief Buffers of solveMultipleRoutes() kept between calls.
+ *
+ * Holds the per-attempt arenas, the per-worker route workspaces, savings queues and
+ * shortest-path engines, the used-node sets and the diversity filter. Passing the same scratch
+ * to many solves (see BatchRunner) lets them reuse that memory instead of allocating it again
+ * for every instance. Once the buffers have grown to the needs of an instance, the attempts of
+ * a solve on it make no heap allocations; the returned routes and the per-call setup (savings
+ * list, engine heuristics) still do. Use one per concurrent solve.
+ */
+struct MultiRouteScratch
+{
+    MultiRouteScratch();
+    ~MultiRouteScratch();
+    MultiRouteScratch(MultiRouteScratch&&) noexcept;
+    MultiRouteScratch& operator=(MultiRouteScratch&&) noexcept;
+
+    struct Buffers;                    ///< Defined next to solveMultipleRoutes().
+    std::unique_ptr<Buffers> buffers;
+};
+
+/**
+ * @brief Parameters of the multi-start route generator (see solveMultipleRoutes()).
+ *
+ * Attempts are run in batches of @ref batchSize. The cost noise of edge e in attempt a is a
+ * pure function of (@ref seed, a, e) (see CounterRng), and all attempts of a batch observe the
+ * same set of already used nodes. Candidates are then filtered in attempt order, so for a fixed
+ * seed and batch size the result does not depend on the number of threads.
+ */
+struct MultiRouteOptions
+{
+    std::uint64_t seed = 0;        ///< Key of the counter-based RNG; the same seed replays a run bit-exactly unless local search has a time limit.
+    unsigned threads = 1;          ///< Worker threads when no pool is given (0 = hardware concurrency).
+    int batchSize = 8;             ///< Attempts generated in parallel before diversity filtering.
+    ThreadPool* pool = nullptr;    ///< Optional shared pool; overrides @ref threads when set.
+    RouteConstraints constraints;  ///< Capacity, length and orientation rules of every attempt.
+    Terminals terminals;           ///< Start and end node of every route; the first and last vertex by default.
+    const DistanceProvider* distances = nullptr;  ///< Depot distances for the savings; Euclidean when null.
+    /// Post-optimization of every attempt. Its pool is ignored because attempts already run on
+    /// the pool, and a time limit makes the result depend on timing.
+    LocalSearchOptions localSearch;
+    MultiRouteScratch* scratch = nullptr;  ///< Buffers reused across calls; local to the call when null.
+    bool printRoutes = true;       ///< Print the accepted routes and their lengths to std::cout.
+};
 
 /**
  * @brief Computes the shortest paths from a source node to all other nodes using Dijkstra's algorithm.
@@ -37,3 +113,179 @@ std::vector<int> reconstruct_path(int from, int to, const std::vector<std::vecto
 std::vector<std::vector<std::pair<int, int>>> solve_clarke_savings(const std::vector<Point>& vertices,
     const std::vector<Edge>& edges,
     int n_of_roads);
+
+/**
+ * @brief Builds start-to-end routes with the Clarke-Wright savings heuristic.
+ *
+ * Every interior node starts on its own route (start, i, end). Savings are computed over
+ * the graph edges using the current edge costs, and routes are merged greedily in order
+ * of decreasing saving. Only routes whose consecutive nodes are adjacent in @p graph are returned.
+ *
+ * @param vertices   The list of points (nodes) in the graph.
+ * @param graph      CSR graph over @p vertices; its edge costs drive the savings.
+ * @param n_of_roads The maximum number of routes to return.
+ * @return std::vector<std::vector<std::pair<int, int>>> Routes as lists of edges, longest first.
+ */
+std::vector<std::vector<std::pair<int, int>>> solveProblem(const std::vector<Point>& vertices,
+    const Graph& graph,
+    int n_of_roads);
+
+/**
+ * @brief Runs the constraint-aware Clarke-Wright merge loop on a prepared savings queue.
+ *
+ * Lets callers that solve the same instance many times reuse one SavingsList and apply
+ * their perturbation directly to the queue instead of rebuilding the savings per attempt.
+ * A saving (i, j) is applied when i and j are endpoints of different routes (only tail(i) and
+ * head(j) unless @ref RouteConstraints::allOrientations is set), the summed load fits the
+ * capacity and the merged route, measured in its shorter orientation with the terminal legs
+ * taken from @p list, does not exceed the maximum length. Load and length are tracked as running
+ * totals, so each check is O(1). The queue is consumed by the call.
+ *
+ * @param vertices    The list of points (nodes) in the graph.
+ * @param graph       CSR graph over @p vertices; its costs are the route link costs.
+ * @param list        Base savings of the instance, providing the terminals and their distances.
+ * @param savings     Savings to merge by, loaded from @p list with SavingsQueue::reset().
+ * @param n_of_roads  The maximum number of routes to return.
+ * When @p localSearch is enabled, all feasible routes are improved by LocalSearch before the
+ * top @p n_of_roads are chosen, so inter-route moves can shift nodes between them.
+ *
+ * @param constraints Demands, capacity, maximum length and allowed orientations.
+ * @param localSearch Post-optimization settings; disabled by default.
+ * @return std::vector<std::vector<std::pair<int, int>>> Routes as lists of edges, longest first.
+ */
+std::vector<std::vector<std::pair<int, int>>> solveProblem(const std::vector<Point>& vertices,
+    const Graph& graph,
+    const SavingsList& list,
+    SavingsQueue& savings,
+    int n_of_roads,
+    const RouteConstraints& constraints = {},
+    const LocalSearchOptions& localSearch = {});
+
+/**
+ * @brief The merge loop of solveProblem() alone, leaving every route in @p routes.
+ *
+ * Applies the savings of @p savings under @p constraints as described above but neither
+ * filters nor orients the result, so @p routes ends up partitioning all interior nodes.
+ * Used where the complete Clarke-Wright partition is needed, e.g. to warm-start
+ * solveRoutesExact().
+ *
+ * @param routes Route state after RouteStore::reset(); receives the merged routes.
+ */
+void mergeRoutes(const Graph& graph,
+    const SavingsList& list,
+    SavingsQueue& savings,
+    const RouteConstraints& constraints,
+    RouteStore& routes);
+
+/**
+ * @brief Allocation-free form of the merge loop above for repeated attempts.
+ *
+ * Scratch state lives in @p workspace and the routes are written to @p routes, whose
+ * allocator (usually an Arena reset between attempts) also backs every route it receives.
+ *
+ * @param workspace Per-thread scratch buffers.
+ * @param routes    Receives the routes, longest first (cleared first).
+ */
+void solveProblem(const std::vector<Point>& vertices,
+    const Graph& graph,
+    const SavingsList& list,
+    SavingsQueue& savings,
+    int n_of_roads,
+    const RouteConstraints& constraints,
+    const LocalSearchOptions& localSearch,
+    RouteWorkspace& workspace,
+    std::pmr::vector<ArenaRoute>& routes);
+
+/**
+ * @brief Computes the Jaccard similarity of two routes over their sets of edges.
+ *
+ * Edges are compared as given, so (u, v) and (v, u) count as different edges.
+ *
+ * @param route1  First route as a list of edges.
+ * @param route2  Second route as a list of edges.
+ * @param scratch Resource for the sorted edge copies (e.g. an Arena), so that repeated
+ *                comparisons need not touch the heap.
+ * @return double |E1 ∩ E2| / |E1 ∪ E2|, or 0 if both routes are empty.
+ */
+double routeSimilarity(std::span<const std::pair<int, int>> route1,
+    std::span<const std::pair<int, int>> route2,
+    std::pmr::memory_resource* scratch = std::pmr::get_default_resource());
+
+/**
+ * @brief Finds the shortest start-to-end path that avoids the given nodes.
+ *
+ * Used as a fallback when the Clarke-Wright attempt does not yield a usable route.
+ *
+ * @param vertices       The list of points (nodes) in the graph.
+ * @param graph          CSR graph over @p vertices.
+ * @param avoidNodes     Nodes that must not be visited.
+ * @param costMultiplier Kept for compatibility; edges touching avoided nodes are skipped, so it has no effect.
+ * @param terminals      Start and end of the path.
+ * @return std::vector<std::pair<int, int>> The path as a list of edges, or empty if none exists.
+ */
+std::vector<std::pair<int, int>> findAlternativePath(const std::vector<Point>& vertices,
+    const Graph& graph,
+    const std::set<int>& avoidNodes,
+    double costMultiplier = 1.0,
+    Terminals terminals = {});
+
+/**
+ * @brief Finds the shortest start-to-end path that avoids the given nodes, reusing a search workspace.
+ *
+ * Preferred over the graph overload when many fallback paths are requested on the same
+ * instance, since the engine keeps its buffers between calls.
+ *
+ * @param vertices   The list of points (nodes) in the graph.
+ * @param engine     Shortest-path engine built for @p vertices and the graph to search.
+ * @param avoidNodes Nodes that must not be visited.
+ * @param terminals  Start and end of the path.
+ * @return std::vector<std::pair<int, int>> The path as a list of edges, or empty if none exists.
+ */
+std::vector<std::pair<int, int>> findAlternativePath(const std::vector<Point>& vertices,
+    ShortestPathEngine& engine,
+    const std::set<int>& avoidNodes,
+    Terminals terminals = {});
+
+/**
+ * @brief Allocation-free form of findAlternativePath() writing into caller-provided storage.
+ *
+ * @param avoidNodes Nodes that must not be visited, in any order.
+ * @param workspace Per-thread scratch buffers.
+ * @param path      Receives the path as a list of edges (cleared first).
+ * @param terminals Start and end of the path.
+ * @return true if a path was found.
+ */
+bool findAlternativePath(const std::vector<Point>& vertices,
+    ShortestPathEngine& engine,
+    std::span<const int> avoidNodes,
+    RouteWorkspace& workspace,
+    ArenaRoute& path,
+    Terminals terminals = {});
+
+/**
+ * @brief Generates a set of mutually diverse start-to-end routes.
+ *
+ * Runs repeated Clarke-Wright attempts on randomly perturbed edge costs, falling back to
+ * shortest paths that avoid already used nodes, and keeps only routes that differ enough
+ * (Jaccard similarity over edges) from the routes accepted so far.
+ *
+ * @param vertices   The list of points (nodes) in the graph.
+ * @param graph      CSR graph over @p vertices with the original edge costs.
+ * @param n_of_roads The number of routes to generate.
+ * @param options    Seed, batch size and threading of the attempts.
+ * @return std::vector<std::vector<std::pair<int, int>>> The generated routes as lists of edges.
+ */
+std::vector<std::vector<std::pair<int, int>>> solveMultipleRoutes(const std::vector<Point>& vertices,
+    const Graph& graph,
+    int n_of_roads,
+    const MultiRouteOptions& options);
+
+/**
+ * @brief Generates diverse routes on a single thread with a random seed.
+ *
+ * Equivalent to solveMultipleRoutes(vertices, graph, n_of_roads, options) with default
+ * options and a seed drawn from std::random_device.
+ */
+std::vector<std::vector<std::pair<int, int>>> solveMultipleRoutes(const std::vector<Point>& vertices,
+    const Graph& graph,
+    int n_of_roads);
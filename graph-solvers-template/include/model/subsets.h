@@ -1,22 +1,59 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 
+/**
+ * @brief Lazily enumerates the non-trivial subsets of {0, 1, ..., n-1}.
+ *
+ * Visits every subset with at least 2 and at most n - 1 members, one at a time, in
+ * increasing bitmask order, so memory stays O(n) however many subsets there are. Callers
+ * that only need the subsets violating a constraint can stop early instead of paying for
+ * all 2^n of them; the exact route solver (solveRoutesExact()) separates such constraints
+ * without enumerating at all.
+ */
+class SubsetGenerator
+{
+public:
+    /**
+     * @param n Number of vertices.
+     * @throws std::length_error If n > 63 (the subsets are walked as a 64-bit mask).
+     */
+    explicit SubsetGenerator(int n);
+
+    /**
+     * @brief Writes the next subset.
+     *
+     * @param subset Receives the members in increasing order (cleared first).
+     * @return false once every subset has been visited.
+     */
+    bool next(std::vector<int>& subset);
+
+    /// @return Number of subsets the generator visits in total.
+    std::uint64_t count() const;
+
+private:
+    int n_;
+    std::uint64_t mask_ = 0;
+};
+
 /**
  * @brief Generates all non-trivial subsets of a vertex set {0, 1, ..., n-1},
  *        excluding subsets that are too small (size < 2) or the full set (size = n).
- * 
+ *
  * Each subset is represented as a vector of vertex indices.
  * These subsets are typically used in the MST Integer Programming model to enforce
- * subtour elimination constraints: For each subset S, the number of edges within S 
+ * subtour elimination constraints: For each subset S, the number of edges within S
  * must be at most |S| - 1 to prevent cycles.
- * 
+ *
  * The subsets are generated using a bitmasking approach, resulting in 2^n total combinations,
- * of which trivial and full-set subsets are excluded.
- * 
+ * of which trivial and full-set subsets are excluded. The result is materialized, so it is
+ * refused beyond 25 vertices; use SubsetGenerator to visit larger families one at a time.
+ *
  * @param n The number of vertices in the graph.
- * 
- * @return std::vector<std::vector<int>> 
+ *
+ * @return std::vector<std::vector<int>>
  *         A list of subsets, where each subset is a vector of integers (vertex indices).
+ * @throws std::length_error If n > 25.
  */
 std::vector<std::vector<int>> generateSubsets(int n);
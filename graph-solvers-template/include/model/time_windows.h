@@ -0,0 +1,69 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <span>
+
+/**
+ * @brief Time-window summary of a node sequence, concatenated in O(1).
+ *
+ * A segment visited without a break behaves like a single node: it can be started at any
+ * time in [earliest, latest] without violating a window, and from then on it takes
+ * @ref duration (travel, service and unavoidable waiting) until service ends at its last
+ * node. Summaries of two sequences and the travel time between them give the summary of
+ * their concatenation in constant time, so a route only needs the summaries of its two
+ * directions to test any merge; nothing is propagated through the nodes themselves.
+ */
+struct TimeSegment
+{
+    double duration = 0.0;                                       ///< Time from the start of service at the first node to the end of service at the last.
+    double earliest = -std::numeric_limits<double>::infinity();  ///< Earliest start of service at the first node.
+    double latest = std::numeric_limits<double>::infinity();     ///< Latest start at the first node that keeps every window.
+    bool feasible = true;                                        ///< false once some window cannot be met.
+
+    /// @return The segment of a single node with window [@p ready, @p due] and service time @p service.
+    static TimeSegment node(double ready, double due, double service)
+    {
+        return { service, ready, due, ready <= due };
+    }
+};
+
+/**
+ * @brief Summary of @p first followed, after @p travel, by @p second.
+ *
+ * Waiting is inserted where @p second cannot start yet; the result is infeasible when even
+ * the earliest start of @p first reaches @p second after its latest start.
+ */
+inline TimeSegment concatenate(const TimeSegment& first, double travel, const TimeSegment& second)
+{
+    const double offset = first.duration + travel;
+    const double wait = std::max(second.earliest - offset - first.latest, 0.0);
+    const double late = first.earliest + offset - second.latest;
+
+    TimeSegment result;
+    result.duration = offset + second.duration + wait;
+    result.earliest = std::max(second.earliest - offset, first.earliest) - wait;
+    result.latest = std::min(second.latest - offset, first.latest);
+    result.feasible = first.feasible && second.feasible && late <= 1e-9;
+    return result;
+}
+
+/**
+ * @brief Checks a whole node sequence against its time windows in one forward pass.
+ *
+ * For moves that rearrange routes arbitrarily (local search, fallback paths), where no
+ * summary of the new sequence exists; merges use the summaries instead.
+ *
+ * @param sequence  Nodes in visiting order, terminals included.
+ * @param segmentOf Callable giving the one-node TimeSegment of a node.
+ * @param travel    Callable giving the travel time between two consecutive nodes.
+ */
+template <class SegmentOf, class Travel>
+bool fitsSchedule(std::span<const int> sequence, SegmentOf&& segmentOf, Travel&& travel)
+{
+    if (sequence.empty()) return true;
+    TimeSegment schedule = segmentOf(sequence[0]);
+    for (std::size_t k = 1; k < sequence.size() && schedule.feasible; ++k)
+        schedule = concatenate(schedule, travel(sequence[k - 1], sequence[k]), segmentOf(sequence[k]));
+    return schedule.feasible;
+}
@@ -1,67 +1,258 @@
 ﻿#include <vector>
+#include <random>
+#include <iostream>
+#include <fstream>
+#include <optional>
 #include "model/subsets.h"
+#include "model/decomposition.h"
+#include "model/exact_solver.h"
 #include "model/solver.h"
+#include "model/batch.h"
+#include "model/route_io.h"
 #include "geometry/visualization.h"
 #include "common/types.h"
-#include <CDT.h>
+#include "common/distance.h"
+#include "common/graph.h"
+#include "common/instance_io.h"
+#include "common/instrumentation.h"
+#include "common/simd.h"
+#include "common/thread_pool.h"
+#include "geometry/spatial_index.h"
+#include "geometry/triangulation.h"
 
-std::pair<std::vector<std::array<int, 3>>, std::vector<Edge>>
-computeTriangulationAndEdges(const std::vector<Point>& vertices)
+int main(int argc, char** argv)
 {
-    std::vector<CDT::V2d<double>> cdt_points;
-    for (const auto& p : vertices)
-        cdt_points.emplace_back(p.x, p.y);
-
-    CDT::Triangulation<double> cdt;
-    cdt.insertVertices(cdt_points);
-    cdt.eraseSuperTriangle();
-
-    std::vector<Edge> edges;
-    for (const auto& tri : cdt.triangles) {
-        for (int i = 0; i < 3; ++i) {
-            int a = tri.vertices[i], b = tri.vertices[(i + 1) % 3];
-            if (a > b) std::swap(a, b);
-            edges.push_back({ a, b, euclidean(vertices[a], vertices[b]) });
+    // Usage: [instance file (.vrp/.tsp, .csv or .cwb)] [--profile=report.json] [--trace=trace.json]
+    //        [--batch=manifest|-] [--jobs=N] [--routes=out.cwr|.json|.csv|.geojson|.txt] [--quiet]
+    //        [--svg-per-route] [--tiles=directory] [--seed=N] [--simd=scalar|avx2|avx512]
+    //        [--exact[=seconds]] [--mip=bundled|cplex] [--decompose[=sweep|cluster]] [--knn=K]
+    //        [--ls-time=ms]
+    std::string instancePath, profilePath, tracePath, batchPath, routesPath, tilesPath, mipBackend;
+    bool quiet = false, svgPerRoute = false;
+    std::optional<std::uint64_t> seedArg;
+    std::optional<double> exactSeconds;
+    std::optional<PartitionKind> decomposition;
+    unsigned jobs = 0;
+    int nearestNeighbours = 0;
+    double localSearchMs = 0.0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--profile=", 0) == 0) profilePath = arg.substr(10);
+        else if (arg.rfind("--trace=", 0) == 0) tracePath = arg.substr(8);
+        else if (arg.rfind("--batch=", 0) == 0) batchPath = arg.substr(8);
+        else if (arg.rfind("--jobs=", 0) == 0) jobs = (unsigned)std::stoul(arg.substr(7));
+        else if (arg.rfind("--routes=", 0) == 0) routesPath = arg.substr(9);
+        else if (arg == "--quiet") quiet = true;
+        else if (arg.rfind("--seed=", 0) == 0) seedArg = std::stoull(arg.substr(7));
+        else if (arg == "--svg-per-route") svgPerRoute = true;
+        else if (arg.rfind("--tiles=", 0) == 0) tilesPath = arg.substr(8);
+        else if (arg.rfind("--simd=", 0) == 0) setSimdLevel(parseSimdLevel(arg.substr(7).c_str()));
+        else if (arg == "--exact") exactSeconds = 60.0;
+        else if (arg.rfind("--exact=", 0) == 0) exactSeconds = std::stod(arg.substr(8));
+        else if (arg.rfind("--mip=", 0) == 0) mipBackend = arg.substr(6);
+        else if (arg == "--decompose" || arg == "--decompose=sweep") decomposition = PartitionKind::Sweep;
+        else if (arg == "--decompose=cluster") decomposition = PartitionKind::Cluster;
+        else if (arg.rfind("--knn=", 0) == 0) nearestNeighbours = std::stoi(arg.substr(6));
+        else if (arg.rfind("--ls-time=", 0) == 0) localSearchMs = std::stod(arg.substr(10));
+        else instancePath = arg;
+    }
+
+    // Tryb wsadowy: wiele instancji w jednym procesie, wyniki jako linie JSON na stdout.
+    // "-" czyta zadania ze stdin, więc proces może obsługiwać potok lub nazwany FIFO
+    if (!batchPath.empty()) {
+        std::ifstream manifest;
+        if (batchPath != "-") {
+            manifest.open(batchPath);
+            if (!manifest) {
+                std::cerr << "Error: cannot open " << batchPath << std::endl;
+                return 1;
+            }
         }
+        BatchOptions batch;
+        batch.threads = jobs;
+        BatchRunner runner(batch);
+        BatchSummary summary = runner.run(batchPath == "-" ? std::cin : manifest, std::cout);
+        std::cerr << summary.jobs << " jobs, " << summary.failed << " failed" << std::endl;
+        return summary.failed == 0 ? 0 : 2;
     }
 
-    std::sort(edges.begin(), edges.end(), [](const Edge& e1, const Edge& e2) {
-        return std::tie(e1.u, e1.v) < std::tie(e2.u, e2.v);
-        });
-    edges.erase(std::unique(edges.begin(), edges.end(), [](const Edge& e1, const Edge& e2) {
-        return e1.u == e2.u && e1.v == e2.v;
-        }), edges.end());
-
-    std::vector<std::array<int, 3>> triangles;
-    for (const auto& tri : cdt.triangles) {
-        std::array<int, 3> triangle = { tri.vertices[0], tri.vertices[1], tri.vertices[2] };
-        triangles.push_back(triangle);
+    // Jedno ziarno steruje punktami i szumem solvera; wypisane, aby można było powtórzyć przebieg
+    std::uint64_t seed = seedArg ? *seedArg : ((std::uint64_t)std::random_device{}() << 32) | std::random_device{}();
+    std::cout << "Seed: " << seed << std::endl;
+
+    // Instance from the command line, random points otherwise
+    std::vector<Point> vertices;
+    std::vector<int> depotNodes;
+    RouteConstraints constraints;
+    if (!instancePath.empty()) {
+        try {
+            Instance instance = loadInstance(instancePath);
+            vertices = instance.points();
+            depotNodes = instance.depots;
+            // Zapotrzebowania, pojemność i okna czasowe z pliku obowiązują we wszystkich trybach rozwiązywania
+            constraints.demands = std::move(instance.demand);
+            constraints.capacity = instance.capacity;
+            constraints.readyTimes = std::move(instance.readyTime);
+            constraints.dueTimes = std::move(instance.dueTime);
+            constraints.serviceTimes = std::move(instance.serviceTime);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+    else {
+        vertices = generateUniquePoints(50, 0.0, 0.0, 40.0, 40.0, seed);
     }
 
-    return { triangles, edges };
-}
+    // Jedna pula wątków dla triangulacji i generowania tras
+    ThreadPool pool;
 
+    TriangulationOptions triangulation;
+    triangulation.pool = &pool;
+    DelaunayGraph delaunay = buildDelaunayGraph(vertices, triangulation);
+    Graph& graph = delaunay.graph;
 
-int main()
-{
-    std::vector<Point> vertices = generateUniquePoints(50);
+    // Kandydaci oszczędności: krawędzie Delaunaya plus k najbliższych sąsiadów każdego punktu
+    if (nearestNeighbours > 0) graph = withNearestNeighbours(graph, vertices, nearestNeighbours, &pool);
 
-    auto [triangles, edges] = computeTriangulationAndEdges(vertices);
+    // Wszystkie etapy, łącznie z kosztami krawędzi kandydatów, czytają odległości z jednego dostawcy
+    auto distances = makeDistanceProvider(vertices);
+    setEdgeCosts(graph, *distances);
 
-    auto outputEdges = solveMultipleRoutes(vertices, edges, 20);
+    MultiRouteOptions options;
+    options.constraints = std::move(constraints);
+    options.distances = distances.get();
+    // Jeden magazyn z pliku (każdy plik CVRPLIB): trasy zaczynają się i kończą w nim
+    if (depotNodes.size() == 1) options.terminals = { depotNodes[0], depotNodes[0] };
+    options.seed = seed;
+    options.pool = &pool;
+    options.localSearch.enabled = true;
+    // Domyślnie bez limitu czasu, żeby --seed odtwarzał przebieg bit w bit
+    options.localSearch.timeLimitMs = localSearchMs;
+    options.printRoutes = !quiet;
 
-    std::vector<std::vector<std::pair<int, int>>> clearGraph;
+    auto outputEdges = solveMultipleRoutes(vertices, graph, 20, options);
 
-    for (int i = 0; i < outputEdges.size(); ++i) {
+    // Rozwiązanie dokładne z certyfikowaną luką: te same nogi terminali co heurystyka
+    if (exactSeconds) {
+        ExactOptions exact;
+        exact.constraints = options.constraints;
+        exact.terminals = options.terminals;
+        exact.distances = distances.get();
+        exact.terminalEdgesOnly = true;
+        exact.backend = mipBackend;
+        exact.timeLimit = *exactSeconds;
+        ExactResult solved;
+        try {
+            solved = solveRoutesExact(vertices, graph, exact);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        std::cout << "Exact (" << solved.backend << "): cost " << solved.cost << ", bound " << solved.bound
+                  << ", gap " << 100.0 * solved.gap() << "%, " << solved.routes.size() << " routes, "
+                  << solved.nodes << " nodes, " << solved.seconds << " s" << std::endl;
+        if (!quiet) {
+            for (const auto& route : solved.routes) {
+                for (std::size_t k = 0; k < route.size(); ++k) std::cout << (k ? " " : "  ") << route[k];
+                std::cout << std::endl;
+            }
+        }
+    }
 
-        std::string filename = "graph_with_route_" + std::to_string(i) + ".svg";
+    // Dekompozycja dla bardzo dużych instancji: niezależne podproblemy na puli wątków
+    if (decomposition) {
+        DecompositionOptions decomposed;
+        decomposed.partition = *decomposition;
+        decomposed.pool = &pool;
+        decomposed.constraints = options.constraints;
+        decomposed.terminals = options.terminals;
+        decomposed.distances = distances.get();
+        auto routes = solveDecomposed(vertices, graph, decomposed);
+        double cost = 0.0;
+        for (const auto& route : routes) {
+            std::size_t last = route.size() - 1;
+            cost += distances->distance(route[0], route[1]) + distances->distance(route[last - 1], route[last]);
+            for (std::size_t k = 1; k + 1 < last; ++k) cost += graph.cost(graph.edgeId(route[k], route[k + 1]));
+        }
+        std::cout << "Decomposed (" << (*decomposition == PartitionKind::Sweep ? "sweep" : "cluster") << "): cost " << cost
+                  << ", " << routes.size() << " routes" << std::endl;
+    }
 
-        std::vector<std::vector<std::pair<int, int>>> singleRoute = { outputEdges[i] };
+    // Kilka magazynów w pliku instancji: każdy obsługuje najbliższych klientów, wspólny graf
+    if (depotNodes.size() > 1) {
+        std::vector<Terminals> depots;
+        for (int node : depotNodes) depots.push_back({ node, node });
+        MultiDepotOptions multi;
+        multi.pool = &pool;
+        multi.constraints = options.constraints;
+        multi.distances = distances.get();
+        MultiDepotSolution solution;
+        try {
+            solution = solveMultiDepot(vertices, graph, depots, multi);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        for (std::size_t d = 0; d < depots.size(); ++d) {
+            std::cout << "Depot " << depotNodes[d] << ": " << solution.routes[d].size() << " routes" << std::endl;
+            if (quiet) continue;
+            for (const auto& route : solution.routes[d]) {
+                for (std::size_t k = 0; k < route.size(); ++k) std::cout << (k ? " " : "  ") << route[k];
+                std::cout << std::endl;
+            }
+        }
+    }
+
+    // Eksport tras do pliku; format wynika z rozszerzenia
+    if (!routesPath.empty()) {
+        try {
+            writeRoutes(routesPath, outputEdges, graph, vertices);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
 
-        drawSVG(vertices, singleRoute, triangles, filename);
+    // Wizualizacja: tło grafu przygotowane raz, pliki rysowane równolegle
+    RenderOptions render;
+    render.pool = &pool;
+    SvgRenderer renderer(vertices, graph, render);
+
+    std::vector<std::string> svgFiles = { "graph_routes.svg", "graph_clear.svg" };
+    std::vector<RouteEdges> svgRoutes = { outputEdges, {} };
+    if (svgPerRoute) {
+        for (int i = 0; i < (int)outputEdges.size(); ++i) {
+            svgFiles.push_back("graph_with_route_" + std::to_string(i) + ".svg");
+            svgRoutes.push_back({ outputEdges[i] });
+        }
+    }
+    try {
+        renderer.renderFiles(svgFiles, svgRoutes);
+        for (const auto& file : svgFiles) std::cout << "SVG visualization written to " << file << std::endl;
+        if (!tilesPath.empty()) {
+            int tiles = renderer.renderTiles(tilesPath, outputEdges);
+            std::cout << tiles << " SVG tiles written to " << tilesPath << std::endl;
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
     }
-    drawSVG(vertices, clearGraph, triangles, "graph_clear.svg");
 
+    // Liczniki i czasy etapów (puste, jeśli instrumentacja jest wyłączona w kompilacji)
+    try {
+        if (!profilePath.empty()) Instrumentation::instance().writeReport(profilePath);
+        if (!tracePath.empty()) Instrumentation::instance().writeChromeTrace(tracePath);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
 
     return 0;
 }
@@ -0,0 +1,71 @@
+#include "common/arena.h"
+
+#include <algorithm>
+
+#include "common/instrumentation.h"
+
+namespace {
+
+constexpr std::size_t chunkAlignment = alignof(std::max_align_t);
+
+std::size_t alignUp(std::size_t value, std::size_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+// Offset of the first address at or after data + offset that satisfies alignment
+std::size_t alignedOffset(const std::byte* data, std::size_t offset, std::size_t alignment)
+{
+    auto address = reinterpret_cast<std::uintptr_t>(data + offset);
+    return offset + (alignUp(address, alignment) - address);
+}
+
+} // namespace
+
+Arena::Arena(std::size_t initialChunk, std::pmr::memory_resource* upstream)
+    : upstream_(upstream), nextChunkSize_(std::max<std::size_t>(initialChunk, 256))
+{
+    chunks_.reserve(16);
+}
+
+Arena::~Arena()
+{
+    for (const auto& chunk : chunks_)
+        upstream_->deallocate(chunk.data, chunk.size, chunkAlignment);
+}
+
+void Arena::reset()
+{
+    current_ = 0;
+    offset_ = 0;
+    used_ = 0;
+}
+
+void* Arena::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    // Try the current chunk, then the chunks retained from earlier rounds
+    for (; current_ < chunks_.size(); ++current_, offset_ = 0) {
+        const Chunk& chunk = chunks_[current_];
+        std::size_t start = alignedOffset(chunk.data, offset_, alignment);
+        if (start + bytes <= chunk.size) {
+            offset_ = start + bytes;
+            used_ += bytes;
+            return chunk.data + start;
+        }
+    }
+
+    // Grow: a new chunk at least twice the previous one and large enough for the request
+    std::size_t size = std::max(nextChunkSize_, alignUp(bytes + alignment, chunkAlignment));
+    auto* data = static_cast<std::byte*>(upstream_->allocate(size, chunkAlignment));
+    chunks_.push_back({ data, size });
+    capacity_ += size;
+    nextChunkSize_ = size * 2;
+    ++upstreamAllocations_;
+    CW_COUNT(ArenaGrowth, 1);
+
+    current_ = chunks_.size() - 1;
+    std::size_t start = alignedOffset(data, 0, alignment);
+    offset_ = start + bytes;
+    used_ += bytes;
+    return data + start;
+}
@@ -0,0 +1,213 @@
+#include "common/distance.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+void DistanceProvider::distances(int from, std::span<const int> to, std::span<double> out) const
+{
+    for (std::size_t k = 0; k < to.size(); ++k)
+        out[k] = distance(from, to[k]);
+}
+
+void DistanceProvider::row(int from, std::span<double> out) const
+{
+    for (int j = 0; j < size(); ++j)
+        out[j] = distance(from, j);
+}
+
+void DistanceProvider::column(int to, std::span<double> out) const
+{
+    for (int i = 0; i < size(); ++i)
+        out[i] = distance(i, to);
+}
+
+EuclideanDistances::EuclideanDistances(const std::vector<Point>& points, Precision precision)
+    : points_(points, precision)
+{
+}
+
+void EuclideanDistances::distances(int from, std::span<const int> to, std::span<double> out) const
+{
+    points_.distancesFrom(from, to, out);
+}
+
+void EuclideanDistances::row(int from, std::span<double> out) const
+{
+    points_.distancesFrom(points_[from], out);
+}
+
+std::size_t EuclideanDistances::memoryBytes() const
+{
+    std::size_t coordinate = points_.precision() == Precision::Double ? sizeof(double) : sizeof(float);
+    return 2 * coordinate * (std::size_t)points_.size();
+}
+
+DenseDistanceMatrix::DenseDistanceMatrix(int n, std::vector<float> values)
+    : n_(n), values_(std::move(values))
+{
+    if (n < 0 || values_.size() != (std::size_t)n * n)
+        throw std::invalid_argument("DenseDistanceMatrix: expected n * n values");
+}
+
+DenseDistanceMatrix::DenseDistanceMatrix(const DistanceProvider& source)
+    : n_(source.size()), values_((std::size_t)source.size() * source.size())
+{
+    std::vector<double> buffer(n_);
+    for (int i = 0; i < n_; ++i) {
+        source.row(i, buffer);
+        std::copy(buffer.begin(), buffer.end(), values_.begin() + (std::size_t)i * n_);
+    }
+}
+
+void DenseDistanceMatrix::distances(int from, std::span<const int> to, std::span<double> out) const
+{
+    const float* row = values_.data() + (std::size_t)from * n_;
+    for (std::size_t k = 0; k < to.size(); ++k)
+        out[k] = row[to[k]];
+}
+
+void DenseDistanceMatrix::row(int from, std::span<double> out) const
+{
+    const float* row = values_.data() + (std::size_t)from * n_;
+    std::copy(row, row + n_, out.begin());
+}
+
+TiledDistanceCache::TiledDistanceCache(const DistanceProvider& source, int tileSize, std::size_t maxTiles)
+    : source_(source),
+      tileSize_(std::max(1, tileSize)),
+      tilesPerRow_((source.size() + tileSize_ - 1) / tileSize_),
+      maxTiles_(std::max<std::size_t>(1, maxTiles))
+{
+}
+
+TiledDistanceCache::TiledDistanceCache(std::unique_ptr<const DistanceProvider> source, int tileSize, std::size_t maxTiles)
+    : owned_(std::move(source)),
+      source_(*owned_),
+      tileSize_(std::max(1, tileSize)),
+      tilesPerRow_((source_.size() + tileSize_ - 1) / tileSize_),
+      maxTiles_(std::max<std::size_t>(1, maxTiles))
+{
+}
+
+TiledDistanceCache::Tile TiledDistanceCache::tile(int tileRow, int tileCol) const
+{
+    std::uint64_t key = (std::uint64_t)tileRow * tilesPerRow_ + tileCol;
+    auto it = tiles_.find(key);
+    if (it != tiles_.end()) {
+        ++hits_;
+        lru_.splice(lru_.begin(), lru_, it->second.lru);
+        return it->second.tile;
+    }
+
+    ++misses_;
+    const int n = source_.size();
+    const int row0 = tileRow * tileSize_, rows = std::min(tileSize_, n - row0);
+    const int col0 = tileCol * tileSize_, cols = std::min(tileSize_, n - col0);
+
+    std::vector<int> targets(cols);
+    std::iota(targets.begin(), targets.end(), col0);
+    auto values = std::make_shared<std::vector<double>>((std::size_t)tileSize_ * tileSize_);
+    for (int r = 0; r < rows; ++r)
+        source_.distances(row0 + r, targets, std::span<double>(values->data() + (std::size_t)r * tileSize_, cols));
+
+    if (tiles_.size() >= maxTiles_) {
+        // Readers hold their own reference, so an evicted tile stays valid until they finish.
+        tiles_.erase(lru_.back());
+        lru_.pop_back();
+    }
+    lru_.push_front(key);
+    Tile result = std::move(values);
+    tiles_.emplace(key, Entry{ result, lru_.begin() });
+    return result;
+}
+
+double TiledDistanceCache::distance(int i, int j) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Tile t = tile(i / tileSize_, j / tileSize_);
+    return (*t)[(std::size_t)(i % tileSize_) * tileSize_ + j % tileSize_];
+}
+
+void TiledDistanceCache::distances(int from, std::span<const int> to, std::span<double> out) const
+{
+    const int tileRow = from / tileSize_;
+    const std::size_t offset = (std::size_t)(from % tileSize_) * tileSize_;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    int lastCol = -1;
+    Tile t;
+    for (std::size_t k = 0; k < to.size(); ++k) {
+        int tileCol = to[k] / tileSize_;
+        if (tileCol != lastCol) {
+            t = tile(tileRow, tileCol);
+            lastCol = tileCol;
+        }
+        out[k] = (*t)[offset + to[k] % tileSize_];
+    }
+}
+
+void TiledDistanceCache::row(int from, std::span<double> out) const
+{
+    const int n = size();
+    const int tileRow = from / tileSize_;
+    const std::size_t offset = (std::size_t)(from % tileSize_) * tileSize_;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int tileCol = 0; tileCol < tilesPerRow_; ++tileCol) {
+        Tile t = tile(tileRow, tileCol);
+        int col0 = tileCol * tileSize_;
+        int cols = std::min(tileSize_, n - col0);
+        std::copy(t->begin() + offset, t->begin() + offset + cols, out.begin() + col0);
+    }
+}
+
+std::size_t TiledDistanceCache::memoryBytes() const
+{
+    return source_.memoryBytes() + maxTiles_ * tileSize_ * tileSize_ * sizeof(double);
+}
+
+std::size_t TiledDistanceCache::cachedTiles() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return tiles_.size();
+}
+
+std::uint64_t TiledDistanceCache::hits() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+std::uint64_t TiledDistanceCache::misses() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
+
+std::unique_ptr<DistanceProvider> makeDistanceProvider(const std::vector<Point>& points, int tiledFrom)
+{
+    auto euclideanDistances = std::make_unique<EuclideanDistances>(points);
+    if ((int)points.size() < tiledFrom)
+        return euclideanDistances;
+    return std::make_unique<TiledDistanceCache>(std::move(euclideanDistances), 64, 256);
+}
+
+void setEdgeCosts(Graph& graph, const DistanceProvider& distances)
+{
+    if (graph.vertexCount() != distances.size())
+        throw std::invalid_argument("setEdgeCosts: graph and distance provider differ in size");
+
+    std::vector<double> buffer;
+    for (int u = 0; u < graph.vertexCount(); ++u) {
+        std::span<const int> neighbours = graph.neighbours(u);
+        std::span<const int> edgeIds = graph.incidentEdges(u);
+        // Neighbours are sorted, so those above u, which own the edge, form the tail
+        std::size_t first = std::upper_bound(neighbours.begin(), neighbours.end(), u) - neighbours.begin();
+        buffer.resize(neighbours.size() - first);
+        distances.distances(u, neighbours.subspan(first), buffer);
+        for (std::size_t k = first; k < neighbours.size(); ++k)
+            graph.setCost(edgeIds[k], buffer[k - first]);
+    }
+}
@@ -0,0 +1,160 @@
+#include "common/dynamic_graph.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+/// Slots given to a vertex when its block is (re)allocated.
+int roomFor(int degree)
+{
+    return std::max(4, degree + degree / 2);
+}
+
+} // namespace
+
+DynamicGraph::DynamicGraph(const Graph& graph)
+    : edges_(graph.edges()), edgeCount_(graph.edgeCount())
+{
+    const int n = graph.vertexCount();
+    begin_.resize(n);
+    degree_.resize(n);
+    capacity_.resize(n);
+
+    std::size_t slots = 0;
+    for (int u = 0; u < n; ++u) {
+        begin_[u] = (int)slots;
+        degree_[u] = graph.degree(u);
+        capacity_[u] = roomFor(degree_[u]);
+        slots += capacity_[u];
+    }
+    targets_.assign(slots, -1);
+    edgeIds_.assign(slots, -1);
+    for (int u = 0; u < n; ++u) {
+        std::copy(graph.neighbours(u).begin(), graph.neighbours(u).end(), targets_.begin() + begin_[u]);
+        std::copy(graph.incidentEdges(u).begin(), graph.incidentEdges(u).end(), edgeIds_.begin() + begin_[u]);
+    }
+}
+
+int DynamicGraph::edgeId(int u, int v) const
+{
+    if (u < 0 || v < 0 || u >= vertexCount() || v >= vertexCount())
+        return npos;
+    if (degree(u) > degree(v)) std::swap(u, v);
+
+    auto adj = neighbours(u);
+    auto it = std::lower_bound(adj.begin(), adj.end(), v);
+    if (it == adj.end() || *it != v)
+        return npos;
+    return edgeIds_[begin_[u] + (it - adj.begin())];
+}
+
+int DynamicGraph::addVertex()
+{
+    begin_.push_back((int)targets_.size());
+    degree_.push_back(0);
+    capacity_.push_back(roomFor(0));
+    targets_.resize(targets_.size() + capacity_.back(), -1);
+    edgeIds_.resize(targets_.size(), -1);
+    return vertexCount() - 1;
+}
+
+int DynamicGraph::addEdge(int u, int v, double cost)
+{
+    if (u < 0 || v < 0 || u >= vertexCount() || v >= vertexCount() || u == v)
+        throw std::invalid_argument("DynamicGraph: invalid edge endpoints");
+    if (u > v) std::swap(u, v);
+
+    int existing = edgeId(u, v);
+    if (existing != npos) return existing;
+
+    int id;
+    if (!freeIds_.empty()) {
+        id = freeIds_.back();
+        freeIds_.pop_back();
+        edges_[id] = { u, v, cost };
+    }
+    else {
+        id = (int)edges_.size();
+        edges_.push_back({ u, v, cost });
+    }
+    insertSlot(u, v, id);
+    insertSlot(v, u, id);
+    ++edgeCount_;
+    return id;
+}
+
+void DynamicGraph::removeEdge(int id)
+{
+    if (!isEdge(id))
+        throw std::invalid_argument("DynamicGraph: no live edge with this id");
+    eraseSlot(edges_[id].u, edges_[id].v);
+    eraseSlot(edges_[id].v, edges_[id].u);
+    edges_[id].u = edges_[id].v = -1;
+    freeIds_.push_back(id);
+    --edgeCount_;
+}
+
+void DynamicGraph::insertSlot(int u, int v, int id)
+{
+    if (degree_[u] == capacity_[u]) grow(u);
+
+    auto first = targets_.begin() + begin_[u];
+    auto last = first + degree_[u];
+    auto at = std::lower_bound(first, last, v) - first;
+    std::move_backward(first + at, last, last + 1);
+    std::move_backward(edgeIds_.begin() + begin_[u] + at, edgeIds_.begin() + begin_[u] + degree_[u],
+        edgeIds_.begin() + begin_[u] + degree_[u] + 1);
+    targets_[begin_[u] + at] = v;
+    edgeIds_[begin_[u] + at] = id;
+    ++degree_[u];
+}
+
+void DynamicGraph::eraseSlot(int u, int v)
+{
+    auto first = targets_.begin() + begin_[u];
+    auto last = first + degree_[u];
+    auto at = std::lower_bound(first, last, v) - first;
+    std::move(first + at + 1, last, first + at);
+    std::move(edgeIds_.begin() + begin_[u] + at + 1, edgeIds_.begin() + begin_[u] + degree_[u],
+        edgeIds_.begin() + begin_[u] + at);
+    --degree_[u];
+}
+
+void DynamicGraph::grow(int u)
+{
+    // Move the block to the end with more room; the old slots are reclaimed by compact()
+    int from = begin_[u];
+    int room = std::max(2 * capacity_[u], roomFor(degree_[u]));
+    begin_[u] = (int)targets_.size();
+    targets_.resize(targets_.size() + room, -1);
+    edgeIds_.resize(targets_.size(), -1);
+    std::copy_n(targets_.begin() + from, degree_[u], targets_.begin() + begin_[u]);
+    std::copy_n(edgeIds_.begin() + from, degree_[u], edgeIds_.begin() + begin_[u]);
+    abandoned_ += capacity_[u];
+    capacity_[u] = room;
+
+    if (abandoned_ * 2 > targets_.size()) compact();
+}
+
+void DynamicGraph::compact()
+{
+    std::vector<int> targets, edgeIds;
+    std::size_t slots = 0;
+    for (int u = 0; u < vertexCount(); ++u) slots += roomFor(degree_[u]);
+    targets.assign(slots, -1);
+    edgeIds.assign(slots, -1);
+
+    int next = 0;
+    for (int u = 0; u < vertexCount(); ++u) {
+        std::copy_n(targets_.begin() + begin_[u], degree_[u], targets.begin() + next);
+        std::copy_n(edgeIds_.begin() + begin_[u], degree_[u], edgeIds.begin() + next);
+        begin_[u] = next;
+        capacity_[u] = roomFor(degree_[u]);
+        next += capacity_[u];
+    }
+    targets_ = std::move(targets);
+    edgeIds_ = std::move(edgeIds);
+    abandoned_ = 0;
+}
@@ -0,0 +1,75 @@
+#include "common/graph.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+Graph::Graph(int vertexCount, const std::vector<Edge>& edges)
+{
+    if (vertexCount < 0)
+        throw std::invalid_argument("Graph: negative vertex count");
+
+    // Bucket canonical (u < v) edges by their lower endpoint, keeping input order.
+    std::vector<int> lowOffsets(vertexCount + 1, 0);
+    for (const auto& e : edges) {
+        if (e.u < 0 || e.v < 0 || e.u >= vertexCount || e.v >= vertexCount)
+            throw std::invalid_argument("Graph: edge endpoint out of range");
+        if (e.u == e.v) continue;
+        ++lowOffsets[std::min(e.u, e.v) + 1];
+    }
+    for (int u = 0; u < vertexCount; ++u)
+        lowOffsets[u + 1] += lowOffsets[u];
+
+    std::vector<std::pair<int, double>> upper(lowOffsets[vertexCount]);
+    std::vector<int> fill(lowOffsets.begin(), lowOffsets.end() - 1);
+    for (const auto& e : edges) {
+        if (e.u == e.v) continue;
+        upper[fill[std::min(e.u, e.v)]++] = { std::max(e.u, e.v), e.cost };
+    }
+
+    // Sort each bucket by upper endpoint and drop duplicates; stable sort keeps the first cost.
+    edges_.reserve(upper.size());
+    for (int u = 0; u < vertexCount; ++u) {
+        auto first = upper.begin() + lowOffsets[u];
+        auto last = upper.begin() + lowOffsets[u + 1];
+        std::stable_sort(first, last, [](const auto& a, const auto& b) { return a.first < b.first; });
+        for (auto it = first; it != last; ++it) {
+            if (it != first && it->first == (it - 1)->first) continue;
+            edges_.push_back({ u, it->first, it->second });
+        }
+    }
+
+    // Full symmetric adjacency. Edges are ordered by (u, v), so filling in edge order
+    // leaves every neighbour list sorted without a second sort.
+    offsets_.assign(vertexCount + 1, 0);
+    for (const auto& e : edges_) {
+        ++offsets_[e.u + 1];
+        ++offsets_[e.v + 1];
+    }
+    for (int u = 0; u < vertexCount; ++u)
+        offsets_[u + 1] += offsets_[u];
+
+    targets_.resize(offsets_[vertexCount]);
+    edgeIds_.resize(offsets_[vertexCount]);
+    fill.assign(offsets_.begin(), offsets_.end() - 1);
+    for (int id = 0; id < (int)edges_.size(); ++id) {
+        const auto& e = edges_[id];
+        targets_[fill[e.u]] = e.v;
+        edgeIds_[fill[e.u]++] = id;
+        targets_[fill[e.v]] = e.u;
+        edgeIds_[fill[e.v]++] = id;
+    }
+}
+
+int Graph::edgeId(int u, int v) const
+{
+    if (u < 0 || v < 0 || u >= vertexCount() || v >= vertexCount())
+        return npos;
+    if (degree(u) > degree(v)) std::swap(u, v);
+
+    auto adj = neighbours(u);
+    auto it = std::lower_bound(adj.begin(), adj.end(), v);
+    if (it == adj.end() || *it != v)
+        return npos;
+    return edgeIds_[offsets_[u] + (it - adj.begin())];
+}
@@ -0,0 +1,441 @@
+#include "common/instance_io.h"
+
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char binaryMagic[4] = { 'C', 'W', 'B', '1' };
+
+struct BinaryHeader
+{
+    char magic[4];
+    std::uint32_t flags;
+    std::uint64_t nodes;
+    std::uint64_t depots;
+    double capacity;
+};
+
+// Cursor over one line of mapped text; tokens are parsed in place.
+struct LineReader
+{
+    std::string_view rest;
+
+    bool nextLine(std::string_view& line)
+    {
+        if (rest.empty()) return false;
+        size_t eol = rest.find('\n');
+        line = rest.substr(0, eol);
+        rest = eol == std::string_view::npos ? std::string_view() : rest.substr(eol + 1);
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        return true;
+    }
+};
+
+bool isSeparator(char c)
+{
+    return c == ' ' || c == '\t' || c == ',' || c == ';';
+}
+
+std::string_view trim(std::string_view s)
+{
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) s.remove_suffix(1);
+    return s;
+}
+
+template <typename T>
+bool parseNumber(std::string_view& s, T& value)
+{
+    while (!s.empty() && isSeparator(s.front())) s.remove_prefix(1);
+    if (!s.empty() && s.front() == '+') s.remove_prefix(1);
+    auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), value);
+    if (ec != std::errc()) return false;
+    s.remove_prefix(ptr - s.data());
+    return true;
+}
+
+[[noreturn]] void fail(const std::string& name, size_t line, const std::string& what)
+{
+    throw std::runtime_error(name + ":" + std::to_string(line) + ": " + what);
+}
+
+void setNode(Instance& instance, long id, double x, double y, bool fixedSize,
+    const std::string& name, size_t lineNo)
+{
+    if (id < 1 || (fixedSize && id > instance.size()))
+        fail(name, lineNo, "node id " + std::to_string(id) + " out of range");
+    if (!fixedSize && id > instance.size()) {
+        instance.x.resize(id);
+        instance.y.resize(id);
+    }
+    instance.x[id - 1] = x;
+    instance.y[id - 1] = y;
+}
+
+Instance parseTsplib(std::string_view data, const std::string& name)
+{
+    enum class Section { Header, Coords, Demands, Depots, TimeWindows, ServiceTimes, Skip };
+
+    Instance instance;
+    instance.name = name;
+    Section section = Section::Header;
+    bool fixedSize = false;
+    bool sawCoords = false;
+
+    LineReader reader{ data };
+    std::string_view line;
+    size_t lineNo = 0;
+    while (reader.nextLine(line)) {
+        ++lineNo;
+        line = trim(line);
+        if (line.empty()) continue;
+
+        // Keywords start with a letter; anything else is section data.
+        bool keyword = (line.front() >= 'A' && line.front() <= 'Z') || (line.front() >= 'a' && line.front() <= 'z');
+        if (keyword) {
+            if (line.starts_with("EOF")) break;
+            if (line.starts_with("NODE_COORD_SECTION")) { section = Section::Coords; sawCoords = true; continue; }
+            if (line.starts_with("DEMAND_SECTION")) { section = Section::Demands; continue; }
+            if (line.starts_with("DEPOT_SECTION")) { section = Section::Depots; continue; }
+            if (line.starts_with("TIME_WINDOW_SECTION")) { section = Section::TimeWindows; continue; }
+            if (line.starts_with("SERVICE_TIME_SECTION")) { section = Section::ServiceTimes; continue; }
+            if (line.find("_SECTION") != std::string_view::npos) { section = Section::Skip; continue; }
+
+            section = Section::Header;
+            size_t colon = line.find(':');
+            if (colon == std::string_view::npos) continue;
+            std::string_view key = trim(line.substr(0, colon));
+            std::string_view value = trim(line.substr(colon + 1));
+
+            if (key == "NAME") {
+                instance.name = std::string(value);
+            }
+            else if (key == "DIMENSION") {
+                long n = 0;
+                if (!parseNumber(value, n) || n < 0) fail(name, lineNo, "invalid DIMENSION");
+                instance.x.assign(n, 0.0);
+                instance.y.assign(n, 0.0);
+                fixedSize = true;
+            }
+            else if (key == "CAPACITY") {
+                if (!parseNumber(value, instance.capacity)) fail(name, lineNo, "invalid CAPACITY");
+            }
+            continue;
+        }
+
+        long id = 0;
+        switch (section) {
+        case Section::Coords: {
+            double x = 0.0, y = 0.0;
+            if (!parseNumber(line, id) || !parseNumber(line, x) || !parseNumber(line, y))
+                fail(name, lineNo, "expected: id x y");
+            setNode(instance, id, x, y, fixedSize, name, lineNo);
+            break;
+        }
+        case Section::Demands: {
+            double d = 0.0;
+            if (!parseNumber(line, id) || !parseNumber(line, d))
+                fail(name, lineNo, "expected: id demand");
+            if (id < 1 || id > instance.size()) fail(name, lineNo, "demand for unknown node");
+            if (instance.demand.empty()) instance.demand.assign(instance.size(), 0.0);
+            instance.demand[id - 1] = d;
+            break;
+        }
+        case Section::TimeWindows: {
+            double ready = 0.0, due = 0.0;
+            if (!parseNumber(line, id) || !parseNumber(line, ready) || !parseNumber(line, due))
+                fail(name, lineNo, "expected: id ready due");
+            if (id < 1 || id > instance.size()) fail(name, lineNo, "time window for unknown node");
+            if (instance.readyTime.empty()) {
+                instance.readyTime.assign(instance.size(), -std::numeric_limits<double>::infinity());
+                instance.dueTime.assign(instance.size(), std::numeric_limits<double>::infinity());
+            }
+            instance.readyTime[id - 1] = ready;
+            instance.dueTime[id - 1] = due;
+            break;
+        }
+        case Section::ServiceTimes: {
+            double service = 0.0;
+            if (!parseNumber(line, id) || !parseNumber(line, service))
+                fail(name, lineNo, "expected: id service");
+            if (id < 1 || id > instance.size()) fail(name, lineNo, "service time for unknown node");
+            if (instance.serviceTime.empty()) instance.serviceTime.assign(instance.size(), 0.0);
+            instance.serviceTime[id - 1] = service;
+            break;
+        }
+        case Section::Depots:
+            while (parseNumber(line, id)) {
+                if (id == -1) break;
+                if (id < 1 || id > instance.size()) fail(name, lineNo, "unknown depot node");
+                instance.depots.push_back((int)id - 1);
+            }
+            break;
+        case Section::Header:
+        case Section::Skip:
+            break;
+        }
+    }
+
+    if (!sawCoords) throw std::runtime_error(name + ": no NODE_COORD_SECTION (explicit weights are not supported)");
+    return instance;
+}
+
+Instance parseCsv(std::string_view data, const std::string& name)
+{
+    Instance instance;
+    instance.name = name;
+
+    LineReader reader{ data };
+    std::string_view line;
+    size_t lineNo = 0;
+    bool withDemand = false;
+    while (reader.nextLine(line)) {
+        ++lineNo;
+        line = trim(line);
+        if (line.empty() || line.front() == '#') continue;
+
+        double x = 0.0, y = 0.0, d = 0.0;
+        std::string_view fields = line;
+        if (!parseNumber(fields, x)) {
+            // A non-numeric first line is a column header.
+            if (instance.size() == 0) continue;
+            fail(name, lineNo, "expected: x, y[, demand]");
+        }
+        if (!parseNumber(fields, y)) fail(name, lineNo, "expected: x, y[, demand]");
+
+        bool hasDemand = parseNumber(fields, d);
+        if (instance.size() == 0) withDemand = hasDemand;
+        else if (hasDemand != withDemand) fail(name, lineNo, "inconsistent number of columns");
+
+        instance.x.push_back(x);
+        instance.y.push_back(y);
+        if (withDemand) instance.demand.push_back(d);
+    }
+    return instance;
+}
+
+Instance parseBinary(std::string_view data, const std::string& name)
+{
+    BinaryHeader header;
+    if (data.size() < sizeof(header)) throw std::runtime_error(name + ": truncated binary header");
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (std::memcmp(header.magic, binaryMagic, 4) != 0) throw std::runtime_error(name + ": not a binary instance");
+
+    bool withDemand = header.flags & 1u;
+    std::uint64_t n = header.nodes;
+    std::uint64_t arrays = withDemand ? 3 : 2;
+    std::uint64_t need = sizeof(header) + n * arrays * sizeof(double) + header.depots * sizeof(std::int32_t);
+    if (n > data.size() || header.depots > data.size() || data.size() < need)
+        throw std::runtime_error(name + ": truncated binary instance");
+
+    Instance instance;
+    instance.name = name;
+    instance.capacity = header.capacity;
+
+    const char* cursor = data.data() + sizeof(header);
+    auto readArray = [&](std::vector<double>& out) {
+        out.resize(n);
+        std::memcpy(out.data(), cursor, n * sizeof(double));
+        cursor += n * sizeof(double);
+    };
+    readArray(instance.x);
+    readArray(instance.y);
+    if (withDemand) readArray(instance.demand);
+
+    instance.depots.resize(header.depots);
+    for (auto& depot : instance.depots) {
+        std::int32_t value;
+        std::memcpy(&value, cursor, sizeof(value));
+        cursor += sizeof(value);
+        if (value < 0 || (std::uint64_t)value >= n) throw std::runtime_error(name + ": depot index out of range");
+        depot = value;
+    }
+    return instance;
+}
+
+std::string lowerExtension(const std::string& path)
+{
+    size_t dot = path.find_last_of('.');
+    size_t slash = path.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) return "";
+    std::string ext = path.substr(dot + 1);
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+    return ext;
+}
+
+} // namespace
+
+std::vector<Point> Instance::points() const
+{
+    std::vector<Point> out(x.size());
+    for (size_t i = 0; i < x.size(); ++i)
+        out[i] = { x[i], y[i] };
+    return out;
+}
+
+MappedFile::MappedFile(const std::string& path)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) throw std::runtime_error("cannot open " + path);
+    file_ = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        throw std::runtime_error("cannot stat " + path);
+    }
+    size_ = (std::size_t)size.QuadPart;
+    if (size_ == 0) return;
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        CloseHandle(file);
+        throw std::runtime_error("cannot map " + path);
+    }
+    mapping_ = mapping;
+    data_ = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (data_ == nullptr) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        throw std::runtime_error("cannot map " + path);
+    }
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("cannot open " + path);
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("cannot stat " + path);
+    }
+    size_ = (std::size_t)st.st_size;
+    if (size_ > 0) {
+        void* data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("cannot map " + path);
+        }
+        ::madvise(data, size_, MADV_SEQUENTIAL);
+        data_ = (const char*)data;
+    }
+    // The mapping stays valid after the descriptor is closed.
+    ::close(fd);
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+    if (data_ != nullptr) UnmapViewOfFile(data_);
+    if (mapping_ != nullptr) CloseHandle((HANDLE)mapping_);
+    if (file_ != nullptr) CloseHandle((HANDLE)file_);
+#else
+    if (data_ != nullptr) ::munmap((void*)data_, size_);
+#endif
+}
+
+Instance parseInstance(std::string_view data, InstanceFormat format, const std::string& name)
+{
+    if (format == InstanceFormat::Auto) {
+        if (data.size() >= 4 && std::memcmp(data.data(), binaryMagic, 4) == 0) format = InstanceFormat::Binary;
+        else if (data.find("NODE_COORD_SECTION") != std::string_view::npos) format = InstanceFormat::Tsplib;
+        else format = InstanceFormat::Csv;
+    }
+
+    Instance instance;
+    switch (format) {
+    case InstanceFormat::Binary: instance = parseBinary(data, name); break;
+    case InstanceFormat::Tsplib: instance = parseTsplib(data, name); break;
+    default: instance = parseCsv(data, name); break;
+    }
+
+    validateUniquePoints(instance);
+    return instance;
+}
+
+Instance loadInstance(const std::string& path, InstanceFormat format)
+{
+    if (format == InstanceFormat::Auto) {
+        std::string ext = lowerExtension(path);
+        if (ext == "vrp" || ext == "tsp") format = InstanceFormat::Tsplib;
+        else if (ext == "csv" || ext == "txt") format = InstanceFormat::Csv;
+        else if (ext == "cwb") format = InstanceFormat::Binary;
+    }
+
+    MappedFile file(path);
+    return parseInstance(file.view(), format, path);
+}
+
+void saveBinaryInstance(const Instance& instance, const std::string& path)
+{
+    std::ofstream out(path, std::ios::binary);
+    if (!out) throw std::runtime_error("cannot write " + path);
+
+    BinaryHeader header;
+    std::memcpy(header.magic, binaryMagic, 4);
+    header.flags = instance.demand.empty() ? 0u : 1u;
+    header.nodes = instance.x.size();
+    header.depots = instance.depots.size();
+    header.capacity = instance.capacity;
+    out.write((const char*)&header, sizeof(header));
+
+    out.write((const char*)instance.x.data(), instance.x.size() * sizeof(double));
+    out.write((const char*)instance.y.data(), instance.y.size() * sizeof(double));
+    if (!instance.demand.empty())
+        out.write((const char*)instance.demand.data(), instance.demand.size() * sizeof(double));
+    for (int depot : instance.depots) {
+        std::int32_t value = depot;
+        out.write((const char*)&value, sizeof(value));
+    }
+    if (!out) throw std::runtime_error("cannot write " + path);
+}
+
+void validateUniquePoints(const Instance& instance)
+{
+    struct KeyHash
+    {
+        size_t operator()(const std::pair<std::uint64_t, std::uint64_t>& k) const
+        {
+            std::uint64_t h = k.first * 0x9E3779B97F4A7C15ull ^ (k.second + 0x7F4A7C159E3779B9ull + (k.first << 6));
+            return (size_t)(h ^ (h >> 29));
+        }
+    };
+
+    std::unordered_map<std::pair<std::uint64_t, std::uint64_t>, int, KeyHash> seen;
+    seen.reserve(instance.x.size());
+    for (int i = 0; i < instance.size(); ++i) {
+        // +0.0 and -0.0 are the same location.
+        double x = instance.x[i] == 0.0 ? 0.0 : instance.x[i];
+        double y = instance.y[i] == 0.0 ? 0.0 : instance.y[i];
+        auto [it, inserted] = seen.emplace(std::make_pair(std::bit_cast<std::uint64_t>(x), std::bit_cast<std::uint64_t>(y)), i);
+        if (!inserted) {
+            throw std::runtime_error(instance.name + ": nodes " + std::to_string(it->second) + " and "
+                + std::to_string(i) + " have the same coordinates");
+        }
+    }
+}
@@ -0,0 +1,278 @@
+#include "common/instrumentation.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+namespace {
+
+thread_local std::uint64_t allocatedBytes = 0;
+
+// Instrumentation's own bookkeeping must not be charged to the stage being timed.
+thread_local bool recording = false;
+
+int threadIndex()
+{
+    static std::atomic<int> next{ 0 };
+    thread_local int index = next.fetch_add(1);
+    return index;
+}
+
+void writeFile(const std::string& path, const std::string& contents)
+{
+    std::ofstream out(path, std::ios::binary);
+    if (!out) throw std::runtime_error("Cannot open " + path + " for writing");
+    out << contents;
+    if (!out) throw std::runtime_error("Failed to write " + path);
+}
+
+std::string escape(const std::string& s)
+{
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+} // namespace
+
+#if CW_INSTRUMENTATION
+
+namespace {
+
+void* countedAllocate(std::size_t size)
+{
+    if (!recording) allocatedBytes += size;
+    void* p = std::malloc(size == 0 ? 1 : size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+// Blocks from here must be released with alignedFree(): MSVC's CRT has no aligned_alloc, and
+// its _aligned_malloc blocks cannot be passed to free().
+void* countedAllocateAligned(std::size_t size, std::size_t alignment)
+{
+    if (!recording) allocatedBytes += size;
+    if (size == 0) size = 1;
+#ifdef _MSC_VER
+    void* p = _aligned_malloc(size, alignment);
+#else
+    // aligned_alloc wants a size that is a multiple of the alignment
+    void* p = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void alignedFree(void* p)
+{
+#ifdef _MSC_VER
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+} // namespace
+
+// Every form of the global operator new must be replaced, otherwise memory from the library
+// versions would reach the free() below. The align_val_t forms allocate through
+// countedAllocateAligned() and release through alignedFree(), all others use malloc() and
+// free(). GCC warns that free() does not match the new expressions inlined into these
+// deletes; the pairing is correct, since every new above allocates through these helpers.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size) { return countedAllocate(size); }
+void* operator new[](std::size_t size) { return countedAllocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return countedAllocateAligned(size, (std::size_t)alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return countedAllocateAligned(size, (std::size_t)alignment); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return countedAllocate(size); }
+    catch (const std::bad_alloc&) { return nullptr; }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return countedAllocate(size); }
+    catch (const std::bad_alloc&) { return nullptr; }
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    try { return countedAllocateAligned(size, (std::size_t)alignment); }
+    catch (const std::bad_alloc&) { return nullptr; }
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    try { return countedAllocateAligned(size, (std::size_t)alignment); }
+    catch (const std::bad_alloc&) { return nullptr; }
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { alignedFree(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { alignedFree(p); }
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif
+
+const char* counterName(Counter counter)
+{
+    switch (counter) {
+    case Counter::Attempts: return "attempts";
+    case Counter::Merges: return "merges";
+    case Counter::RejectedSavings: return "rejected_savings";
+    case Counter::FallbackPaths: return "fallback_paths";
+    case Counter::DiversityRejections: return "diversity_rejections";
+    case Counter::UsedNodesResets: return "used_nodes_resets";
+    case Counter::ArenaGrowth: return "arena_growth";
+    case Counter::Count: break;
+    }
+    return "unknown";
+}
+
+Instrumentation::Instrumentation()
+    : epoch_(std::chrono::steady_clock::now())
+{
+}
+
+Instrumentation& Instrumentation::instance()
+{
+    static Instrumentation instrumentation;
+    return instrumentation;
+}
+
+std::int64_t Instrumentation::now() const
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch_).count();
+}
+
+std::uint64_t Instrumentation::threadAllocatedBytes()
+{
+    return allocatedBytes;
+}
+
+void Instrumentation::record(const char* stage, std::int64_t startNs, std::int64_t durationNs, std::uint64_t bytes)
+{
+    int thread = threadIndex();
+    recording = true;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (events_.size() < maxEvents) events_.push_back({ stage, startNs, durationNs, bytes, thread });
+        else ++droppedEvents_;
+
+        auto& totals = stages_[stage];
+        ++totals.calls;
+        totals.totalNs += durationNs;
+        totals.maxNs = std::max(totals.maxNs, durationNs);
+        totals.bytes += bytes;
+    }
+    recording = false;
+}
+
+void Instrumentation::reset()
+{
+    for (auto& counter : counters_) counter.store(0, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    events_.clear();
+    stages_.clear();
+    droppedEvents_ = 0;
+}
+
+std::uint64_t Instrumentation::stageCalls(const std::string& stage) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = stages_.find(stage);
+    return it == stages_.end() ? 0 : it->second.calls;
+}
+
+std::uint64_t Instrumentation::stageBytes(const std::string& stage) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = stages_.find(stage);
+    return it == stages_.end() ? 0 : it->second.bytes;
+}
+
+std::string Instrumentation::reportJson() const
+{
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    out << "{\n  \"counters\": {";
+    for (int c = 0; c < (int)Counter::Count; ++c) {
+        out << (c ? "," : "") << "\n    \"" << counterName((Counter)c) << "\": " << count((Counter)c);
+    }
+    out << "\n  },\n  \"stages\": [";
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool first = true;
+    for (const auto& [name, totals] : stages_) {
+        out << (first ? "" : ",") << "\n    { \"name\": \"" << escape(name) << "\""
+            << ", \"calls\": " << totals.calls
+            << ", \"total_ms\": " << totals.totalNs / 1e6
+            << ", \"max_ms\": " << totals.maxNs / 1e6
+            << ", \"bytes\": " << totals.bytes << " }";
+        first = false;
+    }
+    out << "\n  ],\n  \"dropped_events\": " << droppedEvents_ << "\n}\n";
+    return out.str();
+}
+
+void Instrumentation::writeReport(const std::string& path) const
+{
+    writeFile(path, reportJson());
+}
+
+void Instrumentation::writeChromeTrace(const std::string& path) const
+{
+    // Complete ("X") events with microsecond timestamps, one track per thread
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    out << "{\"traceEvents\":[\n";
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::int64_t last = 0;
+    for (const auto& e : events_) {
+        out << "{\"name\":\"" << escape(e.stage) << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.thread
+            << ",\"ts\":" << e.start / 1e3 << ",\"dur\":" << e.duration / 1e3
+            << ",\"args\":{\"bytes\":" << e.bytes << "}},\n";
+        last = std::max(last, e.start + e.duration);
+    }
+
+    // Final counter values as one counter event
+    out << "{\"name\":\"counters\",\"ph\":\"C\",\"pid\":1,\"tid\":0,\"ts\":" << last / 1e3 << ",\"args\":{";
+    for (int c = 0; c < (int)Counter::Count; ++c) {
+        out << (c ? "," : "") << "\"" << counterName((Counter)c) << "\":" << count((Counter)c);
+    }
+    out << "}}\n]}\n";
+
+    writeFile(path, out.str());
+}
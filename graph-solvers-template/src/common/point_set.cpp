@@ -0,0 +1,465 @@
+#include "common/point_set.h"
+
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define CW_SIMD_X86 1
+#define CW_TARGET(isa) __attribute__((target(isa)))
+#elif defined(_MSC_VER) && defined(_M_X64)
+#define CW_SIMD_X86 1
+#define CW_TARGET(isa)
+#else
+#define CW_SIMD_X86 0
+#endif
+
+#if CW_SIMD_X86
+#include <immintrin.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define CW_NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+#define CW_NOINLINE __declspec(noinline)
+#else
+#define CW_NOINLINE
+#endif
+
+#if defined(__GNUC__) && !defined(__clang__)
+// GCC 12 flags the deliberately undefined pass-through operands inside its AVX-512 intrinsics
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+namespace {
+
+// The vector kernels read an Edge as {u, v} in the low and the cost in the high 8 bytes
+static_assert(sizeof(Edge) == 16 && offsetof(Edge, v) == 4 && offsetof(Edge, cost) == 8);
+
+// === Scalar kernels (also the tails of the vector loops) ===
+//
+// The distance kernels stay out of line: inlined into an avx512f function, they would be
+// compiled for that target, where -ffp-contract=fast (GCC's default) fuses dx * dx + dy * dy
+// into an FMA and the tail would no longer match euclidean().
+
+template <class T>
+CW_NOINLINE void rowScalar(const T* xs, const T* ys, int begin, int end, T fx, T fy, double* out)
+{
+    for (int j = begin; j < end; ++j) {
+        T dx = xs[j] - fx;
+        T dy = ys[j] - fy;
+        out[j] = std::sqrt(dx * dx + dy * dy);
+    }
+}
+
+template <class T>
+CW_NOINLINE void gatherScalar(const T* xs, const T* ys, const int* to, int begin, int end, T fx, T fy, double* out)
+{
+    for (int k = begin; k < end; ++k) {
+        T dx = xs[to[k]] - fx;
+        T dy = ys[to[k]] - fy;
+        out[k] = std::sqrt(dx * dx + dy * dy);
+    }
+}
+
+template <class T>
+CW_NOINLINE void edgesScalar(const T* xs, const T* ys, const Edge* edges, int begin, int end, double* out)
+{
+    for (int k = begin; k < end; ++k) {
+        T dx = xs[edges[k].u] - xs[edges[k].v];
+        T dy = ys[edges[k].u] - ys[edges[k].v];
+        out[k] = std::sqrt(dx * dx + dy * dy);
+    }
+}
+
+void savingsScalar(const double* depot, const Edge* edges, int begin, int end, double* out)
+{
+    for (int k = begin; k < end; ++k)
+        out[k] = depot[edges[k].u] + depot[edges[k].v] - edges[k].cost;
+}
+
+#if CW_SIMD_X86
+
+// === AVX2 ===
+
+// Splits four consecutive edges into their u, v and cost lanes without gathers
+CW_TARGET("avx2")
+inline void loadEdges4(const Edge* edges, __m128i& u, __m128i& v, __m256d& cost)
+{
+    __m256i a = _mm256_loadu_si256((const __m256i*)edges);        // e0 | e1
+    __m256i b = _mm256_loadu_si256((const __m256i*)(edges + 2));  // e2 | e3
+    __m256i uv = _mm256_permutevar8x32_epi32(_mm256_unpacklo_epi64(a, b), _mm256_setr_epi32(0, 4, 2, 6, 1, 5, 3, 7));
+    u = _mm256_castsi256_si128(uv);
+    v = _mm256_extracti128_si256(uv, 1);
+    cost = _mm256_permute4x64_pd(_mm256_castsi256_pd(_mm256_unpackhi_epi64(a, b)), 0xd8);
+}
+
+CW_TARGET("avx2")
+inline __m256d hypot4(__m256d dx, __m256d dy)
+{
+    return _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)));
+}
+
+CW_TARGET("avx2")
+inline void storeWidened8(double* out, __m256 values)
+{
+    _mm256_storeu_pd(out, _mm256_cvtps_pd(_mm256_castps256_ps128(values)));
+    _mm256_storeu_pd(out + 4, _mm256_cvtps_pd(_mm256_extractf128_ps(values, 1)));
+}
+
+CW_TARGET("avx2")
+inline __m256 hypot8(__m256 dx, __m256 dy)
+{
+    return _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)));
+}
+
+CW_TARGET("avx2")
+void rowAvx2(const double* xs, const double* ys, int n, double fx, double fy, double* out)
+{
+    const __m256d vx = _mm256_set1_pd(fx), vy = _mm256_set1_pd(fy);
+    int j = 0;
+    for (; j + 4 <= n; j += 4) {
+        __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(xs + j), vx);
+        __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(ys + j), vy);
+        _mm256_storeu_pd(out + j, hypot4(dx, dy));
+    }
+    rowScalar(xs, ys, j, n, fx, fy, out);
+}
+
+CW_TARGET("avx2")
+void rowAvx2(const float* xs, const float* ys, int n, float fx, float fy, double* out)
+{
+    const __m256 vx = _mm256_set1_ps(fx), vy = _mm256_set1_ps(fy);
+    int j = 0;
+    for (; j + 8 <= n; j += 8) {
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(xs + j), vx);
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(ys + j), vy);
+        storeWidened8(out + j, hypot8(dx, dy));
+    }
+    rowScalar(xs, ys, j, n, fx, fy, out);
+}
+
+CW_TARGET("avx2")
+void gatherAvx2(const double* xs, const double* ys, const int* to, int n, double fx, double fy, double* out)
+{
+    const __m256d vx = _mm256_set1_pd(fx), vy = _mm256_set1_pd(fy);
+    int k = 0;
+    for (; k + 4 <= n; k += 4) {
+        __m128i idx = _mm_loadu_si128((const __m128i*)(to + k));
+        __m256d dx = _mm256_sub_pd(_mm256_i32gather_pd(xs, idx, 8), vx);
+        __m256d dy = _mm256_sub_pd(_mm256_i32gather_pd(ys, idx, 8), vy);
+        _mm256_storeu_pd(out + k, hypot4(dx, dy));
+    }
+    gatherScalar(xs, ys, to, k, n, fx, fy, out);
+}
+
+CW_TARGET("avx2")
+void gatherAvx2(const float* xs, const float* ys, const int* to, int n, float fx, float fy, double* out)
+{
+    const __m256 vx = _mm256_set1_ps(fx), vy = _mm256_set1_ps(fy);
+    int k = 0;
+    for (; k + 8 <= n; k += 8) {
+        __m256i idx = _mm256_loadu_si256((const __m256i*)(to + k));
+        __m256 dx = _mm256_sub_ps(_mm256_i32gather_ps(xs, idx, 4), vx);
+        __m256 dy = _mm256_sub_ps(_mm256_i32gather_ps(ys, idx, 4), vy);
+        storeWidened8(out + k, hypot8(dx, dy));
+    }
+    gatherScalar(xs, ys, to, k, n, fx, fy, out);
+}
+
+CW_TARGET("avx2")
+void edgesAvx2(const double* xs, const double* ys, const Edge* edges, int n, double* out)
+{
+    int k = 0;
+    for (; k + 4 <= n; k += 4) {
+        __m128i u, v;
+        __m256d cost;
+        loadEdges4(edges + k, u, v, cost);
+        __m256d dx = _mm256_sub_pd(_mm256_i32gather_pd(xs, u, 8), _mm256_i32gather_pd(xs, v, 8));
+        __m256d dy = _mm256_sub_pd(_mm256_i32gather_pd(ys, u, 8), _mm256_i32gather_pd(ys, v, 8));
+        _mm256_storeu_pd(out + k, hypot4(dx, dy));
+    }
+    edgesScalar(xs, ys, edges, k, n, out);
+}
+
+CW_TARGET("avx2")
+void edgesAvx2(const float* xs, const float* ys, const Edge* edges, int n, double* out)
+{
+    int k = 0;
+    for (; k + 8 <= n; k += 8) {
+        __m128i u0, v0, u1, v1;
+        __m256d cost;
+        loadEdges4(edges + k, u0, v0, cost);
+        loadEdges4(edges + k + 4, u1, v1, cost);
+        __m256i u = _mm256_set_m128i(u1, u0), v = _mm256_set_m128i(v1, v0);
+        __m256 dx = _mm256_sub_ps(_mm256_i32gather_ps(xs, u, 4), _mm256_i32gather_ps(xs, v, 4));
+        __m256 dy = _mm256_sub_ps(_mm256_i32gather_ps(ys, u, 4), _mm256_i32gather_ps(ys, v, 4));
+        storeWidened8(out + k, hypot8(dx, dy));
+    }
+    edgesScalar(xs, ys, edges, k, n, out);
+}
+
+CW_TARGET("avx2")
+void savingsAvx2(const double* depot, const Edge* edges, int n, double* out)
+{
+    int k = 0;
+    for (; k + 4 <= n; k += 4) {
+        __m128i u, v;
+        __m256d cost;
+        loadEdges4(edges + k, u, v, cost);
+        __m256d sum = _mm256_add_pd(_mm256_i32gather_pd(depot, u, 8), _mm256_i32gather_pd(depot, v, 8));
+        _mm256_storeu_pd(out + k, _mm256_sub_pd(sum, cost));
+    }
+    savingsScalar(depot, edges, k, n, out);
+}
+
+// === AVX-512 ===
+//
+// Arithmetic goes through the explicit-rounding intrinsics: AVX-512F has fused multiply-add,
+// and the compiler may not contract these into it, so the results match the scalar kernels.
+// The scalar tails are not inlined here for the same reason (see above).
+
+#define CW_RN (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)
+
+CW_TARGET("avx512f")
+inline void loadEdges8(const Edge* edges, __m256i& u, __m256i& v, __m512d& cost)
+{
+    __m512i a = _mm512_loadu_si512(edges);      // e0 .. e3
+    __m512i b = _mm512_loadu_si512(edges + 4);  // e4 .. e7
+    __m512i uv = _mm512_permutexvar_epi32(
+        _mm512_setr_epi32(0, 4, 8, 12, 2, 6, 10, 14, 1, 5, 9, 13, 3, 7, 11, 15), _mm512_unpacklo_epi64(a, b));
+    u = _mm512_castsi512_si256(uv);
+    v = _mm512_extracti64x4_epi64(uv, 1);
+    cost = _mm512_permutexvar_pd(_mm512_setr_epi64(0, 2, 4, 6, 1, 3, 5, 7),
+        _mm512_castsi512_pd(_mm512_unpackhi_epi64(a, b)));
+}
+
+CW_TARGET("avx512f")
+inline __m512d hypot8(__m512d dx, __m512d dy)
+{
+    return _mm512_sqrt_round_pd(
+        _mm512_add_round_pd(_mm512_mul_round_pd(dx, dx, CW_RN), _mm512_mul_round_pd(dy, dy, CW_RN), CW_RN), CW_RN);
+}
+
+CW_TARGET("avx512f")
+inline __m512 hypot16(__m512 dx, __m512 dy)
+{
+    return _mm512_sqrt_round_ps(
+        _mm512_add_round_ps(_mm512_mul_round_ps(dx, dx, CW_RN), _mm512_mul_round_ps(dy, dy, CW_RN), CW_RN), CW_RN);
+}
+
+CW_TARGET("avx512f")
+inline void storeWidened16(double* out, __m512 values)
+{
+    _mm512_storeu_pd(out, _mm512_cvtps_pd(_mm512_castps512_ps256(values)));
+    _mm512_storeu_pd(out + 8, _mm512_cvtps_pd(_mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(values), 1))));
+}
+
+CW_TARGET("avx512f")
+void rowAvx512(const double* xs, const double* ys, int n, double fx, double fy, double* out)
+{
+    const __m512d vx = _mm512_set1_pd(fx), vy = _mm512_set1_pd(fy);
+    int j = 0;
+    for (; j + 8 <= n; j += 8) {
+        __m512d dx = _mm512_sub_pd(_mm512_loadu_pd(xs + j), vx);
+        __m512d dy = _mm512_sub_pd(_mm512_loadu_pd(ys + j), vy);
+        _mm512_storeu_pd(out + j, hypot8(dx, dy));
+    }
+    rowScalar(xs, ys, j, n, fx, fy, out);
+}
+
+CW_TARGET("avx512f")
+void rowAvx512(const float* xs, const float* ys, int n, float fx, float fy, double* out)
+{
+    const __m512 vx = _mm512_set1_ps(fx), vy = _mm512_set1_ps(fy);
+    int j = 0;
+    for (; j + 16 <= n; j += 16) {
+        __m512 dx = _mm512_sub_ps(_mm512_loadu_ps(xs + j), vx);
+        __m512 dy = _mm512_sub_ps(_mm512_loadu_ps(ys + j), vy);
+        storeWidened16(out + j, hypot16(dx, dy));
+    }
+    rowScalar(xs, ys, j, n, fx, fy, out);
+}
+
+CW_TARGET("avx512f")
+void gatherAvx512(const double* xs, const double* ys, const int* to, int n, double fx, double fy, double* out)
+{
+    const __m512d vx = _mm512_set1_pd(fx), vy = _mm512_set1_pd(fy);
+    int k = 0;
+    for (; k + 8 <= n; k += 8) {
+        __m256i idx = _mm256_loadu_si256((const __m256i*)(to + k));
+        __m512d dx = _mm512_sub_pd(_mm512_i32gather_pd(idx, xs, 8), vx);
+        __m512d dy = _mm512_sub_pd(_mm512_i32gather_pd(idx, ys, 8), vy);
+        _mm512_storeu_pd(out + k, hypot8(dx, dy));
+    }
+    gatherScalar(xs, ys, to, k, n, fx, fy, out);
+}
+
+CW_TARGET("avx512f")
+void gatherAvx512(const float* xs, const float* ys, const int* to, int n, float fx, float fy, double* out)
+{
+    const __m512 vx = _mm512_set1_ps(fx), vy = _mm512_set1_ps(fy);
+    int k = 0;
+    for (; k + 16 <= n; k += 16) {
+        __m512i idx = _mm512_loadu_si512(to + k);
+        __m512 dx = _mm512_sub_ps(_mm512_i32gather_ps(idx, xs, 4), vx);
+        __m512 dy = _mm512_sub_ps(_mm512_i32gather_ps(idx, ys, 4), vy);
+        storeWidened16(out + k, hypot16(dx, dy));
+    }
+    gatherScalar(xs, ys, to, k, n, fx, fy, out);
+}
+
+CW_TARGET("avx512f")
+void edgesAvx512(const double* xs, const double* ys, const Edge* edges, int n, double* out)
+{
+    int k = 0;
+    for (; k + 8 <= n; k += 8) {
+        __m256i u, v;
+        __m512d cost;
+        loadEdges8(edges + k, u, v, cost);
+        __m512d dx = _mm512_sub_pd(_mm512_i32gather_pd(u, xs, 8), _mm512_i32gather_pd(v, xs, 8));
+        __m512d dy = _mm512_sub_pd(_mm512_i32gather_pd(u, ys, 8), _mm512_i32gather_pd(v, ys, 8));
+        _mm512_storeu_pd(out + k, hypot8(dx, dy));
+    }
+    edgesScalar(xs, ys, edges, k, n, out);
+}
+
+CW_TARGET("avx512f")
+void edgesAvx512(const float* xs, const float* ys, const Edge* edges, int n, double* out)
+{
+    int k = 0;
+    for (; k + 16 <= n; k += 16) {
+        __m256i u0, v0, u1, v1;
+        __m512d cost;
+        loadEdges8(edges + k, u0, v0, cost);
+        loadEdges8(edges + k + 8, u1, v1, cost);
+        __m512i u = _mm512_inserti64x4(_mm512_castsi256_si512(u0), u1, 1);
+        __m512i v = _mm512_inserti64x4(_mm512_castsi256_si512(v0), v1, 1);
+        __m512 dx = _mm512_sub_ps(_mm512_i32gather_ps(u, xs, 4), _mm512_i32gather_ps(v, xs, 4));
+        __m512 dy = _mm512_sub_ps(_mm512_i32gather_ps(u, ys, 4), _mm512_i32gather_ps(v, ys, 4));
+        storeWidened16(out + k, hypot16(dx, dy));
+    }
+    edgesScalar(xs, ys, edges, k, n, out);
+}
+
+CW_TARGET("avx512f")
+void savingsAvx512(const double* depot, const Edge* edges, int n, double* out)
+{
+    int k = 0;
+    for (; k + 8 <= n; k += 8) {
+        __m256i u, v;
+        __m512d cost;
+        loadEdges8(edges + k, u, v, cost);
+        __m512d sum = _mm512_add_pd(_mm512_i32gather_pd(u, depot, 8), _mm512_i32gather_pd(v, depot, 8));
+        _mm512_storeu_pd(out + k, _mm512_sub_pd(sum, cost));
+    }
+    savingsScalar(depot, edges, k, n, out);
+}
+
+#undef CW_RN
+
+#endif // CW_SIMD_X86
+
+// Calls f with the coordinate arrays of the stored precision
+template <class F>
+void withCoordinates(Precision precision, const std::vector<double>& xs, const std::vector<double>& ys,
+    const std::vector<float>& xf, const std::vector<float>& yf, F&& f)
+{
+    if (precision == Precision::Double) f(xs.data(), ys.data());
+    else f(xf.data(), yf.data());
+}
+
+} // namespace
+
+PointSet::PointSet(std::span<const Point> points, Precision precision)
+    : size_((int)points.size()), precision_(precision)
+{
+    auto fill = [&](auto& xs, auto& ys) {
+        xs.resize(points.size());
+        ys.resize(points.size());
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            xs[i] = points[i].x;
+            ys[i] = points[i].y;
+        }
+    };
+    if (precision == Precision::Double) fill(xs_, ys_);
+    else fill(xf_, yf_);
+}
+
+Point PointSet::operator[](int i) const
+{
+    if (precision_ == Precision::Double) return { xs_[i], ys_[i] };
+    return { xf_[i], yf_[i] };
+}
+
+double PointSet::distance(int i, int j) const
+{
+    if (precision_ == Precision::Double) {
+        double dx = xs_[i] - xs_[j];
+        double dy = ys_[i] - ys_[j];
+        return std::sqrt(dx * dx + dy * dy);
+    }
+    float dx = xf_[i] - xf_[j];
+    float dy = yf_[i] - yf_[j];
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+void PointSet::distancesFrom(const Point& origin, std::span<double> out) const
+{
+    withCoordinates(precision_, xs_, ys_, xf_, yf_, [&](auto* xs, auto* ys) {
+        using T = std::remove_const_t<std::remove_pointer_t<decltype(xs)>>;
+        T fx = (T)origin.x, fy = (T)origin.y;
+#if CW_SIMD_X86
+        switch (simdLevel()) {
+        case SimdLevel::Avx512: return rowAvx512(xs, ys, size_, fx, fy, out.data());
+        case SimdLevel::Avx2: return rowAvx2(xs, ys, size_, fx, fy, out.data());
+        default: break;
+        }
+#endif
+        rowScalar(xs, ys, 0, size_, fx, fy, out.data());
+    });
+}
+
+void PointSet::distancesFrom(int from, std::span<const int> to, std::span<double> out) const
+{
+    const int n = (int)to.size();
+    withCoordinates(precision_, xs_, ys_, xf_, yf_, [&](auto* xs, auto* ys) {
+        auto fx = xs[from], fy = ys[from];
+#if CW_SIMD_X86
+        switch (simdLevel()) {
+        case SimdLevel::Avx512: return gatherAvx512(xs, ys, to.data(), n, fx, fy, out.data());
+        case SimdLevel::Avx2: return gatherAvx2(xs, ys, to.data(), n, fx, fy, out.data());
+        default: break;
+        }
+#endif
+        gatherScalar(xs, ys, to.data(), 0, n, fx, fy, out.data());
+    });
+}
+
+void PointSet::edgeLengths(std::span<const Edge> edges, std::span<double> out) const
+{
+    const int n = (int)edges.size();
+    withCoordinates(precision_, xs_, ys_, xf_, yf_, [&](auto* xs, auto* ys) {
+#if CW_SIMD_X86
+        switch (simdLevel()) {
+        case SimdLevel::Avx512: return edgesAvx512(xs, ys, edges.data(), n, out.data());
+        case SimdLevel::Avx2: return edgesAvx2(xs, ys, edges.data(), n, out.data());
+        default: break;
+        }
+#endif
+        edgesScalar(xs, ys, edges.data(), 0, n, out.data());
+    });
+}
+
+void computeSavings(std::span<const double> depotDistances, std::span<const Edge> edges, std::span<double> out)
+{
+    const int n = (int)edges.size();
+#if CW_SIMD_X86
+    switch (simdLevel()) {
+    case SimdLevel::Avx512: return savingsAvx512(depotDistances.data(), edges.data(), n, out.data());
+    case SimdLevel::Avx2: return savingsAvx2(depotDistances.data(), edges.data(), n, out.data());
+    default: break;
+    }
+#endif
+    savingsScalar(depotDistances.data(), edges.data(), 0, n, out.data());
+}
@@ -0,0 +1,78 @@
+#include "common/radix_sort.h"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <vector>
+
+#include "common/thread_pool.h"
+
+namespace {
+
+constexpr int kRadixBits = 8;
+constexpr int kBuckets = 1 << kRadixBits;
+constexpr std::size_t kMinBlock = 1 << 16;  ///< Fewest keys per block before splitting pays off.
+
+using Histogram = std::array<std::size_t, kBuckets>;
+
+} // namespace
+
+void radixSort(std::span<std::uint64_t> keys, std::span<int> values, ThreadPool* pool)
+{
+    if (keys.size() != values.size()) throw std::invalid_argument("radixSort: keys and values differ in size");
+    const std::size_t n = keys.size();
+    if (n < 2) return;
+
+    int blocks = 1;
+    if (pool != nullptr) blocks = (int)std::clamp<std::size_t>(n / kMinBlock, 1, 4 * (std::size_t)pool->size());
+    auto blockBegin = [&](int b) { return n * b / blocks; };
+    auto forEachBlock = [&](const std::function<void(int)>& body) {
+        if (blocks == 1) body(0);
+        else pool->parallelFor(blocks, [&](int b, unsigned) { body(b); });
+    };
+
+    std::vector<std::uint64_t> keyBuffer(n);
+    std::vector<int> valueBuffer(n);
+    std::span<std::uint64_t> fromKeys = keys, toKeys = keyBuffer;
+    std::span<int> fromValues = values, toValues = valueBuffer;
+    std::vector<Histogram> counts(blocks);
+
+    for (int shift = 0; shift < 64; shift += kRadixBits) {
+        forEachBlock([&](int b) {
+            Histogram& count = counts[b];
+            count.fill(0);
+            for (std::size_t k = blockBegin(b); k < blockBegin(b + 1); ++k) ++count[(fromKeys[k] >> shift) & (kBuckets - 1)];
+        });
+
+        // Offsets bucket by bucket, block by block; skip the pass if one bucket holds every key
+        std::size_t offset = 0;
+        bool trivial = false;
+        for (int digit = 0; digit < kBuckets; ++digit) {
+            std::size_t total = 0;
+            for (int b = 0; b < blocks; ++b) total += counts[b][digit];
+            if (total == n) trivial = true;
+            for (int b = 0; b < blocks; ++b) {
+                std::size_t c = counts[b][digit];
+                counts[b][digit] = offset;
+                offset += c;
+            }
+        }
+        if (trivial) continue;
+
+        forEachBlock([&](int b) {
+            Histogram& next = counts[b];
+            for (std::size_t k = blockBegin(b); k < blockBegin(b + 1); ++k) {
+                std::size_t slot = next[(fromKeys[k] >> shift) & (kBuckets - 1)]++;
+                toKeys[slot] = fromKeys[k];
+                toValues[slot] = fromValues[k];
+            }
+        });
+        std::swap(fromKeys, toKeys);
+        std::swap(fromValues, toValues);
+    }
+
+    if (fromKeys.data() != keys.data()) {
+        std::copy(fromKeys.begin(), fromKeys.end(), keys.begin());
+        std::copy(fromValues.begin(), fromValues.end(), values.begin());
+    }
+}
@@ -0,0 +1,55 @@
+#include "common/random.h"
+
+#include <cstddef>
+
+namespace {
+
+constexpr std::size_t lanes = 8;
+
+} // namespace
+
+void CounterRng::fill(std::uint64_t first, std::span<double> out0, std::span<double> out1) const
+{
+    const std::size_t n = out0.size();
+    std::size_t i = 0;
+
+    // Philox rounds on 8 counters at once, kept in separate arrays per word so that every
+    // inner loop is a plain element-wise operation the compiler turns into SIMD code
+    for (; i + lanes <= n; i += lanes) {
+        std::uint32_t c0[lanes], c1[lanes], c2[lanes], c3[lanes];
+        for (std::size_t l = 0; l < lanes; ++l) {
+            std::uint64_t index = first + i + l;
+            c0[l] = (std::uint32_t)index;
+            c1[l] = (std::uint32_t)(index >> 32);
+            c2[l] = (std::uint32_t)stream_;
+            c3[l] = (std::uint32_t)(stream_ >> 32);
+        }
+        std::uint32_t k0 = key_[0], k1 = key_[1];
+        for (int round = 0; round < 10; ++round) {
+            if (round > 0) {
+                k0 += 0x9E3779B9u;
+                k1 += 0xBB67AE85u;
+            }
+            for (std::size_t l = 0; l < lanes; ++l) {
+                std::uint64_t p0 = (std::uint64_t)0xD2511F53u * c0[l];
+                std::uint64_t p1 = (std::uint64_t)0xCD9E8D57u * c2[l];
+                std::uint32_t n0 = (std::uint32_t)(p1 >> 32) ^ c1[l] ^ k0;
+                std::uint32_t n2 = (std::uint32_t)(p0 >> 32) ^ c3[l] ^ k1;
+                c1[l] = (std::uint32_t)p1;
+                c3[l] = (std::uint32_t)p0;
+                c0[l] = n0;
+                c2[l] = n2;
+            }
+        }
+        for (std::size_t l = 0; l < lanes; ++l) {
+            out0[i + l] = toUnit(c0[l], c1[l]);
+            out1[i + l] = toUnit(c2[l], c3[l]);
+        }
+    }
+
+    for (; i < n; ++i) {
+        auto u = uniform2(first + i);
+        out0[i] = u[0];
+        out1[i] = u[1];
+    }
+}
@@ -0,0 +1,84 @@
+#include "common/simd.h"
+
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace {
+
+SimdLevel queryCpu()
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    // The builtins also check that the OS enabled the wider register state
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return SimdLevel::Avx512;
+    if (__builtin_cpu_supports("avx2")) return SimdLevel::Avx2;
+    return SimdLevel::Scalar;
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return SimdLevel::Scalar;
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx) return SimdLevel::Scalar;
+
+    unsigned long long xcr0 = _xgetbv(0);
+    __cpuidex(info, 7, 0);
+    bool avx2 = (info[1] & (1 << 5)) != 0 && (xcr0 & 0x6) == 0x6;
+    bool avx512 = (info[1] & (1 << 16)) != 0 && (xcr0 & 0xe6) == 0xe6;
+    if (avx512) return SimdLevel::Avx512;
+    if (avx2) return SimdLevel::Avx2;
+    return SimdLevel::Scalar;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+std::atomic<int>& activeLevel()
+{
+    static std::atomic<int> level{ (int)detectSimdLevel() };
+    return level;
+}
+
+} // namespace
+
+SimdLevel detectSimdLevel()
+{
+    static const SimdLevel detected = queryCpu();
+    return detected;
+}
+
+SimdLevel simdLevel()
+{
+    return (SimdLevel)activeLevel().load(std::memory_order_relaxed);
+}
+
+void setSimdLevel(SimdLevel level)
+{
+    if ((int)level > (int)detectSimdLevel()) level = detectSimdLevel();
+    activeLevel().store((int)level, std::memory_order_relaxed);
+}
+
+const char* simdLevelName(SimdLevel level)
+{
+    switch (level) {
+    case SimdLevel::Avx2: return "avx2";
+    case SimdLevel::Avx512: return "avx512";
+    default: return "scalar";
+    }
+}
+
+SimdLevel parseSimdLevel(const char* name)
+{
+    for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::Avx2, SimdLevel::Avx512 }) {
+        if (std::strcmp(name, simdLevelName(level)) == 0) return level;
+    }
+    throw std::invalid_argument(std::string("unknown SIMD level: ") + name);
+}
@@ -0,0 +1,90 @@
+#include "common/thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+
+ThreadPool::ThreadPool(unsigned threads)
+{
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    if (threads <= 1) return;
+
+    workers_.reserve(threads);
+    for (unsigned w = 0; w < threads; ++w)
+        workers_.emplace_back([this, w] { workerLoop(w); });
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_)
+        worker.join();
+}
+
+void ThreadPool::workerLoop(unsigned worker)
+{
+    for (;;) {
+        std::function<void(unsigned)> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this] { return stopping_ || taskHead_ < tasks_.size(); });
+            if (taskHead_ == tasks_.size()) return;
+            task = std::move(tasks_[taskHead_++]);
+            if (taskHead_ == tasks_.size()) {
+                tasks_.clear();
+                taskHead_ = 0;
+            }
+        }
+        task(worker);
+    }
+}
+
+void ThreadPool::parallelFor(int count, const std::function<void(int, unsigned)>& body)
+{
+    if (count <= 0) return;
+
+    if (workers_.empty()) {
+        for (int i = 0; i < count; ++i)
+            body(i, 0);
+        return;
+    }
+
+    std::atomic<int> next{ 0 };
+    std::mutex doneMutex;
+    std::condition_variable done;
+    std::exception_ptr error;
+    unsigned running = std::min<unsigned>((unsigned)workers_.size(), (unsigned)count);
+    unsigned finished = 0;
+
+    auto drain = [&](unsigned worker) {
+        for (int i = next++; i < count; i = next++) {
+            try {
+                body(i, worker);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(doneMutex);
+                if (!error) error = std::current_exception();
+            }
+        }
+        std::lock_guard<std::mutex> lock(doneMutex);
+        if (++finished == running) done.notify_one();
+    };
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // drain outlives the tasks, since this call waits for all of them
+        for (unsigned t = 0; t < running; ++t)
+            tasks_.emplace_back(std::ref(drain));
+    }
+    wake_.notify_all();
+
+    std::unique_lock<std::mutex> lock(doneMutex);
+    done.wait(lock, [&] { return finished == running; });
+    if (error) std::rethrow_exception(error);
+}
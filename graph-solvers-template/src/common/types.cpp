@@ -4,6 +4,8 @@
 #include <random>
 #include <iostream>
 
+#include "common/random.h"
+
 bool Point::operator<(const Point& other) const
 {
     return (x < other.x) || (x == other.x && y < other.y);
@@ -16,18 +18,23 @@ double euclidean(const Point& a, const Point& b)
 
 std::vector<Point> generateUniquePoints(int n, double minX, double minY, double maxX, double maxY)
 {
-    std::set<Point> uniquePoints;
     std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<> distX(minX, maxX);
-    std::uniform_real_distribution<> distY(minY, maxY);
+    std::uint64_t seed = ((std::uint64_t)rd() << 32) | rd();
+    return generateUniquePoints(n, minX, minY, maxX, maxY, seed);
+}
+
+std::vector<Point> generateUniquePoints(int n, double minX, double minY, double maxX, double maxY, std::uint64_t seed)
+{
+    std::set<Point> uniquePoints;
+    CounterRng rng(seed);
 
     const int maxAttempts = n * 10;
     int attempts = 0;
 
     while (uniquePoints.size() < static_cast<size_t>(n) && attempts < maxAttempts)
     {
-        Point p = { distX(gen), distY(gen) };
+        auto u = rng.uniform2((std::uint64_t)attempts);
+        Point p = { minX + (maxX - minX) * u[0], minY + (maxY - minY) * u[1] };
         uniquePoints.insert(p);
         ++attempts;
     }
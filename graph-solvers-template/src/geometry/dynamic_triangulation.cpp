@@ -0,0 +1,466 @@
+#include "geometry/dynamic_triangulation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "common/random.h"
+
+namespace {
+
+/// Twice the signed area of abc; positive when the points turn counter-clockwise.
+double orient(const Point& a, const Point& b, const Point& c)
+{
+    return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+}
+
+/// Positive when d lies inside the circumcircle of the counter-clockwise triangle abc.
+double inCircle(const Point& a, const Point& b, const Point& c, const Point& d)
+{
+    double adx = a.x - d.x, ady = a.y - d.y;
+    double bdx = b.x - d.x, bdy = b.y - d.y;
+    double cdx = c.x - d.x, cdy = c.y - d.y;
+    return (adx * adx + ady * ady) * (bdx * cdy - cdx * bdy)
+        + (bdx * bdx + bdy * bdy) * (cdx * ady - adx * cdy)
+        + (cdx * cdx + cdy * cdy) * (adx * bdy - bdx * ady);
+}
+
+double distance2(const Point& a, const Point& b)
+{
+    double dx = a.x - b.x, dy = a.y - b.y;
+    return dx * dx + dy * dy;
+}
+
+/// Position of (x, y) on a Hilbert curve over a 2^16 x 2^16 grid.
+std::uint64_t hilbertIndex(std::uint32_t x, std::uint32_t y)
+{
+    constexpr std::uint32_t n = 1u << 16;
+    std::uint64_t d = 0;
+    for (std::uint32_t s = n / 2; s > 0; s /= 2) {
+        std::uint32_t rx = (x & s) > 0;
+        std::uint32_t ry = (y & s) > 0;
+        d += (std::uint64_t)s * s * ((3 * rx) ^ ry);
+        if (ry == 0) {
+            if (rx == 1) {
+                x = n - 1 - x;
+                y = n - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return d;
+}
+
+} // namespace
+
+DynamicTriangulation::DynamicTriangulation()
+{
+    points_.resize(superCount);
+    vertexTri_.resize(superCount);
+    reset(0.0, 0.0, 1.0, 1.0);
+}
+
+DynamicTriangulation::DynamicTriangulation(const std::vector<Point>& points)
+{
+    double minX = 0.0, minY = 0.0, maxX = 1.0, maxY = 1.0;
+    if (!points.empty()) {
+        minX = maxX = points[0].x;
+        minY = maxY = points[0].y;
+    }
+    for (const auto& p : points) {
+        if (!std::isfinite(p.x) || !std::isfinite(p.y))
+            throw std::invalid_argument("DynamicTriangulation: non-finite point");
+        minX = std::min(minX, p.x);
+        maxX = std::max(maxX, p.x);
+        minY = std::min(minY, p.y);
+        maxY = std::max(maxY, p.y);
+    }
+
+    points_.resize(superCount);
+    points_.insert(points_.end(), points.begin(), points.end());
+    vertexTri_.assign(points_.size(), -1);
+    reset(minX, minY, maxX, maxY);
+
+    std::vector<int> vertices(points.size());
+    for (int i = 0; i < (int)points.size(); ++i) vertices[i] = i + superCount;
+    insertOrdered(vertices);
+}
+
+void DynamicTriangulation::reset(double minX, double minY, double maxX, double maxY)
+{
+    // The super-triangle's incircle is 32 times wider than the region points may fall into,
+    // so its corners stay far from every circumcircle that matters
+    centreX_ = (minX + maxX) / 2;
+    centreY_ = (minY + maxY) / 2;
+    double half = std::max({ (maxX - minX) / 2, (maxY - minY) / 2, 0.5 });
+    reach_ = 4.0 * half;
+    double r = 128.0 * half;
+    points_[0] = { centreX_, centreY_ + r };
+    points_[1] = { centreX_ - r * std::sqrt(3.0) / 2, centreY_ - r / 2 };
+    points_[2] = { centreX_ + r * std::sqrt(3.0) / 2, centreY_ - r / 2 };
+
+    tris_.clear();
+    freeTris_.clear();
+    alive_ = 0;
+    lastVertex_ = -1;
+    int t = newTriangle(0, 1, 2);
+    for (int v = 0; v < superCount; ++v) vertexTri_[v] = t;
+}
+
+bool DynamicTriangulation::inside(const Point& p) const
+{
+    return std::abs(p.x - centreX_) <= reach_ && std::abs(p.y - centreY_) <= reach_;
+}
+
+void DynamicTriangulation::insertOrdered(const std::vector<int>& vertices)
+{
+    // Consecutive points along a Hilbert curve are close, so each walk starts next to its target
+    const double cell = 2.0 * reach_ / 65535.0;
+    std::vector<std::pair<std::uint64_t, int>> order;
+    order.reserve(vertices.size());
+    for (int v : vertices) {
+        auto gx = (std::uint32_t)std::clamp((points_[v].x - (centreX_ - reach_)) / cell, 0.0, 65535.0);
+        auto gy = (std::uint32_t)std::clamp((points_[v].y - (centreY_ - reach_)) / cell, 0.0, 65535.0);
+        order.push_back({ hilbertIndex(gx, gy), v });
+    }
+    std::sort(order.begin(), order.end());
+
+    int hint = 0;
+    for (const auto& [key, v] : order) {
+        int t = locate(points_[v], hint);
+        for (int u : tris_[t].v) {
+            if (points_[u].x == points_[v].x && points_[u].y == points_[v].y)
+                throw std::invalid_argument("DynamicTriangulation: duplicate point");
+        }
+        insertVertex(v, t, nullptr);
+        hint = v;
+    }
+}
+
+int DynamicTriangulation::insert(const Point& p, Delta& delta)
+{
+    delta.clear();
+    if (!std::isfinite(p.x) || !std::isfinite(p.y))
+        throw std::invalid_argument("DynamicTriangulation: non-finite point");
+
+    int vertex = (int)points_.size();
+    if (!inside(p)) {
+        // Every live point lies inside the region, so p cannot duplicate one
+        points_.push_back(p);
+        vertexTri_.push_back(-1);
+        rebuild(delta);
+        return vertex - superCount;
+    }
+
+    int t = locate(p, startVertex(p));
+    for (int u : tris_[t].v) {
+        if (points_[u].x == p.x && points_[u].y == p.y)
+            throw std::invalid_argument("DynamicTriangulation: duplicate point");
+    }
+    points_.push_back(p);
+    vertexTri_.push_back(-1);
+    insertVertex(vertex, t, &delta);
+    return vertex - superCount;
+}
+
+void DynamicTriangulation::rebuild(Delta& delta)
+{
+    // The newest point is not live yet, so it does not appear in the old edge set
+    auto before = edges();
+
+    std::vector<int> vertices;
+    const Point& added = points_.back();
+    double minX = added.x, maxX = added.x, minY = added.y, maxY = added.y;
+    for (int v = superCount; v < (int)points_.size(); ++v) {
+        if (vertexTri_[v] < 0 && v + 1 != (int)points_.size()) continue;
+        vertices.push_back(v);
+        minX = std::min(minX, points_[v].x);
+        maxX = std::max(maxX, points_[v].x);
+        minY = std::min(minY, points_[v].y);
+        maxY = std::max(maxY, points_[v].y);
+        vertexTri_[v] = -1;
+    }
+    reset(minX, minY, maxX, maxY);
+    insertOrdered(vertices);
+
+    auto after = edges();
+    std::set_difference(after.begin(), after.end(), before.begin(), before.end(), std::back_inserter(delta.added));
+    std::set_difference(before.begin(), before.end(), after.begin(), after.end(), std::back_inserter(delta.removed));
+    delta.rebuilt = true;
+}
+
+int DynamicTriangulation::startVertex(const Point& p)
+{
+    // Jump-and-walk: start from the closest of about n^(1/3) random vertices
+    int best = lastVertex_ >= 0 && vertexTri_[lastVertex_] >= 0 ? lastVertex_ : 0;
+    double bestDistance = distance2(points_[best], p);
+    if (alive_ == 0) return best;
+
+    const CounterRng rng(0x9E3779B97F4A7C15ull);
+    const int samples = (int)std::cbrt((double)alive_) + 1;
+    for (int s = 0; s < samples; ++s) {
+        int v = superCount + (int)(rng.bits(draws_++) % (std::uint64_t)idCount());
+        if (vertexTri_[v] < 0) continue;
+        double d = distance2(points_[v], p);
+        if (d < bestDistance) {
+            best = v;
+            bestDistance = d;
+        }
+    }
+    return best;
+}
+
+int DynamicTriangulation::locate(const Point& p, int hint) const
+{
+    // Visibility walk; the first side tested rotates so the walk cannot cycle between two triangles
+    int t = vertexTri_[hint];
+    const std::size_t limit = 4 * tris_.size() + 16;
+    for (std::size_t step = 0; step < limit; ++step) {
+        const Triangle& tr = tris_[t];
+        int next = -1;
+        for (int k = 0; k < 3; ++k) {
+            int i = (int)((k + step) % 3);
+            if (orient(points_[tr.v[(i + 1) % 3]], points_[tr.v[(i + 2) % 3]], p) < 0) {
+                next = tr.n[i];
+                break;
+            }
+        }
+        if (next < 0) return t;
+        t = next;
+    }
+
+    // Rounding left the triangulation slightly non-Delaunay; fall back to a scan
+    for (t = 0; t < (int)tris_.size(); ++t) {
+        const Triangle& tr = tris_[t];
+        if (tr.v[0] < 0) continue;
+        if (orient(points_[tr.v[0]], points_[tr.v[1]], p) >= 0 && orient(points_[tr.v[1]], points_[tr.v[2]], p) >= 0
+            && orient(points_[tr.v[2]], points_[tr.v[0]], p) >= 0)
+            return t;
+    }
+    throw std::logic_error("DynamicTriangulation: point not covered by any triangle");
+}
+
+void DynamicTriangulation::insertVertex(int vertex, int first, Delta* delta)
+{
+    const Point& p = points_[vertex];
+
+    // Cavity: the connected set of triangles whose circumcircle holds p
+    if (++stamp_ == 0) {
+        std::fill(mark_.begin(), mark_.end(), 0);
+        stamp_ = 1;
+    }
+    cavity_.assign(1, first);
+    mark_[first] = stamp_;
+    for (std::size_t k = 0; k < cavity_.size(); ++k) {
+        for (int u : tris_[cavity_[k]].n) {
+            if (u < 0 || mark_[u] == stamp_) continue;
+            const Triangle& o = tris_[u];
+            if (inCircle(points_[o.v[0]], points_[o.v[1]], points_[o.v[2]], p) > 0) {
+                mark_[u] = stamp_;
+                cavity_.push_back(u);
+            }
+        }
+    }
+
+    sides_.clear();
+    for (int c : cavity_) {
+        const Triangle& t = tris_[c];
+        for (int i = 0; i < 3; ++i) {
+            int a = t.v[(i + 1) % 3], b = t.v[(i + 2) % 3], u = t.n[i];
+            if (u >= 0 && mark_[u] == stamp_) {
+                if (delta != nullptr && c < u) record(delta->removed, a, b);
+            }
+            else {
+                sides_.push_back({ a, b, u });
+            }
+        }
+    }
+    for (int c : cavity_) freeTriangle(c);
+
+    // Fan from p to every side of the cavity border
+    fan_.clear();
+    for (const Side& s : sides_) {
+        int t = newTriangle(vertex, s.a, s.b);
+        tris_[t].n[0] = s.outer;
+        if (s.outer >= 0) link(s.outer, s.a, s.b, t);
+        vertexTri_[s.a] = t;
+        fan_.push_back({ s.a, t });
+        if (delta != nullptr) record(delta->added, vertex, s.a);
+    }
+    vertexTri_[vertex] = fan_.front().second;
+
+    // Triangle (p, a, b) meets (p, b, c) across the side p-b
+    std::sort(fan_.begin(), fan_.end());
+    for (const auto& [a, t] : fan_) {
+        int b = tris_[t].v[2];
+        int next = std::lower_bound(fan_.begin(), fan_.end(), std::pair<int, int>(b, -1))->second;
+        tris_[t].n[1] = next;
+        tris_[next].n[2] = t;
+    }
+
+    ++alive_;
+    lastVertex_ = vertex;
+}
+
+void DynamicTriangulation::remove(int id, Delta& delta)
+{
+    if (!contains(id))
+        throw std::invalid_argument("DynamicTriangulation: no live vertex with this id");
+    delta.clear();
+    const int vertex = id + superCount;
+
+    // Star of the vertex, counter-clockwise: ring vertex k and the triangle across side (k, k + 1)
+    sides_.clear();
+    cavity_.clear();
+    const int first = vertexTri_[vertex];
+    int t = first;
+    do {
+        const Triangle& tr = tris_[t];
+        int i = tr.v[0] == vertex ? 0 : tr.v[1] == vertex ? 1 : 2;
+        sides_.push_back({ tr.v[(i + 1) % 3], tr.v[(i + 2) % 3], tr.n[i] });
+        cavity_.push_back(t);
+        t = tr.n[(i + 1) % 3];
+    } while (t != first);
+
+    for (const Side& s : sides_) record(delta.removed, vertex, s.a);
+    for (int c : cavity_) freeTriangle(c);
+
+    // Clip ears whose circumcircle holds no other ring vertex; such an ear is a Delaunay triangle
+    auto attach = [&](int tri, int slot, int a, int b, int outer) {
+        tris_[tri].n[slot] = outer;
+        if (outer >= 0) link(outer, a, b, tri);
+    };
+    while (sides_.size() > 3) {
+        const int m = (int)sides_.size();
+        int ear = -1, fallback = -1;
+        for (int k = 0; k < m && ear < 0; ++k) {
+            const Point& a = points_[sides_[k].a];
+            const Point& b = points_[sides_[(k + 1) % m].a];
+            const Point& c = points_[sides_[(k + 2) % m].a];
+            if (orient(a, b, c) <= 0) continue;
+            if (fallback < 0) fallback = k;
+            bool empty = true;
+            for (int j = 3; j < m && empty; ++j)
+                empty = inCircle(a, b, c, points_[sides_[(k + j) % m].a]) <= 0;
+            if (empty) ear = k;
+        }
+        if (ear < 0) ear = fallback;
+        if (ear < 0)
+            throw std::logic_error("DynamicTriangulation: no ear in the star of a removed vertex");
+
+        int k1 = (ear + 1) % m, k2 = (ear + 2) % m;
+        int a = sides_[ear].a, b = sides_[k1].a, c = sides_[k2].a;
+        int tri = newTriangle(a, b, c);
+        attach(tri, 2, a, b, sides_[ear].outer);
+        attach(tri, 0, b, c, sides_[k1].outer);
+        vertexTri_[a] = vertexTri_[b] = vertexTri_[c] = tri;
+        record(delta.added, a, c);
+
+        // The ring continues along the new side a-c
+        sides_[ear].outer = tri;
+        sides_.erase(sides_.begin() + k1);
+    }
+
+    int a = sides_[0].a, b = sides_[1].a, c = sides_[2].a;
+    int tri = newTriangle(a, b, c);
+    attach(tri, 2, a, b, sides_[0].outer);
+    attach(tri, 0, b, c, sides_[1].outer);
+    attach(tri, 1, c, a, sides_[2].outer);
+    vertexTri_[a] = vertexTri_[b] = vertexTri_[c] = tri;
+
+    vertexTri_[vertex] = -1;
+    --alive_;
+}
+
+int DynamicTriangulation::newTriangle(int a, int b, int c)
+{
+    int t;
+    if (!freeTris_.empty()) {
+        t = freeTris_.back();
+        freeTris_.pop_back();
+    }
+    else {
+        t = (int)tris_.size();
+        tris_.emplace_back();
+        mark_.resize(tris_.size(), 0);
+    }
+    tris_[t] = { { a, b, c }, { -1, -1, -1 } };
+    mark_[t] = 0;
+    return t;
+}
+
+void DynamicTriangulation::freeTriangle(int t)
+{
+    tris_[t].v[0] = -1;
+    freeTris_.push_back(t);
+}
+
+int DynamicTriangulation::side(int t, int a, int b) const
+{
+    const auto& v = tris_[t].v;
+    for (int i = 0; i < 3; ++i) {
+        if (v[i] != a && v[i] != b) return i;
+    }
+    throw std::logic_error("DynamicTriangulation: side not found");
+}
+
+void DynamicTriangulation::link(int t, int a, int b, int other)
+{
+    tris_[t].n[side(t, a, b)] = other;
+}
+
+void DynamicTriangulation::record(std::vector<std::pair<int, int>>& out, int a, int b) const
+{
+    if (a < superCount || b < superCount) return;
+    a -= superCount;
+    b -= superCount;
+    out.push_back({ std::min(a, b), std::max(a, b) });
+}
+
+std::vector<std::pair<int, int>> DynamicTriangulation::edges() const
+{
+    std::vector<std::pair<int, int>> out;
+    for (int t = 0; t < (int)tris_.size(); ++t) {
+        const Triangle& tr = tris_[t];
+        if (tr.v[0] < 0) continue;
+        for (int i = 0; i < 3; ++i) {
+            if (tr.n[i] < 0 || t < tr.n[i]) record(out, tr.v[(i + 1) % 3], tr.v[(i + 2) % 3]);
+        }
+    }
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+std::vector<std::array<int, 3>> DynamicTriangulation::triangles() const
+{
+    std::vector<std::array<int, 3>> out;
+    for (const Triangle& tr : tris_) {
+        if (tr.v[0] < superCount || tr.v[1] < superCount || tr.v[2] < superCount) continue;
+        out.push_back({ tr.v[0] - superCount, tr.v[1] - superCount, tr.v[2] - superCount });
+    }
+    return out;
+}
+
+bool DynamicTriangulation::isDelaunay() const
+{
+    for (int t = 0; t < (int)tris_.size(); ++t) {
+        const Triangle& tr = tris_[t];
+        if (tr.v[0] < 0) continue;
+        if (orient(points_[tr.v[0]], points_[tr.v[1]], points_[tr.v[2]]) <= 0) return false;
+        for (int i = 0; i < 3; ++i) {
+            int u = tr.n[i];
+            if (u >= 0 && tris_[u].n[side(u, tr.v[(i + 1) % 3], tr.v[(i + 2) % 3])] != t) return false;
+            if (u < 0 || t > u) continue;
+
+            int o = tris_[u].v[side(u, tr.v[(i + 1) % 3], tr.v[(i + 2) % 3])];
+            if (tr.v[0] < superCount || tr.v[1] < superCount || tr.v[2] < superCount || o < superCount) continue;
+
+            // Relative tolerance: the predicate scales with the fourth power of the triangle size
+            const Point& d = points_[o];
+            double r2 = std::max({ distance2(points_[tr.v[0]], d), distance2(points_[tr.v[1]], d),
+                distance2(points_[tr.v[2]], d) });
+            if (inCircle(points_[tr.v[0]], points_[tr.v[1]], points_[tr.v[2]], d) > 1e-9 * r2 * r2) return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,179 @@
+#include "geometry/spatial_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
+#include "common/thread_pool.h"
+
+SpatialGrid::SpatialGrid(const std::vector<Point>& points, double pointsPerCell)
+{
+    int n = (int)points.size();
+    if (n == 0) {
+        cellStart_.assign(2, 0);
+        return;
+    }
+
+    double maxX = points[0].x, maxY = points[0].y;
+    minX_ = points[0].x;
+    minY_ = points[0].y;
+    for (const auto& p : points) {
+        minX_ = std::min(minX_, p.x);
+        minY_ = std::min(minY_, p.y);
+        maxX = std::max(maxX, p.x);
+        maxY = std::max(maxY, p.y);
+    }
+
+    double width = maxX - minX_;
+    double height = maxY - minY_;
+    double area = std::max(width, 1e-12) * std::max(height, 1e-12);
+    cellSize_ = std::sqrt(area * std::max(pointsPerCell, 0.1) / n);
+    if (!(cellSize_ > 0.0)) cellSize_ = 1.0;
+    // Degenerate (collinear) inputs would otherwise produce one very long row of cells.
+    cellSize_ = std::max(cellSize_, std::max(width, height) / (4.0 * n + 1.0));
+
+    cols_ = (int)(width / cellSize_) + 1;
+    rows_ = (int)(height / cellSize_) + 1;
+
+    // Counting sort of the points into cells.
+    std::vector<int> cellOf(n);
+    cellStart_.assign((size_t)cols_ * rows_ + 1, 0);
+    for (int i = 0; i < n; ++i) {
+        cellOf[i] = cellY(points[i].y) * cols_ + cellX(points[i].x);
+        ++cellStart_[cellOf[i] + 1];
+    }
+    for (size_t c = 0; c + 1 < cellStart_.size(); ++c)
+        cellStart_[c + 1] += cellStart_[c];
+
+    ids_.resize(n);
+    xs_.resize(n);
+    ys_.resize(n);
+    std::vector<int> fill(cellStart_.begin(), cellStart_.end() - 1);
+    for (int i = 0; i < n; ++i) {
+        int slot = fill[cellOf[i]]++;
+        ids_[slot] = i;
+        xs_[slot] = points[i].x;
+        ys_[slot] = points[i].y;
+    }
+}
+
+int SpatialGrid::cellX(double x) const
+{
+    return std::clamp((int)std::floor((x - minX_) / cellSize_), 0, cols_ - 1);
+}
+
+int SpatialGrid::cellY(double y) const
+{
+    return std::clamp((int)std::floor((y - minY_) / cellSize_), 0, rows_ - 1);
+}
+
+void SpatialGrid::kNearest(const Point& query, int k, std::vector<int>& out, int exclude) const
+{
+    out.clear();
+    if (k <= 0 || ids_.empty()) return;
+
+    // Max-heap on squared distance holding the best k candidates seen so far.
+    std::priority_queue<std::pair<double, int>> best;
+    auto visit = [&](int cell) {
+        for (int slot = cellStart_[cell]; slot < cellStart_[cell + 1]; ++slot) {
+            if (ids_[slot] == exclude) continue;
+            double dx = xs_[slot] - query.x;
+            double dy = ys_[slot] - query.y;
+            double d2 = dx * dx + dy * dy;
+            if ((int)best.size() < k) best.emplace(d2, ids_[slot]);
+            else if (d2 < best.top().first) {
+                best.pop();
+                best.emplace(d2, ids_[slot]);
+            }
+        }
+    };
+
+    int cx = cellX(query.x);
+    int cy = cellY(query.y);
+    int maxRing = std::max(cols_, rows_);
+    for (int r = 0; r <= maxRing; ++r) {
+        for (int y = cy - r; y <= cy + r; ++y) {
+            if (y < 0 || y >= rows_) continue;
+            bool edgeRow = (y == cy - r || y == cy + r);
+            for (int x = cx - r; x <= cx + r; x += (edgeRow || r == 0) ? 1 : 2 * r) {
+                if (x >= 0 && x < cols_) visit(y * cols_ + x);
+            }
+        }
+
+        // Points in rings beyond r are at least r cells away.
+        double reach = r * cellSize_;
+        if ((int)best.size() == k && best.top().first <= reach * reach) break;
+    }
+
+    out.resize(best.size());
+    for (int i = (int)best.size() - 1; i >= 0; --i) {
+        out[i] = best.top().second;
+        best.pop();
+    }
+}
+
+void SpatialGrid::withinRadius(const Point& query, double radius, std::vector<int>& out) const
+{
+    out.clear();
+    if (ids_.empty() || radius < 0.0) return;
+
+    double r2 = radius * radius;
+    int x0 = cellX(query.x - radius), x1 = cellX(query.x + radius);
+    int y0 = cellY(query.y - radius), y1 = cellY(query.y + radius);
+    for (int y = y0; y <= y1; ++y) {
+        for (int x = x0; x <= x1; ++x) {
+            int cell = y * cols_ + x;
+            for (int slot = cellStart_[cell]; slot < cellStart_[cell + 1]; ++slot) {
+                double dx = xs_[slot] - query.x;
+                double dy = ys_[slot] - query.y;
+                if (dx * dx + dy * dy <= r2) out.push_back(ids_[slot]);
+            }
+        }
+    }
+}
+
+int SpatialGrid::nearest(const Point& query) const
+{
+    std::vector<int> out;
+    kNearest(query, 1, out);
+    return out.empty() ? -1 : out[0];
+}
+
+std::vector<Edge> nearestNeighbourEdges(const std::vector<Point>& points, const SpatialGrid& grid, int k,
+    ThreadPool* pool)
+{
+    int n = (int)points.size();
+    k = std::max(0, std::min(k, n - 1));
+
+    // Every point writes its neighbours into its own k slots, so the result is the same
+    // whether the queries run serially or on the pool.
+    std::vector<Edge> slots((size_t)n * k, Edge{ -1, -1, 0.0 });
+    const int chunk = 1024;
+    auto body = [&](int c, unsigned) {
+        std::vector<int> nbrs;
+        for (int i = c * chunk; i < std::min(n, (c + 1) * chunk); ++i) {
+            grid.kNearest(points[i], k, nbrs, i);
+            for (size_t t = 0; t < nbrs.size(); ++t)
+                slots[(size_t)i * k + t] = { i, nbrs[t], euclidean(points[i], points[nbrs[t]]) };
+        }
+    };
+
+    int chunks = (n + chunk - 1) / chunk;
+    if (pool != nullptr) pool->parallelFor(chunks, body);
+    else for (int c = 0; c < chunks; ++c) body(c, 0);
+
+    slots.erase(std::remove_if(slots.begin(), slots.end(), [](const Edge& e) { return e.u < 0; }), slots.end());
+    return slots;
+}
+
+Graph withNearestNeighbours(const Graph& graph, const std::vector<Point>& points, int k, ThreadPool* pool)
+{
+    if (k <= 0 || points.empty()) return graph;
+
+    // Existing edges first: Graph keeps the first cost of a duplicated pair
+    std::vector<Edge> edges(graph.edges().begin(), graph.edges().end());
+    SpatialGrid grid(points);
+    std::vector<Edge> nearest = nearestNeighbourEdges(points, grid, k, pool);
+    edges.insert(edges.end(), nearest.begin(), nearest.end());
+    return Graph(graph.vertexCount(), edges);
+}
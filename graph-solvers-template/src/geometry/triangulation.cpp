@@ -0,0 +1,391 @@
+#include "geometry/triangulation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+#include <unordered_set>
+
+#include <CDT.h>
+
+#include "common/instrumentation.h"
+#include "common/point_set.h"
+#include "common/thread_pool.h"
+
+namespace {
+
+constexpr double infinity = std::numeric_limits<double>::infinity();
+
+/// Vertical strip of the tiled triangulation.
+struct Strip
+{
+    double lo = -infinity;    ///< Owned x-range [lo, hi).
+    double hi = infinity;
+    double halo = 0.0;        ///< Width of the extra points triangulated on either side.
+    bool complete = false;    ///< Strip and halo hold every point (the triangulation is exact).
+
+    std::vector<std::array<int, 3>> triangles;  ///< Kept triangles (global indices).
+    std::vector<Edge> edges;                    ///< Sides whose both triangles are kept here.
+    std::vector<Edge> seam;                     ///< Sides with only one triangle kept here, oriented.
+};
+
+/// Vertical columns of the points with the y-range of each, for circumcircle emptiness tests.
+struct Columns
+{
+    double x0 = 0.0;
+    double width = 1.0;
+    std::vector<double> minY, maxY;
+
+    int column(double x) const { return std::clamp((int)((x - x0) / width), 0, (int)minY.size() - 1); }
+};
+
+/**
+ * @brief Checks that the circumcircle of a triangle holds no point outside the strip and its halo.
+ *
+ * Columns outside the halo are tested against the chord of the circle over them; a column
+ * only passes if the chord misses the y-range of its points. This keeps the nearly flat hull
+ * triangles (huge circumcircles centred outside the hull) certifiable with a narrow halo.
+ */
+bool coveredByStrip(const Point& a, const Point& b, const Point& c, const Strip& strip, const Columns& columns)
+{
+    double bx = b.x - a.x, by = b.y - a.y;
+    double cx = c.x - a.x, cy = c.y - a.y;
+    double d = 2.0 * (bx * cy - by * cx);
+    double b2 = bx * bx + by * by, c2 = cx * cx + cy * cy;
+    double ux = (cy * b2 - by * c2) / d;
+    double uy = (bx * c2 - cx * b2) / d;
+
+    double centreX = a.x + ux, centreY = a.y + uy;
+    double r = std::sqrt(ux * ux + uy * uy);
+    if (!std::isfinite(centreX) || !std::isfinite(r)) return false;
+
+    const double left = strip.lo - strip.halo, right = strip.hi + strip.halo;
+    if (centreX - r >= left && centreX + r <= right) return true;
+
+    auto chordMisses = [&](int k) {
+        if (columns.minY[k] > columns.maxY[k]) return true; // Empty column
+        double x0 = columns.x0 + k * columns.width;
+        double dx = std::clamp(centreX, x0, x0 + columns.width) - centreX;
+        if (std::abs(dx) >= r) return true;
+        double h = std::sqrt((r - dx) * (r + dx));
+        return centreY + h < columns.minY[k] || centreY - h > columns.maxY[k];
+    };
+    if (centreX - r < left) {
+        for (int k = columns.column(centreX - r), last = columns.column(left); k <= last; ++k)
+            if (!chordMisses(k)) return false;
+    }
+    if (centreX + r > right) {
+        for (int k = columns.column(right), last = columns.column(centreX + r); k <= last; ++k)
+            if (!chordMisses(k)) return false;
+    }
+    return true;
+}
+
+void triangulateStrip(const std::vector<Point>& vertices, const Columns& columns, Strip& strip)
+{
+    strip.triangles.clear();
+    strip.edges.clear();
+    strip.seam.clear();
+
+    std::vector<int> local;
+    for (int i = 0; i < (int)vertices.size(); ++i) {
+        if (vertices[i].x >= strip.lo - strip.halo && vertices[i].x <= strip.hi + strip.halo)
+            local.push_back(i);
+    }
+    strip.complete = local.size() == vertices.size();
+
+    CDT::Triangulation<double> cdt;
+    cdt.insertVertices(local.begin(), local.end(),
+        [&](int i) { return vertices[i].x; },
+        [&](int i) { return vertices[i].y; });
+    cdt.eraseSuperTriangle();
+
+    // Keep the triangles whose leftmost vertex lies in the owned range and that are certainly
+    // Delaunay in the whole point set. The others (artefacts of the strip's own hull, long
+    // triangles reaching past the halo) are left to fillGaps().
+    const auto& triangles = cdt.triangles;
+    std::vector<char> kept(triangles.size(), 0);
+    for (std::size_t t = 0; t < triangles.size(); ++t) {
+        const Point& a = vertices[local[triangles[t].vertices[0]]];
+        const Point& b = vertices[local[triangles[t].vertices[1]]];
+        const Point& c = vertices[local[triangles[t].vertices[2]]];
+        double left = std::min({ a.x, b.x, c.x });
+        if (left < strip.lo || left >= strip.hi) continue;
+        kept[t] = strip.complete || coveredByStrip(a, b, c, strip, columns);
+    }
+
+    // A side shared by two kept triangles is emitted by the one with the higher index; seam
+    // sides keep the orientation of their triangle for the hull check
+    for (std::size_t t = 0; t < triangles.size(); ++t) {
+        if (!kept[t]) continue;
+        const auto& tri = triangles[t];
+        strip.triangles.push_back({ local[tri.vertices[0]], local[tri.vertices[1]], local[tri.vertices[2]] });
+        for (int i = 0; i < 3; ++i) {
+            int a = local[tri.vertices[i]], b = local[tri.vertices[(i + 1) % 3]];
+            CDT::TriInd neighbour = tri.neighbors[i];
+            if (neighbour != CDT::noNeighbor && kept[neighbour]) {
+                if (neighbour < t) strip.edges.push_back({ std::min(a, b), std::max(a, b), 0.0 });
+            }
+            else {
+                strip.seam.push_back({ a, b, 0.0 });
+            }
+        }
+    }
+}
+
+/**
+ * @brief Adds the Delaunay triangles missing between the stitched strips.
+ *
+ * Gaps remain where no strip could certify a triangle, typically long flat triangles along
+ * the hull. A triangle with an empty circumcircle stays Delaunay in any subset of the points,
+ * and every vertex of a missing triangle lies on the boundary of the stitched triangles (or in
+ * none of them), so the missing triangles are those of the triangulation of these few vertices
+ * that lie beyond the boundary. They are found by a flood fill that starts across each boundary
+ * side and never crosses one.
+ *
+ * @param triangles Stitched triangles, counter-clockwise; missing ones are appended.
+ * @param edges     Unique sides; sides of the added triangles are appended.
+ * @param hull      Sides with a single triangle, oriented as in it; updated.
+ */
+void fillGaps(const std::vector<Point>& vertices, std::vector<std::array<int, 3>>& triangles,
+    std::vector<Edge>& edges, std::vector<Edge>& hull)
+{
+    std::vector<char> selected(vertices.size(), 1);
+    for (const auto& t : triangles)
+        selected[t[0]] = selected[t[1]] = selected[t[2]] = 0;
+    for (const auto& side : hull)
+        selected[side.u] = selected[side.v] = 1;
+
+    std::vector<int> local;
+    for (int i = 0; i < (int)vertices.size(); ++i) {
+        if (selected[i]) local.push_back(i);
+    }
+    if (local.size() < 3) return;
+
+    CDT::Triangulation<double> cdt;
+    cdt.insertVertices(local.begin(), local.end(),
+        [&](int i) { return vertices[i].x; },
+        [&](int i) { return vertices[i].y; });
+    cdt.eraseSuperTriangle();
+
+    auto key = [](int a, int b) { return (std::uint64_t)(std::uint32_t)a << 32 | (std::uint32_t)b; };
+    std::unordered_set<std::uint64_t> boundary;
+    for (const auto& side : hull) boundary.insert(key(side.u, side.v));
+
+    // Seeds lie across a boundary side; the fill stops at the other boundary sides
+    const auto& candidates = cdt.triangles;
+    std::vector<char> missing(candidates.size(), 0);
+    std::vector<std::size_t> stack;
+    for (std::size_t t = 0; t < candidates.size(); ++t) {
+        const auto& v = candidates[t].vertices;
+        for (int i = 0; i < 3 && !missing[t]; ++i) {
+            if (boundary.count(key(local[v[(i + 1) % 3]], local[v[i]]))) {
+                missing[t] = 1;
+                stack.push_back(t);
+            }
+        }
+    }
+    while (!stack.empty()) {
+        std::size_t t = stack.back();
+        stack.pop_back();
+        const auto& tri = candidates[t];
+        for (int i = 0; i < 3; ++i) {
+            CDT::TriInd neighbour = tri.neighbors[i];
+            if (neighbour == CDT::noNeighbor || missing[neighbour]) continue;
+            if (boundary.count(key(local[tri.vertices[(i + 1) % 3]], local[tri.vertices[i]]))) continue;
+            missing[neighbour] = 1;
+            stack.push_back(neighbour);
+        }
+    }
+
+    std::vector<Edge> outer;
+    for (std::size_t t = 0; t < candidates.size(); ++t) {
+        if (!missing[t]) continue;
+        const auto& tri = candidates[t];
+        triangles.push_back({ local[tri.vertices[0]], local[tri.vertices[1]], local[tri.vertices[2]] });
+        for (int i = 0; i < 3; ++i) {
+            int a = local[tri.vertices[i]], b = local[tri.vertices[(i + 1) % 3]];
+            CDT::TriInd neighbour = tri.neighbors[i];
+            if (boundary.erase(key(b, a))) continue; // Already listed, now with two triangles
+            if (neighbour != CDT::noNeighbor && missing[neighbour]) {
+                if (neighbour < t) edges.push_back({ std::min(a, b), std::max(a, b), 0.0 });
+            }
+            else {
+                edges.push_back({ std::min(a, b), std::max(a, b), 0.0 });
+                outer.push_back({ a, b, 0.0 });
+            }
+        }
+    }
+
+    hull.erase(std::remove_if(hull.begin(), hull.end(), [&](const Edge& side) {
+        return !boundary.count(key(side.u, side.v));
+        }), hull.end());
+    hull.insert(hull.end(), outer.begin(), outer.end());
+}
+
+/**
+ * @brief Checks that the stitched triangles form a triangulated convex polygon.
+ *
+ * Together with every triangle being Delaunay this means no triangle is missing: Euler's
+ * formula rules out holes and duplicated sides, and a boundary that turns the same way at
+ * every vertex rules out notches in the hull.
+ */
+bool isConvexTriangulation(const std::vector<Point>& vertices, std::size_t edges, std::size_t triangles,
+    const std::vector<Edge>& hull)
+{
+    const long long v = vertices.size(), e = edges, t = triangles, h = hull.size();
+    if (hull.empty() || v - e + t != 1 || 3 * t + h != 2 * e) return false;
+
+    std::vector<int> next(vertices.size(), -1);
+    for (const auto& side : hull) {
+        if (next[side.u] != -1) return false;
+        next[side.u] = side.v;
+    }
+
+    int turns[2] = { 0, 0 };
+    int steps = 0, a = hull.front().u;
+    do {
+        int b = next[a], c = b < 0 ? -1 : next[b];
+        if (c < 0) return false;
+        double cross = (vertices[b].x - vertices[a].x) * (vertices[c].y - vertices[b].y)
+            - (vertices[b].y - vertices[a].y) * (vertices[c].x - vertices[b].x);
+        if (cross > 0.0) ++turns[0];
+        else if (cross < 0.0) ++turns[1];
+        a = b;
+    } while (++steps <= h && a != hull.front().u);
+    return steps == h && (turns[0] == 0 || turns[1] == 0);
+}
+
+} // namespace
+
+DelaunayGraph buildDelaunayGraph(const std::vector<Point>& vertices, const TriangulationOptions& options)
+{
+    CW_PROFILE_SCOPE("triangulation");
+    const int n = (int)vertices.size();
+    if (n < 3) return { {}, Graph(n, {}) };
+
+    int tiles = options.tiles;
+    if (tiles <= 0) {
+        tiles = options.pool == nullptr ? 1
+            : std::min<int>(options.pool->size(), n / std::max(1, options.minTilePoints));
+    }
+    tiles = std::clamp(tiles, 1, std::max(1, n / 16));
+
+    // Strip borders at x-quantiles; successive nth_element calls avoid a full sort
+    std::vector<Strip> strips(tiles);
+    Columns columns;
+    if (tiles > 1) {
+        double minX = vertices[0].x, maxX = minX, minY = vertices[0].y, maxY = minY;
+        for (const auto& p : vertices) {
+            minX = std::min(minX, p.x);
+            maxX = std::max(maxX, p.x);
+            minY = std::min(minY, p.y);
+            maxY = std::max(maxY, p.y);
+        }
+
+        std::vector<double> xs(n);
+        for (int i = 0; i < n; ++i) xs[i] = vertices[i].x;
+        auto first = xs.begin();
+        for (int s = 1; s < tiles; ++s) {
+            auto nth = xs.begin() + (std::size_t)n * s / tiles;
+            std::nth_element(first, nth, xs.end());
+            strips[s - 1].hi = strips[s].lo = *nth;
+            first = nth;
+        }
+
+        // Halo and columns start at a few mean point spacings
+        double area = (maxX - minX) * (maxY - minY);
+        double spacing = area > 0.0 ? std::sqrt(area / n) : (maxX - minX) / n;
+        if (!(spacing > 0.0)) spacing = 1.0;
+        for (auto& strip : strips) strip.halo = 4.0 * spacing;
+
+        int count = (int)std::min<double>(n, (maxX - minX) / spacing + 1.0);
+        columns.x0 = minX;
+        columns.width = std::max((maxX - minX) / count, spacing / n);
+        columns.minY.assign(count, infinity);
+        columns.maxY.assign(count, -infinity);
+        for (const auto& p : vertices) {
+            int k = columns.column(p.x);
+            columns.minY[k] = std::min(columns.minY[k], p.y);
+            columns.maxY[k] = std::max(columns.maxY[k], p.y);
+        }
+    }
+
+    DelaunayGraph result;
+    std::vector<Edge> edges, seam, hull;
+    while (true) {
+        auto body = [&](int s, unsigned) { triangulateStrip(vertices, columns, strips[s]); };
+        if (options.pool != nullptr) options.pool->parallelFor(tiles, body);
+        else for (int s = 0; s < tiles; ++s) body(s, 0);
+
+        // === Stitch: seam sides appear once on the hull and twice between strips ===
+        std::size_t edgeCount = 0, seamCount = 0, triangleCount = 0;
+        for (const auto& strip : strips) {
+            edgeCount += strip.edges.size();
+            seamCount += strip.seam.size();
+            triangleCount += strip.triangles.size();
+        }
+        edges.clear();
+        seam.clear();
+        hull.clear();
+        result.triangles.clear();
+        edges.reserve(edgeCount + seamCount);
+        seam.reserve(seamCount);
+        result.triangles.reserve(triangleCount);
+        for (const auto& strip : strips) {
+            edges.insert(edges.end(), strip.edges.begin(), strip.edges.end());
+            seam.insert(seam.end(), strip.seam.begin(), strip.seam.end());
+            result.triangles.insert(result.triangles.end(), strip.triangles.begin(), strip.triangles.end());
+        }
+
+        auto key = [](const Edge& e) { return std::make_pair(std::min(e.u, e.v), std::max(e.u, e.v)); };
+        std::sort(seam.begin(), seam.end(), [&](const Edge& e1, const Edge& e2) { return key(e1) < key(e2); });
+        bool consistent = true;
+        for (std::size_t i = 0; i < seam.size();) {
+            std::size_t j = i + 1;
+            while (j < seam.size() && key(seam[j]) == key(seam[i])) ++j;
+            if (j - i == 1) hull.push_back(seam[i]);
+            else if (j - i > 2) consistent = false;
+            edges.push_back({ key(seam[i]).first, key(seam[i]).second, 0.0 });
+            i = j;
+        }
+
+        // Strips triangulated with every point are exact; otherwise fill the gaps and check
+        bool exact = std::all_of(strips.begin(), strips.end(), [](const Strip& s) { return s.complete; });
+        if (exact) break;
+        if (consistent) {
+            fillGaps(vertices, result.triangles, edges, hull);
+            if (isConvexTriangulation(vertices, edges.size(), result.triangles.size(), hull)) break;
+        }
+
+        // Inconsistent stitching (e.g. cocircular points resolved differently): widen and retry
+        for (auto& strip : strips) strip.halo *= 2.0;
+    }
+
+    result.graph = Graph(n, edges);
+
+    // Edge lengths in one pass over the final edges, batched through the SIMD kernels
+    Graph& graph = result.graph;
+    const PointSet coordinates(vertices);
+    const int chunk = 1 << 16;
+    const int chunks = (graph.edgeCount() + chunk - 1) / chunk;
+    auto lengths = [&](int c, unsigned) {
+        int begin = c * chunk, end = std::min(graph.edgeCount(), (c + 1) * chunk);
+        std::vector<double> costs(end - begin);
+        coordinates.edgeLengths(std::span<const Edge>(graph.edges()).subspan(begin, end - begin), costs);
+        for (int id = begin; id < end; ++id)
+            graph.setCost(id, costs[id - begin]);
+    };
+    if (options.pool != nullptr) options.pool->parallelFor(chunks, lengths);
+    else for (int c = 0; c < chunks; ++c) lengths(c, 0);
+
+    return result;
+}
+
+std::pair<std::vector<std::array<int, 3>>, std::vector<Edge>>
+computeTriangulationAndEdges(const std::vector<Point>& vertices)
+{
+    DelaunayGraph delaunay = buildDelaunayGraph(vertices);
+    return { std::move(delaunay.triangles), delaunay.graph.edges() };
+}
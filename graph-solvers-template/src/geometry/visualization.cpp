@@ -1,12 +1,20 @@
 #include "geometry/visualization.h"
 
-#include <CDT.h>
-#include <iostream>
-#include <fstream>
-#include <array>
-#include <map>
-#include <set>
+#include <algorithm>
+#include <charconv>
 #include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <ostream>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "common/instrumentation.h"
+#include "common/thread_pool.h"
 
 const std::vector<std::string> route_colors = { "red", "blue", "green", "orange", "purple" };
 
@@ -14,7 +22,7 @@ void offset_line(double& x1, double& y1, double& x2, double& y2, double offset)
     double dx = x2 - x1;
     double dy = y2 - y1;
     double len = std::sqrt(dx * dx + dy * dy);
-    if (len == 0) return;  
+    if (len == 0) return;
 
     double nx = -dy / len;
     double ny = dx / len;
@@ -24,129 +32,451 @@ void offset_line(double& x1, double& y1, double& x2, double& y2, double offset)
     y2 += ny * offset;
 }
 
-void drawSVG(const std::vector<Point>& points,
-    const std::vector<std::vector<std::pair<int, int>>>& all_routes_edges,
-    const std::vector<std::array<int, 3>>& triangles,
-    const std::string& filename)
+namespace {
+
+constexpr double legendWidth = 250.0;
+constexpr double offsetStep = 3.0;
+
+// Maps coordinates to pixels: x grows to the right, y is flipped so that it grows upwards
+struct Frame
 {
-    if (points.empty()) return;
+    double originX;   ///< Coordinate shown at the left margin.
+    double originY;   ///< Coordinate shown at the top margin.
+    double k;         ///< Pixels per coordinate unit.
+    double margin;
+    double width;
+    double height;
+
+    double x(double wx) const { return (wx - originX) * k + margin; }
+    double y(double wy) const { return (originY - wy) * k + margin; }
+};
+
+void appendNumber(std::string& out, double value)
+{
+    char digits[64];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::fixed, 1);
+    out.append(digits, result.ptr);
+}
+
+void appendInt(std::string& out, long long value)
+{
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    out.append(digits, result.ptr);
+}
+
+std::uint64_t pairKey(std::uint64_t a, std::uint64_t b)
+{
+    if (a > b) std::swap(a, b);
+    return (a << 32) ^ b;
+}
+
+// Unordered pair of grid cells. Both 64-bit cell keys are kept, since folding them into one
+// 64-bit key would merge distinct pairs and drop real edges from the decimated background.
+struct CellPair
+{
+    std::uint64_t a, b;
+
+    CellPair(std::uint64_t first, std::uint64_t second) : a(std::min(first, second)), b(std::max(first, second)) {}
+    bool operator==(const CellPair& other) const = default;
+};
 
-    // Compute bounding box
-    double minX = points[0].x, maxX = points[0].x;
-    double minY = points[0].y, maxY = points[0].y;
-    for (const auto& p : points) {
-        minX = std::min(minX, p.x);
-        maxX = std::max(maxX, p.x);
-        minY = std::min(minY, p.y);
-        maxY = std::max(maxY, p.y);
+struct CellPairHash
+{
+    std::size_t operator()(const CellPair& p) const
+    {
+        std::uint64_t h = p.a * 0x9E3779B97F4A7C15ull;
+        h ^= p.b + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2);
+        return std::hash<std::uint64_t>{}(h);
     }
+};
 
-    double margin = 50;
-    double scale = 25;
+// Grid cell of a pixel position, packed into one key
+std::uint64_t cellKey(double px, double py, double cell)
+{
+    auto cx = (std::uint32_t)(std::int32_t)std::floor(px / cell);
+    auto cy = (std::uint32_t)(std::int32_t)std::floor(py / cell);
+    return ((std::uint64_t)cy << 32) | cx;
+}
 
-    double legend_width = 250;
+double snap(double p, double cell)
+{
+    return (std::floor(p / cell) + 0.5) * cell;
+}
 
-    double width = (maxX - minX) * scale + 2 * margin + legend_width;
-    double height = (maxY - minY) * scale + 2 * margin;
+// Level-of-detail grid for an area that should show at most @p budget edges
+double lodCell(const RenderOptions& options, double width, double height, std::size_t edges, std::size_t budget)
+{
+    if (options.lodCellPixels > 0.0) return options.lodCellPixels;
+    if (edges <= budget || budget == 0) return 0.0;
+    // A planar graph has about three edges per node; one node per cell keeps ~budget edges
+    return std::sqrt(width * height * 3.0 / (double)budget);
+}
 
-    auto transformX = [&](double x) { return (x - minX) * scale + margin; };
-    auto transformY = [&](double y) { return height - ((y - minY) * scale + margin); };
+// Grey background edges as one path; with cell > 0 endpoints are snapped and duplicates dropped
+std::size_t appendEdges(std::string& out, const Frame& frame, const std::vector<Point>& points,
+    const Graph& graph, const std::vector<int>* edges, double cell)
+{
+    std::string d;
+    std::unordered_set<CellPair, CellPairHash> drawn;
+    std::size_t count = 0;
+    const int total = edges ? (int)edges->size() : graph.edgeCount();
+    for (int i = 0; i < total; ++i) {
+        const Edge& e = graph.edge(edges ? (*edges)[i] : i);
+        double x1 = frame.x(points[e.u].x), y1 = frame.y(points[e.u].y);
+        double x2 = frame.x(points[e.v].x), y2 = frame.y(points[e.v].y);
+        if (cell > 0.0) {
+            std::uint64_t a = cellKey(x1, y1, cell), b = cellKey(x2, y2, cell);
+            if (a == b || !drawn.emplace(a, b).second) continue;
+            x1 = snap(x1, cell), y1 = snap(y1, cell), x2 = snap(x2, cell), y2 = snap(y2, cell);
+        }
+        d += 'M';
+        appendNumber(d, x1);
+        d += ' ';
+        appendNumber(d, y1);
+        d += 'L';
+        appendNumber(d, x2);
+        d += ' ';
+        appendNumber(d, y2);
+        ++count;
+    }
+    if (count > 0) {
+        out += "<path stroke='#cccccc' stroke-width='1' fill='none' d='";
+        out += d;
+        out += "' />\n";
+    }
+    return count;
+}
 
-    std::ofstream svg(filename);
-    svg << "<svg xmlns='http://www.w3.org/2000/svg' width='" << width << "' height='" << height << "'>\n";
+// Numbered circles for small graphs, a single path of dots (snapped when cell > 0) otherwise
+void appendNodes(std::string& out, const Frame& frame, const std::vector<Point>& points,
+    const std::vector<int>* nodes, bool labels, double cell)
+{
+    const int total = nodes ? (int)nodes->size() : (int)points.size();
+    const int last = (int)points.size() - 1;
+    auto label = [&](int i, double cx, double cy) {
+        if (i != 0 && i != last) return;
+        out += "<text x='";
+        appendNumber(out, cx);
+        out += "' y='";
+        appendNumber(out, cy + 20);
+        out += i == 0 ? "' fill='green' font-weight='bold'>start</text>\n" : "' fill='red' font-weight='bold'>meta</text>\n";
+    };
 
-    // Delaunay edges in gray
-    svg << "<g stroke='#cccccc' stroke-width='1'>\n";
-    for (const auto& tri : triangles) {
-        for (int i = 0; i < 3; ++i) {
-            int a = tri[i], b = tri[(i + 1) % 3];
-            svg << "<line x1='" << transformX(points[a].x) << "' y1='" << transformY(points[a].y)
-                << "' x2='" << transformX(points[b].x) << "' y2='" << transformY(points[b].y) << "' />\n";
+    out += "<g fill='blue' font-family='Arial' font-size='14' text-anchor='middle' dominant-baseline='middle'>\n";
+    if (labels) {
+        for (int n = 0; n < total; ++n) {
+            int i = nodes ? (*nodes)[n] : n;
+            double cx = frame.x(points[i].x), cy = frame.y(points[i].y);
+            out += "<circle cx='";
+            appendNumber(out, cx);
+            out += "' cy='";
+            appendNumber(out, cy);
+            out += "' r='6' />\n<text x='";
+            appendNumber(out, cx);
+            out += "' y='";
+            appendNumber(out, cy - 12);
+            out += "' fill='black'>";
+            appendInt(out, i);
+            out += "</text>\n";
+            label(i, cx, cy);
         }
     }
-    svg << "</g>\n";
-
-   
-    std::map<std::pair<int, int>, std::vector<size_t>> edge_to_routes;
-    for (size_t route_idx = 0; route_idx < all_routes_edges.size(); ++route_idx) {
-        for (const auto& e : all_routes_edges[route_idx]) {
-            int a = std::min(e.first, e.second);
-            int b = std::max(e.first, e.second);
-            edge_to_routes[{a, b}].push_back(route_idx);
+    else {
+        std::string d;
+        std::unordered_set<std::uint64_t> drawn;
+        for (int n = 0; n < total; ++n) {
+            int i = nodes ? (*nodes)[n] : n;
+            double cx = frame.x(points[i].x), cy = frame.y(points[i].y);
+            if (cell > 0.0) {
+                if (!drawn.insert(cellKey(cx, cy, cell)).second) continue;
+                cx = snap(cx, cell), cy = snap(cy, cell);
+            }
+            d += 'M';
+            appendNumber(d, cx);
+            d += ' ';
+            appendNumber(d, cy);
+            d += "h0";
+        }
+        if (!d.empty()) {
+            out += "<path stroke='blue' stroke-width='4' stroke-linecap='round' d='";
+            out += d;
+            out += "' />\n";
+        }
+        for (int n = 0; n < total; ++n) {
+            int i = nodes ? (*nodes)[n] : n;
+            label(i, frame.x(points[i].x), frame.y(points[i].y));
         }
     }
+    out += "</g>\n";
+}
 
+// Perpendicular offset (in pixels) of every route edge: routes sharing an edge are spread
+// side by side in route order
+std::vector<std::vector<double>> overlapOffsets(const RouteEdges& routes)
+{
+    std::unordered_map<std::uint64_t, std::pair<int, int>> shared;  // edge -> (routes, next slot)
+    for (const auto& route : routes)
+        for (const auto& [a, b] : route) ++shared[pairKey((std::uint32_t)a, (std::uint32_t)b)].first;
 
-    double offset_step = 3.0;
-    for (const auto& [edge, routes] : edge_to_routes) {
-        int a = edge.first;
-        int b = edge.second;
-        double x1 = transformX(points[a].x);
-        double y1 = transformY(points[a].y);
-        double x2 = transformX(points[b].x);
-        double y2 = transformY(points[b].y);
-
-        int n = (int)routes.size();
-  
-        for (int i = 0; i < n; ++i) {
-            double offset = 0;
-            if (n % 2 == 1) {
-              
-                offset = (i - n / 2) * offset_step;
-            }
-            else {
-                
-                offset = (i - n / 2 + 0.5) * offset_step;
-            }
+    std::vector<std::vector<double>> offsets(routes.size());
+    for (std::size_t r = 0; r < routes.size(); ++r) {
+        offsets[r].reserve(routes[r].size());
+        for (const auto& [a, b] : routes[r]) {
+            auto& [n, slot] = shared[pairKey((std::uint32_t)a, (std::uint32_t)b)];
+            int i = slot++;
+            offsets[r].push_back(n % 2 == 1 ? (i - n / 2) * offsetStep : (i - n / 2 + 0.5) * offsetStep);
+        }
+    }
+    return offsets;
+}
 
-            double ox1 = x1, oy1 = y1, ox2 = x2, oy2 = y2;
-            offset_line(ox1, oy1, ox2, oy2, offset);
+// One layer per route; @p segments (route, edge position) selects a subset, all when null
+void appendRoutes(std::string& out, const Frame& frame, const std::vector<Point>& points,
+    const RouteEdges& routes, const std::vector<std::vector<double>>& offsets,
+    const std::vector<std::pair<int, int>>* segments)
+{
+    auto segment = [&](std::string& d, int r, int k, double& lastX, double& lastY) {
+        auto [a, b] = routes[r][k];
+        double x1 = frame.x(points[a].x), y1 = frame.y(points[a].y);
+        double x2 = frame.x(points[b].x), y2 = frame.y(points[b].y);
+        double offset = offsets[r][k];
+        // Offsets are measured from the edge taken as (min, max), whichever way the route runs
+        if (offset != 0.0) offset_line(x1, y1, x2, y2, a <= b ? offset : -offset);
+        if (d.empty() || x1 != lastX || y1 != lastY) {
+            d += 'M';
+            appendNumber(d, x1);
+            d += ' ';
+            appendNumber(d, y1);
+        }
+        d += 'L';
+        appendNumber(d, x2);
+        d += ' ';
+        appendNumber(d, y2);
+        lastX = x2, lastY = y2;
+    };
+    auto layer = [&](int r, const std::string& d) {
+        out += "<g id='route-";
+        appendInt(out, r);
+        out += "' stroke='";
+        out += route_colors[r % route_colors.size()];
+        out += "' stroke-width='3' fill='none' stroke-linejoin='round'><path d='";
+        out += d;
+        out += "' /></g>\n";
+    };
 
-            const std::string& color = route_colors[routes[i] % route_colors.size()];
-            svg << "<line stroke='" << color << "' stroke-width='3' "
-                << "x1='" << ox1 << "' y1='" << oy1
-                << "' x2='" << ox2 << "' y2='" << oy2 << "' />\n";
+    double lastX = 0.0, lastY = 0.0;
+    if (segments == nullptr) {
+        for (int r = 0; r < (int)routes.size(); ++r) {
+            std::string d;
+            for (int k = 0; k < (int)routes[r].size(); ++k) segment(d, r, k, lastX, lastY);
+            layer(r, d);
         }
+        return;
+    }
+    for (std::size_t s = 0; s < segments->size();) {
+        int r = (*segments)[s].first;
+        std::string d;
+        for (; s < segments->size() && (*segments)[s].first == r; ++s)
+            segment(d, r, (*segments)[s].second, lastX, lastY);
+        layer(r, d);
     }
+}
 
-    // Vertices in blue with labels
-    svg << "<g fill='blue' font-family='Arial' font-size='14' text-anchor='middle' dominant-baseline='middle'>\n";
-    for (size_t i = 0; i < points.size(); ++i) {
-        double cx = transformX(points[i].x);
-        double cy = transformY(points[i].y);
+void writeFile(const std::string& filename, const std::string& content)
+{
+    std::ofstream file(filename, std::ios::binary);
+    file.write(content.data(), (std::streamsize)content.size());
+    if (!file) throw std::runtime_error("cannot write " + filename);
+}
 
-        // Draw the vertex circle
-        svg << "<circle cx='" << cx << "' cy='" << cy << "' r='6' />\n";
+// Tile range [first, last] covered by the interval [lo, hi] on an axis split into tiles of @p unit
+std::pair<int, int> tileRange(double lo, double hi, double unit, int count)
+{
+    int first = std::clamp((int)std::floor(lo / unit), 0, count - 1);
+    int last = std::clamp((int)std::floor(hi / unit), 0, count - 1);
+    return { first, last };
+}
 
-        // Draw the vertex number (offset a bit above)
-        svg << "<text x='" << cx << "' y='" << (cy - 12) << "' fill='black'>" << i << "</text>\n";
+} // namespace
 
-        // For first and last vertex add labels "start" and "meta"
-        if (i == 0) {
-            svg << "<text x='" << cx << "' y='" << (cy + 20) << "' fill='green' font-weight='bold'>start</text>\n";
-        }
-        else if (i == points.size() - 1) {
-            svg << "<text x='" << cx << "' y='" << (cy + 20) << "' fill='red' font-weight='bold'>meta</text>\n";
-        }
+SvgRenderer::SvgRenderer(const std::vector<Point>& points, const Graph& graph, const RenderOptions& options)
+    : points_(points), graph_(graph), options_(options)
+{
+    CW_PROFILE_SCOPE("svg_prepare");
+    if (!points_.empty()) {
+        minX_ = maxX_ = points_[0].x;
+        minY_ = maxY_ = points_[0].y;
+    }
+    for (const auto& p : points_) {
+        minX_ = std::min(minX_, p.x);
+        maxX_ = std::max(maxX_, p.x);
+        minY_ = std::min(minY_, p.y);
+        maxY_ = std::max(maxY_, p.y);
     }
-    svg << "</g>\n";
+    width_ = (maxX_ - minX_) * options_.scale + 2 * options_.margin + legendWidth;
+    height_ = (maxY_ - minY_) * options_.scale + 2 * options_.margin;
+
+    Frame frame{ minX_, maxY_, options_.scale, options_.margin, width_, height_ };
+    double cell = lodCell(options_, width_ - legendWidth, height_, (std::size_t)graph_.edgeCount(), options_.maxDetailEdges);
+    backgroundEdges_ = appendEdges(edgeLayer_, frame, points_, graph_, nullptr, cell);
+    appendNodes(nodeLayer_, frame, points_, nullptr, (int)points_.size() <= options_.maxLabeledNodes, cell);
+}
+
+void SvgRenderer::render(std::ostream& out, const RouteEdges& routes) const
+{
+    CW_PROFILE_SCOPE("svg_render");
+    std::string svg;
+    svg.reserve(edgeLayer_.size() + nodeLayer_.size() + 4096);
+    svg += "<svg xmlns='http://www.w3.org/2000/svg' width='";
+    appendNumber(svg, width_);
+    svg += "' height='";
+    appendNumber(svg, height_);
+    svg += "'>\n<script>function toggle(i){var g=document.getElementById('route-'+i);"
+           "g.style.display=g.style.display=='none'?'':'none';}</script>\n";
+    svg += edgeLayer_;
+
+    Frame frame{ minX_, maxY_, options_.scale, options_.margin, width_, height_ };
+    appendRoutes(svg, frame, points_, routes, overlapOffsets(routes), nullptr);
+    svg += nodeLayer_;
+
+    // Legend; clicking an entry toggles its route layer
+    svg += "<g font-family='Arial' font-size='14'>\n";
+    double legendX = width_ - legendWidth + 10;
+    double legendY = 30;
+    svg += "<text x='";
+    appendNumber(svg, legendX);
+    svg += "' y='";
+    appendNumber(svg, legendY - 20);
+    svg += "' font-weight='bold'>Legenda tras:</text>\n";
+    for (std::size_t i = 0; i < routes.size(); ++i) {
+        svg += "<g style='cursor:pointer' onclick='toggle(";
+        appendInt(svg, (long long)i);
+        svg += ")'><rect x='";
+        appendNumber(svg, legendX);
+        svg += "' y='";
+        appendNumber(svg, legendY - 12);
+        svg += "' width='20' height='12' fill='";
+        svg += route_colors[i % route_colors.size()];
+        svg += "' /><text x='";
+        appendNumber(svg, legendX + 30);
+        svg += "' y='";
+        appendNumber(svg, legendY);
+        svg += "' fill='black'>Trasa #";
+        appendInt(svg, (long long)i + 1);
+        svg += "</text></g>\n";
+        legendY += 25;
+    }
+    svg += "</g>\n</svg>\n";
+    out.write(svg.data(), (std::streamsize)svg.size());
+}
+
+void SvgRenderer::renderFile(const std::string& filename, const RouteEdges& routes) const
+{
+    std::ofstream file(filename, std::ios::binary);
+    render(file, routes);
+    if (!file) throw std::runtime_error("cannot write " + filename);
+}
+
+void SvgRenderer::renderFiles(const std::vector<std::string>& filenames, const std::vector<RouteEdges>& routeSets) const
+{
+    if (filenames.size() != routeSets.size())
+        throw std::invalid_argument("renderFiles: one route set per file is required");
+
+    auto body = [&](int i, unsigned) { renderFile(filenames[i], routeSets[i]); };
+    if (options_.pool != nullptr) options_.pool->parallelFor((int)filenames.size(), body);
+    else for (int i = 0; i < (int)filenames.size(); ++i) body(i, 0);
+}
 
+int SvgRenderer::renderTiles(const std::string& directory, const RouteEdges& routes, const TileOptions& tiles) const
+{
+    CW_PROFILE_SCOPE("svg_tiles");
+    if (points_.empty() || tiles.levels <= 0) return 0;
+
+    const double side = std::max({ maxX_ - minX_, maxY_ - minY_, 1e-9 });
+    const double top = minY_ + side;
+    const double size = tiles.tileSize;
+    const auto offsets = overlapOffsets(routes);
+
+    // Contents of one tile, bucketed by the bounding box of each edge, node and route segment
+    struct Tile
+    {
+        int z = 0, x = 0, y = 0;
+        std::vector<int> edges, nodes;
+        std::vector<std::pair<int, int>> segments;
+    };
+    std::vector<Tile> all;
+    for (int z = 0; z < tiles.levels; ++z) {
+        const int count = 1 << z;
+        const double unit = side / count;
+        std::vector<Tile> level((std::size_t)count * count);
+        for (int ty = 0; ty < count; ++ty)
+            for (int tx = 0; tx < count; ++tx) level[(std::size_t)ty * count + tx] = Tile{ z, tx, ty, {}, {}, {} };
 
-    svg << "<g font-family='Arial' font-size='14'>\n";
-    double legend_x = width - legend_width + 10;
-    double legend_y = 30;
-    svg << "<text x='" << legend_x << "' y='" << legend_y - 20 << "' font-weight='bold'>Legenda tras:</text>\n";
+        auto visit = [&](const Point& p, const Point& q, auto&& add) {
+            auto [x0, x1] = tileRange(std::min(p.x, q.x) - minX_, std::max(p.x, q.x) - minX_, unit, count);
+            auto [y0, y1] = tileRange(top - std::max(p.y, q.y), top - std::min(p.y, q.y), unit, count);
+            for (int ty = y0; ty <= y1; ++ty)
+                for (int tx = x0; tx <= x1; ++tx) add(level[(std::size_t)ty * count + tx]);
+        };
+        for (int id = 0; id < graph_.edgeCount(); ++id) {
+            const Edge& e = graph_.edge(id);
+            visit(points_[e.u], points_[e.v], [&](Tile& t) { t.edges.push_back(id); });
+        }
+        for (int i = 0; i < (int)points_.size(); ++i)
+            visit(points_[i], points_[i], [&](Tile& t) { t.nodes.push_back(i); });
+        for (int r = 0; r < (int)routes.size(); ++r)
+            for (int k = 0; k < (int)routes[r].size(); ++k)
+                visit(points_[routes[r][k].first], points_[routes[r][k].second],
+                    [&](Tile& t) { t.segments.emplace_back(r, k); });
 
-    for (size_t i = 0; i < all_routes_edges.size(); ++i) {
-        const std::string& color = route_colors[i % route_colors.size()];
-        svg << "<rect x='" << legend_x << "' y='" << legend_y - 12 << "' width='20' height='12' fill='" << color << "' />\n";
-        svg << "<text x='" << (legend_x + 30) << "' y='" << legend_y << "' fill='black'>Trasa #" << (i + 1)
-            << "</text>\n";
-        legend_y += 25;
+        for (auto& t : level)
+            if (!t.edges.empty() || !t.nodes.empty() || !t.segments.empty()) all.push_back(std::move(t));
     }
-    svg << "</g>\n";
 
-    svg << "</svg>\n";
-    svg.close();
+    for (const auto& t : all)
+        std::filesystem::create_directories(std::filesystem::path(directory) / std::to_string(t.z) / std::to_string(t.x));
+
+    const std::size_t budget = std::min<std::size_t>(options_.maxDetailEdges, (std::size_t)(size * size / 16.0));
+    auto body = [&](int i, unsigned) {
+        const Tile& t = all[i];
+        const double unit = side / (1 << t.z);
+        Frame frame{ minX_ + t.x * unit, top - t.y * unit, size / unit, 0.0, size, size };
+        double cell = lodCell(options_, size, size, t.edges.size(), budget);
+
+        std::string svg;
+        svg += "<svg xmlns='http://www.w3.org/2000/svg' width='";
+        appendInt(svg, tiles.tileSize);
+        svg += "' height='";
+        appendInt(svg, tiles.tileSize);
+        svg += "'>\n";
+        appendEdges(svg, frame, points_, graph_, &t.edges, cell);
+        appendRoutes(svg, frame, points_, routes, offsets, &t.segments);
+        appendNodes(svg, frame, points_, &t.nodes, (int)t.nodes.size() <= options_.maxLabeledNodes && cell == 0.0, cell);
+        svg += "</svg>\n";
+
+        auto path = std::filesystem::path(directory) / std::to_string(t.z) / std::to_string(t.x) / (std::to_string(t.y) + ".svg");
+        writeFile(path.string(), svg);
+    };
+    if (options_.pool != nullptr) options_.pool->parallelFor((int)all.size(), body);
+    else for (int i = 0; i < (int)all.size(); ++i) body(i, 0);
+    return (int)all.size();
+}
+
+void drawSVG(const std::vector<Point>& points,
+    const std::vector<std::vector<std::pair<int, int>>>& all_routes_edges,
+    const std::vector<std::array<int, 3>>& triangles,
+    const std::string& filename)
+{
+    if (points.empty()) return;
+
+    // Triangle sides as a graph, so that sides shared by two triangles are drawn once
+    std::vector<Edge> sides;
+    sides.reserve(triangles.size() * 3);
+    for (const auto& tri : triangles)
+        for (int i = 0; i < 3; ++i) sides.push_back({ tri[i], tri[(i + 1) % 3], 0.0 });
+    Graph graph((int)points.size(), sides);
+
+    SvgRenderer(points, graph).renderFile(filename, all_routes_edges);
     std::cout << "SVG visualization written to " << filename << std::endl;
 }
@@ -0,0 +1,392 @@
+#include "model/batch.h"
+
+#include <charconv>
+#include <cmath>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include "common/instance_io.h"
+#include "common/instrumentation.h"
+#include "common/thread_pool.h"
+#include "model/route_io.h"
+
+namespace {
+
+std::string escape(std::string_view s)
+{
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        if (c == '\n') out += "\\n";
+        else if (c == '\t') out += "\\t";
+        else if ((unsigned char)c < 0x20) out += ' ';
+        else out += c;
+    }
+    return out;
+}
+
+// Shortest representation that reads back to the same double, as RouteWriter writes it
+void appendShortest(std::string& out, double value)
+{
+    char digits[32];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    out.append(digits, result.ptr);
+}
+
+template <typename T>
+T parseNumber(std::string_view key, std::string_view value, int lineNumber)
+{
+    T result{};
+    auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), result);
+    if (error != std::errc() || end != value.data() + value.size())
+        throw std::invalid_argument("line " + std::to_string(lineNumber) + ": bad value for "
+            + std::string(key) + ": '" + std::string(value) + "'");
+    return result;
+}
+
+// Manifest lines handed from the reading thread to the pool workers
+class LineQueue
+{
+public:
+    void push(int lineNumber, std::string line)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            lines_.emplace_back(lineNumber, std::move(line));
+        }
+        ready_.notify_one();
+    }
+
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+        }
+        ready_.notify_all();
+    }
+
+    bool pop(int& lineNumber, std::string& line)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ready_.wait(lock, [this] { return closed_ || !lines_.empty(); });
+        if (lines_.empty()) return false;
+        lineNumber = lines_.front().first;
+        line = std::move(lines_.front().second);
+        lines_.pop_front();
+        return true;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::deque<std::pair<int, std::string>> lines_;
+    bool closed_ = false;
+};
+
+} // namespace
+
+std::string BatchJob::instanceKey() const
+{
+    if (!instance.empty()) return instance;
+    return "random:" + std::to_string(randomPoints) + ":" + std::to_string(pointsSeed);
+}
+
+bool parseBatchJob(std::string_view line, int lineNumber, BatchJob& job)
+{
+    job = BatchJob();
+    job.id = std::to_string(lineNumber);
+
+    auto isSpace = [](char c) { return c == ' ' || c == '\t' || c == '\r'; };
+    std::size_t pos = 0;
+    while (pos < line.size() && isSpace(line[pos])) ++pos;
+    if (pos == line.size() || line[pos] == '#') return false;
+
+    while (pos < line.size()) {
+        std::size_t end = pos;
+        while (end < line.size() && !isSpace(line[end])) ++end;
+        std::string_view token = line.substr(pos, end - pos);
+        pos = end;
+        while (pos < line.size() && isSpace(line[pos])) ++pos;
+
+        std::size_t eq = token.find('=');
+        if (eq == std::string_view::npos)
+            throw std::invalid_argument("line " + std::to_string(lineNumber) + ": expected key=value, got '"
+                + std::string(token) + "'");
+        std::string_view key = token.substr(0, eq);
+        std::string_view value = token.substr(eq + 1);
+
+        if (key == "id") job.id = value;
+        else if (key == "instance") job.instance = value;
+        else if (key == "random") job.randomPoints = parseNumber<int>(key, value, lineNumber);
+        else if (key == "points_seed") job.pointsSeed = parseNumber<std::uint64_t>(key, value, lineNumber);
+        else if (key == "routes") job.routes = parseNumber<int>(key, value, lineNumber);
+        else if (key == "seed") job.seed = parseNumber<std::uint64_t>(key, value, lineNumber);
+        else if (key == "batch") job.batchSize = parseNumber<int>(key, value, lineNumber);
+        else if (key == "capacity") job.capacity = parseNumber<double>(key, value, lineNumber);
+        else if (key == "max_length") job.maxLength = parseNumber<double>(key, value, lineNumber);
+        else if (key == "local_search") job.localSearch = parseNumber<int>(key, value, lineNumber) != 0;
+        else
+            throw std::invalid_argument("line " + std::to_string(lineNumber) + ": unknown key '"
+                + std::string(key) + "'");
+    }
+
+    if (job.instance.empty() && job.randomPoints <= 0)
+        throw std::invalid_argument("line " + std::to_string(lineNumber) + ": job needs instance= or random=");
+    if (job.routes <= 0)
+        throw std::invalid_argument("line " + std::to_string(lineNumber) + ": routes must be positive");
+    return true;
+}
+
+std::shared_ptr<const PreparedInstance> prepareInstance(const BatchJob& job, ThreadPool* pool)
+{
+    CW_PROFILE_SCOPE("prepare_instance");
+    auto prepared = std::make_shared<PreparedInstance>();
+    if (!job.instance.empty()) {
+        Instance instance = loadInstance(job.instance);
+        prepared->points = instance.points();
+        prepared->demands = std::move(instance.demand);
+        prepared->readyTimes = std::move(instance.readyTime);
+        prepared->dueTimes = std::move(instance.dueTime);
+        prepared->serviceTimes = std::move(instance.serviceTime);
+        prepared->depots = std::move(instance.depots);
+        prepared->capacity = instance.capacity;
+    }
+    else {
+        prepared->points = generateUniquePoints(job.randomPoints, 0.0, 0.0, 40.0, 40.0, job.pointsSeed);
+    }
+    if (prepared->points.size() < 3)
+        throw std::runtime_error("instance " + job.instanceKey() + " has fewer than 3 nodes");
+
+    TriangulationOptions triangulation;
+    triangulation.pool = pool;
+    prepared->delaunay = buildDelaunayGraph(prepared->points, triangulation);
+
+    // Candidate edges take their costs from the provider the solver reads
+    prepared->distances = makeDistanceProvider(prepared->points);
+    setEdgeCosts(prepared->delaunay.graph, *prepared->distances);
+    return prepared;
+}
+
+std::size_t PreparedInstance::memoryBytes() const
+{
+    const Graph& graph = delaunay.graph;
+    std::size_t bytes = points.size() * sizeof(Point)
+        + delaunay.triangles.size() * sizeof(delaunay.triangles[0])
+        + (std::size_t)graph.vertexCount() * sizeof(int)
+        + (std::size_t)graph.edgeCount() * (sizeof(Edge) + 4 * sizeof(int))
+        + (demands.size() + readyTimes.size() + dueTimes.size() + serviceTimes.size()) * sizeof(double)
+        + depots.size() * sizeof(int);
+    if (distances) bytes += distances->memoryBytes();
+    return bytes;
+}
+
+struct InstanceCache::Entry
+{
+    std::shared_future<std::shared_ptr<const PreparedInstance>> ready;
+    std::list<std::string>::iterator lru;
+    std::size_t bytes = 0;  ///< memoryBytes() of the instance; 0 until it is prepared.
+};
+
+InstanceCache::InstanceCache(std::size_t capacity, std::size_t memoryBudget)
+    : capacity_(capacity), memoryBudget_(memoryBudget)
+{
+}
+
+void InstanceCache::evict()
+{
+    // Evicted instances stay alive for the jobs still holding them
+    while (!lru_.empty() && (entries_.size() > capacity_ || cachedBytes_ > memoryBudget_)) {
+        auto it = entries_.find(lru_.back());
+        cachedBytes_ -= it->second->bytes;
+        entries_.erase(it);
+        lru_.pop_back();
+    }
+}
+
+std::shared_ptr<const PreparedInstance> InstanceCache::get(const BatchJob& job)
+{
+    std::string key = job.instanceKey();
+    std::promise<std::shared_ptr<const PreparedInstance>> promise;
+    std::shared_ptr<Entry> entry;
+    bool owner = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        if (it != entries_.end()) {
+            ++hits_;
+            entry = it->second;
+            lru_.splice(lru_.begin(), lru_, entry->lru);
+        }
+        else {
+            ++misses_;
+            owner = true;
+            entry = std::make_shared<Entry>();
+            entry->ready = promise.get_future().share();
+            if (capacity_ > 0) {
+                lru_.push_front(key);
+                entry->lru = lru_.begin();
+                entries_.emplace(key, entry);
+                evict();
+            }
+        }
+    }
+
+    if (owner) {
+        try {
+            auto prepared = prepareInstance(job);
+            std::size_t bytes = prepared->memoryBytes();
+            promise.set_value(std::move(prepared));
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = entries_.find(key);
+            if (it != entries_.end() && it->second == entry) {
+                if (bytes > memoryBudget_) {
+                    // Keeping it would flush every other instance and still exceed the budget
+                    lru_.erase(entry->lru);
+                    entries_.erase(it);
+                }
+                else {
+                    entry->bytes = bytes;
+                    cachedBytes_ += bytes;
+                    evict();
+                }
+            }
+        }
+        catch (...) {
+            promise.set_exception(std::current_exception());
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = entries_.find(key);
+            if (it != entries_.end() && it->second == entry) {
+                lru_.erase(entry->lru);
+                entries_.erase(it);
+            }
+        }
+    }
+    return entry->ready.get();
+}
+
+std::uint64_t InstanceCache::hits() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+std::uint64_t InstanceCache::misses() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
+
+std::size_t InstanceCache::cachedBytes() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cachedBytes_;
+}
+
+BatchRunner::BatchRunner(const BatchOptions& options)
+    : pool_(options.pool), cache_(options.cacheSize, options.cacheBytes)
+{
+    if (pool_ == nullptr) {
+        ownPool_ = std::make_unique<ThreadPool>(options.threads);
+        pool_ = ownPool_.get();
+    }
+    scratch_.resize(pool_->size());
+}
+
+BatchRunner::~BatchRunner() = default;
+
+BatchSummary BatchRunner::run(std::istream& jobs, std::ostream& results)
+{
+    LineQueue queue;
+    std::mutex outputMutex;
+    BatchSummary summary;
+
+    auto emit = [&](const std::string& json, bool failed) {
+        std::lock_guard<std::mutex> lock(outputMutex);
+        results << json << '\n';
+        results.flush();
+        ++summary.jobs;
+        if (failed) ++summary.failed;
+    };
+
+    auto solve = [&](int lineNumber, const std::string& line, unsigned worker) {
+        BatchJob job;
+        try {
+            if (!parseBatchJob(line, lineNumber, job)) return;
+        }
+        catch (const std::exception& e) {
+            emit("{\"id\":\"" + escape(job.id) + "\",\"status\":\"error\",\"message\":\"" + escape(e.what()) + "\"}", true);
+            return;
+        }
+        try {
+            CW_PROFILE_SCOPE("batch_job");
+            auto start = std::chrono::steady_clock::now();
+            auto instance = cache_.get(job);
+            const Graph& graph = instance->delaunay.graph;
+
+            // Jobs already share the pool, so each one runs on a single thread
+            MultiRouteOptions options;
+            options.seed = job.seed;
+            options.threads = 1;
+            options.batchSize = job.batchSize;
+            options.distances = instance->distances.get();
+            // Routes of a single-depot file (every CVRPLIB instance) are round trips from it
+            if (instance->depots.size() == 1) options.terminals = { instance->depots[0], instance->depots[0] };
+            options.constraints.demands = instance->demands;
+            options.constraints.capacity = std::isfinite(job.capacity) ? job.capacity : instance->capacity;
+            options.constraints.maxLength = job.maxLength;
+            options.constraints.readyTimes = instance->readyTimes;
+            options.constraints.dueTimes = instance->dueTimes;
+            options.constraints.serviceTimes = instance->serviceTimes;
+            options.localSearch.enabled = job.localSearch;
+            options.localSearch.timeLimitMs = 0.0;  // A time limit would make results depend on load
+            options.scratch = &scratch_[worker];
+            options.printRoutes = false;
+
+            auto routes = solveMultipleRoutes(instance->points, graph, job.routes, options);
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            std::ostringstream json;
+            json << "{\"id\":\"" << escape(job.id) << "\",\"instance\":\"" << escape(job.instanceKey())
+                 << "\",\"status\":\"ok\",\"nodes\":" << instance->points.size() << ",\"routes\":[";
+            std::string lengths;
+            for (std::size_t r = 0; r < routes.size(); ++r) {
+                json << (r ? ",[" : "[");
+                std::vector<int> nodes = routeNodes(routes[r]);
+                for (std::size_t k = 0; k < nodes.size(); ++k) json << (k ? "," : "") << nodes[k];
+                json << ']';
+                if (r) lengths += ',';
+                appendShortest(lengths, routeLength(graph, routes[r]));
+            }
+            json << "],\"lengths\":[" << lengths << "],\"ms\":" << ms << '}';
+            emit(json.str(), false);
+        }
+        catch (const std::exception& e) {
+            emit("{\"id\":\"" + escape(job.id) + "\",\"status\":\"error\",\"message\":\"" + escape(e.what()) + "\"}", true);
+        }
+    };
+
+    // A separate reader keeps the workers busy, so results stream out before the input ends
+    std::thread reader([&] {
+        std::string line;
+        for (int lineNumber = 1; std::getline(jobs, line); ++lineNumber)
+            queue.push(lineNumber, line);
+        queue.close();
+    });
+
+    pool_->parallelFor((int)pool_->size(), [&](int, unsigned worker) {
+        int lineNumber = 0;
+        std::string line;
+        while (queue.pop(lineNumber, line))
+            solve(lineNumber, line, worker);
+    });
+    reader.join();
+    return summary;
+}
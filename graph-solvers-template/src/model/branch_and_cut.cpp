@@ -0,0 +1,901 @@
+#include "model/mip.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+
+namespace {
+
+constexpr double kInf = std::numeric_limits<double>::infinity();
+constexpr double kPrimalTol = 1e-7;    ///< Bound violation a basic variable may keep.
+constexpr double kDualTol = 1e-9;      ///< Wrong-sign reduced cost still taken as dual feasible.
+constexpr double kPivotTol = 1e-9;     ///< Smallest pivot row entry the ratio test accepts.
+constexpr double kIntegralTol = 1e-6;  ///< Distance to the nearest integer of an integral value.
+constexpr long long kHeuristicPeriod = 20;     ///< Nodes between calls of the primal heuristic.
+constexpr std::size_t kMaxCutsPerRound = 100;  ///< Most violated separator rows added per LP.
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * Bounded dual simplex for min cᵀx subject to A x - s = 0 and l <= (x, s) <= u.
+ *
+ * Variables 0..n-1 are the model columns and n..n+m-1 the slacks of the rows, so a row
+ * lower <= a·x <= upper becomes bounds on its slack. The basis inverse is kept as an
+ * explicit dense m × m matrix with product-form updates and periodic refactorization.
+ *
+ * Every column has finite bounds, so placing each nonbasic column at the bound that suits
+ * the sign of its reduced cost makes any basis dual feasible: the solver never needs a
+ * phase one. Tightening bounds (branching) and appending rows (cuts) keep the basis dual
+ * feasible as well, and the dual simplex continues from it. While dual feasible, cᵀx is a
+ * lower bound on the LP optimum even before the solve finishes.
+ */
+class DualSimplex
+{
+public:
+    enum class Result { Optimal, Infeasible, Interrupted };
+
+    explicit DualSimplex(const MipModel& model)
+        : n_(model.columnCount())
+    {
+        for (int j = 0; j < n_; ++j) {
+            if (!std::isfinite(model.lower[j]) || !std::isfinite(model.upper[j]) || model.lower[j] > model.upper[j])
+                throw std::invalid_argument("MIP column bounds must be finite and ordered");
+        }
+        cost_ = model.cost;
+        lower_ = model.lower;
+        upper_ = model.upper;
+        columns_.resize(n_);
+        reset();
+        for (const auto& row : model.rows) addRow(row);
+    }
+
+    int rowCount() const { return m_; }
+
+    /// Appends lower <= a·x <= upper; its slack enters the basis.
+    void addRow(const MipRow& row)
+    {
+        const int i = m_;
+        double activity = 0.0;
+        scratch_.assign(m_, 0.0);
+        std::vector<int>& basic = candidates_;
+        basic.clear();
+        auto& entries = rows_.emplace_back();
+        for (std::size_t k = 0; k < row.index.size(); ++k) {
+            int j = row.index[k];
+            if (row.value[k] == 0.0) continue;
+            columns_[j].push_back({ i, row.value[k] });
+            entries.push_back({ j, row.value[k] });
+            activity += row.value[k] * x_[j];
+            if (position_[j] >= 0) {
+                if (scratch_[position_[j]] == 0.0) basic.push_back(position_[j]);
+                scratch_[position_[j]] += row.value[k];
+            }
+        }
+        if (row.lower > row.upper + kPrimalTol) crossed_ = true;
+        cost_.push_back(0.0);
+        lower_.push_back(row.lower);
+        upper_.push_back(row.upper);
+        x_.push_back(activity);
+        d_.push_back(0.0);
+        state_.push_back(Basic);
+
+        // B' = [[B, 0], [c, -1]] with c the row's coefficients of the basic variables, so
+        // B'^-1 = [[B^-1, 0], [c B^-1, -1]]
+        reserve(m_ + 1);
+        double norm = 1.0;
+        for (int k = 0; k < m_; ++k) {
+            double* column = inverseColumn(k);
+            double sum = 0.0;
+            for (int r : basic) sum += scratch_[r] * column[r];
+            column[i] = sum;
+            norm += sum * sum;
+        }
+        double* last = inverseColumn(i);
+        std::fill(last, last + m_, 0.0);
+        last[i] = -1.0;
+        basis_.push_back(n_ + i);
+        position_.push_back(i);
+        weight_.push_back(norm);
+        ++m_;
+    }
+
+    /// @return Whether row i is basic and at least @p margin inside its bounds, i.e. not binding.
+    bool isLoose(int i, double margin) const
+    {
+        int slack = n_ + i;
+        return state_[slack] == Basic && x_[slack] > lower_[slack] + margin && x_[slack] < upper_[slack] - margin;
+    }
+
+    /**
+     * Drops the flagged rows, whose slacks must be basic. With the slack of row i basic in
+     * position r, the inverse of the smaller basis is B^-1 without row r and column i, and
+     * the values and reduced costs of all other variables stay the same.
+     */
+    void removeRows(const std::vector<char>& remove)
+    {
+        std::vector<int> newIndex(m_, -1), newPosition(m_, -1);
+        int rows = 0, kept = 0;
+        for (int i = 0; i < m_; ++i) {
+            if (!remove[i]) newIndex[i] = rows++;
+        }
+        if (rows == m_) return;
+        for (int r = 0; r < m_; ++r) {
+            int v = basis_[r];
+            if (v >= n_ && remove[v - n_]) continue;
+            newPosition[r] = kept;
+            basis_[kept] = v >= n_ ? n_ + newIndex[v - n_] : v;
+            ++kept;
+        }
+
+        // Entries only move toward the front, so the inverse compacts in place
+        for (int k = 0; k < m_; ++k) {
+            if (newIndex[k] < 0) continue;
+            const double* from = inverseColumn(k);
+            double* to = inverseColumn(newIndex[k]);
+            for (int r = 0; r < m_; ++r) {
+                if (newPosition[r] >= 0) to[newPosition[r]] = from[r];
+            }
+        }
+        basis_.resize(kept);
+
+        for (auto& column : columns_) {
+            std::erase_if(column, [&](const std::pair<int, double>& entry) { return remove[entry.first]; });
+            for (auto& entry : column) entry.first = newIndex[entry.first];
+        }
+        for (int i = 0; i < m_; ++i) {
+            if (newIndex[i] >= 0 && newIndex[i] != i) rows_[newIndex[i]] = std::move(rows_[i]);
+        }
+        rows_.resize(rows);
+        auto compact = [&](auto& values) {
+            for (int i = 0; i < m_; ++i) {
+                if (newIndex[i] >= 0) values[n_ + newIndex[i]] = values[n_ + i];
+            }
+            values.resize(n_ + rows);
+        };
+        compact(cost_);
+        compact(lower_);
+        compact(upper_);
+        compact(x_);
+        compact(d_);
+        compact(state_);
+        m_ = rows;
+        position_.assign(n_ + m_, -1);
+        for (int r = 0; r < m_; ++r) position_[basis_[r]] = r;
+        recomputeWeights();
+    }
+
+    /// Changes the bounds of column j, keeping the basis dual feasible.
+    void setBounds(int j, double lb, double ub)
+    {
+        lower_[j] = lb;
+        upper_[j] = ub;
+        if (state_[j] == Basic) return;
+        moveNonbasic(j, preferredValue(j));
+    }
+
+    double objective() const
+    {
+        double z = 0.0;
+        for (int j = 0; j < n_; ++j) z += cost_[j] * x_[j];
+        return z;
+    }
+
+    std::span<const double> values() const { return { x_.data(), (std::size_t)n_ }; }
+
+    /// Runs dual simplex iterations until optimal, infeasible or past @p deadline.
+    Result solve(Clock::time_point deadline)
+    {
+        if (crossed_) return Result::Infeasible;
+        restoreDualFeasibility();
+        for (long long iteration = 0;; ++iteration) {
+            if (sinceRefactor_ >= std::max(200, m_)) refactor();
+            if ((iteration & 63) == 63 && Clock::now() > deadline) return Result::Interrupted;
+
+            // Leaving row: largest infeasibility relative to its dual steepest-edge weight
+            int r = -1;
+            double best = 0.0;
+            for (int k = 0; k < m_; ++k) {
+                int v = basis_[k];
+                double infeasibility = std::max(lower_[v] - x_[v], x_[v] - upper_[v]);
+                if (infeasibility <= kPrimalTol) continue;
+                double score = infeasibility * infeasibility / std::max(weight_[k], 1e-12);
+                if (score > best) {
+                    best = score;
+                    r = k;
+                }
+            }
+            if (r < 0) return Result::Optimal;
+
+            int leaving = basis_[r];
+            bool toLower = x_[leaving] < lower_[leaving];
+            double sign = toLower ? -1.0 : 1.0;
+            computePivotRow(r, sign);
+
+            // Harris ratio test: largest bound on the dual step, then the largest pivot within it
+            double limit = kInf;
+            for (int j : candidates_) {
+                double a = sign * alpha_[j];
+                double dj = state_[j] == AtLower ? std::max(d_[j], 0.0) : std::min(d_[j], 0.0);
+                limit = std::min(limit, (std::abs(dj) + kDualTol) / std::abs(a));
+            }
+            if (limit == kInf) return Result::Infeasible;
+
+            int q = -1;
+            double pivot = 0.0;
+            for (int j : candidates_) {
+                double dj = state_[j] == AtLower ? std::max(d_[j], 0.0) : std::min(d_[j], 0.0);
+                if (std::abs(dj) / std::abs(alpha_[j]) <= limit && std::abs(alpha_[j]) > pivot) {
+                    pivot = std::abs(alpha_[j]);
+                    q = j;
+                }
+            }
+
+            // Entering column; a mismatch with the pivot row means the inverse has drifted
+            computeColumn(q, column_);
+            if (std::abs(column_[r] - alpha_[q]) > 1e-7 * std::max(1.0, std::abs(alpha_[q]))) {
+                if (sinceRefactor_ > 0) {
+                    refactor();
+                    continue;
+                }
+            }
+            pivotOn(r, q, toLower ? lower_[leaving] : upper_[leaving]);
+        }
+    }
+
+private:
+    enum State : char { Basic, AtLower, AtUpper };
+
+    /// Column k of B^-1 (stored column-major, so B^-1 a_j is a sum of contiguous columns).
+    double* inverseColumn(int k) { return inverse_.data() + (std::size_t)k * stride_; }
+    const double* inverseColumn(int k) const { return inverse_.data() + (std::size_t)k * stride_; }
+
+    void reserve(int rows)
+    {
+        if (rows <= stride_) return;
+        int stride = std::max(rows, 2 * stride_ + 16);
+        std::vector<double> grown((std::size_t)stride * stride, 0.0);
+        for (int k = 0; k < m_; ++k)
+            std::copy_n(inverseColumn(k), m_, grown.data() + (std::size_t)k * stride);
+        inverse_ = std::move(grown);
+        stride_ = stride;
+    }
+
+    /// Squared norms of the rows of B^-1, the dual steepest-edge weights.
+    void recomputeWeights()
+    {
+        weight_.assign(m_, 0.0);
+        for (int k = 0; k < m_; ++k) {
+            const double* column = inverseColumn(k);
+            for (int r = 0; r < m_; ++r) weight_[r] += column[r] * column[r];
+        }
+    }
+
+    /// Slack basis B = -I with every column at the bound its cost prefers.
+    void reset()
+    {
+        const int rows = m_;
+        basis_.resize(rows);
+        position_.assign(n_ + rows, -1);
+        state_.assign(n_ + rows, Basic);
+        x_.assign(n_ + rows, 0.0);
+        d_.assign(n_ + rows, 0.0);
+        for (int j = 0; j < n_; ++j) {
+            d_[j] = cost_[j];
+            state_[j] = cost_[j] >= 0.0 ? AtLower : AtUpper;
+            x_[j] = cost_[j] >= 0.0 ? lower_[j] : upper_[j];
+        }
+        reserve(rows);
+        for (int i = 0; i < rows; ++i) {
+            double* column = inverseColumn(i);
+            std::fill(column, column + rows, 0.0);
+            column[i] = -1.0;
+            basis_[i] = n_ + i;
+            position_[n_ + i] = i;
+        }
+        weight_.assign(rows, 1.0);
+        recomputePrimal();
+        sinceRefactor_ = 0;
+    }
+
+    double preferredValue(int j) const
+    {
+        if (lower_[j] == upper_[j]) return lower_[j];
+        if (d_[j] > kDualTol && std::isfinite(lower_[j])) return lower_[j];
+        if (d_[j] < -kDualTol && std::isfinite(upper_[j])) return upper_[j];
+        // Zero reduced cost: stay at the nearer finite bound
+        if (!std::isfinite(upper_[j])) return lower_[j];
+        if (!std::isfinite(lower_[j])) return upper_[j];
+        return std::abs(x_[j] - lower_[j]) <= std::abs(x_[j] - upper_[j]) ? lower_[j] : upper_[j];
+    }
+
+    void moveNonbasic(int j, double value)
+    {
+        state_[j] = value == lower_[j] ? AtLower : AtUpper;
+        double delta = value - x_[j];
+        if (delta == 0.0) return;
+        computeColumn(j, column_);
+        for (int r = 0; r < m_; ++r) x_[basis_[r]] -= delta * column_[r];
+        x_[j] = value;
+    }
+
+    void restoreDualFeasibility()
+    {
+        for (int j = 0; j < n_ + m_; ++j) {
+            if (state_[j] == Basic) continue;
+            double value = preferredValue(j);
+            if (value != x_[j]) moveNonbasic(j, value);
+        }
+    }
+
+    /// column = B^-1 a_j
+    void computeColumn(int j, std::vector<double>& column) const
+    {
+        column.assign(m_, 0.0);
+        if (j >= n_) {
+            const double* from = inverseColumn(j - n_);
+            for (int r = 0; r < m_; ++r) column[r] = -from[r];
+            return;
+        }
+        for (auto [i, v] : columns_[j]) {
+            const double* from = inverseColumn(i);
+            for (int r = 0; r < m_; ++r) column[r] += v * from[r];
+        }
+    }
+
+    /// Fills alpha_ = e_r B^-1 [A | -I] for every nonbasic variable (fixed ones keep their
+    /// reduced costs current for when branching releases them) and keeps in candidates_
+    /// those whose move pushes the leaving variable toward its violated bound.
+    void computePivotRow(int r, double sign)
+    {
+        // Row-wise over the nonzeros of e_r B^-1, which is usually sparse
+        alpha_.assign(n_ + m_, 0.0);
+        for (int k = 0; k < m_; ++k) {
+            double rho = inverseColumn(k)[r];
+            alpha_[n_ + k] = -rho;
+            if (rho == 0.0) continue;
+            for (auto [j, v] : rows_[k]) alpha_[j] += rho * v;
+        }
+        candidates_.clear();
+        for (int j = 0; j < n_ + m_; ++j) {
+            if (state_[j] == Basic) continue;
+            double a = alpha_[j];
+            if (std::abs(a) <= kPivotTol || lower_[j] == upper_[j]) continue;
+            if (state_[j] == AtLower ? sign * a > 0.0 : sign * a < 0.0) candidates_.push_back(j);
+        }
+    }
+
+    void pivotOn(int r, int q, double target)
+    {
+        int leaving = basis_[r];
+        const double pivot = column_[r];
+
+        // Primal: the leaving variable lands on its bound
+        double step = (x_[leaving] - target) / pivot;
+        x_[q] += step;
+        for (int k = 0; k < m_; ++k) x_[basis_[k]] -= step * column_[k];
+        x_[leaving] = target;
+
+        // Dual; the entering reduced cost is clamped to its sign like in the ratio test
+        double dq = state_[q] == AtLower ? std::max(d_[q], 0.0) : std::min(d_[q], 0.0);
+        double dualStep = dq / alpha_[q];
+        for (int j = 0; j < n_ + m_; ++j) {
+            if (state_[j] != Basic) d_[j] -= dualStep * alpha_[j];
+        }
+        d_[leaving] = -dualStep;
+        d_[q] = 0.0;
+
+        // Steepest-edge weights: exact for the pivot row, an upper bound for the others
+        // (refactor() recomputes them exactly)
+        double pivotWeight = weight_[r] / (pivot * pivot);
+        for (int i = 0; i < m_; ++i) {
+            double ratio = column_[i] / pivot;
+            weight_[i] = std::max(weight_[i], ratio * ratio * weight_[r]);
+        }
+        weight_[r] = std::max(pivotWeight, 1e-12);
+
+        // Basis inverse, one column at a time: divide row r by the pivot and eliminate the
+        // entering column from the other rows; columns with a zero in row r are unchanged
+        column_[r] = 0.0;
+        for (int k = 0; k < m_; ++k) {
+            double* column = inverseColumn(k);
+            if (column[r] == 0.0) continue;
+            double f = column[r] / pivot;
+            for (int i = 0; i < m_; ++i) column[i] -= column_[i] * f;
+            column[r] = f;
+        }
+
+        basis_[r] = q;
+        position_[q] = r;
+        position_[leaving] = -1;
+        state_[q] = Basic;
+        state_[leaving] = target == lower_[leaving] ? AtLower : AtUpper;
+        ++sinceRefactor_;
+    }
+
+    /// x_B = -B^-1 N x_N
+    void recomputePrimal()
+    {
+        std::vector<double>& rhs = scratch_;
+        rhs.assign(m_, 0.0);
+        for (int j = 0; j < n_; ++j) {
+            if (state_[j] == Basic || x_[j] == 0.0) continue;
+            for (auto [i, v] : columns_[j]) rhs[i] -= v * x_[j];
+        }
+        for (int i = 0; i < m_; ++i) {
+            if (state_[n_ + i] != Basic) rhs[i] += x_[n_ + i];
+        }
+        column_.assign(m_, 0.0);
+        for (int k = 0; k < m_; ++k) {
+            if (rhs[k] == 0.0) continue;
+            const double* column = inverseColumn(k);
+            for (int r = 0; r < m_; ++r) column_[r] += column[r] * rhs[k];
+        }
+        for (int r = 0; r < m_; ++r) x_[basis_[r]] = column_[r];
+    }
+
+    /// d = c - (c_B B^-1) [A | -I]
+    void recomputeDual()
+    {
+        std::vector<double>& y = scratch_;
+        y.assign(m_, 0.0);
+        for (int k = 0; k < m_; ++k) {
+            const double* column = inverseColumn(k);
+            double sum = 0.0;
+            for (int r = 0; r < m_; ++r) sum += cost_[basis_[r]] * column[r];
+            y[k] = sum;
+        }
+        for (int j = 0; j < n_; ++j) {
+            if (state_[j] == Basic) {
+                d_[j] = 0.0;
+                continue;
+            }
+            double s = cost_[j];
+            for (auto [i, v] : columns_[j]) s -= y[i] * v;
+            d_[j] = s;
+        }
+        for (int i = 0; i < m_; ++i) d_[n_ + i] = state_[n_ + i] == Basic ? 0.0 : y[i];
+    }
+
+    /**
+     * Inverts the basis from scratch; falls back to the slack basis if it is singular.
+     *
+     * With the rows T whose slacks are nonbasic ordered first, B = [[B_TX, 0], [B_SX, -I]]
+     * for the basic structural columns X, so B^-1 = [[B_TX^-1, 0], [B_SX B_TX^-1, -I]] and
+     * only the |X| × |X| block needs a dense inversion.
+     */
+    void refactor()
+    {
+        std::vector<int> local(m_, -1);  // row in T -> index in the block
+        int t = 0;
+        for (int i = 0; i < m_; ++i) {
+            if (state_[n_ + i] != Basic) local[i] = t++;
+        }
+        std::vector<int> structural;     // block column -> basis position
+        for (int p = 0; p < m_; ++p) {
+            if (basis_[p] < n_) structural.push_back(p);
+        }
+
+        std::vector<double> a((std::size_t)t * t, 0.0), inv((std::size_t)t * t, 0.0);
+        for (int c = 0; c < t; ++c) {
+            for (auto [i, v] : columns_[basis_[structural[c]]]) {
+                if (local[i] >= 0) a[(std::size_t)local[i] * t + c] = v;
+            }
+            inv[(std::size_t)c * t + c] = 1.0;
+        }
+
+        // Gauss-Jordan with partial pivoting on [B_TX | I]
+        for (int c = 0; c < t; ++c) {
+            int p = c;
+            for (int i = c + 1; i < t; ++i) {
+                if (std::abs(a[(std::size_t)i * t + c]) > std::abs(a[(std::size_t)p * t + c])) p = i;
+            }
+            double pv = a[(std::size_t)p * t + c];
+            if (std::abs(pv) < 1e-11) {
+                reset();
+                return;
+            }
+            if (p != c) {
+                std::swap_ranges(a.begin() + (std::size_t)p * t, a.begin() + (std::size_t)(p + 1) * t, a.begin() + (std::size_t)c * t);
+                std::swap_ranges(inv.begin() + (std::size_t)p * t, inv.begin() + (std::size_t)(p + 1) * t, inv.begin() + (std::size_t)c * t);
+            }
+            double* ac = a.data() + (std::size_t)c * t;
+            double* ic = inv.data() + (std::size_t)c * t;
+            for (int k = 0; k < t; ++k) {
+                ac[k] /= pv;
+                ic[k] /= pv;
+            }
+            for (int i = 0; i < t; ++i) {
+                if (i == c) continue;
+                double f = a[(std::size_t)i * t + c];
+                if (f == 0.0) continue;
+                double* ai = a.data() + (std::size_t)i * t;
+                double* ii = inv.data() + (std::size_t)i * t;
+                for (int k = c; k < t; ++k) ai[k] -= f * ac[k];
+                for (int k = 0; k < t; ++k) ii[k] -= f * ic[k];
+            }
+        }
+
+        // Row c of the reduced block belongs to basis position structural[c]; slack rows
+        // combine those rows with their coefficients on the basic structurals
+        for (int k = 0; k < m_; ++k) std::fill(inverseColumn(k), inverseColumn(k) + m_, 0.0);
+        for (int c = 0; c < t; ++c) {
+            const double* row = inv.data() + (std::size_t)c * t;
+            for (int i = 0; i < m_; ++i) {
+                if (local[i] >= 0) inverseColumn(i)[structural[c]] = row[local[i]];
+            }
+            for (auto [s, v] : columns_[basis_[structural[c]]]) {
+                if (local[s] >= 0) continue;
+                int q = position_[n_ + s];
+                for (int i = 0; i < m_; ++i) {
+                    if (local[i] >= 0) inverseColumn(i)[q] += v * row[local[i]];
+                }
+            }
+        }
+        for (int s = 0; s < m_; ++s) {
+            if (local[s] < 0) inverseColumn(s)[position_[n_ + s]] = -1.0;
+        }
+        recomputeWeights();
+        recomputePrimal();
+        recomputeDual();
+        sinceRefactor_ = 0;
+    }
+
+    int n_ = 0;
+    int m_ = 0;
+    int stride_ = 0;
+    std::vector<double> cost_, lower_, upper_;           ///< Columns, then slacks.
+    std::vector<std::vector<std::pair<int, double>>> columns_;  ///< Sparse A by column.
+    std::vector<std::vector<std::pair<int, double>>> rows_;     ///< The same entries by row.
+    std::vector<double> x_;        ///< Value of every variable.
+    std::vector<double> d_;        ///< Reduced costs (0 for basic variables).
+    std::vector<State> state_;
+    std::vector<int> basis_;       ///< Basic variable of each basis position.
+    std::vector<int> position_;    ///< Basis position of each variable, -1 if nonbasic.
+    std::vector<double> inverse_;  ///< Dense B^-1, column-major with stride_.
+    std::vector<double> weight_;   ///< Squared norms of the rows of B^-1 (dual steepest edge).
+    int sinceRefactor_ = 0;
+    bool crossed_ = false;         ///< Some row has lower > upper.
+
+    std::vector<double> alpha_, column_, scratch_;
+    std::vector<int> candidates_;
+};
+
+/// Bound change on the path from the root to a node.
+struct BoundChange
+{
+    int column;
+    double lower;
+    double upper;
+};
+
+struct Node
+{
+    std::vector<BoundChange> changes;  ///< Cumulative, applied in order.
+    double bound;                      ///< LP bound of the parent.
+    int depth;
+};
+
+struct NodeOrder
+{
+    bool operator()(const Node& a, const Node& b) const
+    {
+        if (a.bound != b.bound) return a.bound > b.bound;
+        return a.depth < b.depth;
+    }
+};
+
+bool isIntegral(const MipModel& model, std::span<const double> x)
+{
+    for (int j = 0; j < model.columnCount(); ++j) {
+        if (model.integer[j] && std::abs(x[j] - std::round(x[j])) > kIntegralTol) return false;
+    }
+    return true;
+}
+
+/**
+ * Best-bound branch-and-cut with diving: after branching the solver continues with one child
+ * and queues the other, so bound changes between consecutive LPs stay small.
+ */
+class BranchAndCutBackend : public MipBackend
+{
+public:
+    const char* name() const override { return "bundled"; }
+
+    MipResult solve(const MipModel& model, MipSeparator& separator, const MipOptions& options) override
+    {
+        const auto started = Clock::now();
+        const auto deadline = started + std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(std::max(0.0, options.timeLimit)));
+        const int n = model.columnCount();
+
+        MipResult result;
+        result.objective = kInf;
+        DualSimplex lp(model);
+        std::vector<MipRow> cuts;
+
+        // Cuts in the LP after the model rows, and those dropped after staying loose for a few
+        // LPs in a row; a dropped cut stays valid and returns once an LP point violates it again
+        const int modelRows = (int)model.rows.size();
+        std::vector<MipRow> active, pool;
+        std::vector<int> looseCount;  // per active cut
+        std::vector<double> point;
+        std::vector<char> remove;
+
+        auto addCuts = [&](std::vector<MipRow>& rows, std::span<const double> x) {
+            if (rows.size() > kMaxCutsPerRound) {
+                std::vector<std::pair<double, std::size_t>> order;
+                for (std::size_t k = 0; k < rows.size(); ++k) order.push_back({ -rows[k].violation(x), k });
+                std::nth_element(order.begin(), order.begin() + kMaxCutsPerRound, order.end());
+                std::vector<MipRow> strongest;
+                for (std::size_t k = 0; k < kMaxCutsPerRound; ++k) strongest.push_back(std::move(rows[order[k].second]));
+                rows = std::move(strongest);
+            }
+            int added = 0;
+            for (auto& row : rows) {
+                if (row.violation(x) <= 1e-6) continue;
+                lp.addRow(row);
+                active.push_back(std::move(row));
+                looseCount.push_back(0);
+                ++added;
+            }
+            result.cuts += added;
+            rows.clear();
+            return added;
+        };
+
+        auto restoreFromPool = [&](std::span<const double> x) {
+            int restored = 0;
+            std::erase_if(pool, [&](MipRow& row) {
+                if (row.violation(x) <= 1e-6) return false;
+                lp.addRow(row);
+                active.push_back(std::move(row));
+                looseCount.push_back(0);
+                ++restored;
+                return true;
+            });
+            return restored;
+        };
+
+        auto dropLooseCuts = [&]() {
+            remove.assign(lp.rowCount(), 0);
+            bool any = false;
+            for (int i = modelRows; i < lp.rowCount(); ++i) {
+                int& count = looseCount[i - modelRows];
+                count = lp.isLoose(i, 1e-4) ? count + 1 : 0;
+                remove[i] = count >= 8;
+                any = any || remove[i];
+            }
+            if (!any) return;
+            lp.removeRows(remove);
+            int kept = 0;
+            for (int k = 0; k < (int)active.size(); ++k) {
+                if (remove[modelRows + k]) {
+                    pool.push_back(std::move(active[k]));
+                }
+                else if (kept++ != k) {
+                    active[kept - 1] = std::move(active[k]);
+                    looseCount[kept - 1] = looseCount[k];
+                }
+            }
+            active.resize(kept);
+            looseCount.resize(kept);
+        };
+
+        // Warm starts and heuristic solutions: accepted only if integral and passing the
+        // bounds, the rows and the separator
+        auto tryCandidate = [&](std::span<const double> x) {
+            if ((int)x.size() != n) return;
+            bool feasible = isIntegral(model, x);
+            for (int j = 0; j < n && feasible; ++j) feasible = x[j] >= model.lower[j] - 1e-9 && x[j] <= model.upper[j] + 1e-9;
+            for (const auto& row : model.rows) {
+                if (!feasible) break;
+                feasible = row.violation(x) <= 1e-6;
+            }
+            if (!feasible) return;
+            separator.separateIntegral(x, cuts);
+            if (cuts.empty()) acceptIncumbent(model, x, result);
+            cuts.clear();
+        };
+        if (!options.start.empty()) tryCandidate(options.start);
+        std::vector<double> candidate;
+
+        std::priority_queue<Node, std::vector<Node>, NodeOrder> open;
+        std::vector<BoundChange> applied;   // bound changes currently in the LP
+        double unresolved = kInf;           // bound of nodes abandoned because of the time limit
+        bool stopped = false;
+        auto lastLog = started;
+
+        auto applyChanges = [&](const std::vector<BoundChange>& changes) {
+            for (const auto& c : applied) lp.setBounds(c.column, model.lower[c.column], model.upper[c.column]);
+            for (const auto& c : changes) lp.setBounds(c.column, c.lower, c.upper);
+            applied = changes;
+        };
+
+        auto globalBound = [&](double current) {
+            double bound = std::min(current, unresolved);
+            if (!open.empty()) bound = std::min(bound, open.top().bound);
+            return std::min(bound, result.objective);
+        };
+
+        auto closeEnough = [&](double bound) {
+            if (result.x.empty()) return false;
+            return result.objective - bound <= options.relativeGap * std::max(std::abs(result.objective), 1e-10);
+        };
+
+        std::optional<Node> next = Node{ {}, -kInf, 0 };
+        while (next || !open.empty()) {
+            if (!next) {
+                next = open.top();
+                open.pop();
+            }
+            Node node = std::move(*next);
+            next.reset();
+
+            if (closeEnough(globalBound(node.bound))) {
+                open.push(std::move(node));
+                break;
+            }
+            if (Clock::now() > deadline || (options.nodeLimit >= 0 && result.nodes >= options.nodeLimit)) {
+                open.push(std::move(node));
+                stopped = true;
+                break;
+            }
+            ++result.nodes;
+            applyChanges(node.changes);
+
+            // Cut loop: resolve while the separator finds violated rows
+            int rounds = 0;
+            double lastBound = -kInf;
+            int stalled = 0;
+            for (;;) {
+                auto status = lp.solve(deadline);
+                if (status == DualSimplex::Result::Infeasible) break;
+                double z = std::max(lp.objective(), node.bound);
+                if (status == DualSimplex::Result::Interrupted) {
+                    unresolved = std::min(unresolved, z);
+                    stopped = true;
+                    break;
+                }
+                if (!result.x.empty() && z >= result.objective - options.relativeGap * std::max(std::abs(result.objective), 1e-10))
+                    break;
+
+                // Copied: adding rows to the LP may move its storage
+                point.assign(lp.values().begin(), lp.values().end());
+                std::span<const double> x = point;
+                if (restoreFromPool(x) > 0) continue;
+                dropLooseCuts();
+                if (isIntegral(model, x)) {
+                    separator.separateIntegral(x, cuts);
+                    if (addCuts(cuts, x) > 0) continue;
+                    acceptIncumbent(model, x, result);
+                    break;
+                }
+
+                // Fractional: strengthen with cuts until the bound tails off, then branch
+                int maxRounds = node.depth == 0 ? 200 : 3;
+                if (rounds < maxRounds && stalled < (node.depth == 0 ? 5 : 1)) {
+                    separator.separateFractional(x, cuts);
+                    ++rounds;
+                    if (addCuts(cuts, x) > 0) {
+                        stalled = z - lastBound > 1e-4 * std::max(1.0, std::abs(z)) ? 0 : stalled + 1;
+                        lastBound = z;
+                        continue;
+                    }
+                }
+
+                // Primal heuristic on the final LP of the root and of every kHeuristicPeriod-th node
+                if (node.depth == 0 || result.nodes % kHeuristicPeriod == 0) {
+                    candidate.clear();
+                    if (separator.suggestSolution(x, candidate)) tryCandidate(candidate);
+                    if (!result.x.empty() && z >= result.objective - options.relativeGap * std::max(std::abs(result.objective), 1e-10))
+                        break;
+                }
+
+                int column = branchingColumn(model, x);
+                double value = x[column];
+                Node down{ node.changes, z, node.depth + 1 };
+                down.changes.push_back({ column, lowerOf(node.changes, model, column), std::floor(value) });
+                Node up{ node.changes, z, node.depth + 1 };
+                up.changes.push_back({ column, std::ceil(value), upperOf(node.changes, model, column) });
+
+                // Dive toward the side the LP leans to
+                bool upFirst = value - std::floor(value) >= 0.5;
+                open.push(upFirst ? std::move(down) : std::move(up));
+                next = upFirst ? std::move(up) : std::move(down);
+                break;
+            }
+            if (stopped) break;
+
+            if (options.verbose && Clock::now() - lastLog > std::chrono::seconds(1)) {
+                lastLog = Clock::now();
+                log(result, globalBound(next ? next->bound : kInf), open.size(), started);
+            }
+        }
+
+        double bound = globalBound(next ? next->bound : kInf);
+        if (open.empty() && !next && unresolved == kInf) bound = result.objective;
+        result.bound = result.x.empty() ? bound : std::min(bound, result.objective);
+        if (result.x.empty()) {
+            result.status = (open.empty() && !next && !stopped) ? MipStatus::Infeasible : MipStatus::NoSolution;
+            if (result.status == MipStatus::Infeasible) result.bound = kInf;
+        }
+        else {
+            result.status = closeEnough(result.bound) ? MipStatus::Optimal : MipStatus::Feasible;
+        }
+        result.seconds = std::chrono::duration<double>(Clock::now() - started).count();
+        if (options.verbose) log(result, result.bound, open.size(), started);
+        return result;
+    }
+
+private:
+    static double lowerOf(const std::vector<BoundChange>& changes, const MipModel& model, int column)
+    {
+        for (auto it = changes.rbegin(); it != changes.rend(); ++it) {
+            if (it->column == column) return it->lower;
+        }
+        return model.lower[column];
+    }
+
+    static double upperOf(const std::vector<BoundChange>& changes, const MipModel& model, int column)
+    {
+        for (auto it = changes.rbegin(); it != changes.rend(); ++it) {
+            if (it->column == column) return it->upper;
+        }
+        return model.upper[column];
+    }
+
+    /// Most fractional integer column; ties go to the larger cost, then the lower index.
+    static int branchingColumn(const MipModel& model, std::span<const double> x)
+    {
+        int best = -1;
+        double bestScore = -1.0;
+        for (int j = 0; j < model.columnCount(); ++j) {
+            if (!model.integer[j]) continue;
+            double f = x[j] - std::floor(x[j]);
+            double score = std::min(f, 1.0 - f);
+            if (score <= kIntegralTol) continue;
+            score += 1e-9 * std::abs(model.cost[j]);
+            if (score > bestScore) {
+                bestScore = score;
+                best = j;
+            }
+        }
+        return best;
+    }
+
+    static void acceptIncumbent(const MipModel& model, std::span<const double> x, MipResult& result)
+    {
+        std::vector<double> rounded(x.begin(), x.end());
+        double objective = 0.0;
+        for (int j = 0; j < model.columnCount(); ++j) {
+            if (model.integer[j]) rounded[j] = std::round(rounded[j]);
+            objective += model.cost[j] * rounded[j];
+        }
+        if (objective < result.objective) {
+            result.objective = objective;
+            result.x = std::move(rounded);
+        }
+    }
+
+    static void log(const MipResult& result, double bound, std::size_t open, Clock::time_point started)
+    {
+        double seconds = std::chrono::duration<double>(Clock::now() - started).count();
+        std::cout << std::fixed << std::setprecision(2) << "[bundled] " << seconds << "s nodes " << result.nodes
+            << " open " << open << " cuts " << result.cuts << " best " << result.objective << " bound " << bound
+            << " gap " << 100.0 * std::max(0.0, result.objective - bound) / std::max(std::abs(result.objective), 1e-10)
+            << "%" << std::defaultfloat << std::endl;
+    }
+};
+
+} // namespace
+
+std::unique_ptr<MipBackend> makeBranchAndCutBackend()
+{
+    return std::make_unique<BranchAndCutBackend>();
+}
@@ -0,0 +1,191 @@
+#ifdef CW_HAVE_CPLEX
+
+#include "model/mip.h"
+
+#include <ilcplex/ilocplex.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+/// Builds the linear expression of @p row over @p vars.
+IloExpr rowExpression(IloEnv env, const IloNumVarArray& vars, const MipRow& row)
+{
+    IloExpr expr(env);
+    for (std::size_t k = 0; k < row.index.size(); ++k) expr += row.value[k] * vars[row.index[k]];
+    return expr;
+}
+
+IloRange toRange(IloEnv env, const IloNumVarArray& vars, const MipRow& row)
+{
+    const double inf = std::numeric_limits<double>::infinity();
+    IloExpr expr = rowExpression(env, vars, row);
+    IloRange range(env, row.lower == -inf ? -IloInfinity : row.lower, expr, row.upper == inf ? IloInfinity : row.upper);
+    expr.end();
+    return range;
+}
+
+/**
+ * Generic callback forwarding CPLEX's candidate and relaxation points to the separator:
+ * candidates it cuts off are rejected with its rows as lazy constraints, and rows found on
+ * relaxations are added as user cuts. CPLEX may call from several threads; the separator is
+ * not required to be thread-safe, so calls are serialized.
+ */
+class SeparatorCallback : public IloCplex::Callback::Function
+{
+public:
+    SeparatorCallback(const IloNumVarArray& vars, MipSeparator& separator, int& cuts)
+        : vars_(vars)
+        , separator_(separator)
+        , cuts_(cuts)
+    {
+    }
+
+    void invoke(const IloCplex::Callback::Context& context) override
+    {
+        IloEnv env = context.getEnv();
+        IloNumArray values(env);
+        std::vector<double> x, solution;
+        std::vector<MipRow> rows;
+
+        bool candidate = context.inCandidate();
+        if (candidate) {
+            if (!context.isCandidatePoint()) return;
+            context.getCandidatePoint(vars_, values);
+        }
+        else {
+            context.getRelaxationPoint(vars_, values);
+        }
+        x.resize(values.getSize());
+        for (IloInt j = 0; j < values.getSize(); ++j) x[j] = values[j];
+
+        bool suggested = false;
+        {
+            std::lock_guard lock(mutex_);
+            if (candidate) {
+                separator_.separateIntegral(x, rows);
+            }
+            else {
+                separator_.separateFractional(x, rows);
+                suggested = separator_.suggestSolution(x, solution);
+            }
+            cuts_ += (int)rows.size();
+        }
+
+        if (candidate && !rows.empty()) {
+            IloRangeArray lazy(env);
+            for (const auto& row : rows) lazy.add(toRange(env, vars_, row));
+            context.rejectCandidate(lazy);
+            lazy.endElements();
+            lazy.end();
+        }
+        else if (!candidate) {
+            for (const auto& row : rows) {
+                IloRange cut = toRange(env, vars_, row);
+                context.addUserCut(cut, IloCplex::UseCutPurge, IloFalse);
+                cut.end();
+            }
+        }
+        if (suggested) {
+            IloNumArray start(env, (IloInt)solution.size());
+            for (std::size_t j = 0; j < solution.size(); ++j) start[(IloInt)j] = solution[j];
+            context.postHeuristicSolution(vars_, start, IloInfinity,
+                IloCplex::Callback::Context::SolutionStrategy::CheckFeasible);
+            start.end();
+        }
+        values.end();
+    }
+
+private:
+    const IloNumVarArray& vars_;
+    MipSeparator& separator_;
+    int& cuts_;
+    std::mutex mutex_;
+};
+
+class CplexBackend : public MipBackend
+{
+public:
+    const char* name() const override { return "cplex"; }
+
+    MipResult solve(const MipModel& model, MipSeparator& separator, const MipOptions& options) override
+    {
+        const double inf = std::numeric_limits<double>::infinity();
+        const int n = model.columnCount();
+        MipResult result;
+        result.objective = inf;
+        result.bound = -inf;
+
+        IloEnv env;
+        try {
+            IloModel ilo(env);
+            IloNumVarArray vars(env);
+            for (int j = 0; j < n; ++j) {
+                vars.add(IloNumVar(env, model.lower[j] == -inf ? -IloInfinity : model.lower[j],
+                    model.upper[j] == inf ? IloInfinity : model.upper[j], model.integer[j] ? ILOINT : ILOFLOAT));
+            }
+            IloExpr objective(env);
+            for (int j = 0; j < n; ++j) objective += model.cost[j] * vars[j];
+            ilo.add(IloMinimize(env, objective));
+            objective.end();
+            for (const auto& row : model.rows) ilo.add(toRange(env, vars, row));
+
+            IloCplex cplex(ilo);
+            cplex.setParam(IloCplex::Param::TimeLimit, options.timeLimit);
+            cplex.setParam(IloCplex::Param::MIP::Tolerances::MIPGap, options.relativeGap);
+            cplex.setParam(IloCplex::Param::Threads, (IloInt)options.threads);
+            if (options.nodeLimit >= 0) cplex.setParam(IloCplex::Param::MIP::Limits::Nodes, (IloInt)options.nodeLimit);
+            if (!options.verbose) cplex.setOut(env.getNullStream());
+
+            if ((int)options.start.size() == n) {
+                IloNumArray start(env, n);
+                for (int j = 0; j < n; ++j) start[j] = options.start[j];
+                cplex.addMIPStart(vars, start);
+                start.end();
+            }
+
+            SeparatorCallback callback(vars, separator, result.cuts);
+            cplex.use(&callback, IloCplex::Callback::Context::Id::Candidate | IloCplex::Callback::Context::Id::Relaxation);
+
+            bool solved = cplex.solve();
+            result.nodes = cplex.getNnodes64();
+            IloAlgorithm::Status status = cplex.getStatus();
+            if (solved) {
+                IloNumArray values(env);
+                cplex.getValues(values, vars);
+                result.x.resize(n);
+                for (int j = 0; j < n; ++j) result.x[j] = model.integer[j] ? std::round(values[j]) : values[j];
+                values.end();
+                result.objective = cplex.getObjValue();
+                result.bound = std::min(cplex.getBestObjValue(), result.objective);
+                result.status = status == IloAlgorithm::Optimal ? MipStatus::Optimal : MipStatus::Feasible;
+            }
+            else {
+                result.status = status == IloAlgorithm::Infeasible ? MipStatus::Infeasible : MipStatus::NoSolution;
+                result.bound = status == IloAlgorithm::Infeasible ? inf : cplex.getBestObjValue();
+            }
+            result.seconds = cplex.getTime();
+        }
+        catch (const IloException& e) {
+            env.end();
+            throw std::runtime_error(std::string("CPLEX: ") + e.getMessage());
+        }
+        env.end();
+        return result;
+    }
+};
+
+} // namespace
+
+std::unique_ptr<MipBackend> makeCplexBackend()
+{
+    return std::make_unique<CplexBackend>();
+}
+
+#endif // CW_HAVE_CPLEX
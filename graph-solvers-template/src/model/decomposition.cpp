@@ -0,0 +1,534 @@
+#include "model/decomposition.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <numbers>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+#include "common/instrumentation.h"
+#include "common/radix_sort.h"
+#include "common/thread_pool.h"
+#include "model/savings.h"
+#include "model/solver.h"
+
+namespace {
+
+constexpr double kInf = std::numeric_limits<double>::infinity();
+constexpr int kBlock = 1 << 14;  ///< Nodes per task of the parallel per-node loops.
+constexpr double kDissolveFraction = 0.75;  ///< Routes below this share of every finite limit are re-merged node by node.
+
+/// Runs body(begin, end) over [0, count) in blocks, on the pool when there is one.
+void forEachBlock(ThreadPool* pool, int count, const std::function<void(int, int)>& body)
+{
+    int blocks = (count + kBlock - 1) / kBlock;
+    if (pool == nullptr || blocks <= 1) {
+        body(0, count);
+        return;
+    }
+    pool->parallelFor(blocks, [&](int b, unsigned) { body(b * kBlock, std::min(count, (b + 1) * kBlock)); });
+}
+
+/// Position of the cell (x, y) along the Hilbert curve over a 2^32 x 2^32 grid.
+std::uint64_t hilbertIndex(std::uint32_t x, std::uint32_t y)
+{
+    std::uint64_t d = 0;
+    for (std::uint32_t s = 1u << 31; s > 0; s >>= 1) {
+        std::uint32_t rx = (x & s) != 0, ry = (y & s) != 0;
+        d += (std::uint64_t)s * s * ((3 * rx) ^ ry);
+        // Rotate the quadrant so the curve continues in the same orientation
+        if (ry == 0) {
+            if (rx == 1) {
+                x = ~x;
+                y = ~y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return d;
+}
+
+/// Maps t in [0, 1] to [0, 2^32).
+std::uint64_t quantize(double t)
+{
+    return (std::uint64_t)std::clamp(t * 4294967296.0, 0.0, 4294967295.0);
+}
+
+/**
+ * Sorts the interior @p nodes into partition order, by their sweep angle around @p origin or
+ * their Hilbert index, so that partition p is the slice [n p / P, n (p + 1) / P).
+ */
+void orderNodes(const std::vector<Point>& vertices, const Point& origin, PartitionKind kind, ThreadPool* pool,
+    std::vector<int>& nodes)
+{
+    const int interior = (int)nodes.size();
+    std::vector<std::uint64_t> keys(interior);
+
+    double minX = origin.x, maxX = minX, minY = origin.y, maxY = minY;
+    if (kind == PartitionKind::Cluster) {
+        for (const auto& p : vertices) {
+            minX = std::min(minX, p.x);
+            maxX = std::max(maxX, p.x);
+            minY = std::min(minY, p.y);
+            maxY = std::max(maxY, p.y);
+        }
+    }
+    const double width = maxX > minX ? maxX - minX : 1.0;
+    const double height = maxY > minY ? maxY - minY : 1.0;
+
+    forEachBlock(pool, interior, [&](int begin, int end) {
+        for (int k = begin; k < end; ++k) {
+            const Point& p = vertices[nodes[k]];
+            if (kind == PartitionKind::Sweep) {
+                double angle = std::atan2(p.y - origin.y, p.x - origin.x);
+                keys[k] = quantize((angle + std::numbers::pi) / (2.0 * std::numbers::pi));
+            }
+            else {
+                keys[k] = hilbertIndex((std::uint32_t)quantize((p.x - minX) / width), (std::uint32_t)quantize((p.y - minY) / height));
+            }
+        }
+    });
+    radixSort(keys, nodes, pool);
+}
+
+/// Routes as interior node sequences, without the terminals.
+struct RouteSet
+{
+    std::vector<std::vector<int>> routes;
+    std::vector<double> loads;  ///< Summed demand of each route.
+    std::vector<double> costs;  ///< Internal link cost of each route.
+};
+
+/// Per-worker buffers of the partition solves and boundary windows.
+struct Scratch
+{
+    RouteStore store;
+    SavingsQueue queue;
+    std::vector<Edge> edges;
+    std::vector<int> ids;
+    std::vector<int> sequence;
+    std::vector<int> endpointId;  ///< Global node -> contracted node, -1 outside the window.
+};
+
+/**
+ * Time windows of a renumbered instance: local id k takes the window of @p nodeOf[k], or none
+ * where @p nodeOf is -1 (endpoints of contracted pieces, whose times the store overrides).
+ */
+void renumberWindows(const RouteConstraints& constraints, std::span<const int> nodeOf, RouteConstraints& local)
+{
+    if (!constraints.hasTimeWindows()) return;
+    const std::size_t count = nodeOf.size();
+    local.readyTimes.assign(count, -kInf);
+    local.dueTimes.assign(count, kInf);
+    local.serviceTimes.assign(count, 0.0);
+    for (std::size_t k = 0; k < count; ++k) {
+        if (nodeOf[k] < 0) continue;
+        TimeSegment window = constraints.segment(nodeOf[k]);
+        local.readyTimes[k] = window.earliest;
+        local.dueTimes[k] = window.latest;
+        local.serviceTimes[k] = window.duration;
+    }
+}
+
+/// Time-window summary of the interior nodes [first, last) driven in that order along their graph links.
+template <class It>
+TimeSegment chainTimes(const Graph& graph, const RouteConstraints& constraints, It first, It last)
+{
+    TimeSegment chain = constraints.segment(*first);
+    for (It previous = first++; first != last; previous = first++)
+        chain = concatenate(chain, graph.cost(graph.edgeId(*previous, *first)), constraints.segment(*first));
+    return chain;
+}
+
+/**
+ * Orients a route start, ..., end: the shorter direction when routes may be driven either
+ * way, unless only the other direction keeps the time windows.
+ */
+void orientRoute(const Graph& graph, std::vector<int>& route, std::span<const double> fromStart,
+    std::span<const double> toEnd, const RouteConstraints& constraints)
+{
+    if (!constraints.allOrientations || route.size() < 4) return;
+    const int start = route.front(), end = route.back();
+    int first = route[1], last = route[route.size() - 2];
+    bool reverse = fromStart[last] + toEnd[first] < fromStart[first] + toEnd[last];
+    if (constraints.hasTimeWindows()) {
+        auto fits = [&](const TimeSegment& chain, int head, int tail) {
+            return constraints.fitsWindows(start, fromStart[head], chain, toEnd[tail], end);
+        };
+        bool forward = fits(chainTimes(graph, constraints, route.begin() + 1, route.end() - 1), first, last);
+        bool backward = fits(chainTimes(graph, constraints, route.rbegin() + 1, route.rend() - 1), last, first);
+        if (forward != backward) reverse = backward;
+    }
+    if (reverse) std::reverse(route.begin() + 1, route.end() - 1);
+}
+
+/**
+ * Solves the partition made of @p nodes on its induced subgraph, renumbered as start 0,
+ * nodes 1..m and end m + 1. @p local maps every node of the partition to its local id.
+ */
+void solvePartition(const Graph& graph, std::span<const int> nodes, std::span<const int> part, int p,
+    std::span<const int> local, Terminals terminals, std::span<const double> fromStart, std::span<const double> toEnd,
+    const RouteConstraints& constraints, Scratch& scratch, RouteSet& out)
+{
+    const int m = (int)nodes.size();
+    scratch.edges.clear();
+    std::vector<double> depot(m + 2, 0.0), end(m + 2, 0.0);
+    RouteConstraints localConstraints = constraints;
+    if (!constraints.demands.empty()) localConstraints.demands.assign(m + 2, 0.0);
+    if (constraints.hasTimeWindows()) {
+        scratch.ids.assign(1, terminals.start);
+        scratch.ids.insert(scratch.ids.end(), nodes.begin(), nodes.end());
+        scratch.ids.push_back(terminals.end);
+        renumberWindows(constraints, scratch.ids, localConstraints);
+    }
+    for (int k = 0; k < m; ++k) {
+        int u = nodes[k];
+        depot[k + 1] = fromStart[u];
+        end[k + 1] = toEnd[u];
+        if (!constraints.demands.empty()) localConstraints.demands[k + 1] = constraints.demands[u];
+
+        auto neighbours = graph.neighbours(u);
+        auto incident = graph.incidentEdges(u);
+        for (std::size_t a = 0; a < neighbours.size(); ++a) {
+            int v = neighbours[a];
+            if (v > u && part[v] == p) scratch.edges.push_back({ k + 1, local[v], graph.cost(incident[a]) });
+        }
+    }
+
+    Graph subgraph(m + 2, scratch.edges);
+    SavingsList list(std::move(depot), std::move(end), subgraph, 0, m + 1);
+    scratch.store.reset(m + 2, 0, m + 1, localConstraints);
+    scratch.queue.reset(list);
+    mergeRoutes(subgraph, list, scratch.queue, localConstraints, scratch.store);
+
+    scratch.store.routes(scratch.ids);
+    for (int id : scratch.ids) {
+        scratch.store.materialize(id, scratch.sequence);
+        auto& route = out.routes.emplace_back();
+        for (std::size_t k = 1; k + 1 < scratch.sequence.size(); ++k) route.push_back(nodes[scratch.sequence[k] - 1]);
+        out.loads.push_back(scratch.store.load(id));
+        out.costs.push_back(scratch.store.cost(id));
+    }
+}
+
+/// Whether a route uses so little of the capacity and length limits that its nodes are better re-merged.
+bool underfilled(const std::vector<int>& route, double load, double cost, std::span<const double> fromStart,
+    std::span<const double> toEnd, const RouteConstraints& constraints)
+{
+    if (constraints.capacity == kInf && constraints.maxLength == kInf) return false;
+    double legs = std::min(fromStart[route.front()] + toEnd[route.back()], fromStart[route.back()] + toEnd[route.front()]);
+    return load < kDissolveFraction * constraints.capacity && cost + legs < kDissolveFraction * constraints.maxLength;
+}
+
+/**
+ * Merges the routes @p members of @p in by Clarke-Wright on a contracted instance of pieces:
+ * routes pre-linked from head to tail with their internal cost, and the single nodes of the
+ * underfilled routes. Only piece endpoints become nodes, and the candidate links are the
+ * graph edges between endpoints of different pieces.
+ */
+void mergeWindow(const Graph& graph, const RouteSet& in, std::span<const int> members, Terminals terminals,
+    std::span<const double> fromStart, std::span<const double> toEnd, const RouteConstraints& constraints,
+    Scratch& scratch, RouteSet& out)
+{
+    std::vector<std::span<const int>> pieces;
+    std::vector<double> pieceCosts;
+    std::vector<int> headOf, tailOf;     // piece -> contracted node
+    std::vector<int> pieceOf(1, -1);     // contracted node -> piece (start at 0)
+    std::vector<int> nodeOf(1, -1);      // contracted node -> graph node
+    std::vector<int> windowOf(1, terminals.start);  // contracted node -> node whose window it keeps
+    std::vector<double> depot(1, 0.0), endDistances(1, 0.0), demands(1, 0.0);
+    auto& endpointId = scratch.endpointId;
+    auto addPiece = [&](std::span<const int> nodes, double load, double cost) {
+        int id = (int)pieces.size();
+        pieces.push_back(nodes);
+        pieceCosts.push_back(cost);
+        for (int node : { nodes.front(), nodes.back() }) {
+            if (endpointId[node] >= 0) continue;
+            endpointId[node] = (int)pieceOf.size();
+            pieceOf.push_back(id);
+            nodeOf.push_back(node);
+            windowOf.push_back(nodes.size() == 1 ? node : -1);
+            depot.push_back(fromStart[node]);
+            endDistances.push_back(toEnd[node]);
+            demands.push_back(node == nodes.front() ? load : 0.0);
+        }
+        headOf.push_back(endpointId[nodes.front()]);
+        tailOf.push_back(endpointId[nodes.back()]);
+    };
+    for (int r : members) {
+        const auto& route = in.routes[r];
+        if (!underfilled(route, in.loads[r], in.costs[r], fromStart, toEnd, constraints)) {
+            addPiece(route, in.loads[r], in.costs[r]);
+            continue;
+        }
+        for (std::size_t k = 0; k < route.size(); ++k)
+            addPiece(std::span<const int>(route).subspan(k, 1), constraints.demands.empty() ? 0.0 : constraints.demands[route[k]], 0.0);
+    }
+    const int contractedEnd = (int)pieceOf.size();
+    windowOf.push_back(terminals.end);
+    depot.push_back(0.0);
+    endDistances.push_back(0.0);
+    demands.push_back(0.0);
+
+    scratch.edges.clear();
+    for (int c = 1; c < contractedEnd; ++c) {
+        int u = nodeOf[c];
+        auto neighbours = graph.neighbours(u);
+        auto incident = graph.incidentEdges(u);
+        for (std::size_t a = 0; a < neighbours.size(); ++a) {
+            int v = neighbours[a];
+            if (v > u && endpointId[v] >= 0 && pieceOf[endpointId[v]] != pieceOf[c])
+                scratch.edges.push_back({ c, endpointId[v], graph.cost(incident[a]) });
+        }
+    }
+
+    const int contractedCount = contractedEnd + 1;
+    Graph contracted(contractedCount, scratch.edges);
+    SavingsList list(std::move(depot), std::move(endDistances), contracted, 0, contractedEnd);
+    RouteConstraints contractedConstraints = constraints;
+    if (!constraints.demands.empty()) contractedConstraints.demands = std::move(demands);
+    renumberWindows(constraints, windowOf, contractedConstraints);
+    scratch.store.reset(contractedCount, 0, contractedEnd, contractedConstraints);
+    for (std::size_t r = 0; r < pieces.size(); ++r) {
+        // The link carries the internal cost, so the length limit sees whole routes, and the
+        // store takes the time summaries of the whole piece in both directions
+        if (headOf[r] == tailOf[r]) continue;
+        int id = scratch.store.merge(headOf[r], tailOf[r], pieceCosts[r]);
+        if (scratch.store.timed()) {
+            const auto& nodes = pieces[r];
+            scratch.store.setTimes(id, chainTimes(graph, constraints, nodes.begin(), nodes.end()),
+                chainTimes(graph, constraints, nodes.rbegin(), nodes.rend()));
+        }
+    }
+    scratch.queue.reset(list);
+    mergeRoutes(contracted, list, scratch.queue, contractedConstraints, scratch.store);
+
+    // Expand every contracted route into its pieces
+    scratch.store.routes(scratch.ids);
+    for (int id : scratch.ids) {
+        scratch.store.materialize(id, scratch.sequence);
+        auto& route = out.routes.emplace_back();
+        for (std::size_t k = 1; k + 1 < scratch.sequence.size(); ++k) {
+            int piece = pieceOf[scratch.sequence[k]];
+            auto nodes = pieces[piece];
+            if (scratch.sequence[k] == headOf[piece]) route.insert(route.end(), nodes.begin(), nodes.end());
+            else route.insert(route.end(), nodes.rbegin(), nodes.rend());
+            if (nodes.size() > 1) ++k;  // the partner endpoint was emitted with the piece
+        }
+        out.loads.push_back(scratch.store.load(id));
+        out.costs.push_back(scratch.store.cost(id));
+    }
+    for (std::size_t c = 1; c < nodeOf.size(); ++c) endpointId[nodeOf[c]] = -1;
+}
+
+} // namespace
+
+std::vector<std::vector<int>> solveDecomposed(const std::vector<Point>& vertices, const Graph& graph,
+    const DecompositionOptions& options)
+{
+    CW_PROFILE_SCOPE("decomposed_solve");
+    const int n = (int)vertices.size();
+    std::vector<std::vector<int>> result;
+    if (n == 0) return result;
+    const auto [start, end] = options.terminals.resolved(n);
+
+    ThreadPool* pool = options.pool;
+    const RouteConstraints& constraints = options.constraints;
+    std::vector<double> fromStart(n), toEnd(n);
+    if (options.distances != nullptr) {
+        options.distances->row(start, fromStart);
+        options.distances->column(end, toEnd);
+    }
+    else {
+        EuclideanDistances distances(vertices);
+        distances.row(start, fromStart);
+        distances.column(end, toEnd);
+    }
+
+    // Partition order and ownership
+    std::vector<int> order, part(n, -1), local(n, 0);
+    order.reserve(n);
+    for (int v = 0; v < n; ++v) {
+        if (v != start && v != end) order.push_back(v);
+    }
+    const int interior = (int)order.size();
+    if (interior == 0) return result;
+    int partitions = options.partitions > 0 ? options.partitions
+        : (interior + std::max(1, options.partitionSize) - 1) / std::max(1, options.partitionSize);
+    partitions = std::clamp(partitions, 1, interior);
+    {
+        CW_PROFILE_SCOPE("partition");
+        orderNodes(vertices, vertices[start], options.partition, pool, order);
+        forEachBlock(pool, interior, [&](int begin, int finish) {
+            for (int k = begin; k < finish; ++k) {
+                int p = (int)((std::int64_t)k * partitions / interior);
+                while ((std::int64_t)interior * (p + 1) / partitions <= k) ++p;
+                part[order[k]] = p;
+                local[order[k]] = k - (int)((std::int64_t)interior * p / partitions) + 1;
+            }
+        });
+    }
+    auto sliceOf = [&](int p) {
+        std::size_t first = (std::size_t)((std::int64_t)interior * p / partitions);
+        std::size_t last = (std::size_t)((std::int64_t)interior * (p + 1) / partitions);
+        return std::span<const int>(order).subspan(first, last - first);
+    };
+
+    // Independent Clarke-Wright solves
+    std::vector<RouteSet> solved(partitions);
+    std::vector<Scratch> scratch(pool != nullptr ? pool->size() : 1);
+    {
+        CW_PROFILE_SCOPE("partition_solves");
+        auto solveOne = [&](int p, unsigned worker) {
+            solvePartition(graph, sliceOf(p), part, p, local, { start, end }, fromStart, toEnd, constraints, scratch[worker], solved[p]);
+        };
+        if (pool != nullptr) pool->parallelFor(partitions, solveOne);
+        else for (int p = 0; p < partitions; ++p) solveOne(p, 0);
+    }
+    RouteSet current;
+    for (auto& partition : solved) {
+        std::move(partition.routes.begin(), partition.routes.end(), std::back_inserter(current.routes));
+        current.loads.insert(current.loads.end(), partition.loads.begin(), partition.loads.end());
+        current.costs.insert(current.costs.end(), partition.costs.begin(), partition.costs.end());
+    }
+    solved.clear();
+
+    // Boundary merge in two rounds of windows over neighbouring partitions, {2i, 2i + 1} and
+    // then {2i + 1, 2i + 2}, so that every border lies inside a window once. The windows of a
+    // round are disjoint and merged in parallel; a route belongs to the partition of its head.
+    if (options.boundaryMerge && partitions > 1) {
+        CW_PROFILE_SCOPE("boundary_merge");
+        for (auto& buffers : scratch) buffers.endpointId.assign(n, -1);
+        for (int round = 0; round < 2; ++round) {
+            auto windowOf = [&](int p) {
+                // Sweep sectors close the circle, so the last window also takes sector 0
+                if (round == 1 && p == 0 && options.partition == PartitionKind::Sweep) p = partitions - 1;
+                return (p + round) / 2;
+            };
+            const int windows = windowOf(partitions - 1) + 1;
+            std::vector<int> first(windows + 1, 0), members(current.routes.size());
+            for (const auto& route : current.routes) ++first[windowOf(part[route.front()]) + 1];
+            for (int w = 0; w < windows; ++w) first[w + 1] += first[w];
+            std::vector<int> next(first.begin(), first.end() - 1);
+            for (std::size_t r = 0; r < current.routes.size(); ++r) members[next[windowOf(part[current.routes[r].front()])]++] = (int)r;
+
+            std::vector<RouteSet> merged(windows);
+            auto mergeOne = [&](int w, unsigned worker) {
+                std::span<const int> window(members.data() + first[w], first[w + 1] - first[w]);
+                if (!window.empty())
+                    mergeWindow(graph, current, window, { start, end }, fromStart, toEnd, constraints, scratch[worker], merged[w]);
+            };
+            if (pool != nullptr) pool->parallelFor(windows, mergeOne);
+            else for (int w = 0; w < windows; ++w) mergeOne(w, 0);
+
+            current = {};
+            for (auto& window : merged) {
+                std::move(window.routes.begin(), window.routes.end(), std::back_inserter(current.routes));
+                current.loads.insert(current.loads.end(), window.loads.begin(), window.loads.end());
+                current.costs.insert(current.costs.end(), window.costs.begin(), window.costs.end());
+            }
+        }
+    }
+
+    result.reserve(current.routes.size());
+    for (auto& nodes : current.routes) {
+        auto& route = result.emplace_back();
+        route.reserve(nodes.size() + 2);
+        route.push_back(start);
+        route.insert(route.end(), nodes.begin(), nodes.end());
+        route.push_back(end);
+        orientRoute(graph, route, fromStart, toEnd, constraints);
+    }
+    return result;
+}
+
+MultiDepotSolution solveMultiDepot(const std::vector<Point>& vertices, const Graph& graph,
+    std::span<const Terminals> depots, const MultiDepotOptions& options)
+{
+    CW_PROFILE_SCOPE("multi_depot");
+    const int n = (int)vertices.size();
+    if (depots.empty()) throw std::invalid_argument("solveMultiDepot: no depots");
+    std::vector<Terminals> terminals;
+    for (const auto& depot : depots) {
+        Terminals resolved = depot.resolved(n);
+        if (resolved.start < 0 || resolved.start >= n || resolved.end >= n)
+            throw std::invalid_argument("solveMultiDepot: depot terminal outside the instance");
+        terminals.push_back(resolved);
+    }
+    const int depotCount = (int)terminals.size();
+    ThreadPool* pool = options.pool;
+
+    // Nearest depot of every node by its round trip; the savings use that depot's distances
+    MultiDepotSolution solution;
+    solution.depotOf.assign(n, -1);
+    solution.routes.resize(depotCount);
+    std::vector<double> fromStart(n), toEnd(n);
+    {
+        CW_PROFILE_SCOPE("depot_assignment");
+        std::vector<double> best(n, kInf), row(n), column(n);
+        std::optional<EuclideanDistances> euclidean;
+        if (options.distances == nullptr) euclidean.emplace(vertices);
+        const DistanceProvider& distances = options.distances != nullptr ? *options.distances : *euclidean;
+        for (int d = 0; d < depotCount; ++d) {
+            distances.row(terminals[d].start, row);
+            distances.column(terminals[d].end, column);
+            forEachBlock(pool, n, [&](int begin, int end) {
+                for (int v = begin; v < end; ++v) {
+                    if (row[v] + column[v] >= best[v]) continue;
+                    best[v] = row[v] + column[v];
+                    fromStart[v] = row[v];
+                    toEnd[v] = column[v];
+                    solution.depotOf[v] = d;
+                }
+            });
+        }
+        for (const auto& depot : terminals) solution.depotOf[depot.start] = solution.depotOf[depot.end] = -1;
+    }
+
+    // Customers grouped by depot in node order, numbered 1..m within their depot
+    std::vector<int> first(depotCount + 1, 0), order(n), local(n, 0);
+    for (int v = 0; v < n; ++v) {
+        if (solution.depotOf[v] >= 0) ++first[solution.depotOf[v] + 1];
+    }
+    for (int d = 0; d < depotCount; ++d) first[d + 1] += first[d];
+    std::vector<int> next(first.begin(), first.end() - 1);
+    for (int v = 0; v < n; ++v) {
+        int d = solution.depotOf[v];
+        if (d < 0) continue;
+        local[v] = next[d] - first[d] + 1;
+        order[next[d]++] = v;
+    }
+
+    // Independent Clarke-Wright solves, one per depot
+    std::vector<RouteSet> solved(depotCount);
+    {
+        CW_PROFILE_SCOPE("depot_solves");
+        std::vector<Scratch> scratch(pool != nullptr ? pool->size() : 1);
+        auto solveOne = [&](int d, unsigned worker) {
+            std::span<const int> customers(order.data() + first[d], first[d + 1] - first[d]);
+            if (!customers.empty())
+                solvePartition(graph, customers, solution.depotOf, d, local, terminals[d], fromStart, toEnd, options.constraints,
+                    scratch[worker], solved[d]);
+        };
+        if (pool != nullptr) pool->parallelFor(depotCount, solveOne);
+        else for (int d = 0; d < depotCount; ++d) solveOne(d, 0);
+    }
+
+    for (int d = 0; d < depotCount; ++d) {
+        for (auto& nodes : solved[d].routes) {
+            auto& route = solution.routes[d].emplace_back();
+            route.reserve(nodes.size() + 2);
+            route.push_back(terminals[d].start);
+            route.insert(route.end(), nodes.begin(), nodes.end());
+            route.push_back(terminals[d].end);
+            orientRoute(graph, route, fromStart, toEnd, options.constraints);
+        }
+    }
+    return solution;
+}
@@ -0,0 +1,601 @@
+#include "model/dynamic_instance.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+DynamicInstance::DynamicInstance(const std::vector<Point>& points, const DynamicOptions& options)
+    : start_(0), end_((int)points.size() - 1), triangulation_(points), constraints_(options.constraints),
+      maxSearchNodes_(options.maxSearchNodes)
+{
+    if (points.size() < 2)
+        throw std::invalid_argument("DynamicInstance: at least the two terminals are required");
+    if (constraints_.hasTimeWindows()
+        && (constraints_.readyTimes.size() < points.size() || constraints_.dueTimes.size() < points.size()
+            || (!constraints_.serviceTimes.empty() && constraints_.serviceTimes.size() < points.size())))
+        throw std::invalid_argument("DynamicInstance: time windows must cover every point");
+
+    std::vector<Edge> edges;
+    for (auto [u, v] : triangulation_.edges())
+        edges.push_back({ u, v, euclidean(points[u], points[v]) });
+    graph_ = DynamicGraph(Graph((int)points.size(), edges));
+    routesAt_.resize(points.size());
+}
+
+double DynamicInstance::demand(int v) const
+{
+    return v < (int)constraints_.demands.size() ? constraints_.demands[v] : 0.0;
+}
+
+double DynamicInstance::linkTime(int u, int v) const
+{
+    int e = graph_.edgeId(u, v);
+    if (e != DynamicGraph::npos) return graph_.cost(e);
+
+    // A link deleted by the current update keeps its old cost until it is repaired
+    for (std::size_t k = 0; k < delta_.removed.size(); ++k) {
+        auto [a, b] = delta_.removed[k];
+        if ((a == u && b == v) || (a == v && b == u)) return removedCosts_[k];
+    }
+    return std::numeric_limits<double>::infinity();
+}
+
+std::uint64_t DynamicInstance::pairKey(int u, int v) const
+{
+    return ((std::uint64_t)std::min(u, v) << 32) | (std::uint32_t)std::max(u, v);
+}
+
+double DynamicInstance::edgeCostFor(int u, int v) const
+{
+    auto it = overrides_.find(pairKey(u, v));
+    return it != overrides_.end() ? it->second : euclidean(point(u), point(v));
+}
+
+// === Update bookkeeping ===
+
+void DynamicInstance::beginUpdate()
+{
+    stats_ = {};
+    touched_.assign(routes_.size(), 0);
+    dropped_.assign(routes_.size(), 0);
+}
+
+void DynamicInstance::applyDelta()
+{
+    removedCosts_.clear();
+    for (auto [u, v] : delta_.removed) {
+        int id = graph_.edgeId(u, v);
+        removedCosts_.push_back(graph_.cost(id));
+        graph_.removeEdge(id);
+    }
+    for (auto [u, v] : delta_.added)
+        graph_.addEdge(u, v, edgeCostFor(u, v));
+
+    stats_.edgesAdded = (int)delta_.added.size();
+    stats_.edgesRemoved = (int)delta_.removed.size();
+    stats_.rebuilt = delta_.rebuilt;
+}
+
+void DynamicInstance::finishUpdate()
+{
+    auto firstDropped = std::find(dropped_.begin(), dropped_.end(), 1) - dropped_.begin();
+    for (int r = 0; r < (int)routes_.size(); ++r) {
+        if (dropped_[r]) ++stats_.routesDropped;
+        else if (touched_[r]) ++stats_.routesRepaired;
+    }
+    if (stats_.routesDropped == 0) return;
+
+    // Routes after the first dropped one change index: unregister them, compact, register again
+    auto forInterior = [&](int r, auto&& f) {
+        for (int node : routes_[r]) {
+            if (!isTerminal(node)) f(routesAt_[node]);
+        }
+    };
+    for (int r = (int)firstDropped; r < (int)routes_.size(); ++r) {
+        forInterior(r, [&](std::vector<int>& at) { at.erase(std::find(at.begin(), at.end(), r)); });
+    }
+    int kept = (int)firstDropped;
+    for (int r = kept; r < (int)routes_.size(); ++r) {
+        if (dropped_[r]) continue;
+        routes_[kept] = std::move(routes_[r]);
+        lengths_[kept] = lengths_[r];
+        loads_[kept] = loads_[r];
+        if (constraints_.hasTimeWindows()) {
+            forwardTimes_[kept] = std::move(forwardTimes_[r]);
+            backwardTimes_[kept] = std::move(backwardTimes_[r]);
+        }
+        ++kept;
+    }
+    routes_.resize(kept);
+    lengths_.resize(kept);
+    loads_.resize(kept);
+    if (constraints_.hasTimeWindows()) {
+        forwardTimes_.resize(kept);
+        backwardTimes_.resize(kept);
+    }
+    for (int r = (int)firstDropped; r < kept; ++r) {
+        forInterior(r, [&](std::vector<int>& at) { at.push_back(r); });
+    }
+}
+
+// === Route edits ===
+
+int DynamicInstance::position(int r, int node) const
+{
+    const auto& route = routes_[r];
+    if (node == start_) return 0;
+    if (node == end_) return (int)route.size() - 1;
+    auto it = std::find(route.begin() + 1, route.end() - 1, node);
+    return it == route.end() - 1 ? -1 : (int)(it - route.begin());
+}
+
+int DynamicInstance::findLink(int r, int a, int b) const
+{
+    if (isTerminal(a)) std::swap(a, b);
+    const auto& route = routes_[r];
+    int p = position(r, a);
+    if (p < 0) return -1;
+    if (p + 1 < (int)route.size() && route[p + 1] == b) return p;
+    if (p > 0 && route[p - 1] == b) return p - 1;
+    return -1;
+}
+
+void DynamicInstance::routesAt(int node, std::vector<int>& out) const
+{
+    out.clear();
+    if (isTerminal(node)) {
+        for (int r = 0; r < (int)routes_.size(); ++r) {
+            if (!dropped_[r]) out.push_back(r);
+        }
+        return;
+    }
+    for (int r : routesAt_[node]) {
+        if (!dropped_[r]) out.push_back(r);
+    }
+}
+
+bool DynamicInstance::fits(int r, int i, int j, std::span<const int> via, double length) const
+{
+    const auto& route = routes_[r];
+    double load = loads_[r];
+    for (int k = i + 1; k < j; ++k) load -= demand(route[k]);
+    for (int node : via) load += demand(node);
+    // Written so that a NaN length (an infinite cost replaced by another) never fits
+    if (!(load <= constraints_.capacity && length <= constraints_.maxLength)) return false;
+    if (!constraints_.hasTimeWindows()) return true;
+
+    // The summaries before and after the splice, joined through the new nodes
+    TimeSegment times = forwardTimes_[r][i];
+    int last = route[i];
+    for (int node : via) {
+        times = concatenate(times, linkCost(last, node), constraints_.segment(node));
+        last = node;
+    }
+    return concatenate(times, linkCost(last, route[j]), backwardTimes_[r][j]).feasible;
+}
+
+void DynamicInstance::updateTimes(int r)
+{
+    if (!constraints_.hasTimeWindows()) return;
+    const auto& route = routes_[r];
+    const int m = (int)route.size();
+    auto& forward = forwardTimes_[r];
+    auto& backward = backwardTimes_[r];
+    forward.resize(m);
+    backward.resize(m);
+
+    forward[0] = constraints_.segment(route[0]);
+    for (int k = 1; k < m; ++k)
+        forward[k] = concatenate(forward[k - 1], linkTime(route[k - 1], route[k]), constraints_.segment(route[k]));
+    backward[m - 1] = constraints_.segment(route[m - 1]);
+    for (int k = m - 2; k >= 0; --k)
+        backward[k] = concatenate(constraints_.segment(route[k]), linkTime(route[k], route[k + 1]), backward[k + 1]);
+}
+
+void DynamicInstance::replaceSegment(int r, int i, int j, std::span<const int> via, double length)
+{
+    auto& route = routes_[r];
+    for (int k = i + 1; k < j; ++k) {
+        int node = route[k];
+        loads_[r] -= demand(node);
+        auto& at = routesAt_[node];
+        at.erase(std::find(at.begin(), at.end(), r));
+    }
+    for (int node : via) {
+        loads_[r] += demand(node);
+        routesAt_[node].push_back(r);
+    }
+    route.erase(route.begin() + i + 1, route.begin() + j);
+    route.insert(route.begin() + i + 1, via.begin(), via.end());
+    lengths_[r] = length;
+    touched_[r] = 1;
+    updateTimes(r);
+}
+
+void DynamicInstance::drop(int r)
+{
+    dropped_[r] = 1;
+}
+
+bool DynamicInstance::findDetour(int r, int a, int b, std::vector<int>& path, double& cost)
+{
+    const int n = graph_.vertexCount();
+    if ((int)blocked_.size() < n) {
+        blocked_.resize(n, 0);
+        seen_.resize(n, 0);
+        closed_.resize(n, 0);
+        dist_.resize(n);
+        parent_.resize(n);
+    }
+    if (++generation_ == 0) {
+        std::fill(blocked_.begin(), blocked_.end(), 0);
+        std::fill(seen_.begin(), seen_.end(), 0);
+        std::fill(closed_.begin(), closed_.end(), 0);
+        generation_ = 1;
+    }
+
+    // The route may not cross itself or pass through a terminal
+    for (int node : routes_[r]) blocked_[node] = generation_;
+    blocked_[start_] = blocked_[end_] = generation_;
+    blocked_[a] = blocked_[b] = 0;
+
+    // A* with the Euclidean distance scaled to stay below every edge cost
+    const Point& target = point(b);
+    auto potential = [&](int v) { return heuristicScale_ * euclidean(point(v), target); };
+    heap_.clear();
+    dist_[a] = 0.0;
+    parent_[a] = -1;
+    seen_[a] = generation_;
+    heap_.push(potential(a), a);
+
+    int settled = 0;
+    bool found = false;
+    while (!heap_.empty()) {
+        int u = heap_.pop().second;
+        if (closed_[u] == generation_) continue;
+        closed_[u] = generation_;
+        if (u == b) {
+            found = true;
+            break;
+        }
+        if (++settled > maxSearchNodes_) break;
+
+        auto adj = graph_.neighbours(u);
+        auto ids = graph_.incidentEdges(u);
+        for (std::size_t k = 0; k < adj.size(); ++k) {
+            int v = adj[k];
+            if (blocked_[v] == generation_ || closed_[v] == generation_) continue;
+            double c = graph_.cost(ids[k]);
+            if (!std::isfinite(c)) continue;
+            double d = dist_[u] + c;
+            if (seen_[v] != generation_ || d < dist_[v]) {
+                seen_[v] = generation_;
+                dist_[v] = d;
+                parent_[v] = u;
+                heap_.push(d + potential(v), v);
+            }
+        }
+    }
+    stats_.settledNodes += settled;
+    if (!found) return false;
+
+    path.clear();
+    for (int v = b; v != -1; v = parent_[v]) path.push_back(v);
+    std::reverse(path.begin(), path.end());
+    cost = dist_[b];
+    return true;
+}
+
+// === Repairs ===
+
+void DynamicInstance::repairLink(int a, int b, double oldCost, int via)
+{
+    // A route using the link visits both ends, so the interior end's route list covers it
+    routesAt(isTerminal(a) ? b : a, candidates_);
+    std::vector<int> path;
+    for (int r : candidates_) {
+        int i = findLink(r, a, b);
+        if (i < 0) continue;
+        int x = routes_[r][i], y = routes_[r][i + 1];
+        double base = lengths_[r] - oldCost;
+
+        // The new point usually sits right on the deleted link
+        if (via >= 0 && position(r, via) < 0 && graph_.hasEdge(x, via) && graph_.hasEdge(via, y)) {
+            double length = base + linkCost(x, via) + linkCost(via, y);
+            if (fits(r, i, i + 1, std::span<const int>(&via, 1), length)) {
+                replaceSegment(r, i, i + 1, std::span<const int>(&via, 1), length);
+                continue;
+            }
+        }
+
+        double cost;
+        if (findDetour(r, x, y, path, cost)) {
+            std::span<const int> inner(path.data() + 1, path.size() - 2);
+            if (fits(r, i, i + 1, inner, base + cost)) {
+                replaceSegment(r, i, i + 1, inner, base + cost);
+                continue;
+            }
+        }
+
+        // The new point already took the neighbouring link: skip the node between it and the
+        // far end, to be placed again after the repairs
+        int q = via >= 0 ? position(r, via) : -1;
+        if (q >= 0 && (q == i - 1 || q == i + 2)) {
+            int skipped = q == i - 1 ? x : y;
+            int far = q == i - 1 ? y : x;
+            if (graph_.hasEdge(via, far)) {
+                double length = base - linkCost(via, skipped) + linkCost(via, far);
+                if (fits(r, std::min(q, i), std::max(q, i + 1), {}, length)) {
+                    replaceSegment(r, std::min(q, i), std::max(q, i + 1), {}, length);
+                    skipped_.push_back(skipped);
+                    continue;
+                }
+            }
+        }
+        drop(r);
+    }
+}
+
+bool DynamicInstance::insertCheapest(int node)
+{
+    // Candidate links join two graph neighbours of the node, so only routes through them are scanned
+    double best = std::numeric_limits<double>::infinity();
+    int bestRoute = -1, bestLink = -1;
+    for (int w : graph_.neighbours(node)) {
+        routesAt(w, candidates_);
+        for (int r : candidates_) {
+            const auto& route = routes_[r];
+            int p = position(r, w);
+            for (int i : { p - 1, p }) {
+                if (i < 0 || i + 1 >= (int)route.size()) continue;
+                int other = route[i] == w ? route[i + 1] : route[i];
+                if (!graph_.hasEdge(node, other)) continue;
+
+                double added = linkCost(route[i], node) + linkCost(node, route[i + 1]) - linkCost(route[i], route[i + 1]);
+                if (added < best && fits(r, i, i + 1, std::span<const int>(&node, 1), lengths_[r] + added)) {
+                    best = added;
+                    bestRoute = r;
+                    bestLink = i;
+                }
+            }
+        }
+    }
+    if (bestRoute < 0) return false;
+
+    replaceSegment(bestRoute, bestLink, bestLink + 1, std::span<const int>(&node, 1), lengths_[bestRoute] + best);
+    return true;
+}
+
+// === Updates ===
+
+int DynamicInstance::insertPoint(const Point& p, double demand)
+{
+    // Throws before anything changes if the point is a duplicate
+    int id = triangulation_.insert(p, delta_);
+    beginUpdate();
+
+    graph_.addVertex();
+    routesAt_.emplace_back();
+    if (demand != 0.0 || !constraints_.demands.empty()) {
+        constraints_.demands.resize(id + 1, 0.0);
+        constraints_.demands[id] = demand;
+    }
+    if (constraints_.hasTimeWindows()) {
+        constraints_.readyTimes.resize(id + 1, -std::numeric_limits<double>::infinity());
+        constraints_.dueTimes.resize(id + 1, std::numeric_limits<double>::infinity());
+        if (!constraints_.serviceTimes.empty()) constraints_.serviceTimes.resize(id + 1, 0.0);
+    }
+    applyDelta();
+
+    skipped_.clear();
+    for (std::size_t k = 0; k < delta_.removed.size(); ++k)
+        repairLink(delta_.removed[k].first, delta_.removed[k].second, removedCosts_[k], id);
+
+    routesAt(id, candidates_);
+    if (candidates_.empty()) insertCheapest(id);
+    for (int node : skipped_) {
+        routesAt(node, candidates_);
+        if (candidates_.empty()) insertCheapest(node);
+    }
+
+    finishUpdate();
+    stats_.covered = !routesAt_[id].empty();
+    return id;
+}
+
+void DynamicInstance::removePoint(int id)
+{
+    if (!contains(id) || isTerminal(id))
+        throw std::invalid_argument("DynamicInstance: no removable point with this id");
+    beginUpdate();
+
+    // Costs of the links through the point, read while its edges still exist
+    std::vector<int> through = routesAt_[id];
+    std::vector<double> cut;
+    for (int r : through) {
+        const auto& route = routes_[r];
+        int p = position(r, id);
+        cut.push_back(linkCost(route[p - 1], id) + linkCost(id, route[p + 1]));
+    }
+
+    triangulation_.remove(id, delta_);
+    applyDelta();
+
+    std::vector<int> path;
+    for (std::size_t k = 0; k < through.size(); ++k) {
+        int r = through[k];
+        int p = position(r, id);
+        int a = routes_[r][p - 1], b = routes_[r][p + 1];
+        double base = lengths_[r] - cut[k];
+
+        if (graph_.hasEdge(a, b) && fits(r, p - 1, p + 1, {}, base + linkCost(a, b))) {
+            replaceSegment(r, p - 1, p + 1, {}, base + linkCost(a, b));
+            continue;
+        }
+        double cost;
+        if (findDetour(r, a, b, path, cost)) {
+            std::span<const int> inner(path.data() + 1, path.size() - 2);
+            if (fits(r, p - 1, p + 1, inner, base + cost)) {
+                replaceSegment(r, p - 1, p + 1, inner, base + cost);
+                continue;
+            }
+        }
+        drop(r);
+    }
+
+    finishUpdate();
+}
+
+void DynamicInstance::setEdgeCost(int u, int v, double cost)
+{
+    int e = graph_.edgeId(u, v);
+    if (e == DynamicGraph::npos)
+        throw std::invalid_argument("DynamicInstance: the vertices are not adjacent");
+    if (std::isnan(cost) || cost < 0.0)
+        throw std::invalid_argument("DynamicInstance: edge cost must be non-negative");
+    beginUpdate();
+
+    double old = graph_.cost(e);
+    graph_.setCost(e, cost);
+    overrides_[pairKey(u, v)] = cost;
+    double straight = euclidean(point(u), point(v));
+    if (straight > 0.0) heuristicScale_ = std::min(heuristicScale_, cost / straight);
+
+    routesAt(isTerminal(u) ? v : u, candidates_);
+    std::vector<int> path;
+    for (int r : candidates_) {
+        int i = findLink(r, u, v);
+        if (i < 0) continue;
+
+        // Summed again rather than adjusted, so an earlier infinite cost does not leave NaN behind
+        const auto& route = routes_[r];
+        double length = 0.0;
+        for (std::size_t k = 0; k + 1 < route.size(); ++k) length += linkCost(route[k], route[k + 1]);
+        lengths_[r] = length;
+        updateTimes(r);
+        if (cost <= old) continue;
+
+        double detour;
+        if (findDetour(r, route[i], route[i + 1], path, detour) && path.size() > 2 && detour < cost) {
+            std::span<const int> inner(path.data() + 1, path.size() - 2);
+            if (fits(r, i, i + 1, inner, length - cost + detour)) {
+                replaceSegment(r, i, i + 1, inner, length - cost + detour);
+                continue;
+            }
+        }
+        // A slower link may also make the route miss a window
+        if (!std::isfinite(cost) || (constraints_.hasTimeWindows() && !forwardTimes_[r].back().feasible)) drop(r);
+    }
+
+    finishUpdate();
+}
+
+// === Solutions ===
+
+void DynamicInstance::setRoutes(std::vector<std::vector<int>> routes)
+{
+    for (const auto& route : routes) {
+        if (route.size() < 2 || route.front() != start_ || route.back() != end_)
+            throw std::invalid_argument("DynamicInstance: a route must run from the start to the end terminal");
+        for (std::size_t k = 0; k < route.size(); ++k) {
+            if (!contains(route[k]) || (k > 0 && k + 1 < route.size() && isTerminal(route[k])))
+                throw std::invalid_argument("DynamicInstance: a route visits an invalid vertex");
+            if (k > 0 && !graph_.hasEdge(route[k - 1], route[k]))
+                throw std::invalid_argument("DynamicInstance: a route link is not a graph edge");
+        }
+    }
+
+    for (const auto& route : routes_) {
+        for (int node : route) routesAt_[node].clear();
+    }
+    routes_ = std::move(routes);
+    lengths_.assign(routes_.size(), 0.0);
+    loads_.assign(routes_.size(), 0.0);
+    if (constraints_.hasTimeWindows()) {
+        forwardTimes_.assign(routes_.size(), {});
+        backwardTimes_.assign(routes_.size(), {});
+    }
+    for (int r = 0; r < (int)routes_.size(); ++r) {
+        const auto& route = routes_[r];
+        for (std::size_t k = 0; k < route.size(); ++k) {
+            if (k > 0) lengths_[r] += linkCost(route[k - 1], route[k]);
+            if (isTerminal(route[k])) continue;
+            loads_[r] += demand(route[k]);
+            routesAt_[route[k]].push_back(r);
+        }
+        updateTimes(r);
+    }
+}
+
+void DynamicInstance::solve(int n_of_roads, MultiRouteOptions options)
+{
+    Snapshot s = snapshot();
+    options.printRoutes = false;
+    options.constraints = constraints_;
+    // Demands and windows are indexed by vertex id, the snapshot by position
+    auto& c = options.constraints;
+    for (auto* values : { &c.demands, &c.readyTimes, &c.dueTimes, &c.serviceTimes }) {
+        if (values->empty()) continue;
+        std::vector<double> byIndex(s.ids.size(), 0.0);
+        for (std::size_t k = 0; k < s.ids.size(); ++k) {
+            if (s.ids[k] < (int)values->size()) byIndex[k] = (*values)[s.ids[k]];
+        }
+        *values = std::move(byIndex);
+    }
+    auto found = solveMultipleRoutes(s.points, s.graph, n_of_roads, options);
+
+    // The solver's last-resort filler may return broken paths; only real routes are kept
+    const int last = (int)s.points.size() - 1;
+    std::vector<std::vector<int>> routes;
+    for (const auto& edges : found) {
+        if (edges.empty() || edges.front().first != 0 || edges.back().second != last) continue;
+        std::vector<int> nodes{ 0 };
+        for (auto [u, v] : edges) {
+            if (u != nodes.back() || !s.graph.hasEdge(u, v)) break;
+            nodes.push_back(v);
+        }
+        if ((int)nodes.size() != (int)edges.size() + 1) continue;
+        for (int& node : nodes) node = s.ids[node];
+        routes.push_back(std::move(nodes));
+    }
+    setRoutes(std::move(routes));
+}
+
+std::vector<std::vector<std::pair<int, int>>> DynamicInstance::routeEdges() const
+{
+    std::vector<std::vector<std::pair<int, int>>> out;
+    out.reserve(routes_.size());
+    for (const auto& route : routes_) {
+        auto& edges = out.emplace_back();
+        for (std::size_t k = 0; k + 1 < route.size(); ++k) edges.emplace_back(route[k], route[k + 1]);
+    }
+    return out;
+}
+
+DynamicInstance::Snapshot DynamicInstance::snapshot() const
+{
+    Snapshot s;
+    s.ids.push_back(start_);
+    for (int v = 0; v < triangulation_.idCount(); ++v) {
+        if (contains(v) && !isTerminal(v)) s.ids.push_back(v);
+    }
+    s.ids.push_back(end_);
+
+    std::vector<int> index(graph_.vertexCount(), -1);
+    s.points.reserve(s.ids.size());
+    for (int k = 0; k < (int)s.ids.size(); ++k) {
+        index[s.ids[k]] = k;
+        s.points.push_back(point(s.ids[k]));
+    }
+
+    std::vector<Edge> edges;
+    edges.reserve(graph_.edgeCount());
+    for (int e = 0; e < graph_.idBound(); ++e) {
+        if (!graph_.isEdge(e)) continue;
+        const Edge& edge = graph_.edge(e);
+        edges.push_back({ index[edge.u], index[edge.v], edge.cost });
+    }
+    s.graph = Graph((int)s.ids.size(), edges);
+    return s;
+}
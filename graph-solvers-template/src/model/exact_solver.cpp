@@ -0,0 +1,595 @@
+#include "model/exact_solver.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <set>
+#include <stdexcept>
+
+#include "common/instrumentation.h"
+#include "model/local_search.h"
+#include "model/savings.h"
+#include "model/solver.h"
+
+namespace {
+
+constexpr double kInf = std::numeric_limits<double>::infinity();
+constexpr double kEps = 1e-6;
+
+/**
+ * Two-index model of the route cover: x_e for graph edges between interior nodes, y_i for
+ * the leg start-i and z_i for the leg i-end. Every interior node has degree 2 in x + y + z.
+ * The start and end may be the same depot; y_i and z_i are then two columns for one link.
+ */
+struct RouteModel
+{
+    int start = 0;
+    int end = 0;
+    int vertexCount = 0;
+    MipModel mip;
+    std::vector<int> u, v;               ///< Endpoints of each column; legs use start or end as v.
+    std::vector<int> edgeColumn;         ///< Graph edge id -> column, -1 if not modelled.
+    std::vector<int> startLeg, endLeg;   ///< Node -> column of its y / z leg, -1 if none.
+    std::vector<std::vector<int>> incident;  ///< Node -> columns touching it.
+
+    bool isInterior(int node) const { return node != start && node != end; }
+    bool isLeg(int column) const { return !isInterior(v[column]); }
+
+    int addColumn(double cost, int a, int b)
+    {
+        int column = mip.addColumn(cost, 0.0, 1.0, true);
+        u.push_back(a);
+        v.push_back(b);
+        incident[a].push_back(column);
+        if (isInterior(b)) incident[b].push_back(column);
+        return column;
+    }
+};
+
+/**
+ * Route covers for the model from Clarke-Wright savings, polished by LocalSearch. The search
+ * runs on a copy of the graph in which the terminal legs are edges priced like their
+ * columns, so it measures routes exactly as the model does. Given an LP point, the savings
+ * of the edges it uses are raised, which steers the merges toward the relaxation.
+ */
+class RouteHeuristic
+{
+public:
+    RouteHeuristic(const RouteModel& model, const Graph& graph, const SavingsList& list,
+        const RouteConstraints& constraints)
+        : model_(model)
+        , graph_(graph)
+        , list_(list)
+        , constraints_(constraints)
+    {
+        auto fromStart = list.depotDistances();
+        auto toEnd = list.endDistances();
+        std::vector<Edge> edges;
+        for (int column = 0; column < model.mip.columnCount(); ++column) {
+            int b = model.v[column];
+            double cost = b == model.start ? fromStart[model.u[column]] : b == model.end ? toEnd[model.u[column]] : model.mip.cost[column];
+            edges.push_back({ model.u[column], b, cost });
+        }
+        legGraph_ = Graph(model.vertexCount, edges);
+        options_.enabled = true;
+        options_.timeLimitMs = 50.0;
+    }
+
+    /// Column values of the best cover found, or empty if it does not fit the model.
+    std::vector<double> run(std::span<const double> lp = {})
+    {
+        // Alternate how strongly the LP pulls, so repeated calls explore different merges
+        const double weight = lp.empty() ? 0.0 : kWeights[calls_++ % std::size(kWeights)];
+        store_.reset(model_.vertexCount, model_.start, model_.end, constraints_.demands);
+        savings_.reset(list_, [&](int k) {
+            int column = model_.edgeColumn[list_[k].edge];
+            return column < 0 || lp.empty() ? 1.0 : 1.0 - weight * lp[column];
+        });
+        mergeRoutes(graph_, list_, savings_, constraints_, store_);
+
+        auto fromStart = list_.depotDistances();
+        auto toEnd = list_.endDistances();
+        routes_.clear();
+        store_.routes(ids_);
+        for (int id : ids_) {
+            auto& route = routes_.emplace_back();
+            store_.materialize(id, route);
+            int first = route[1], last = route[route.size() - 2];
+
+            // Shorter orientation whose legs exist in the model
+            bool forward = model_.startLeg[first] >= 0 && model_.endLeg[last] >= 0;
+            bool backward = model_.startLeg[last] >= 0 && model_.endLeg[first] >= 0;
+            if (forward && backward) forward = fromStart[first] + toEnd[last] <= fromStart[last] + toEnd[first];
+            else if (!forward && !backward) return {};
+            if (!forward) std::reverse(route.begin() + 1, route.end() - 1);
+        }
+        search_.run(legGraph_, routes_, constraints_, options_);
+
+        std::vector<double> x(model_.mip.columnCount(), 0.0);
+        for (const auto& route : routes_) {
+            x[model_.startLeg[route[1]]] = 1.0;
+            x[model_.endLeg[route[route.size() - 2]]] = 1.0;
+            for (std::size_t k = 1; k + 2 < route.size(); ++k) {
+                int column = model_.edgeColumn[graph_.edgeId(route[k], route[k + 1])];
+                if (column < 0) return {};
+                x[column] = 1.0;
+            }
+        }
+        return x;
+    }
+
+private:
+    static constexpr double kWeights[] = { 0.5, 0.8, 0.3 };
+
+    const RouteModel& model_;
+    const Graph& graph_;
+    const SavingsList& list_;
+    const RouteConstraints& constraints_;
+    Graph legGraph_;
+    LocalSearch search_;
+    LocalSearchOptions options_;
+    RouteStore store_;
+    SavingsQueue savings_;
+    std::vector<int> ids_;
+    std::vector<std::vector<int>> routes_;
+    std::size_t calls_ = 0;
+};
+
+/**
+ * Lazy constraints and cuts of the route model. Integral points are checked component by
+ * component; fractional points get connectivity and rounded capacity cuts from the
+ * components of their support graph and from max-flow min-cuts toward the terminals.
+ */
+class RouteSeparator : public MipSeparator
+{
+public:
+    RouteSeparator(const RouteModel& model, const RouteConstraints& constraints, RouteHeuristic& heuristic)
+        : model_(model)
+        , constraints_(constraints)
+        , heuristic_(heuristic)
+        , inSet_(model.vertexCount, 0)
+    {
+    }
+
+    void separateIntegral(std::span<const double> x, std::vector<MipRow>& cuts) override
+    {
+        seen_.clear();
+        forEachComponent(x, 0.5, [&](const std::vector<int>& component) {
+            double legsIn = 0.0, legsOut = 0.0;
+            for (int node : component) {
+                if (model_.startLeg[node] >= 0) legsIn += x[model_.startLeg[node]];
+                if (model_.endLeg[node] >= 0) legsOut += x[model_.endLeg[node]];
+            }
+            // A cycle, or a path whose both ends run to the same terminal
+            if (legsIn + legsOut < 1.5) {
+                addConnectivityCut(component, cuts);
+                return;
+            }
+            if (std::abs(legsIn - legsOut) > 0.5) {
+                addOrientationCut(component, legsIn > legsOut, cuts);
+                return;
+            }
+            if (demandOf(component) > constraints_.capacity + 1e-9) {
+                addConnectivityCut(component, cuts);
+                return;
+            }
+            if (constraints_.maxLength < kInf) addPathCutIfTooLong(x, component, cuts);
+        });
+    }
+
+    void separateFractional(std::span<const double> x, std::vector<MipRow>& cuts) override
+    {
+        seen_.clear();
+        std::size_t before = cuts.size();
+        forEachComponent(x, kEps, [&](const std::vector<int>& component) {
+            double lhs = 0.0, balance = 0.0;
+            for (int node : component) {
+                if (model_.startLeg[node] >= 0) lhs += x[model_.startLeg[node]], balance += x[model_.startLeg[node]];
+                if (model_.endLeg[node] >= 0) lhs += x[model_.endLeg[node]], balance -= x[model_.endLeg[node]];
+            }
+            if (lhs < connectivityRhs(component) - kEps) addConnectivityCut(component, cuts);
+            if (std::abs(balance) > kEps) addOrientationCut(component, balance > 0.0, cuts);
+        });
+        if (constraints_.capacity < kInf && !constraints_.demands.empty()) separateCapacityGreedy(x, cuts);
+        if (cuts.size() > before) return;
+        separateMinCuts(x, cuts);
+    }
+
+    bool suggestSolution(std::span<const double> x, std::vector<double>& solution) override
+    {
+        solution = heuristic_.run(x);
+        return !solution.empty();
+    }
+
+private:
+    double demandOf(const std::vector<int>& set) const
+    {
+        if (constraints_.demands.empty()) return 0.0;
+        double sum = 0.0;
+        for (int node : set) sum += constraints_.demands[node];
+        return sum;
+    }
+
+    /// 2 ⌈d(S) / Q⌉, at least 2: routes needed to serve S, each entering and leaving once.
+    double connectivityRhs(const std::vector<int>& set) const
+    {
+        double routes = 1.0;
+        if (constraints_.capacity < kInf && constraints_.capacity > 0.0)
+            routes = std::max(1.0, std::ceil(demandOf(set) / constraints_.capacity - 1e-9));
+        return 2.0 * routes;
+    }
+
+    bool firstTime(std::vector<int> set, int kind)
+    {
+        std::sort(set.begin(), set.end());
+        set.push_back(kind);
+        return seen_.insert(std::move(set)).second;
+    }
+
+    /// x(δ(S)) + y(S) + z(S) >= 2 ⌈d(S) / Q⌉
+    void addConnectivityCut(const std::vector<int>& set, std::vector<MipRow>& cuts)
+    {
+        if (!firstTime(set, 0)) return;
+        for (int node : set) inSet_[node] = 1;
+        MipRow row{ {}, {}, connectivityRhs(set), kInf };
+        for (int node : set) {
+            for (int column : model_.incident[node]) {
+                if (!model_.isLeg(column) && inSet_[model_.u[column]] && inSet_[model_.v[column]]) continue;
+                row.index.push_back(column);
+                row.value.push_back(1.0);
+            }
+        }
+        for (int node : set) inSet_[node] = 0;
+        cuts.push_back(std::move(row));
+    }
+
+    /// y(S) - z(S) <= x(δ(S)) when @p moreStarts, z(S) - y(S) <= x(δ(S)) otherwise.
+    void addOrientationCut(const std::vector<int>& set, bool moreStarts, std::vector<MipRow>& cuts)
+    {
+        if (!firstTime(set, moreStarts ? 1 : 2)) return;
+        for (int node : set) inSet_[node] = 1;
+        MipRow row{ {}, {}, -kInf, 0.0 };
+        for (int node : set) {
+            for (int column : model_.incident[node]) {
+                double coefficient;
+                if (column == model_.startLeg[node]) coefficient = moreStarts ? 1.0 : -1.0;
+                else if (column == model_.endLeg[node]) coefficient = moreStarts ? -1.0 : 1.0;
+                else if (inSet_[model_.u[column]] && inSet_[model_.v[column]]) continue;
+                else coefficient = -1.0;
+                row.index.push_back(column);
+                row.value.push_back(coefficient);
+            }
+        }
+        for (int node : set) inSet_[node] = 0;
+        cuts.push_back(std::move(row));
+    }
+
+    /// Forbids one start-to-end path longer than the maximum: its k + 1 columns sum to at most k.
+    void addPathCutIfTooLong(std::span<const double> x, const std::vector<int>& component, std::vector<MipRow>& cuts)
+    {
+        int first = -1;
+        for (int node : component) {
+            if (model_.startLeg[node] >= 0 && x[model_.startLeg[node]] > 0.5) first = node;
+        }
+        if (first < 0) return;
+
+        MipRow row{ {}, {}, -kInf, 0.0 };
+        double length = 0.0;
+        auto take = [&](int column) {
+            row.index.push_back(column);
+            row.value.push_back(1.0);
+            length += model_.mip.cost[column];
+        };
+        take(model_.startLeg[first]);
+        for (int node = first, prev = -1;;) {
+            int next = -1;
+            for (int column : model_.incident[node]) {
+                if (model_.isLeg(column) || x[column] < 0.5) continue;
+                int other = model_.u[column] == node ? model_.v[column] : model_.u[column];
+                if (other == prev) continue;
+                next = other;
+                take(column);
+                break;
+            }
+            if (next < 0) {
+                take(model_.endLeg[node]);
+                break;
+            }
+            prev = node;
+            node = next;
+        }
+        if (length <= constraints_.maxLength + 1e-9) return;
+        row.upper = (double)row.index.size() - 1.0;
+        cuts.push_back(std::move(row));
+    }
+
+    /// Calls @p visit with each connected component of the interior nodes in the support
+    /// graph of the edge columns above @p threshold.
+    template <class Visit>
+    void forEachComponent(std::span<const double> x, double threshold, Visit&& visit)
+    {
+        std::vector<char> visited(model_.vertexCount, 0);
+        std::vector<int> component, stack;
+        for (int root = 0; root < model_.vertexCount; ++root) {
+            if (!model_.isInterior(root) || visited[root]) continue;
+            component.clear();
+            stack.assign(1, root);
+            visited[root] = 1;
+            while (!stack.empty()) {
+                int node = stack.back();
+                stack.pop_back();
+                component.push_back(node);
+                for (int column : model_.incident[node]) {
+                    if (model_.isLeg(column) || x[column] <= threshold) continue;
+                    int other = model_.u[column] == node ? model_.v[column] : model_.u[column];
+                    if (visited[other]) continue;
+                    visited[other] = 1;
+                    stack.push_back(other);
+                }
+            }
+            visit(component);
+        }
+    }
+
+    /**
+     * Rounded capacity cuts by greedy growth: from every seed node, repeatedly add the node
+     * most strongly connected to the set. Since every interior node has degree 2, adding j
+     * changes x(δ(S)) + y(S) + z(S) by 2 (1 - x(j : S)), so the left-hand side is tracked in
+     * O(1) per step and checked against 2 ⌈d(S) / Q⌉ after each one.
+     */
+    void separateCapacityGreedy(std::span<const double> x, std::vector<MipRow>& cuts)
+    {
+        const int n = model_.vertexCount;
+        std::vector<double> link(n, 0.0);  // x(j : S)
+        std::vector<int> set, frontier;
+        for (int seed = 0; seed < n; ++seed) {
+            if (!model_.isInterior(seed)) continue;
+            set.assign(1, seed);
+            frontier.clear();
+            double boundary = 2.0, demand = constraints_.demands[seed];
+            auto grow = [&](int node) {
+                inSet_[node] = 1;
+                for (int column : model_.incident[node]) {
+                    if (model_.isLeg(column) || x[column] <= kEps) continue;
+                    int other = model_.u[column] == node ? model_.v[column] : model_.u[column];
+                    if (inSet_[other]) continue;
+                    if (link[other] == 0.0) frontier.push_back(other);
+                    link[other] += x[column];
+                }
+            };
+            grow(seed);
+            for (;;) {
+                int best = -1;
+                for (int node : frontier) {
+                    if (!inSet_[node] && (best < 0 || link[node] > link[best])) best = node;
+                }
+                if (best < 0) break;
+                boundary += 2.0 * (1.0 - link[best]);
+                demand += constraints_.demands[best];
+                set.push_back(best);
+                grow(best);
+                double routes = std::ceil(demand / constraints_.capacity - 1e-9);
+                if (routes >= 2.0 && boundary < 2.0 * routes - 1e-3) {
+                    for (int node : set) inSet_[node] = 0;
+                    addConnectivityCut(set, cuts);
+                    for (int node : set) inSet_[node] = 1;
+                    break;
+                }
+            }
+            for (int node : set) inSet_[node] = 0;
+            for (int node : frontier) link[node] = 0.0;
+        }
+    }
+
+    /**
+     * Max-flow from every interior node to the merged terminals over capacities x_e and
+     * y_i + z_i, stopped once it reaches 2. A smaller flow leaves the source side of the
+     * min-cut as a violated connectivity set.
+     */
+    void separateMinCuts(std::span<const double> x, std::vector<MipRow>& cuts)
+    {
+        const int n = model_.vertexCount;
+        const int sink = model_.start;
+
+        // Residual network: arc 2k and 2k+1 are the two directions of undirected edge k
+        std::vector<std::vector<int>> arcsOf(n);
+        std::vector<int> head;
+        std::vector<double> capacity;
+        auto addEdge = [&](int a, int b, double c) {
+            arcsOf[a].push_back((int)head.size());
+            head.push_back(b);
+            capacity.push_back(c);
+            arcsOf[b].push_back((int)head.size());
+            head.push_back(a);
+            capacity.push_back(c);
+        };
+        std::vector<double> toTerminal(n, 0.0);
+        for (int column = 0; column < model_.mip.columnCount(); ++column) {
+            if (x[column] <= kEps) continue;
+            if (model_.isLeg(column)) toTerminal[model_.u[column]] += x[column];
+            else addEdge(model_.u[column], model_.v[column], x[column]);
+        }
+        for (int node = 0; node < n; ++node) {
+            if (toTerminal[node] > 0.0) addEdge(node, sink, toTerminal[node]);
+        }
+
+        std::vector<char> covered(n, 0);
+        std::vector<double> residual;
+        std::vector<int> parentArc(n), queue;
+        for (int source = 0; source < n; ++source) {
+            if (!model_.isInterior(source) || covered[source]) continue;
+
+            residual = capacity;
+            double flow = 0.0;
+            for (;;) {
+                // Breadth-first augmenting path
+                std::fill(parentArc.begin(), parentArc.end(), -1);
+                queue.assign(1, source);
+                parentArc[source] = -2;
+                for (std::size_t k = 0; k < queue.size() && parentArc[sink] == -1; ++k) {
+                    int node = queue[k];
+                    for (int arc : arcsOf[node]) {
+                        int next = head[arc];
+                        if (residual[arc] <= 1e-9 || parentArc[next] != -1) continue;
+                        parentArc[next] = arc;
+                        queue.push_back(next);
+                    }
+                }
+                if (parentArc[sink] == -1) break;
+
+                double push = 2.0 - flow;
+                for (int node = sink; node != source; node = head[parentArc[node] ^ 1])
+                    push = std::min(push, residual[parentArc[node]]);
+                for (int node = sink; node != source; node = head[parentArc[node] ^ 1]) {
+                    residual[parentArc[node]] -= push;
+                    residual[parentArc[node] ^ 1] += push;
+                }
+                flow += push;
+                if (flow >= 2.0 - kEps) break;
+            }
+            if (flow >= 2.0 - kEps) continue;
+
+            // The nodes still reached from the source form the violated set
+            std::vector<int> set;
+            for (int node : queue) {
+                if (parentArc[node] != -1) set.push_back(node);
+            }
+            for (int node : set) covered[node] = 1;
+            addConnectivityCut(set, cuts);
+        }
+    }
+
+    const RouteModel& model_;
+    const RouteConstraints& constraints_;
+    RouteHeuristic& heuristic_;
+    std::vector<char> inSet_;
+    std::set<std::vector<int>> seen_;  ///< Sets cut in the current call, with the cut kind appended.
+};
+
+} // namespace
+
+double ExactResult::gap() const
+{
+    if (routes.empty() && status != MipStatus::Optimal) return kInf;
+    return std::max(0.0, cost - bound) / std::max(std::abs(cost), 1e-10);
+}
+
+ExactResult solveRoutesExact(const std::vector<Point>& vertices, const Graph& graph, const ExactOptions& options)
+{
+    if (options.constraints.hasTimeWindows())
+        throw std::invalid_argument("solveRoutesExact: time windows are not supported by the route model");
+    auto backend = makeMipBackend(options.backend);
+    ExactResult result;
+    result.backend = backend->name();
+
+    const int n = (int)vertices.size();
+    const Terminals terminals = options.terminals.resolved(n);
+    if (n - (terminals.start == terminals.end ? 1 : 2) <= 0) {
+        result.status = MipStatus::Optimal;
+        return result;
+    }
+
+    RouteModel model;
+    model.start = terminals.start;
+    model.end = terminals.end;
+    model.vertexCount = n;
+    model.incident.resize(n);
+    model.edgeColumn.assign(graph.edgeCount(), -1);
+    model.startLeg.assign(n, -1);
+    model.endLeg.assign(n, -1);
+
+    SavingsList list = options.distances
+        ? SavingsList(*options.distances, graph, model.start, model.end)
+        : SavingsList(vertices, graph, model.start, model.end);
+    auto fromStart = list.depotDistances();
+    auto toEnd = list.endDistances();
+
+    for (int id = 0; id < graph.edgeCount(); ++id) {
+        const Edge& e = graph.edge(id);
+        if (model.isInterior(e.u) && model.isInterior(e.v)) model.edgeColumn[id] = model.addColumn(e.cost, e.u, e.v);
+    }
+    MipRow starts{ {}, {}, -kInf, kInf }, balance{ {}, {}, 0.0, 0.0 };
+    for (int i = 0; i < n; ++i) {
+        if (!model.isInterior(i)) continue;
+        if (!options.terminalEdgesOnly || graph.hasEdge(model.start, i)) {
+            model.startLeg[i] = model.addColumn(fromStart[i], i, model.start);
+            starts.index.push_back(model.startLeg[i]);
+            starts.value.push_back(1.0);
+            balance.index.push_back(model.startLeg[i]);
+            balance.value.push_back(1.0);
+        }
+        if (!options.terminalEdgesOnly || graph.hasEdge(i, model.end)) {
+            model.endLeg[i] = model.addColumn(toEnd[i], i, model.end);
+            balance.index.push_back(model.endLeg[i]);
+            balance.value.push_back(-1.0);
+        }
+    }
+
+    // Degree 2 at every interior node; as many starts as ends; route count limits
+    for (int i = 0; i < n; ++i) {
+        if (!model.isInterior(i)) continue;
+        MipRow degree{ {}, {}, 2.0, 2.0 };
+        for (int column : model.incident[i]) {
+            degree.index.push_back(column);
+            degree.value.push_back(1.0);
+        }
+        model.mip.addRow(std::move(degree));
+    }
+    model.mip.addRow(std::move(balance));
+    if (options.maxRoutes > 0) starts.upper = options.maxRoutes;
+    const RouteConstraints& constraints = options.constraints;
+    if (constraints.capacity < kInf && constraints.capacity > 0.0 && !constraints.demands.empty()) {
+        double total = 0.0;
+        for (int i = 0; i < n; ++i) {
+            if (model.isInterior(i)) total += constraints.demands[i];
+        }
+        starts.lower = std::ceil(total / constraints.capacity - 1e-9);
+    }
+    if (starts.lower > -kInf || starts.upper < kInf) model.mip.addRow(std::move(starts));
+
+    MipOptions mipOptions;
+    mipOptions.timeLimit = options.timeLimit;
+    mipOptions.relativeGap = options.relativeGap;
+    mipOptions.nodeLimit = options.nodeLimit;
+    mipOptions.threads = options.threads;
+    mipOptions.verbose = options.verbose;
+
+    CW_PROFILE_SCOPE("exact_mip");
+    RouteHeuristic heuristic(model, graph, list, constraints);
+    if (options.warmStart) mipOptions.start = heuristic.run();
+    RouteSeparator separator(model, constraints, heuristic);
+    MipResult solved = backend->solve(model.mip, separator, mipOptions);
+
+    result.status = solved.status;
+    result.bound = solved.bound;
+    result.nodes = solved.nodes;
+    result.cuts = solved.cuts;
+    result.seconds = solved.seconds;
+    if (solved.x.empty()) {
+        result.cost = kInf;
+        return result;
+    }
+    result.cost = solved.objective;
+
+    // Trace every route from its start leg through the edge columns to its end leg
+    const auto& x = solved.x;
+    for (int first = 0; first < n; ++first) {
+        if (model.startLeg[first] < 0 || x[model.startLeg[first]] < 0.5) continue;
+        auto& route = result.routes.emplace_back();
+        route.push_back(model.start);
+        for (int node = first, prev = -1; node >= 0;) {
+            route.push_back(node);
+            int next = -1;
+            for (int column : model.incident[node]) {
+                if (model.isLeg(column) || x[column] < 0.5) continue;
+                int other = model.u[column] == node ? model.v[column] : model.u[column];
+                if (other != prev) next = other;
+            }
+            prev = node;
+            node = next;
+        }
+        route.push_back(model.end);
+    }
+    return result;
+}
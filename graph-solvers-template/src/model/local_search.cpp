@@ -0,0 +1,375 @@
+#include "model/local_search.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "common/thread_pool.h"
+
+namespace {
+
+constexpr double epsilon = 1e-9;
+constexpr double infinity = std::numeric_limits<double>::infinity();
+
+} // namespace
+
+double LocalSearch::cost(int u, int v) const
+{
+    // Missing links cost infinity, so a move that needs one is never improving
+    int id = graph_->edgeId(u, v);
+    return id == Graph::npos ? infinity : graph_->cost(id);
+}
+
+bool LocalSearch::expired() const
+{
+    return limited_ && Clock::now() >= deadline_;
+}
+
+void LocalSearch::reindex(int r, int from, int to)
+{
+    const auto& s = routes_[r];
+    from = std::max(from, 1);
+    to = std::min(to, (int)s.size() - 2);
+    for (int k = from; k <= to; ++k)
+        position_[s[k]] = k;
+}
+
+void LocalSearch::wake(int node)
+{
+    // Terminals are shared by every route and carry no bit
+    if (routeOf_[node] >= 0) dontLook_[node] = 0;
+}
+
+bool LocalSearch::keepsWindows(std::span<const int> route) const
+{
+    if (!constraints_->hasTimeWindows()) return true;
+    return fitsSchedule(route, [&](int v) { return constraints_->segment(v); }, [&](int u, int v) { return cost(u, v); });
+}
+
+double LocalSearch::routeLength(int r) const
+{
+    const auto& s = routes_[r];
+    double length = 0.0;
+    for (size_t k = 0; k + 1 < s.size(); ++k)
+        length += cost(s[k], s[k + 1]);
+    return length;
+}
+
+LocalSearchStats LocalSearch::run(const Graph& graph, std::span<std::vector<int>> routes,
+    const RouteConstraints& constraints, const LocalSearchOptions& options)
+{
+    graph_ = &graph;
+    routes_ = routes;
+    constraints_ = &constraints;
+    options_ = &options;
+    limited_ = options.timeLimitMs > 0.0;
+    deadline_ = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double, std::milli>(options.timeLimitMs));
+
+    const int n = graph.vertexCount();
+    const int count = (int)routes.size();
+    routeOf_.assign(n, -1);
+    position_.assign(n, 0);
+    dontLook_.assign(n, 0);
+    load_.assign(count, 0.0);
+    length_.assign(count, 0.0);
+
+    double before = 0.0;
+    for (int r = 0; r < count; ++r) {
+        const auto& s = routes[r];
+        for (int k = 1; k + 1 < (int)s.size(); ++k) {
+            routeOf_[s[k]] = r;
+            position_[s[k]] = k;
+            if (!constraints.demands.empty()) load_[r] += constraints.demands[s[k]];
+        }
+        length_[r] = routeLength(r);
+        before += length_[r];
+    }
+
+    LocalSearchStats stats;
+    const bool intra = options.twoOpt || options.orOpt;
+    const bool inter = (options.relocate || options.swap) && count > 1;
+    while (true) {
+        if (intra) {
+            routeStats_.assign(count, {});
+            auto body = [&](int r, unsigned) {
+                while (improveRoute(r, routeStats_[r]) && !expired()) {}
+            };
+            if (options.pool != nullptr) options.pool->parallelFor(count, body);
+            else for (int r = 0; r < count; ++r) body(r, 0);
+
+            for (const auto& s : routeStats_) {
+                stats.twoOptMoves += s.twoOptMoves;
+                stats.orOptMoves += s.orOptMoves;
+            }
+        }
+        if (expired()) {
+            stats.timedOut = true;
+            break;
+        }
+        if (!inter || !improveBetweenRoutes(stats)) break;
+        if (!intra) continue;
+    }
+
+    double after = 0.0;
+    for (int r = 0; r < count; ++r) after += length_[r];
+    stats.gain = before - after;
+    return stats;
+}
+
+bool LocalSearch::improveRoute(int r, LocalSearchStats& stats)
+{
+    const auto& s = routes_[r];
+    bool improved = false;
+    for (int i = 1; i + 1 < (int)s.size(); ++i) {
+        if (expired()) break;
+        int x = s[i];
+        if (dontLook_[x]) continue;
+
+        if ((options_->twoOpt && tryTwoOpt(r, i, stats)) || (options_->orOpt && tryOrOpt(r, i, stats))) {
+            improved = true;
+            continue;
+        }
+        dontLook_[x] = 1;
+    }
+    return improved;
+}
+
+bool LocalSearch::tryTwoOpt(int r, int i, LocalSearchStats& stats)
+{
+    auto& s = routes_[r];
+    const int last = (int)s.size() - 1;
+    const int x = s[i];
+    auto neighbours = graph_->neighbours(x);
+    auto edges = graph_->incidentEdges(x);
+
+    // Reversing s[from..to] replaces links (a, b), (c, d) by (a, c), (b, d)
+    auto apply = [&](int from, int to, double delta) {
+        if (constraints_->hasTimeWindows()) {
+            std::vector<int> trial = s;
+            std::reverse(trial.begin() + from, trial.begin() + to + 1);
+            if (!keepsWindows(trial)) return false;
+        }
+        int a = s[from - 1], b = s[from], c = s[to], d = s[to + 1];
+        std::reverse(s.begin() + from, s.begin() + to + 1);
+        reindex(r, from, to);
+        length_[r] += delta;
+        ++stats.twoOptMoves;
+        wake(a); wake(b); wake(c); wake(d);
+        return true;
+    };
+
+    // x as a: new link (x, c) for a neighbour c further along the route
+    if (i + 1 < last) {
+        int a = x, b = s[i + 1];
+        for (size_t k = 0; k < neighbours.size(); ++k) {
+            int c = neighbours[k];
+            if (routeOf_[c] != r) continue;
+            int j = position_[c];
+            if (j <= i + 1) continue;
+            int d = s[j + 1];
+            double delta = graph_->cost(edges[k]) + cost(b, d) - cost(a, b) - cost(c, d);
+            if (delta < -epsilon && apply(i + 1, j, delta)) return true;
+        }
+    }
+
+    // x as b: new link (x, d) for a neighbour d further along the route (possibly the end terminal)
+    {
+        int a = s[i - 1], b = x;
+        for (size_t k = 0; k < neighbours.size(); ++k) {
+            int d = neighbours[k];
+            int j;
+            if (d == s[last]) j = last;
+            else if (routeOf_[d] == r) j = position_[d];
+            else continue;
+            if (j <= i + 1) continue;
+            int c = s[j - 1];
+            double delta = cost(a, c) + graph_->cost(edges[k]) - cost(a, b) - cost(c, d);
+            if (delta < -epsilon && apply(i, j - 1, delta)) return true;
+        }
+    }
+    return false;
+}
+
+bool LocalSearch::tryOrOpt(int r, int i, LocalSearchStats& stats)
+{
+    auto& s = routes_[r];
+    const int last = (int)s.size() - 1;
+    const int interior = last - 1;
+
+    for (int len = 1; len <= options_->maxSegment && len < interior; ++len) {
+        int e = i + len - 1;
+        if (e >= last) break;
+
+        int p = s[i - 1], q = s[e + 1];
+        int first = s[i], tail = s[e];
+        double removeGain = cost(p, first) + cost(tail, q) - cost(p, q);
+        if (!(removeGain > epsilon)) continue;
+
+        // Candidate gaps are next to a graph neighbour of either end of the segment
+        for (int endpoint : { first, tail }) {
+            for (int v : graph_->neighbours(endpoint)) {
+                int j;
+                if (v == s[0]) j = 0;
+                else if (v == s[last]) j = last;
+                else if (routeOf_[v] == r) j = position_[v];
+                else continue;
+                if (j >= i && j <= e) continue;
+
+                // v before the gap (g = j) or after it (g = j - 1)
+                for (int g : { j, j - 1 }) {
+                    if (g < 0 || g + 1 > last) continue;
+                    if (g >= i - 1 && g <= e) continue;
+                    int x = s[g], y = s[g + 1];
+
+                    // Orientation that puts endpoint next to v
+                    bool reversed = (g == j) ? endpoint != first : endpoint != tail;
+                    if (len == 1) reversed = false;
+                    int lead = reversed ? tail : first;
+                    int trail = reversed ? first : tail;
+
+                    double delta = cost(x, lead) + cost(trail, y) - cost(x, y) - removeGain;
+                    if (!(delta < -epsilon)) continue;
+
+                    auto move = [&](std::vector<int>& t) {
+                        if (reversed) std::reverse(t.begin() + i, t.begin() + e + 1);
+                        if (g > e) std::rotate(t.begin() + i, t.begin() + e + 1, t.begin() + g + 1);
+                        else std::rotate(t.begin() + g + 1, t.begin() + i, t.begin() + e + 1);
+                    };
+                    if (constraints_->hasTimeWindows()) {
+                        std::vector<int> trial = s;
+                        move(trial);
+                        if (!keepsWindows(trial)) continue;
+                    }
+                    move(s);
+                    reindex(r, std::min(i, g + 1), std::max(e, g));
+                    length_[r] += delta;
+                    ++stats.orOptMoves;
+                    wake(p); wake(q); wake(first); wake(tail); wake(x); wake(y);
+                    return true;
+                }
+            }
+            if (len == 1) break;
+        }
+    }
+    return false;
+}
+
+bool LocalSearch::improveBetweenRoutes(LocalSearchStats& stats)
+{
+    const int n = (int)routeOf_.size();
+    std::fill(dontLook_.begin(), dontLook_.end(), 0);
+
+    bool any = false;
+    bool improved = true;
+    while (improved) {
+        improved = false;
+        for (int u = 0; u < n; ++u) {
+            if (routeOf_[u] < 0 || dontLook_[u]) continue;
+            if (expired()) return any;
+
+            if ((options_->relocate && tryRelocate(u, stats)) || (options_->swap && trySwap(u, stats))) {
+                improved = any = true;
+                continue;
+            }
+            dontLook_[u] = 1;
+        }
+    }
+    return any;
+}
+
+bool LocalSearch::tryRelocate(int u, LocalSearchStats& stats)
+{
+    const int a = routeOf_[u];
+    auto& s = routes_[a];
+    if (s.size() <= 3) return false; // Would leave an empty route
+
+    const int i = position_[u];
+    const int p = s[i - 1], q = s[i + 1];
+    const double removeGain = cost(p, u) + cost(u, q) - cost(p, q);
+    if (!(removeGain > epsilon)) return false;
+
+    const double demand = constraints_->demands.empty() ? 0.0 : constraints_->demands[u];
+    for (int v : graph_->neighbours(u)) {
+        int b = routeOf_[v];
+        if (b < 0 || b == a) continue;
+        if (load_[b] + demand > constraints_->capacity) continue;
+
+        auto& t = routes_[b];
+        int j = position_[v];
+        for (int g : { j - 1, j }) {
+            int x = t[g], y = t[g + 1];
+            double add = cost(x, u) + cost(u, y) - cost(x, y);
+            if (!(add - removeGain < -epsilon)) continue;
+            if (length_[b] + add > constraints_->maxLength) continue;
+            if (constraints_->hasTimeWindows()) {
+                std::vector<int> shorter = s, longer = t;
+                shorter.erase(shorter.begin() + i);
+                longer.insert(longer.begin() + g + 1, u);
+                if (!keepsWindows(shorter) || !keepsWindows(longer)) continue;
+            }
+
+            s.erase(s.begin() + i);
+            reindex(a, i, (int)s.size() - 2);
+            t.insert(t.begin() + g + 1, u);
+            routeOf_[u] = b;
+            reindex(b, g + 1, (int)t.size() - 2);
+
+            load_[a] -= demand;
+            load_[b] += demand;
+            length_[a] -= removeGain;
+            length_[b] += add;
+            ++stats.relocateMoves;
+            wake(p); wake(q); wake(x); wake(y); wake(u);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool LocalSearch::trySwap(int u, LocalSearchStats& stats)
+{
+    const int a = routeOf_[u];
+    auto& s = routes_[a];
+    const int i = position_[u];
+    const int p = s[i - 1], q = s[i + 1];
+    const double du = constraints_->demands.empty() ? 0.0 : constraints_->demands[u];
+
+    for (int w : graph_->neighbours(u)) {
+        int b = routeOf_[w];
+        if (b < 0 || b == a) continue;
+
+        auto& t = routes_[b];
+        int j = position_[w];
+        int pb = t[j - 1], qb = t[j + 1];
+
+        double deltaA = cost(p, w) + cost(w, q) - cost(p, u) - cost(u, q);
+        double deltaB = cost(pb, u) + cost(u, qb) - cost(pb, w) - cost(w, qb);
+        if (!(deltaA + deltaB < -epsilon)) continue;
+
+        double dw = constraints_->demands.empty() ? 0.0 : constraints_->demands[w];
+        if (load_[a] - du + dw > constraints_->capacity || load_[b] - dw + du > constraints_->capacity) continue;
+        if (length_[a] + deltaA > constraints_->maxLength || length_[b] + deltaB > constraints_->maxLength) continue;
+        if (constraints_->hasTimeWindows()) {
+            std::vector<int> first = s, second = t;
+            first[i] = w;
+            second[j] = u;
+            if (!keepsWindows(first) || !keepsWindows(second)) continue;
+        }
+
+        s[i] = w;
+        t[j] = u;
+        routeOf_[u] = b;
+        routeOf_[w] = a;
+        position_[u] = j;
+        position_[w] = i;
+
+        load_[a] += dw - du;
+        load_[b] += du - dw;
+        length_[a] += deltaA;
+        length_[b] += deltaB;
+        ++stats.swapMoves;
+        wake(p); wake(q); wake(pb); wake(qb); wake(u); wake(w);
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,66 @@
+#include "model/mip.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+double MipRow::activity(std::span<const double> x) const
+{
+    double sum = 0.0;
+    for (std::size_t k = 0; k < index.size(); ++k)
+        sum += value[k] * x[index[k]];
+    return sum;
+}
+
+double MipRow::violation(std::span<const double> x) const
+{
+    double a = activity(x);
+    return std::max({ 0.0, lower - a, a - upper });
+}
+
+int MipModel::addColumn(double c, double lb, double ub, bool isInteger)
+{
+    cost.push_back(c);
+    lower.push_back(lb);
+    upper.push_back(ub);
+    integer.push_back(isInteger ? 1 : 0);
+    return columnCount() - 1;
+}
+
+void MipModel::addRow(MipRow row)
+{
+    if (row.index.size() != row.value.size())
+        throw std::invalid_argument("MipModel: row index and value sizes differ");
+    for (int j : row.index) {
+        if (j < 0 || j >= columnCount())
+            throw std::invalid_argument("MipModel: row refers to a missing column");
+    }
+    rows.push_back(std::move(row));
+}
+
+double MipResult::gap() const
+{
+    if (x.empty()) return std::numeric_limits<double>::infinity();
+    return std::max(0.0, objective - bound) / std::max(std::abs(objective), 1e-10);
+}
+
+std::unique_ptr<MipBackend> makeMipBackend(std::string_view name)
+{
+#ifdef CW_HAVE_CPLEX
+    if (name.empty() || name == "cplex") return makeCplexBackend();
+#else
+    if (name.empty()) return makeBranchAndCutBackend();
+#endif
+    if (name == "bundled") return makeBranchAndCutBackend();
+    throw std::invalid_argument("unknown or unavailable MIP backend: " + std::string(name));
+}
+
+std::vector<std::string> availableMipBackends()
+{
+#ifdef CW_HAVE_CPLEX
+    return { "cplex", "bundled" };
+#else
+    return { "bundled" };
+#endif
+}
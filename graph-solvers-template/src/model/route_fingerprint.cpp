@@ -0,0 +1,210 @@
+#include "model/route_fingerprint.h"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+#include "common/simd.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define CW_SIMD_X86 1
+#define CW_TARGET(isa) __attribute__((target(isa)))
+#elif defined(_MSC_VER) && defined(_M_X64)
+#define CW_SIMD_X86 1
+#define CW_TARGET(isa)
+#else
+#define CW_SIMD_X86 0
+#endif
+
+#if CW_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+
+std::uint64_t mix64(std::uint64_t z)
+{
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Hash of edge id under the k-th MinHash permutation.
+std::uint32_t minHash(int edge, int k)
+{
+    return (std::uint32_t)mix64((std::uint64_t)edge * 0x9E3779B97F4A7C15ull + (std::uint64_t)(k + 1) * 0xD1B54A32D192ED03ull);
+}
+
+// Number of bits set in a[i] & b[i] for i in [begin, n).
+std::uint64_t popcountAndScalar(const std::uint64_t* a, const std::uint64_t* b, std::size_t begin, std::size_t n)
+{
+    std::uint64_t count = 0;
+    for (std::size_t i = begin; i < n; ++i)
+        count += std::popcount(a[i] & b[i]);
+    return count;
+}
+
+#if CW_SIMD_X86
+
+// Nibble lookup popcount, summed per 64-bit lane with SAD against zero.
+CW_TARGET("avx2")
+std::uint64_t popcountAndAvx2(const std::uint64_t* a, const std::uint64_t* b, std::size_t n)
+{
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i lowNibble = _mm256_set1_epi8(0x0f);
+    __m256i acc = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i v = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(a + i)),
+            _mm256_loadu_si256((const __m256i*)(b + i)));
+        __m256i lo = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, lowNibble));
+        __m256i hi = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), lowNibble));
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256()));
+    }
+    std::uint64_t count = (std::uint64_t)_mm256_extract_epi64(acc, 0) + (std::uint64_t)_mm256_extract_epi64(acc, 1)
+        + (std::uint64_t)_mm256_extract_epi64(acc, 2) + (std::uint64_t)_mm256_extract_epi64(acc, 3);
+    return count + popcountAndScalar(a, b, i, n);
+}
+
+#endif
+
+// Number of bits set in a[i] & b[i] over n words, on the kernel chosen by simdLevel().
+int popcountAnd(const std::uint64_t* a, const std::uint64_t* b, std::size_t n)
+{
+#if CW_SIMD_X86
+    // Short windows stay scalar: the vector loop would run at most once
+    if (n >= 8 && simdLevel() != SimdLevel::Scalar) return (int)popcountAndAvx2(a, b, n);
+#endif
+    return (int)popcountAndScalar(a, b, 0, n);
+}
+
+} // namespace
+
+RouteFingerprint::RouteFingerprint(const Graph& graph, std::span<const std::pair<int, int>> route,
+    std::pmr::memory_resource* resource)
+    : words_(resource)
+{
+    signature_.fill(std::numeric_limits<std::uint32_t>::max());
+
+    int lo = std::numeric_limits<int>::max();
+    int hi = -1;
+    for (const auto& [u, v] : route) {
+        int id = graph.edgeId(u, v);
+        if (id == Graph::npos) continue;
+        lo = std::min(lo, id);
+        hi = std::max(hi, id);
+    }
+    if (hi < 0) return;
+
+    firstWord_ = lo / 64;
+    words_.assign(hi / 64 - firstWord_ + 1, 0);
+    for (const auto& [u, v] : route) {
+        int id = graph.edgeId(u, v);
+        if (id == Graph::npos) continue;
+
+        std::uint64_t& word = words_[id / 64 - firstWord_];
+        std::uint64_t bit = 1ull << (id % 64);
+        if (word & bit) continue;
+        word |= bit;
+        ++count_;
+
+        for (int k = 0; k < signatureSize; ++k)
+            signature_[k] = std::min(signature_[k], minHash(id, k));
+    }
+}
+
+RouteFingerprint::RouteFingerprint(const RouteFingerprint& other, std::pmr::memory_resource* resource)
+    : count_(other.count_),
+      firstWord_(other.firstWord_),
+      words_(other.words_.begin(), other.words_.end(), resource),
+      signature_(other.signature_)
+{
+}
+
+double jaccard(const RouteFingerprint& a, const RouteFingerprint& b)
+{
+    if (a.edgeCount() == 0 && b.edgeCount() == 0) return 0.0;
+
+    auto wa = a.words();
+    auto wb = b.words();
+    int first = std::max(a.firstWord(), b.firstWord());
+    int last = std::min(a.firstWord() + (int)wa.size(), b.firstWord() + (int)wb.size());
+
+    int common = 0;
+    if (first < last) {
+        common = popcountAnd(wa.data() + (first - a.firstWord()),
+            wb.data() + (first - b.firstWord()), (std::size_t)(last - first));
+    }
+    return (double)common / (a.edgeCount() + b.edgeCount() - common);
+}
+
+double estimateJaccard(const RouteFingerprint& a, const RouteFingerprint& b)
+{
+    int equal = 0;
+    for (int k = 0; k < RouteFingerprint::signatureSize; ++k)
+        equal += a.signature()[k] == b.signature()[k];
+    return (double)equal / RouteFingerprint::signatureSize;
+}
+
+std::uint64_t DiversityFilter::bandKey(const RouteFingerprint& fingerprint, int band)
+{
+    std::uint64_t key = (std::uint64_t)band;
+    for (int r = 0; r < bandRows; ++r)
+        key = mix64(key * 0x9E3779B97F4A7C15ull + fingerprint.signature()[band * bandRows + r]);
+    return key;
+}
+
+bool DiversityFilter::exceeds(const RouteFingerprint& candidate, const RouteFingerprint& accepted, double limit) const
+{
+    // |A ∩ B| / |A ∪ B| <= min / max, so very different sizes cannot be too similar.
+    int small = std::min(candidate.edgeCount(), accepted.edgeCount());
+    int large = std::max(candidate.edgeCount(), accepted.edgeCount());
+    if (large > 0 && (double)small / large <= limit) return false;
+
+    return jaccard(candidate, accepted) > limit;
+}
+
+bool DiversityFilter::isDifferent(const RouteFingerprint& candidate, double minDifferenceThreshold) const
+{
+    double limit = 1.0 - minDifferenceThreshold;
+
+    if (size() < lshThreshold_) {
+        for (const auto& accepted : routes_) {
+            if (exceeds(candidate, accepted, limit)) return false;
+        }
+        return true;
+    }
+
+    std::vector<int>& nearby = nearby_;
+    nearby.clear();
+    for (int band = 0; band < bandCount; ++band) {
+        auto it = buckets_.find(bandKey(candidate, band));
+        if (it != buckets_.end())
+            nearby.insert(nearby.end(), it->second.begin(), it->second.end());
+    }
+    std::sort(nearby.begin(), nearby.end());
+    nearby.erase(std::unique(nearby.begin(), nearby.end()), nearby.end());
+
+    for (int index : nearby) {
+        if (exceeds(candidate, routes_[index], limit)) return false;
+    }
+    return true;
+}
+
+void DiversityFilter::add(const RouteFingerprint& fingerprint)
+{
+    int index = (int)routes_.size();
+    for (int band = 0; band < bandCount; ++band)
+        buckets_[bandKey(fingerprint, band)].push_back(index);
+    // The copy lives in the filter's own arena, detached from the caller's scratch
+    routes_.emplace_back(fingerprint, &arena_);
+}
+
+void DiversityFilter::clear()
+{
+    // The containers must let go of the arena's memory before it is rewound
+    buckets_ = decltype(buckets_)(&arena_);
+    routes_ = decltype(routes_)(&arena_);
+    arena_.reset();
+}
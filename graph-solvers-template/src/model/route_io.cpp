@@ -0,0 +1,291 @@
+#include "model/route_io.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+
+namespace {
+
+constexpr char binaryMagic[4] = { 'C', 'W', 'R', '1' };
+constexpr std::size_t flushThreshold = std::size_t(1) << 16;
+
+bool endsWith(const std::string& s, const std::string& suffix)
+{
+    if (s.size() < suffix.size()) return false;
+    for (std::size_t i = 0; i < suffix.size(); ++i) {
+        char c = s[s.size() - suffix.size() + i];
+        if (c >= 'A' && c <= 'Z') c = (char)(c - 'A' + 'a');
+        if (c != suffix[i]) return false;
+    }
+    return true;
+}
+
+bool readVarint(std::istream& in, unsigned long long& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int byte = in.get();
+        if (byte == std::char_traits<char>::eof()) return false;
+        value |= (unsigned long long)(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+} // namespace
+
+RouteFormat routeFormatFromPath(const std::string& path)
+{
+    if (endsWith(path, ".cwr")) return RouteFormat::Binary;
+    if (endsWith(path, ".geojson")) return RouteFormat::GeoJson;
+    if (endsWith(path, ".json")) return RouteFormat::Json;
+    if (endsWith(path, ".csv")) return RouteFormat::Csv;
+    return RouteFormat::Text;
+}
+
+std::vector<int> routeNodes(const std::vector<std::pair<int, int>>& route)
+{
+    std::vector<int> nodes;
+    if (route.empty()) return nodes;
+    nodes.reserve(route.size() + 1);
+    nodes.push_back(route.front().first);
+    for (const auto& edge : route) nodes.push_back(edge.second);
+    return nodes;
+}
+
+double routeLength(const Graph& graph, const std::vector<std::pair<int, int>>& route)
+{
+    double length = 0.0;
+    for (const auto& [u, v] : route) {
+        int id = graph.edgeId(u, v);
+        if (id != Graph::npos) length += graph.cost(id);
+    }
+    return length;
+}
+
+RouteWriter::RouteWriter(std::ostream& out, RouteFormat format, const Graph& graph, const std::vector<Point>* points)
+    : out_(out), format_(format), graph_(graph), points_(points)
+{
+    if (format_ == RouteFormat::GeoJson && points_ == nullptr)
+        throw std::invalid_argument("GeoJSON route output needs node coordinates");
+    buffer_.reserve(flushThreshold + 256);
+    begin();
+}
+
+RouteWriter::~RouteWriter()
+{
+    try {
+        finish();
+    }
+    catch (...) {
+        // Destructors must not throw; call finish() to observe write errors
+    }
+}
+
+void RouteWriter::begin()
+{
+    switch (format_) {
+    case RouteFormat::Text: buffer_ += "\n=== ZNALEZIONE TRASY ===\n"; break;
+    case RouteFormat::Binary: buffer_.append(binaryMagic, sizeof(binaryMagic)); break;
+    case RouteFormat::Json: buffer_ += "{\"routes\":["; break;
+    case RouteFormat::Csv: buffer_ += "route,length,nodes\n"; break;
+    case RouteFormat::GeoJson: buffer_ += "{\"type\":\"FeatureCollection\",\"features\":["; break;
+    }
+}
+
+void RouteWriter::write(const std::vector<std::pair<int, int>>& route)
+{
+    const int index = count_++;
+    const double length = routeLength(graph_, route);
+    const std::vector<int> nodes = routeNodes(route);
+
+    switch (format_) {
+    case RouteFormat::Text:
+        buffer_ += "Trasa ";
+        appendInt(index);
+        buffer_ += ": ";
+        if (nodes.empty()) {
+            buffer_ += "PUSTA\n";
+            break;
+        }
+        appendInt(nodes[0]);
+        for (std::size_t k = 1; k < nodes.size(); ++k) {
+            buffer_ += " -> ";
+            appendInt(nodes[k]);
+        }
+        buffer_ += " | Dlugosc: ";
+        appendFixed(length, 2);
+        buffer_ += '\n';
+        break;
+
+    case RouteFormat::Binary: {
+        appendVarint(nodes.size());
+        char bytes[sizeof(double)];
+        std::memcpy(bytes, &length, sizeof(double));
+        buffer_.append(bytes, sizeof(double));
+        long long previous = 0;
+        for (int node : nodes) {
+            long long delta = (long long)node - previous;
+            appendVarint(((unsigned long long)delta << 1) ^ (unsigned long long)(delta >> 63));
+            previous = node;
+        }
+        break;
+    }
+
+    case RouteFormat::Json:
+        buffer_ += index ? ",\n{\"route\":" : "\n{\"route\":";
+        appendInt(index);
+        buffer_ += ",\"length\":";
+        appendDouble(length);
+        buffer_ += ",\"nodes\":[";
+        for (std::size_t k = 0; k < nodes.size(); ++k) {
+            if (k) buffer_ += ',';
+            appendInt(nodes[k]);
+        }
+        buffer_ += "]}";
+        break;
+
+    case RouteFormat::Csv:
+        appendInt(index);
+        buffer_ += ',';
+        appendDouble(length);
+        buffer_ += ',';
+        for (std::size_t k = 0; k < nodes.size(); ++k) {
+            if (k) buffer_ += ' ';
+            appendInt(nodes[k]);
+        }
+        buffer_ += '\n';
+        break;
+
+    case RouteFormat::GeoJson:
+        buffer_ += index ? ",\n" : "\n";
+        buffer_ += "{\"type\":\"Feature\",\"properties\":{\"route\":";
+        appendInt(index);
+        buffer_ += ",\"length\":";
+        appendDouble(length);
+        buffer_ += "},\"geometry\":{\"type\":\"LineString\",\"coordinates\":[";
+        for (std::size_t k = 0; k < nodes.size(); ++k) {
+            const Point& p = points_->at(nodes[k]);
+            buffer_ += k ? ",[" : "[";
+            appendDouble(p.x);
+            buffer_ += ',';
+            appendDouble(p.y);
+            buffer_ += ']';
+        }
+        buffer_ += "]}}";
+        break;
+    }
+
+    if (buffer_.size() >= flushThreshold) flush();
+}
+
+void RouteWriter::finish()
+{
+    if (finished_) return;
+    finished_ = true;
+
+    switch (format_) {
+    case RouteFormat::Text: buffer_ += "========================\n\n"; break;
+    case RouteFormat::Binary: break;
+    case RouteFormat::Json:
+    case RouteFormat::GeoJson: buffer_ += "\n]}\n"; break;
+    case RouteFormat::Csv: break;
+    }
+    flush();
+    out_.flush();
+    if (!out_) throw std::runtime_error("failed to write routes");
+}
+
+void RouteWriter::flush()
+{
+    out_.write(buffer_.data(), (std::streamsize)buffer_.size());
+    buffer_.clear();
+}
+
+void RouteWriter::appendInt(long long value)
+{
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    buffer_.append(digits, result.ptr);
+}
+
+void RouteWriter::appendDouble(double value)
+{
+    // Shortest representation that reads back to the same double
+    char digits[32];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    buffer_.append(digits, result.ptr);
+}
+
+void RouteWriter::appendFixed(double value, int precision)
+{
+    char digits[352];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::fixed, precision);
+    buffer_.append(digits, result.ptr);
+}
+
+void RouteWriter::appendVarint(unsigned long long value)
+{
+    while (value >= 0x80) {
+        buffer_ += (char)((value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+    buffer_ += (char)value;
+}
+
+void writeRoutes(const std::string& path,
+    const std::vector<std::vector<std::pair<int, int>>>& routes,
+    const Graph& graph,
+    const std::vector<Point>& points)
+{
+    writeRoutes(path, routes, graph, points, routeFormatFromPath(path));
+}
+
+void writeRoutes(const std::string& path,
+    const std::vector<std::vector<std::pair<int, int>>>& routes,
+    const Graph& graph,
+    const std::vector<Point>& points,
+    RouteFormat format)
+{
+    std::ofstream out(path, std::ios::binary);
+    if (!out) throw std::runtime_error("cannot write " + path);
+    RouteWriter writer(out, format, graph, &points);
+    for (const auto& route : routes) writer.write(route);
+    try {
+        writer.finish();
+    }
+    catch (const std::runtime_error&) {
+        throw std::runtime_error("cannot write " + path);
+    }
+}
+
+std::vector<StoredRoute> readBinaryRoutes(std::istream& in)
+{
+    char magic[sizeof(binaryMagic)];
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, binaryMagic, sizeof(magic)) != 0)
+        throw std::runtime_error("not a binary route stream");
+
+    std::vector<StoredRoute> routes;
+    unsigned long long count = 0;
+    while (in.peek() != std::char_traits<char>::eof()) {
+        StoredRoute& route = routes.emplace_back();
+        char bytes[sizeof(double)];
+        if (!readVarint(in, count) || !in.read(bytes, sizeof(bytes)))
+            throw std::runtime_error("truncated route record");
+        std::memcpy(&route.length, bytes, sizeof(double));
+
+        route.nodes.reserve((std::size_t)std::min<unsigned long long>(count, 1u << 20));
+        long long previous = 0;
+        for (unsigned long long k = 0; k < count; ++k) {
+            unsigned long long zigzag = 0;
+            if (!readVarint(in, zigzag)) throw std::runtime_error("truncated route record");
+            previous += (long long)(zigzag >> 1) ^ -(long long)(zigzag & 1);
+            route.nodes.push_back((int)previous);
+        }
+    }
+    return routes;
+}
@@ -0,0 +1,140 @@
+#include "model/route_store.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+void RouteStore::reset(int vertexCount, int start, int end, std::span<const double> demands)
+{
+    start_ = start;
+    end_ = end;
+    timed_ = false;
+    links_.assign(vertexCount, { none, none });
+    parent_.resize(vertexCount);
+    head_.resize(vertexCount);
+    tail_.resize(vertexCount);
+    size_.assign(vertexCount, 1);
+    load_.resize(vertexCount);
+    cost_.assign(vertexCount, 0.0);
+
+    routeCount_ = 0;
+    for (int i = 0; i < vertexCount; ++i) {
+        load_[i] = demands.empty() ? 0.0 : demands[i];
+        if (i == start || i == end) {
+            parent_[i] = none;
+            size_[i] = 0;
+            continue;
+        }
+        parent_[i] = i;
+        head_[i] = i;
+        tail_[i] = i;
+        ++routeCount_;
+    }
+}
+
+void RouteStore::reset(int vertexCount, int start, int end, const RouteConstraints& constraints)
+{
+    reset(vertexCount, start, end, constraints.demands);
+    if (!constraints.hasTimeWindows()) return;
+
+    const std::size_t n = (std::size_t)vertexCount;
+    if (constraints.readyTimes.size() < n || constraints.dueTimes.size() != constraints.readyTimes.size()
+        || (!constraints.serviceTimes.empty() && constraints.serviceTimes.size() != constraints.readyTimes.size()))
+        throw std::invalid_argument("RouteStore: time windows do not cover every vertex");
+
+    timed_ = true;
+    forward_.resize(n);
+    for (int i = 0; i < vertexCount; ++i) forward_[i] = constraints.segment(i);
+    backward_ = forward_;
+}
+
+void RouteStore::setTimes(int route, const TimeSegment& forward, const TimeSegment& backward)
+{
+    forward_[route] = forward;
+    backward_[route] = backward;
+}
+
+int RouteStore::routeOf(int node)
+{
+    int root = node;
+    while (parent_[root] != root)
+        root = parent_[root];
+    // Full path compression: a second pass points every node on the path
+    // straight at the root, keeping the trees flat without recursion.
+    while (parent_[node] != root) {
+        int up = parent_[node];
+        parent_[node] = root;
+        node = up;
+    }
+    return root;
+}
+
+void RouteStore::reverse(int route)
+{
+    std::swap(head_[route], tail_[route]);
+    if (timed_) std::swap(forward_[route], backward_[route]);
+}
+
+int RouteStore::merge(int a, int b, double linkCost)
+{
+    int front = routeOf(a);
+    int back = routeOf(b);
+
+    // Orient the routes as (... a) + (b ...).
+    if (tail_[front] != a) reverse(front);
+    if (head_[back] != b) reverse(back);
+
+    link(a, b);
+    link(b, a);
+
+    int head = head_[front];
+    int tail = tail_[back];
+    int size = size_[front] + size_[back];
+    double load = load_[front] + load_[back];
+    double cost = cost_[front] + cost_[back] + linkCost;
+    TimeSegment forward, backward;
+    if (timed_) {
+        forward = concatenate(forward_[front], linkCost, forward_[back]);
+        backward = concatenate(backward_[back], linkCost, backward_[front]);
+    }
+
+    // Union by size; the surviving root takes over the route bookkeeping.
+    if (size_[front] < size_[back]) std::swap(front, back);
+    parent_[back] = front;
+    head_[front] = head;
+    tail_[front] = tail;
+    size_[front] = size;
+    load_[front] = load;
+    cost_[front] = cost;
+    if (timed_) setTimes(front, forward, backward);
+
+    --routeCount_;
+    return front;
+}
+
+void RouteStore::routes(std::vector<int>& out)
+{
+    out.clear();
+    for (int i = 0; i < (int)links_.size(); ++i) {
+        if (!contains(i) || !isEndpoint(i)) continue;
+        int route = routeOf(i);
+        // Report each route once, from its smaller endpoint.
+        if (i == std::min(head_[route], tail_[route]))
+            out.push_back(route);
+    }
+}
+
+void RouteStore::materialize(int route, std::vector<int>& out) const
+{
+    out.clear();
+    out.reserve(size_[route] + 2);
+    out.push_back(start_);
+    int prev = none;
+    for (int node = head_[route]; node != none;) {
+        out.push_back(node);
+        int next = links_[node][0] == prev ? links_[node][1] : links_[node][0];
+        prev = node;
+        node = next;
+    }
+    out.push_back(end_);
+}
@@ -0,0 +1,48 @@
+#include "model/savings.h"
+
+#include <utility>
+
+#include "common/point_set.h"
+
+SavingsList::SavingsList(const std::vector<Point>& vertices, const Graph& graph, int start, int end)
+    : SavingsList(EuclideanDistances(vertices), graph, start, end)
+{
+}
+
+SavingsList::SavingsList(const DistanceProvider& distances, const Graph& graph, int start, int end)
+{
+    const int n = distances.size();
+    depotDistances_.resize(n);
+    endDistances_.resize(n);
+    distances.row(start, depotDistances_);
+    distances.column(end, endDistances_);
+    computeBase(graph, start, end);
+}
+
+SavingsList::SavingsList(std::vector<double> depotDistances, std::vector<double> endDistances,
+    const Graph& graph, int start, int end)
+    : depotDistances_(std::move(depotDistances))
+    , endDistances_(std::move(endDistances))
+{
+    computeBase(graph, start, end);
+}
+
+void SavingsList::computeBase(const Graph& graph, int start, int end)
+{
+    start_ = start;
+    end_ = end;
+
+    // Savings of every edge in one vectorized pass, then drop those touching a terminal
+    std::vector<double> values(graph.edgeCount());
+    computeSavings(depotDistances_, graph.edges(), values);
+
+    base_.reserve(graph.edgeCount());
+    costs_.reserve(graph.edgeCount());
+    for (int id = 0; id < graph.edgeCount(); ++id) {
+        const auto& e = graph.edge(id);
+        if (e.u == start || e.v == start || e.u == end || e.v == end) continue;
+
+        base_.push_back({ e.u, e.v, values[id], id });
+        costs_.push_back(e.cost);
+    }
+}
@@ -0,0 +1,208 @@
+#include "model/shortest_path.h"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+#include "common/point_set.h"
+
+void BinaryHeap::push(double key, int node)
+{
+    items_.emplace_back(key, node);
+    std::push_heap(items_.begin(), items_.end(), std::greater<>());
+}
+
+std::pair<double, int> BinaryHeap::pop()
+{
+    std::pop_heap(items_.begin(), items_.end(), std::greater<>());
+    auto top = items_.back();
+    items_.pop_back();
+    return top;
+}
+
+void RadixHeap::clear()
+{
+    for (auto& bucket : buckets_)
+        bucket.clear();
+    last_ = 0;
+    size_ = 0;
+}
+
+int RadixHeap::bucketOf(std::uint64_t key, std::uint64_t last)
+{
+    return key == last ? 0 : 64 - std::countl_zero(key ^ last);
+}
+
+void RadixHeap::push(double key, int node)
+{
+    std::uint64_t bits = std::bit_cast<std::uint64_t>(std::max(key, 0.0));
+    bits = std::max(bits, last_);
+    buckets_[bucketOf(bits, last_)].emplace_back(bits, node);
+    ++size_;
+}
+
+void RadixHeap::refill()
+{
+    if (!buckets_[0].empty()) return;
+
+    int i = 1;
+    while (buckets_[i].empty())
+        ++i;
+
+    auto& bucket = buckets_[i];
+    std::uint64_t smallest = bucket.front().first;
+    for (const auto& item : bucket)
+        smallest = std::min(smallest, item.first);
+
+    // Every item of bucket i lands in a lower bucket relative to the new minimum.
+    last_ = smallest;
+    for (const auto& item : bucket)
+        buckets_[bucketOf(item.first, last_)].push_back(item);
+    bucket.clear();
+}
+
+double RadixHeap::minKey()
+{
+    refill();
+    return std::bit_cast<double>(last_);
+}
+
+std::pair<double, int> RadixHeap::pop()
+{
+    refill();
+    auto item = buckets_[0].back();
+    buckets_[0].pop_back();
+    --size_;
+    return { std::bit_cast<double>(item.first), item.second };
+}
+
+ShortestPathEngine::ShortestPathEngine(const std::vector<Point>& vertices, const Graph& graph, HeapKind heap)
+    : vertices_(&vertices), graph_(&graph), heapKind_(heap)
+{
+    rebind(vertices, graph);
+}
+
+void ShortestPathEngine::rebind(const std::vector<Point>& vertices, const Graph& graph)
+{
+    vertices_ = &vertices;
+    graph_ = &graph;
+
+    // The heuristic stays admissible as long as no edge is cheaper than scale * its length.
+    scale_ = std::numeric_limits<double>::infinity();
+    std::vector<double> lengths(graph.edgeCount());
+    PointSet(vertices).edgeLengths(graph.edges(), lengths);
+    for (int id = 0; id < graph.edgeCount(); ++id) {
+        if (lengths[id] > 0.0)
+            scale_ = std::min(scale_, std::max(graph.edge(id).cost, 0.0) / lengths[id]);
+    }
+    if (scale_ == std::numeric_limits<double>::infinity())
+        scale_ = 0.0;
+
+    int n = graph.vertexCount();
+    blockStamp_.assign(n, 0);
+    for (int dir = 0; dir < 2; ++dir) {
+        seenStamp_[dir].assign(n, 0);
+        closedStamp_[dir].assign(n, 0);
+        dist_[dir].assign(n, 0.0);
+        parent_[dir].assign(n, -1);
+    }
+}
+
+void ShortestPathEngine::beginQuery()
+{
+    // Stamps from older queries become stale; only a wrap-around needs a real reset.
+    if (++generation_ == 0) {
+        std::fill(blockStamp_.begin(), blockStamp_.end(), 0);
+        for (int dir = 0; dir < 2; ++dir) {
+            std::fill(seenStamp_[dir].begin(), seenStamp_[dir].end(), 0);
+            std::fill(closedStamp_[dir].begin(), closedStamp_[dir].end(), 0);
+        }
+        generation_ = 1;
+    }
+}
+
+bool ShortestPathEngine::search(int source, int target, std::vector<int>& path)
+{
+    if (heapKind_ == HeapKind::Radix)
+        return searchWith(radix_[0], radix_[1], source, target, path);
+    return searchWith(binary_[0], binary_[1], source, target, path);
+}
+
+template <typename Heap>
+bool ShortestPathEngine::searchWith(Heap& forward, Heap& backward, int source, int target, std::vector<int>& path)
+{
+    path.clear();
+    lastDistance_ = std::numeric_limits<double>::infinity();
+    if (source == target) {
+        path.push_back(source);
+        lastDistance_ = 0.0;
+        return true;
+    }
+
+    const Point& s = (*vertices_)[source];
+    const Point& t = (*vertices_)[target];
+    auto potential = [&](int v) {
+        return scale_ * 0.5 * (euclidean((*vertices_)[v], t) - euclidean(s, (*vertices_)[v]));
+    };
+
+    forward.clear();
+    backward.clear();
+    Heap* heaps[2] = { &forward, &backward };
+
+    auto label = [&](int dir, int v, double g, int parent) {
+        seenStamp_[dir][v] = generation_;
+        dist_[dir][v] = g;
+        parent_[dir][v] = parent;
+    };
+
+    label(0, source, 0.0, -1);
+    label(1, target, 0.0, -1);
+    forward.push(potential(source), source);
+    backward.push(-potential(target), target);
+
+    double best = std::numeric_limits<double>::infinity();
+    int meet = -1;
+
+    while (!forward.empty() && !backward.empty()) {
+        double keyF = forward.minKey();
+        double keyB = backward.minKey();
+        if (keyF + keyB >= best) break;
+
+        // Expand the direction with the smaller frontier key.
+        int dir = keyF <= keyB ? 0 : 1;
+        double sign = dir == 0 ? 1.0 : -1.0;
+        auto [key, u] = heaps[dir]->pop();
+        if (closedStamp_[dir][u] == generation_) continue;
+        closedStamp_[dir][u] = generation_;
+
+        double gu = dist_[dir][u];
+        auto nbrs = graph_->neighbours(u);
+        auto ids = graph_->incidentEdges(u);
+        for (size_t k = 0; k < nbrs.size(); ++k) {
+            int v = nbrs[k];
+            if (blockStamp_[v] == generation_ && v != source && v != target) continue;
+
+            double g = gu + graph_->cost(ids[k]);
+            if (seenStamp_[dir][v] == generation_ && g >= dist_[dir][v]) continue;
+
+            label(dir, v, g, u);
+            heaps[dir]->push(g + sign * potential(v), v);
+
+            if (seenStamp_[1 - dir][v] == generation_ && g + dist_[1 - dir][v] < best) {
+                best = g + dist_[1 - dir][v];
+                meet = v;
+            }
+        }
+    }
+
+    if (meet < 0) return false;
+
+    for (int v = meet; v != -1; v = parent_[0][v])
+        path.push_back(v);
+    std::reverse(path.begin(), path.end());
+    for (int v = parent_[1][meet]; v != -1; v = parent_[1][v])
+        path.push_back(v);
+
+    lastDistance_ = best;
+    return true;
+}
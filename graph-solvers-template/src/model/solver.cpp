@@ -1,5 +1,4 @@
 #include "model/solver.h"
-#include <ilcplex/ilocplex.h>
 
 #include <iostream>
 #include <vector>
@@ -14,341 +13,660 @@
 #include <iomanip>
 
 #include <unordered_map>
+#include <memory>
+#include <cstdint>
+#include <optional>
+#include <numeric>
+#include <functional>
+
+#include "common/arena.h"
+#include "common/random.h"
+#include "common/instrumentation.h"
+#include "common/thread_pool.h"
+#include "model/route_store.h"
+#include "model/shortest_path.h"
+#include "model/route_fingerprint.h"
+#include "model/route_io.h"
 
 // Funkcja do obliczania podobieństwa między trasami (Jaccard similarity)
-double routeSimilarity(const std::vector<std::pair<int, int>>& route1,
-    const std::vector<std::pair<int, int>>& route2) {
-    std::set<std::pair<int, int>> edges1(route1.begin(), route1.end());
-    std::set<std::pair<int, int>> edges2(route2.begin(), route2.end());
-
-    std::set<std::pair<int, int>> intersection;
-    std::set_intersection(edges1.begin(), edges1.end(),
-        edges2.begin(), edges2.end(),
-        std::inserter(intersection, intersection.begin()));
-
-    std::set<std::pair<int, int>> union_set;
-    std::set_union(edges1.begin(), edges1.end(),
-        edges2.begin(), edges2.end(),
-        std::inserter(union_set, union_set.begin()));
-
-    if (union_set.empty()) return 0.0;
-    return static_cast<double>(intersection.size()) / union_set.size();
-}
-
-// Funkcja do sprawdzenia czy trasa jest wystarczająco różna od istniejących
-bool isRouteDifferent(const std::vector<std::pair<int, int>>& newRoute,
-    const std::vector<std::vector<std::pair<int, int>>>& existingRoutes,
-    double minDifferenceThreshold = 0.3) {
-    for (const auto& existingRoute : existingRoutes) {
-        if (routeSimilarity(newRoute, existingRoute) > (1.0 - minDifferenceThreshold)) {
-            return false;
-        }
+double routeSimilarity(std::span<const std::pair<int, int>> route1,
+    std::span<const std::pair<int, int>> route2,
+    std::pmr::memory_resource* scratch) {
+    std::pmr::vector<std::pair<int, int>> edges1(route1.begin(), route1.end(), scratch);
+    std::pmr::vector<std::pair<int, int>> edges2(route2.begin(), route2.end(), scratch);
+    std::sort(edges1.begin(), edges1.end());
+    std::sort(edges2.begin(), edges2.end());
+    edges1.erase(std::unique(edges1.begin(), edges1.end()), edges1.end());
+    edges2.erase(std::unique(edges2.begin(), edges2.end()), edges2.end());
+
+    // Liczność przecięcia w jednym przejściu po posortowanych listach
+    size_t common = 0;
+    for (size_t i = 0, j = 0; i < edges1.size() && j < edges2.size();) {
+        if (edges1[i] < edges2[j]) ++i;
+        else if (edges2[j] < edges1[i]) ++j;
+        else { ++common; ++i; ++j; }
     }
-    return true;
-}
-
-// Funkcja do znajdowania alternatywnej trasy używając k-shortest paths
-std::vector<std::pair<int, int>> findAlternativePath(
-    const std::vector<Point>& vertices,
-    const std::vector<Edge>& edges,
-    const std::set<int>& avoidNodes,
-    double costMultiplier = 1.0) {
 
-    int start = 0;
-    int end = (int)vertices.size() - 1;
-
-    // Buduj graf z modyfikowanymi kosztami
-    std::unordered_map<int, std::vector<std::pair<int, double>>> adj;
-    std::set<std::pair<int, int>> edge_set;
-
-    for (const auto& edge : edges) {
-        if (avoidNodes.count(edge.u) || avoidNodes.count(edge.v)) continue;
-
-        double modifiedCost = edge.cost;
-        // Zwiększ koszt krawędzi prowadzących do unikanych węzłów
-        if (avoidNodes.count(edge.u) || avoidNodes.count(edge.v)) {
-            modifiedCost *= costMultiplier;
-        }
+    size_t unionSize = edges1.size() + edges2.size() - common;
+    if (unionSize == 0) return 0.0;
+    return static_cast<double>(common) / unionSize;
+}
 
-        adj[edge.u].emplace_back(edge.v, modifiedCost);
-        adj[edge.v].emplace_back(edge.u, modifiedCost);
-        edge_set.insert({ edge.u, edge.v });
-        edge_set.insert({ edge.v, edge.u });
-    }
+void dijkstra(int source, const std::vector<std::vector<std::pair<int, double>>>& adj,
+    std::vector<double>& dist, std::vector<int>& parent) {
 
-    // Dijkstra do znajdowania najkrótszej ścieżki
-    std::vector<double> dist(vertices.size(), std::numeric_limits<double>::infinity());
-    std::vector<int> parent(vertices.size(), -1);
-    std::priority_queue<std::pair<double, int>,
-        std::vector<std::pair<double, int>>,
-        std::greater<std::pair<double, int>>> pq;
+    dist.assign(adj.size(), std::numeric_limits<double>::infinity());
+    parent.assign(adj.size(), -1);
 
-    dist[start] = 0;
-    pq.push({ 0, start });
+    BinaryHeap pq;
+    dist[source] = 0;
+    pq.push(0, source);
 
     while (!pq.empty()) {
-        auto [d, u] = pq.top();
-        pq.pop();
-
+        auto [d, u] = pq.pop();
         if (d > dist[u]) continue;
 
         for (auto [v, cost] : adj[u]) {
             if (dist[u] + cost < dist[v]) {
                 dist[v] = dist[u] + cost;
                 parent[v] = u;
-                pq.push({ dist[v], v });
+                pq.push(dist[v], v);
             }
         }
     }
+}
 
-    // Rekonstruuj ścieżkę
-    std::vector<std::pair<int, int>> path;
-    if (dist[end] == std::numeric_limits<double>::infinity()) {
-        return path; // Brak ścieżki
-    }
+std::vector<int> reconstruct_path(int from, int to, const std::vector<std::vector<int>>& parent_matrix) {
+    std::vector<int> path;
+    const auto& parent = parent_matrix[from];
 
-    int current = end;
-    while (parent[current] != -1) {
-        path.push_back({ parent[current], current });
-        current = parent[current];
+    for (int current = to; current != -1; current = parent[current]) {
+        path.push_back(current);
+        if (current == from) break;
     }
+    if (path.back() != from) return {}; // Brak ścieżki
 
     std::reverse(path.begin(), path.end());
     return path;
 }
 
-std::vector<std::vector<std::pair<int, int>>> solveProblem(
+// Funkcja do znajdowania alternatywnej trasy omijającej podane węzły
+bool findAlternativePath(
     const std::vector<Point>& vertices,
-    const std::vector<Edge>& edges,
-    int n_of_roads) {
+    ShortestPathEngine& engine,
+    std::span<const int> avoidNodes,
+    RouteWorkspace& workspace,
+    ArenaRoute& path,
+    Terminals terminals) {
+
+    CW_PROFILE_SCOPE("fallback_path");
+    CW_COUNT(FallbackPaths, 1);
+
+    const auto [start, end] = terminals.resolved((int)vertices.size());
 
-    int start = 0;
-    int end = (int)vertices.size() - 1;
-
-    // === Adjacency and Edge set for validation ===
-    std::unordered_map<int, std::vector<std::pair<int, double>>> adj;
-    std::set<std::pair<int, int>> edge_set;
-    for (const auto& edge : edges) {
-        adj[edge.u].emplace_back(edge.v, edge.cost);
-        adj[edge.v].emplace_back(edge.u, edge.cost);
-        edge_set.insert({ edge.u, edge.v });
-        edge_set.insert({ edge.v, edge.u });
+    path.clear();
+    auto& nodes = workspace.nodes;
+    if (!engine.findPath(start, end, avoidNodes, nodes)) {
+        return false; // Brak ścieżki
     }
 
-    // === Initial routes ===
-    std::unordered_map<int, int> nodeToRoute;
-    std::vector<std::vector<int>> routes;
-    for (int i = 0; i < (int)vertices.size(); ++i) {
-        if (i == start || i == end) continue;
-        routes.push_back({ start, i, end });
-        nodeToRoute[i] = (int)routes.size() - 1;
+    path.reserve(nodes.size() - 1);
+    for (size_t i = 0; i + 1 < nodes.size(); ++i) {
+        path.emplace_back(nodes[i], nodes[i + 1]);
     }
+    return true;
+}
 
-    // === Compute Savings ===
-    struct Saving {
-        int i, j;
-        double value;
-    };
-    std::vector<Saving> savings;
-    for (const auto& edge : edges) {
-        int i = edge.u;
-        int j = edge.v;
-        if (i == start || j == start || i == end || j == end) continue;
+std::vector<std::pair<int, int>> findAlternativePath(
+    const std::vector<Point>& vertices,
+    ShortestPathEngine& engine,
+    const std::set<int>& avoidNodes,
+    Terminals terminals) {
 
-        const auto& p0 = vertices[start];
-        const auto& pi = vertices[i];
-        const auto& pj = vertices[j];
+    RouteWorkspace workspace;
+    ArenaRoute path(std::pmr::new_delete_resource());
+    std::vector<int> avoid(avoidNodes.begin(), avoidNodes.end());
+    findAlternativePath(vertices, engine, avoid, workspace, path, terminals);
+    return { path.begin(), path.end() };
+}
+
+std::vector<std::pair<int, int>> findAlternativePath(
+    const std::vector<Point>& vertices,
+    const Graph& graph,
+    const std::set<int>& avoidNodes,
+    double costMultiplier,
+    Terminals terminals) {
 
-        double c0i = std::hypot(p0.x - pi.x, p0.y - pi.y);
-        double c0j = std::hypot(p0.x - pj.x, p0.y - pj.y);
+    // Krawędzie do unikanych węzłów są pomijane, więc mnożnik nie wpływa na wynik
+    (void)costMultiplier;
 
-        savings.push_back({ i, j, c0i + c0j - edge.cost });
+    ShortestPathEngine engine(vertices, graph);
+    return findAlternativePath(vertices, engine, avoidNodes, terminals);
+}
+
+// Czy ścieżka zastępcza dotrzymuje okien czasowych; czas przejazdu to koszt krawędzi
+static bool keepsWindows(const Graph& graph, const RouteConstraints& constraints, std::span<const std::pair<int, int>> path) {
+    if (!constraints.hasTimeWindows() || path.empty()) return true;
+    TimeSegment schedule = constraints.segment(path.front().first);
+    for (const auto& [u, v] : path) {
+        schedule = concatenate(schedule, graph.cost(graph.edgeId(u, v)), constraints.segment(v));
+        if (!schedule.feasible) return false;
     }
+    return true;
+}
 
-    std::sort(savings.begin(), savings.end(), [](const Saving& a, const Saving& b) {
-        return a.value > b.value;
-        });
+std::vector<std::vector<std::pair<int, int>>> solveProblem(
+    const std::vector<Point>& vertices,
+    const Graph& graph,
+    int n_of_roads) {
 
-    // === Route merging ===
-    for (const auto& s : savings) {
-        if (nodeToRoute.count(s.i) == 0 || nodeToRoute.count(s.j) == 0) continue;
-        int ri = nodeToRoute[s.i];
-        int rj = nodeToRoute[s.j];
-        if (ri == rj || routes[ri].empty() || routes[rj].empty()) continue;
+    SavingsList list(vertices, graph, 0, (int)vertices.size() - 1);
+    SavingsQueue savings;
+    savings.reset(list);
+    return solveProblem(vertices, graph, list, savings, n_of_roads);
+}
+
+std::vector<std::vector<std::pair<int, int>>> solveProblem(
+    const std::vector<Point>& vertices,
+    const Graph& graph,
+    const SavingsList& list,
+    SavingsQueue& savings,
+    int n_of_roads,
+    const RouteConstraints& constraints,
+    const LocalSearchOptions& localSearch) {
+
+    RouteWorkspace workspace;
+    std::pmr::vector<ArenaRoute> routes(std::pmr::new_delete_resource());
+    solveProblem(vertices, graph, list, savings, n_of_roads, constraints, localSearch, workspace, routes);
 
-        auto& route_i = routes[ri];
-        auto& route_j = routes[rj];
+    std::vector<std::vector<std::pair<int, int>>> finalRoutes;
+    finalRoutes.reserve(routes.size());
+    for (const auto& route : routes) {
+        finalRoutes.emplace_back(route.begin(), route.end());
+    }
+    return finalRoutes;
+}
 
-        // Merge if i at end-1 of route_i and j at 1 of route_j
-        int back_i = route_i[route_i.size() - 2];
-        int front_j = route_j[1];
+void mergeRoutes(const Graph& graph,
+    const SavingsList& list,
+    SavingsQueue& savings,
+    const RouteConstraints& constraints,
+    RouteStore& routes) {
 
-        if (back_i == s.i && front_j == s.j &&
-            edge_set.count({ s.i, s.j })) {
+    if (constraints.hasTimeWindows() && !routes.timed())
+        throw std::invalid_argument("mergeRoutes: the route store was reset without the time windows");
 
-            // valid merge
-            route_i.pop_back(); // remove end
-            route_j.erase(route_j.begin()); // remove start
-            route_i.insert(route_i.end(), route_j.begin(), route_j.end());
+    auto fromStart = list.depotDistances();
+    auto toEnd = list.endDistances();
+    const int start = list.start(), end = list.end();
 
-            for (int k = 1; k < (int)route_j.size() - 1; ++k) {
-                nodeToRoute[route_j[k]] = ri;
-            }
+    // Shorter of the two orientations, terminal legs included
+    auto routeLength = [&](int head, int tail, double internal) {
+        return internal + std::min(fromStart[head] + toEnd[tail], fromStart[tail] + toEnd[head]);
+    };
+
+    // Length limit and time windows of a chain driven from first to last
+    auto fitsDirection = [&](const TimeSegment& chain, int first, int last, double internal) {
+        return internal + fromStart[first] + toEnd[last] <= constraints.maxLength
+            && constraints.fitsWindows(start, fromStart[first], chain, toEnd[last], end);
+    };
+
+    // Savings popped lazily in decreasing order
+    std::uint64_t popped = 0, merged = 0;
+    Saving s;
+    while (routes.routeCount() > 1 && savings.pop(s)) {
+        ++popped;
+        if (!routes.contains(s.i) || !routes.contains(s.j)) continue;
 
-            route_j.clear();
+        // Both nodes must be route endpoints; without reversal only tail(i) -> head(j) is allowed
+        if (constraints.allOrientations) {
+            if (!routes.isEndpoint(s.i) || !routes.isEndpoint(s.j)) continue;
+        }
+        else if (!routes.isLast(s.i) || !routes.isFirst(s.j)) {
+            continue;
         }
-    }
 
-    // === Include all non-empty routes ===
-    std::vector<std::vector<int>> candidates;
-    for (const auto& route : routes) {
-        if (!route.empty() && route.front() == start && route.back() == end) {
-            candidates.push_back(route);
+        int ri = routes.routeOf(s.i);
+        int rj = routes.routeOf(s.j);
+        if (ri == rj) continue;
+
+        // Capacity and length of the merged route, from running totals
+        if (routes.load(ri) + routes.load(rj) > constraints.capacity) continue;
+
+        int head = routes.head(ri) == s.i ? routes.tail(ri) : routes.head(ri);
+        int tail = routes.head(rj) == s.j ? routes.tail(rj) : routes.head(rj);
+        double internal = routes.cost(ri) + routes.cost(rj) + graph.cost(s.edge);
+        if (routeLength(head, tail, internal) > constraints.maxLength) continue;
+
+        // Time windows from the route summaries: the merged chain as joined, or reversed when
+        // routes may be turned; each direction must also keep the length limit on its own
+        if (routes.timed()) {
+            bool frontForward = routes.tail(ri) == s.i, backForward = routes.head(rj) == s.j;
+            const TimeSegment& front = frontForward ? routes.forward(ri) : routes.backward(ri);
+            const TimeSegment& frontReversed = frontForward ? routes.backward(ri) : routes.forward(ri);
+            const TimeSegment& back = backForward ? routes.forward(rj) : routes.backward(rj);
+            const TimeSegment& backReversed = backForward ? routes.backward(rj) : routes.forward(rj);
+            double link = graph.cost(s.edge);
+            bool fits = fitsDirection(concatenate(front, link, back), head, tail, internal);
+            if (!fits && constraints.allOrientations)
+                fits = fitsDirection(concatenate(backReversed, link, frontReversed), tail, head, internal);
+            if (!fits) continue;
         }
+
+        routes.merge(s.i, s.j, graph.cost(s.edge));
+        ++merged;
     }
+    // Counted locally so that parallel attempts do not contend on the shared counters
+    CW_COUNT(Merges, merged);
+    CW_COUNT(RejectedSavings, popped - merged);
+}
 
-    // Sort by number of interior points (more = better)
-    std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) {
-        return a.size() > b.size();
-        });
+void solveProblem(
+    const std::vector<Point>& vertices,
+    const Graph& graph,
+    const SavingsList& list,
+    SavingsQueue& savings,
+    int n_of_roads,
+    const RouteConstraints& constraints,
+    const LocalSearchOptions& localSearch,
+    RouteWorkspace& workspace,
+    std::pmr::vector<ArenaRoute>& finalRoutes) {
+
+    const int start = list.start();
+    const int end = list.end();
+
+    auto fromStart = list.depotDistances();
+    auto toEnd = list.endDistances();
+
+    // Shorter of the two orientations, terminal legs included
+    auto routeLength = [&](int head, int tail, double internal) {
+        return internal + std::min(fromStart[head] + toEnd[tail], fromStart[tail] + toEnd[head]);
+    };
 
-    // Take top N and convert to edge pairs
-    std::vector<std::vector<std::pair<int, int>>> finalRoutes;
-    for (int i = 0; i < (int)candidates.size(); ++i) {
-        const auto& route = candidates[i];
-        bool valid = true;
+    // === Initial routes ===
+    RouteStore& routes = workspace.routes;
+    routes.reset((int)vertices.size(), start, end, constraints);
 
-        // Must start and end at correct nodes
-        if (route.front() != start || route.back() != end) {
-            continue;
+    // === Route merging ===
+    {
+        CW_PROFILE_SCOPE("clarke_wright");
+        mergeRoutes(graph, list, savings, constraints, routes);
+    }
+
+    // Time windows (and then the length) of a route driven from first to last
+    auto fitsTimes = [&](int r, bool reversed) {
+        if (!routes.timed()) return true;
+        int first = reversed ? routes.tail(r) : routes.head(r);
+        int last = reversed ? routes.head(r) : routes.tail(r);
+        const TimeSegment& chain = reversed ? routes.backward(r) : routes.forward(r);
+        return routes.cost(r) + fromStart[first] + toEnd[last] <= constraints.maxLength
+            && constraints.fitsWindows(start, fromStart[first], chain, toEnd[last], end);
+    };
+
+    // === Keep feasible routes, oriented so that their terminal edges exist ===
+    // Interior links always follow graph edges, so only start-head and tail-end need checking
+    std::vector<int>& candidates = workspace.candidates;
+    routes.routes(candidates);
+    candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [&](int r) {
+        if (routes.load(r) > constraints.capacity) return true;
+        if (routeLength(routes.head(r), routes.tail(r), routes.cost(r)) > constraints.maxLength) return true;
+
+        if (graph.hasEdge(start, routes.head(r)) && graph.hasEdge(routes.tail(r), end) && fitsTimes(r, false)) return false;
+        if (graph.hasEdge(start, routes.tail(r)) && graph.hasEdge(routes.head(r), end) && fitsTimes(r, true)) {
+            routes.reverse(r);
+            return false;
         }
+        return true;
+        }), candidates.end());
+
+    // Sort by number of interior points (more = better). Ties keep the order of routes(),
+    // i.e. of the smaller endpoint; std::sort needs no temporary buffer, unlike stable_sort
+    std::sort(candidates.begin(), candidates.end(), [&](int a, int b) {
+        if (routes.size(a) != routes.size(b)) return routes.size(a) > routes.size(b);
+        return std::min(routes.head(a), routes.tail(a)) < std::min(routes.head(b), routes.tail(b));
+        });
 
-        std::vector<std::pair<int, int>> path;
+    auto emit = [&](const std::vector<int>& route) {
+        auto& path = finalRoutes.emplace_back();
+        path.reserve(route.size() - 1);
         for (size_t j = 0; j + 1 < route.size(); ++j) {
-            int u = route[j];
-            int v = route[j + 1];
-            if (edge_set.count({ u, v }) == 0) {
-                valid = false;
-                break;
-            }
-            path.emplace_back(u, v);
+            path.emplace_back(route[j], route[j + 1]);
         }
-
-        if (valid) {
-            finalRoutes.push_back(path);
+    };
+    finalRoutes.clear();
+
+    if (!localSearch.enabled) {
+        // Take top N and convert to edge pairs; only these are materialized
+        std::vector<int>& route = workspace.nodes;
+        for (int i = 0; i < (int)candidates.size() && (int)finalRoutes.size() < n_of_roads; ++i) {
+            routes.materialize(candidates[i], route);
+            emit(route);
         }
-
-        if ((int)finalRoutes.size() >= n_of_roads) break;
+        return;
     }
 
-    return finalRoutes;
+    // === Local search on all feasible routes, then top N by the new sizes ===
+    CW_PROFILE_SCOPE("local_search");
+    auto& sequences = workspace.sequences;
+    if (sequences.size() < candidates.size()) sequences.resize(candidates.size());
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        routes.materialize(candidates[i], sequences[i]);
+    }
+    std::span<std::vector<int>> improved(sequences.data(), candidates.size());
+    workspace.localSearch.run(graph, improved, constraints, localSearch);
+
+    auto& order = workspace.order;
+    order.resize(improved.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        if (improved[a].size() != improved[b].size()) return improved[a].size() > improved[b].size();
+        return a < b;
+        });
+    for (int i = 0; i < (int)order.size() && (int)finalRoutes.size() < n_of_roads; ++i) {
+        emit(improved[order[i]]);
+    }
 }
 
+struct MultiRouteScratch::Buffers {
+    // Pamięć jednej próby: trasa, jej odcisk i wyniki solveProblem leżą w arenie,
+    // która jest cofana przed kolejną próbą w tym samym miejscu partii
+    struct Slot {
+        Arena arena;
+        std::pmr::vector<ArenaRoute> results{ &arena };
+        ArenaRoute route{ &arena };
+        std::optional<RouteFingerprint> print;
+
+        void reset() {
+            // Kontenery muszą porzucić pamięć areny przed jej cofnięciem
+            print.reset();
+            results = std::pmr::vector<ArenaRoute>(&arena);
+            route = ArenaRoute(&arena);
+            arena.reset();
+        }
+    };
+
+    // Jednolite liczby losowe próby, po dwie na krawędź grafu (indeks = id krawędzi)
+    struct Noise {
+        std::vector<double> first;
+        std::vector<double> second;
+    };
+
+    // Zbiór węzłów: flagi do sprawdzania i lista elementów do przeglądania; po rozgrzaniu
+    // wstawianie i czyszczenie nie alokują
+    struct NodeSet {
+        std::vector<char> contains;
+        std::vector<int> nodes;
+
+        void reset(int n) {
+            contains.assign(n, 0);
+            nodes.clear();
+        }
+        void insert(int node) {
+            if (!contains[node]) {
+                contains[node] = 1;
+                nodes.push_back(node);
+            }
+        }
+        // Wstawia węzły trasy poza terminalami
+        void insertRoute(std::span<const std::pair<int, int>> route, int start, int end) {
+            for (const auto& edge : route) {
+                if (edge.first != start && edge.first != end) insert(edge.first);
+                if (edge.second != start && edge.second != end) insert(edge.second);
+            }
+        }
+    };
+
+    std::vector<SavingsQueue> queues;
+    std::vector<RouteWorkspace> workspaces;
+    std::vector<ShortestPathEngine> engines;
+    std::vector<Noise> noise;
+    std::vector<Slot> slots;
+
+    NodeSet usedNodes;       // Węzły używane w już znalezionych trasach
+    NodeSet batchUsed;       // Migawka usedNodes, którą widzą wszystkie próby partii
+    NodeSet avoidedNodes;    // Węzły wszystkich przyjętych tras dla silnego unikania
+    std::vector<int> nodesToRemove;
+    DiversityFilter accepted;
+};
+
+MultiRouteScratch::MultiRouteScratch() : buffers(std::make_unique<Buffers>()) {}
+MultiRouteScratch::~MultiRouteScratch() = default;
+MultiRouteScratch::MultiRouteScratch(MultiRouteScratch&&) noexcept = default;
+MultiRouteScratch& MultiRouteScratch::operator=(MultiRouteScratch&&) noexcept = default;
+
 std::vector<std::vector<std::pair<int, int>>> solveMultipleRoutes(
     const std::vector<Point>& vertices,
-    const std::vector<Edge>& edges,
+    const Graph& graph,
     int n_of_roads) {
 
+    MultiRouteOptions options;
+    options.seed = std::random_device{}();
+    return solveMultipleRoutes(vertices, graph, n_of_roads, options);
+}
+
+std::vector<std::vector<std::pair<int, int>>> solveMultipleRoutes(
+    const std::vector<Point>& vertices,
+    const Graph& graph,
+    int n_of_roads,
+    const MultiRouteOptions& options) {
+
+    CW_PROFILE_SCOPE("solve_multiple_routes");
+    const auto [start, end] = options.terminals.resolved((int)vertices.size());
     std::vector<std::vector<std::pair<int, int>>> allRoutes;
-    std::set<int> usedNodes; // Węzły używane w już znalezionych trasach
 
-    std::default_random_engine rng(std::random_device{}());
-    std::uniform_real_distribution<double> noiseDist(0.8, 1.2); // Szum multiplikatywny
-    std::uniform_real_distribution<double> avoidDist(2.0, 5.0); // Mnożnik dla unikanych węzłów
+    // Strumień RNG tylko dla sekwencyjnej fazy scalania wyników
+    CounterEngine rng(options.seed, ~0ull);
+    auto noiseFactor = [](double u) { return 0.8 + 0.4 * u; }; // Szum multiplikatywny [0.8, 1.2)
+    auto avoidFactor = [](double u) { return 2.0 + 3.0 * u; }; // Mnożnik dla unikanych węzłów [2, 5)
+
+    std::unique_ptr<ThreadPool> ownPool;
+    ThreadPool* pool = options.pool;
+    if (pool == nullptr) {
+        ownPool = std::make_unique<ThreadPool>(options.threads);
+        pool = ownPool.get();
+    }
+
+    // Oszczędności bazowe liczone raz; każdy wątek ma własną kolejkę, do której
+    // szum jest nakładany jako poprawka na wartościach bazowych
+    SavingsList savingsList = [&] {
+        CW_PROFILE_SCOPE("savings_list");
+        return options.distances != nullptr
+            ? SavingsList(*options.distances, graph, start, end)
+            : SavingsList(vertices, graph, start, end);
+        }();
+    // Bufory z poprzednich wywołań, jeśli podano scratch
+    std::optional<MultiRouteScratch> ownScratch;
+    if (options.scratch == nullptr) ownScratch.emplace();
+    MultiRouteScratch::Buffers& buffers = *(options.scratch != nullptr ? options.scratch : &*ownScratch)->buffers;
+
+    auto& queues = buffers.queues;
+    auto& workspaces = buffers.workspaces;
+    if (queues.size() < pool->size()) queues.resize(pool->size());
+    if (workspaces.size() < pool->size()) workspaces.resize(pool->size());
+    if (buffers.noise.size() < pool->size()) buffers.noise.resize(pool->size());
+
+    // Szum próby jest czystą funkcją (seed, numer próby, id krawędzi): liczony jednym
+    // przebiegiem po wszystkich krawędziach, bez stanu dzielonego między wątkami
+    auto drawNoise = [&](unsigned worker, std::uint64_t attempt) -> MultiRouteScratch::Buffers::Noise& {
+        auto& noise = buffers.noise[worker];
+        noise.first.resize(graph.edgeCount());
+        noise.second.resize(graph.edgeCount());
+        CounterRng(options.seed, attempt).fill(0, noise.first, noise.second);
+        return noise;
+    };
+
+    // Próby już działają na puli, więc lokalne przeszukiwanie w próbie jest sekwencyjne
+    LocalSearchOptions attemptSearch = options.localSearch;
+    attemptSearch.pool = nullptr;
+
+    // Silniki najkrótszych ścieżek z przestrzenią roboczą wielokrotnego użytku, po jednym na wątek;
+    // silniki z poprzednich wywołań są przepinane na bieżącą instancję
+    auto& engines = buffers.engines;
+    for (unsigned w = 0; w < pool->size(); ++w) {
+        if (w < engines.size()) engines[w].rebind(vertices, graph);
+        else engines.emplace_back(vertices, graph);
+    }
+    const int batchSize = std::max(1, options.batchSize);
+
+    // Jedna arena na pozycję w partii; wynik próby żyje w niej do końca scalania partii
+    if ((int)buffers.slots.size() < batchSize) buffers.slots = std::vector<MultiRouteScratch::Buffers::Slot>(batchSize);
+    auto& slots = buffers.slots;
 
     int maxAttempts = n_of_roads * 50;
     int attempts = 0;
 
-    while ((int)allRoutes.size() < n_of_roads && attempts < maxAttempts) {
-        ++attempts;
-
-        // Strategia 1: Znajdź trasę używając Clark-Wright z szumem
-        std::vector<Edge> noisyEdges;
-        for (const auto& e : edges) {
-            double noisyMultiplier = noiseDist(rng);
-            // Zwiększ koszt krawędzi prowadzących do już używanych węzłów
-            if (usedNodes.count(e.u) || usedNodes.count(e.v)) {
-                noisyMultiplier *= avoidDist(rng);
-            }
-            noisyEdges.push_back({ e.u, e.v, e.cost * noisyMultiplier });
-        }
+    // Odciski tras (bitsety krawędzi) do szybkiego liczenia podobieństwa
+    DiversityFilter& accepted = buffers.accepted;
+    accepted.clear();
+    auto& usedNodes = buffers.usedNodes;
+    auto& batchUsed = buffers.batchUsed;
+    usedNodes.reset((int)vertices.size());
+    const std::vector<char>& used = batchUsed.contains;
 
-        auto cwRoutes = solveProblem(vertices, noisyEdges, 1);
+    while ((int)allRoutes.size() < n_of_roads && attempts < maxAttempts) {
+        int batch = std::min(batchSize, maxAttempts - attempts);
+        int firstAttempt = attempts;
+
+        // Wszystkie próby w partii widzą ten sam stan usedNodes
+        batchUsed = usedNodes;
+
+        CW_PROFILE_SCOPE("batch");
+        auto runAttempt = [&](int b, unsigned worker) {
+            CW_PROFILE_SCOPE("attempt");
+            const auto& noise = drawNoise(worker, (std::uint64_t)(firstAttempt + b));
+            SavingsQueue& savings = queues[worker];
+            auto& slot = slots[b];
+            slot.reset();
+
+            // Strategia 1: Znajdź trasę używając Clark-Wright z szumem
+            savings.reset(savingsList, [&](int k) {
+                const Saving& e = savingsList[k];
+                double noisyMultiplier = noiseFactor(noise.first[e.edge]);
+                // Zwiększ koszt krawędzi prowadzących do już używanych węzłów
+                if (used[e.i] || used[e.j]) {
+                    noisyMultiplier *= avoidFactor(noise.second[e.edge]);
+                }
+                return noisyMultiplier;
+                });
 
-        // Strategia 2: Jeśli Clark-Wright nie dał dobrej trasy, użyj alternatywnej metody
-        std::vector<std::pair<int, int>> newRoute;
-        if (!cwRoutes.empty()) {
-            newRoute = cwRoutes[0];
-        }
-        else {
-            // Spróbuj znaleźć alternatywną ścieżkę
-            newRoute = findAlternativePath(vertices, edges, usedNodes, avoidDist(rng));
-        }
+            solveProblem(vertices, graph, savingsList, savings, 1, options.constraints, attemptSearch,
+                workspaces[worker], slot.results);
 
-        if (newRoute.empty()) continue;
-
-        // Sprawdź czy trasa jest wystarczająco różna
-        if (!isRouteDifferent(newRoute, allRoutes, 0.4)) {
-            // Jeśli za podobna, spróbuj z większym unikaniem używanych węzłów
-            if (attempts % 10 == 0) {
-                std::set<int> stronglyAvoidedNodes;
-                for (const auto& route : allRoutes) {
-                    for (const auto& edge : route) {
-                        if (edge.first != 0 && edge.first != (int)vertices.size() - 1) {
-                            stronglyAvoidedNodes.insert(edge.first);
-                        }
-                        if (edge.second != 0 && edge.second != (int)vertices.size() - 1) {
-                            stronglyAvoidedNodes.insert(edge.second);
-                        }
+            // Strategia 2: Jeśli Clark-Wright nie dał dobrej trasy, użyj alternatywnej metody
+            if (!slot.results.empty()) {
+                slot.route = std::move(slot.results[0]);
+            }
+            else {
+                // Spróbuj znaleźć alternatywną ścieżkę
+                findAlternativePath(vertices, engines[worker], batchUsed.nodes, workspaces[worker], slot.route, options.terminals);
+                // Najkrótsza ścieżka nie zna okien czasowych - odrzuć ją, jeśli ich nie dotrzymuje
+                if (!keepsWindows(graph, options.constraints, slot.route)) slot.route.clear();
+            }
+            slot.print.emplace(graph, slot.route, &slot.arena);
+            };
+        // Przez referencję: std::function nie kopiuje wtedy lambdy na stertę
+        pool->parallelFor(batch, std::ref(runAttempt));
+
+        // Scalanie kandydatów w stałej kolejności - wynik nie zależy od liczby wątków
+        for (int b = 0; b < batch && (int)allRoutes.size() < n_of_roads; ++b) {
+            ++attempts;
+            CW_COUNT(Attempts, 1);
+            auto& newRoute = slots[b].route;
+            auto& newPrint = slots[b].print;
+
+            if (newRoute.empty()) continue;
+
+            // Sprawdź czy trasa jest wystarczająco różna
+            if (!accepted.isDifferent(*newPrint, 0.4)) {
+                CW_COUNT(DiversityRejections, 1);
+                // Jeśli za podobna, spróbuj z większym unikaniem używanych węzłów
+                if (attempts % 10 == 0) {
+                    auto& stronglyAvoidedNodes = buffers.avoidedNodes;
+                    stronglyAvoidedNodes.reset((int)vertices.size());
+                    for (const auto& route : allRoutes) {
+                        stronglyAvoidedNodes.insertRoute(route, start, end);
+                    }
+                    if (!findAlternativePath(vertices, engines[0], stronglyAvoidedNodes.nodes, workspaces[0], newRoute, options.terminals)
+                        || !keepsWindows(graph, options.constraints, newRoute)) {
+                        continue;
+                    }
+                    newPrint.emplace(graph, newRoute, &slots[b].arena);
+                    if (!accepted.isDifferent(*newPrint, 0.3)) {
+                        CW_COUNT(DiversityRejections, 1);
+                        continue;
                     }
                 }
-                newRoute = findAlternativePath(vertices, edges, stronglyAvoidedNodes, 10.0);
-
-                if (newRoute.empty() || !isRouteDifferent(newRoute, allRoutes, 0.3)) {
+                else {
                     continue;
                 }
             }
-            else {
-                continue;
-            }
-        }
-
-        allRoutes.push_back(newRoute);
-
-        // Aktualizuj zestaw używanych węzłów
-        for (const auto& edge : newRoute) {
-            if (edge.first != 0 && edge.first != (int)vertices.size() - 1) {
-                usedNodes.insert(edge.first);
-            }
-            if (edge.second != 0 && edge.second != (int)vertices.size() - 1) {
-                usedNodes.insert(edge.second);
-            }
-        }
 
-        // Co jakiś czas resetuj część używanych węzłów, żeby nie zablokować wszystkich możliwości
-        if (attempts % 20 == 0 && usedNodes.size() > vertices.size() / 3) {
-            std::vector<int> nodesToRemove(usedNodes.begin(), usedNodes.end());
-            std::shuffle(nodesToRemove.begin(), nodesToRemove.end(), rng);
-            // Usuń połowę używanych węzłów
-            for (size_t i = 0; i < nodesToRemove.size() / 2; ++i) {
-                usedNodes.erase(nodesToRemove[i]);
+            allRoutes.emplace_back(newRoute.begin(), newRoute.end());
+            accepted.add(*newPrint);
+
+            // Aktualizuj zestaw używanych węzłów
+            usedNodes.insertRoute(newRoute, start, end);
+
+            // Co jakiś czas resetuj część używanych węzłów, żeby nie zablokować wszystkich możliwości
+            if (attempts % 20 == 0 && usedNodes.nodes.size() > vertices.size() / 3) {
+                // Losowanie z rosnącej kolejności węzłów, jak przy przeglądaniu std::set
+                auto& nodesToRemove = buffers.nodesToRemove;
+                nodesToRemove.assign(usedNodes.nodes.begin(), usedNodes.nodes.end());
+                std::sort(nodesToRemove.begin(), nodesToRemove.end());
+                std::shuffle(nodesToRemove.begin(), nodesToRemove.end(), rng);
+                CW_COUNT(UsedNodesResets, 1);
+                // Usuń połowę używanych węzłów
+                for (size_t i = 0; i < nodesToRemove.size() / 2; ++i) {
+                    usedNodes.contains[nodesToRemove[i]] = 0;
+                }
+                std::erase_if(usedNodes.nodes, [&](int node) { return !usedNodes.contains[node]; });
             }
         }
+        attempts = firstAttempt + batch;
     }
 
     // Jeśli nadal za mało tras, spróbuj z mniej restrykcyjnymi kryteriami
     if ((int)allRoutes.size() < n_of_roads) {
-        int remainingRoutes = n_of_roads - (int)allRoutes.size();
-        for (int i = 0; i < remainingRoutes && i < maxAttempts; ++i) {
-            std::vector<Edge> veryNoisyEdges;
-            for (const auto& e : edges) {
-                double multiplier = noiseDist(rng) * noiseDist(rng); // Więcej szumu
-                veryNoisyEdges.push_back({ e.u, e.v, e.cost * multiplier });
-            }
+        CW_PROFILE_SCOPE("relaxed_attempts");
+        int remainingRoutes = std::min(n_of_roads - (int)allRoutes.size(), maxAttempts);
+        CW_COUNT(Attempts, remainingRoutes);
+
+        // Partiami o rozmiarze liczby aren, ziarna zależą tylko od numeru próby
+        for (int first = 0; first < remainingRoutes; first += batchSize) {
+            int batch = std::min(batchSize, remainingRoutes - first);
+
+            auto runRelaxedAttempt = [&](int b, unsigned worker) {
+                CW_PROFILE_SCOPE("attempt");
+                const auto& noise = drawNoise(worker, (std::uint64_t)(maxAttempts + first + b));
+                SavingsQueue& savings = queues[worker];
+                auto& slot = slots[b];
+                slot.reset();
+
+                savings.reset(savingsList, [&](int k) {
+                    int edge = savingsList[k].edge;
+                    return noiseFactor(noise.first[edge]) * noiseFactor(noise.second[edge]); // Więcej szumu
+                    });
+
+                solveProblem(vertices, graph, savingsList, savings, 1, options.constraints, attemptSearch,
+                    workspaces[worker], slot.results);
+                if (!slot.results.empty()) {
+                    slot.route = std::move(slot.results[0]);
+                }
+                };
+            pool->parallelFor(batch, std::ref(runRelaxedAttempt));
 
-            auto routes = solveProblem(vertices, veryNoisyEdges, 1);
-            if (!routes.empty() && isRouteDifferent(routes[0], allRoutes, 0.2)) {
-                allRoutes.push_back(routes[0]);
+            for (int b = 0; b < batch; ++b) {
+                const auto& route = slots[b].route;
+                if (route.empty()) continue;
+
+                RouteFingerprint print(graph, route, &slots[b].arena);
+                if (accepted.isDifferent(print, 0.2)) {
+                    allRoutes.emplace_back(route.begin(), route.end());
+                    accepted.add(print);
+                }
+                else {
+                    CW_COUNT(DiversityRejections, 1);
+                }
             }
         }
     }
@@ -370,39 +688,11 @@ std::vector<std::vector<std::pair<int, int>>> solveMultipleRoutes(
     }
 
     // === Wypisywanie znalezionych tras ===
-    std::cout << "\n=== ZNALEZIONE TRASY ===" << std::endl;
-    for (int i = 0; i < (int)allRoutes.size(); ++i) {
-        const auto& route = allRoutes[i];
-
-        // Oblicz długość trasy
-        double totalLength = 0.0;
-        std::cout << "Trasa " << (i) << ": ";
-
-        if (!route.empty()) {
-            // Wypisz pierwszy węzeł
-            std::cout << route[0].first;
-
-            // Wypisz kolejne węzły i oblicz długość
-            for (const auto& edge : route) {
-                std::cout << " -> " << edge.second;
-
-                // Znajdź koszt tej krawędzi w oryginalnych danych
-                for (const auto& originalEdge : edges) {
-                    if ((originalEdge.u == edge.first && originalEdge.v == edge.second) ||
-                        (originalEdge.u == edge.second && originalEdge.v == edge.first)) {
-                        totalLength += originalEdge.cost;
-                        break;
-                    }
-                }
-            }
-
-            std::cout << " | Dlugosc: " << std::fixed << std::setprecision(2) << totalLength << std::endl;
-        }
-        else {
-            std::cout << "PUSTA" << std::endl;
-        }
+    if (options.printRoutes) {
+        RouteWriter writer(std::cout, RouteFormat::Text, graph);
+        for (const auto& route : allRoutes) writer.write(route);
+        writer.finish();
     }
-    std::cout << "========================\n" << std::endl;
 
     return allRoutes;
 }
\ No newline at end of file
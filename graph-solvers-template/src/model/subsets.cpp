@@ -0,0 +1,45 @@
+#include "model/subsets.h"
+
+#include <bit>
+#include <stdexcept>
+
+SubsetGenerator::SubsetGenerator(int n)
+    : n_(n < 0 ? 0 : n)
+{
+    if (n_ > 63) throw std::length_error("SubsetGenerator: at most 63 vertices");
+}
+
+bool SubsetGenerator::next(std::vector<int>& subset)
+{
+    const std::uint64_t full = (std::uint64_t(1) << n_) - 1;
+    while (mask_ < full) {
+        ++mask_;
+        int size = std::popcount(mask_);
+        if (size < 2 || mask_ == full) continue;
+
+        subset.clear();
+        for (std::uint64_t bits = mask_; bits != 0; bits &= bits - 1)
+            subset.push_back(std::countr_zero(bits));
+        return true;
+    }
+    return false;
+}
+
+std::uint64_t SubsetGenerator::count() const
+{
+    // 2^n minus the empty set, the n singletons and the full set
+    if (n_ < 2) return 0;
+    return (std::uint64_t(1) << n_) - (std::uint64_t)n_ - 2;
+}
+
+std::vector<std::vector<int>> generateSubsets(int n)
+{
+    if (n > 25) throw std::length_error("generateSubsets: more than 2^25 subsets; use SubsetGenerator");
+
+    SubsetGenerator generator(n);
+    std::vector<std::vector<int>> subsets;
+    subsets.reserve(generator.count());
+    std::vector<int> subset;
+    while (generator.next(subset)) subsets.push_back(subset);
+    return subsets;
+}
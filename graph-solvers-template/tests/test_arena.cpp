@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#include "common/arena.h"
+
+namespace {
+
+// Upstream resource that counts the chunks it hands out.
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+    int allocations = 0;
+    int deallocations = 0;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+    {
+        ++deallocations;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+} // namespace
+
+TEST(ArenaTest, RespectsAlignment) {
+    Arena arena(256);
+    (void)arena.allocate(1, 1);
+    for (std::size_t alignment : { 2u, 8u, 16u, 64u }) {
+        void* p = arena.allocate(3, alignment);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(p) % alignment, 0u);
+    }
+}
+
+TEST(ArenaTest, GrowsAndServesLargeRequests) {
+    CountingResource upstream;
+    Arena arena(256, &upstream);
+
+    void* small = arena.allocate(100, 8);
+    void* large = arena.allocate(10000, 8);
+    EXPECT_NE(small, nullptr);
+    EXPECT_NE(large, nullptr);
+    EXPECT_EQ(upstream.allocations, 2);
+    EXPECT_GE(arena.capacity(), 10100u);
+    EXPECT_EQ(arena.bytesUsed(), 10100u);
+}
+
+TEST(ArenaTest, SteadyStateRoundsDoNotAllocateUpstream) {
+    CountingResource upstream;
+    {
+        Arena arena(512, &upstream);
+        for (int round = 0; round < 5; ++round) {
+            {
+                std::pmr::vector<std::pmr::vector<int>> routes(&arena);
+                for (int r = 0; r < 20; ++r) {
+                    auto& route = routes.emplace_back();
+                    for (int k = 0; k < 50 + r; ++k) route.push_back(k);
+                }
+                EXPECT_EQ(routes.back().get_allocator().resource(), &arena);
+            }
+            if (round == 0) {
+                EXPECT_GT(upstream.allocations, 1);
+            }
+            arena.reset();
+            EXPECT_EQ(arena.bytesUsed(), 0u);
+        }
+        EXPECT_EQ((int)arena.upstreamAllocations(), upstream.allocations);
+
+        int afterWarmup = upstream.allocations;
+        for (int round = 0; round < 3; ++round) {
+            {
+                std::pmr::vector<int> scratch(&arena);
+                scratch.resize(1000);
+            }
+            // The vector is gone before its memory is rewound
+            arena.reset();
+        }
+        EXPECT_EQ(upstream.allocations, afterWarmup);
+    }
+    EXPECT_EQ(upstream.deallocations, upstream.allocations);
+}
@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "common/instrumentation.h"
+#include "common/thread_pool.h"
+#include "common/types.h"
+#include "geometry/triangulation.h"
+#include "model/solver.h"
+
+namespace {
+
+MultiRouteOptions replayOptions(ThreadPool& pool, MultiRouteScratch& scratch)
+{
+    MultiRouteOptions options;
+    options.seed = 11;
+    options.pool = &pool;
+    options.scratch = &scratch;
+    options.printRoutes = false;
+    options.localSearch.enabled = true;
+    options.localSearch.timeLimitMs = 0.0;
+    return options;
+}
+
+} // namespace
+
+// Counted by the instrumented operator new: the "attempt" spans record every byte their thread allocates
+TEST(AttemptAllocationTest, ReplayedAttemptsDoNotAllocate) {
+    std::vector<Point> points = generateUniquePoints(150, 0.0, 0.0, 40.0, 40.0, 8);
+    Graph graph = buildDelaunayGraph(points).graph;
+
+    // A single-thread pool runs attempts inline, so each one reuses the same worker buffers
+    ThreadPool pool(1);
+    MultiRouteScratch scratch;
+    MultiRouteOptions options = replayOptions(pool, scratch);
+    auto first = solveMultipleRoutes(points, graph, 12, options);
+    ASSERT_FALSE(first.empty());
+
+    auto& instrumentation = Instrumentation::instance();
+    instrumentation.reset();
+    EXPECT_EQ(solveMultipleRoutes(points, graph, 12, options), first);
+
+    // The run covers shortest-path fallbacks and rejected near-duplicates, not only merges
+    EXPECT_GT(instrumentation.stageCalls("attempt"), 12u);
+    EXPECT_GT(instrumentation.count(Counter::FallbackPaths), 0u);
+    EXPECT_GT(instrumentation.count(Counter::DiversityRejections), 0u);
+    EXPECT_EQ(instrumentation.stageBytes("attempt"), 0u);
+    EXPECT_EQ(instrumentation.count(Counter::ArenaGrowth), 0u);
+}
+
+TEST(AttemptAllocationTest, ParallelForReusesItsTaskQueue) {
+    ThreadPool pool(3);
+    std::vector<int> hits(64, 0);
+    auto body = [&](int i, unsigned) { ++hits[i]; };
+    pool.parallelFor(64, std::ref(body));
+
+    std::uint64_t before = Instrumentation::threadAllocatedBytes();
+    for (int round = 0; round < 10; ++round) pool.parallelFor(64, std::ref(body));
+    EXPECT_EQ(Instrumentation::threadAllocatedBytes(), before);
+    for (int count : hits) EXPECT_EQ(count, 11);
+}
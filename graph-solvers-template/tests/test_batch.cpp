@@ -0,0 +1,223 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "common/thread_pool.h"
+#include "model/batch.h"
+
+namespace {
+
+std::vector<std::string> lines(const std::string& text)
+{
+    std::vector<std::string> result;
+    std::istringstream in(text);
+    for (std::string line; std::getline(in, line);) result.push_back(line);
+    return result;
+}
+
+std::string runBatch(BatchRunner& runner, const std::string& manifest, BatchSummary* summary = nullptr)
+{
+    std::istringstream in(manifest);
+    std::ostringstream out;
+    BatchSummary result = runner.run(in, out);
+    if (summary) *summary = result;
+    return out.str();
+}
+
+// The "ms" field is the only part of a result that depends on timing
+std::string withoutTime(const std::string& line)
+{
+    return line.substr(0, line.find(",\"ms\":"));
+}
+
+// Routes and lengths of an "ok" result line
+void parseResult(const std::string& line, std::vector<std::vector<int>>& routes, std::vector<double>& lengths)
+{
+    const char* end = line.data() + line.size();
+    const char* p = line.data() + line.find("\"routes\":[") + 10;
+    while (*p == '[') {
+        routes.emplace_back();
+        for (++p; *p != ']';) {
+            if (*p == ',') ++p;
+            int node = 0;
+            p = std::from_chars(p, end, node).ptr;
+            routes.back().push_back(node);
+        }
+        if (*++p == ',') ++p;
+    }
+    p = line.data() + line.find("\"lengths\":[") + 11;
+    while (*p != ']') {
+        if (*p == ',') ++p;
+        double length = 0.0;
+        p = std::from_chars(p, end, length).ptr;
+        lengths.push_back(length);
+    }
+}
+
+} // namespace
+
+TEST(BatchTest, ParsesJobLine) {
+    BatchJob job;
+    ASSERT_TRUE(parseBatchJob("id=a  random=40 points_seed=3 routes=5 seed=9 batch=4 capacity=12.5 local_search=1", 7, job));
+    EXPECT_EQ(job.id, "a");
+    EXPECT_EQ(job.randomPoints, 40);
+    EXPECT_EQ(job.pointsSeed, 3u);
+    EXPECT_EQ(job.routes, 5);
+    EXPECT_EQ(job.seed, 9u);
+    EXPECT_EQ(job.batchSize, 4);
+    EXPECT_DOUBLE_EQ(job.capacity, 12.5);
+    EXPECT_TRUE(job.localSearch);
+    EXPECT_EQ(job.instanceKey(), "random:40:3");
+
+    EXPECT_FALSE(parseBatchJob("   # comment", 1, job));
+    EXPECT_FALSE(parseBatchJob("", 2, job));
+    ASSERT_TRUE(parseBatchJob("instance=a.vrp", 3, job));
+    EXPECT_EQ(job.id, "3");
+
+    EXPECT_THROW(parseBatchJob("routes=3", 4, job), std::invalid_argument);
+    EXPECT_THROW(parseBatchJob("random=10 colour=red", 5, job), std::invalid_argument);
+    EXPECT_THROW(parseBatchJob("random=ten", 6, job), std::invalid_argument);
+}
+
+TEST(BatchTest, StreamsOneResultPerJob) {
+    BatchOptions options;
+    options.threads = 1;
+    BatchRunner runner(options);
+
+    BatchSummary summary;
+    std::string output = runBatch(runner,
+        "# two jobs on one instance and a broken one\n"
+        "id=a random=40 points_seed=1 routes=3 seed=5\n"
+        "\n"
+        "id=b random=40 points_seed=1 routes=2 seed=6\n"
+        "id=c instance=missing-file.vrp\n", &summary);
+
+    auto results = lines(output);
+    ASSERT_EQ(results.size(), 3u);
+    EXPECT_EQ(summary.jobs, 3);
+    EXPECT_EQ(summary.failed, 1);
+    EXPECT_EQ(results[0].rfind("{\"id\":\"a\",\"instance\":\"random:40:1\",\"status\":\"ok\",\"nodes\":40,\"routes\":[[0,", 0), 0u);
+    EXPECT_EQ(results[1].rfind("{\"id\":\"b\"", 0), 0u);
+    EXPECT_EQ(results[2].rfind("{\"id\":\"c\",\"status\":\"error\"", 0), 0u);
+
+    // Both random jobs share one prepared instance
+    EXPECT_EQ(runner.cache().misses(), 2u);
+    EXPECT_EQ(runner.cache().hits(), 1u);
+}
+
+TEST(BatchTest, ResultsDoNotDependOnPoolSize) {
+    std::string manifest;
+    for (int i = 0; i < 12; ++i)
+        manifest += "id=" + std::to_string(i) + " random=60 points_seed=" + std::to_string(i % 3)
+            + " routes=4 seed=" + std::to_string(i) + " local_search=" + std::to_string(i % 2) + "\n";
+
+    BatchOptions serialOptions;
+    serialOptions.threads = 1;
+    BatchRunner serial(serialOptions);
+    auto expected = lines(runBatch(serial, manifest));
+
+    ThreadPool pool(4);
+    BatchOptions parallelOptions;
+    parallelOptions.pool = &pool;
+    BatchRunner parallel(parallelOptions);
+    // Second run reuses the cached instances and the per-worker scratch
+    runBatch(parallel, manifest);
+    auto actual = lines(runBatch(parallel, manifest));
+
+    ASSERT_EQ(actual.size(), expected.size());
+    std::transform(expected.begin(), expected.end(), expected.begin(), withoutTime);
+    std::transform(actual.begin(), actual.end(), actual.begin(), withoutTime);
+    std::sort(expected.begin(), expected.end());
+    std::sort(actual.begin(), actual.end());
+    EXPECT_EQ(actual, expected);
+}
+
+TEST(BatchTest, CacheStaysWithinMemoryBudget) {
+    BatchJob small, large;
+    parseBatchJob("random=50 points_seed=1", 1, small);
+    parseBatchJob("random=2000 points_seed=1", 2, large);
+    std::size_t smallBytes = prepareInstance(small)->memoryBytes();
+    std::size_t largeBytes = prepareInstance(large)->memoryBytes();
+    ASSERT_GT(largeBytes, 4 * smallBytes);
+
+    // Room for a few small instances, not for the large one
+    InstanceCache cache(16, 3 * smallBytes);
+    cache.get(small);
+    EXPECT_EQ(cache.cachedBytes(), smallBytes);
+    auto kept = cache.get(large);
+    EXPECT_EQ(kept->points.size(), 2000u);
+    EXPECT_LE(cache.cachedBytes(), 3 * smallBytes);
+
+    // The small instance survived the large one, which was not kept
+    cache.get(small);
+    EXPECT_EQ(cache.hits(), 1u);
+    cache.get(large);
+    EXPECT_EQ(cache.misses(), 3u);
+}
+
+TEST(BatchTest, LengthsReadBackExactly) {
+    BatchOptions options;
+    options.threads = 1;
+    BatchRunner runner(options);
+    auto results = lines(runBatch(runner, "id=a random=80 points_seed=4 routes=4 seed=2\n"));
+    ASSERT_EQ(results.size(), 1u);
+
+    std::vector<std::vector<int>> routes;
+    std::vector<double> lengths;
+    parseResult(results[0], routes, lengths);
+    ASSERT_EQ(routes.size(), 4u);
+    ASSERT_EQ(lengths.size(), routes.size());
+
+    BatchJob job;
+    parseBatchJob("random=80 points_seed=4", 1, job);
+    auto instance = prepareInstance(job);
+    const Graph& graph = instance->delaunay.graph;
+    for (std::size_t r = 0; r < routes.size(); ++r) {
+        double length = 0.0;
+        for (std::size_t k = 1; k < routes[r].size(); ++k)
+            length += graph.cost(graph.edgeId(routes[r][k - 1], routes[r][k]));
+        EXPECT_EQ(lengths[r], length);
+    }
+}
+
+TEST(BatchTest, SingleDepotFileGivesRoundTrips) {
+    // CVRPLIB file whose only depot is node 7 (index 6)
+    auto path = (std::filesystem::temp_directory_path() / "cw_single_depot.vrp").string();
+    {
+        std::mt19937 rng(5);
+        std::uniform_int_distribution<int> coord(0, 999);
+        std::ofstream file(path);
+        file << "NAME : single-depot\nTYPE : CVRP\nDIMENSION : 40\nEDGE_WEIGHT_TYPE : EUC_2D\nCAPACITY : 30\n";
+        file << "NODE_COORD_SECTION\n";
+        for (int i = 1; i <= 40; ++i) file << i << ' ' << coord(rng) << ' ' << coord(rng) << '\n';
+        file << "DEMAND_SECTION\n";
+        for (int i = 1; i <= 40; ++i) file << i << ' ' << (i == 7 ? 0 : 1 + i % 4) << '\n';
+        file << "DEPOT_SECTION\n 7\n -1\nEOF\n";
+    }
+
+    BatchOptions options;
+    options.threads = 1;
+    BatchRunner runner(options);
+    auto results = lines(runBatch(runner, "id=a instance=" + path + " routes=4 seed=3\n"));
+    std::filesystem::remove(path);
+    ASSERT_EQ(results.size(), 1u);
+    ASSERT_NE(results[0].find("\"status\":\"ok\""), std::string::npos) << results[0];
+
+    std::vector<std::vector<int>> routes;
+    std::vector<double> lengths;
+    parseResult(results[0], routes, lengths);
+    ASSERT_FALSE(routes.empty());
+    for (const auto& route : routes) {
+        ASSERT_GE(route.size(), 3u);
+        EXPECT_EQ(route.front(), 6);
+        EXPECT_EQ(route.back(), 6);
+        EXPECT_EQ(std::count(route.begin() + 1, route.end() - 1, 6), 0);
+    }
+}
@@ -0,0 +1,312 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <set>
+
+#include "common/graph.h"
+#include "common/radix_sort.h"
+#include "common/thread_pool.h"
+#include "model/decomposition.h"
+#include "model/route_store.h"
+#include "model/savings.h"
+#include "model/solver.h"
+#include "test_instances.h"
+
+namespace {
+
+// Radius graph with the start in the middle, so that sweep sectors are meaningful
+using Instance = RadiusInstance;
+
+Instance makeInstance(int n, double radius, unsigned seed)
+{
+    return makeRadiusInstance(n, radius, seed, Point{ 50.0, 50.0 });
+}
+
+DecompositionOptions capacitated(int n, double capacity)
+{
+    DecompositionOptions options;
+    options.constraints.demands.assign(n, 1.0);
+    options.constraints.demands[0] = options.constraints.demands[n - 1] = 0.0;
+    options.constraints.capacity = capacity;
+    return options;
+}
+
+// Checks that the routes run between the terminals, follow graph edges and respect the
+// constraints; returns the total cost. Visits are counted into @p visits.
+double expectValidRoutes(const Instance& instance, const RouteConstraints& constraints,
+    const std::vector<std::vector<int>>& routes, Terminals terminals, std::vector<int>& visits)
+{
+    const int n = (int)instance.points.size();
+    const auto [start, end] = terminals.resolved(n);
+    double total = 0.0;
+    for (const auto& route : routes) {
+        EXPECT_GE(route.size(), 3u);
+        if (route.size() < 3) continue;
+        EXPECT_EQ(route.front(), start);
+        EXPECT_EQ(route.back(), end);
+        double demand = 0.0;
+        double length = euclidean(instance.points[start], instance.points[route[1]])
+            + euclidean(instance.points[route[route.size() - 2]], instance.points[end]);
+        for (std::size_t k = 1; k + 1 < route.size(); ++k) {
+            ++visits[route[k]];
+            if (!constraints.demands.empty()) demand += constraints.demands[route[k]];
+            if (k + 2 < route.size()) {
+                int id = instance.graph.edgeId(route[k], route[k + 1]);
+                EXPECT_NE(id, Graph::npos);
+                if (id != Graph::npos) length += instance.graph.cost(id);
+            }
+        }
+        EXPECT_LE(demand, constraints.capacity + 1e-9);
+        EXPECT_LE(length, constraints.maxLength + 1e-9);
+        total += length;
+    }
+    return total;
+}
+
+// Same, and checks that every node but the terminals is visited once
+double expectValidRoutes(const Instance& instance, const RouteConstraints& constraints,
+    const std::vector<std::vector<int>>& routes, Terminals terminals = {})
+{
+    const int n = (int)instance.points.size();
+    std::vector<int> visits(n, 0);
+    double total = expectValidRoutes(instance, constraints, routes, terminals, visits);
+    const auto [start, end] = terminals.resolved(n);
+    for (int i = 0; i < n; ++i) {
+        if (i == start || i == end) continue;
+        EXPECT_EQ(visits[i], 1) << "node " << i;
+    }
+    return total;
+}
+
+std::set<std::set<int>> nodeSets(const std::vector<std::vector<int>>& routes)
+{
+    std::set<std::set<int>> sets;
+    for (const auto& route : routes) sets.insert(std::set<int>(route.begin() + 1, route.end() - 1));
+    return sets;
+}
+
+} // namespace
+
+TEST(RadixSortTest, MatchesStableSort)
+{
+    ThreadPool pool(4);
+    std::mt19937_64 rng(5);
+    for (std::size_t n : { std::size_t(0), std::size_t(1), std::size_t(1000), std::size_t(300000) }) {
+        for (int wide = 0; wide < 2; ++wide) {
+            // Few distinct keys, so that stability is visible in the payload
+            std::vector<std::uint64_t> keys(n);
+            for (auto& key : keys) key = wide ? (rng() % 64) << 40 | rng() % 7 : rng() % 1000;
+            std::vector<int> values(n);
+            std::iota(values.begin(), values.end(), 0);
+
+            std::vector<int> expected = values;
+            std::stable_sort(expected.begin(), expected.end(), [&](int a, int b) { return keys[a] < keys[b]; });
+
+            for (ThreadPool* threads : { (ThreadPool*)nullptr, &pool }) {
+                std::vector<std::uint64_t> sortedKeys = keys;
+                std::vector<int> sortedValues = values;
+                radixSort(sortedKeys, sortedValues, threads);
+                EXPECT_TRUE(std::is_sorted(sortedKeys.begin(), sortedKeys.end()));
+                EXPECT_EQ(sortedValues, expected) << "n " << n;
+            }
+        }
+    }
+}
+
+TEST(RadixSortTest, RejectsMismatchedSizes)
+{
+    std::vector<std::uint64_t> keys(3);
+    std::vector<int> values(2);
+    EXPECT_THROW(radixSort(keys, values), std::invalid_argument);
+}
+
+TEST(DecompositionTest, RoutesCoverEveryNodeOnce)
+{
+    const int n = 400;
+    Instance instance = makeInstance(n, 12.0, 3);
+    for (PartitionKind kind : { PartitionKind::Sweep, PartitionKind::Cluster }) {
+        for (int partitions : { 1, 3, 8 }) {
+            DecompositionOptions options = capacitated(n, 15.0);
+            options.partition = kind;
+            options.partitions = partitions;
+            options.constraints.maxLength = 250.0;
+            auto routes = solveDecomposed(instance.points, instance.graph, options);
+            expectValidRoutes(instance, options.constraints, routes);
+        }
+    }
+}
+
+TEST(DecompositionTest, ResultDoesNotDependOnThreads)
+{
+    const int n = 600;
+    Instance instance = makeInstance(n, 10.0, 8);
+    DecompositionOptions options = capacitated(n, 20.0);
+    options.partitionSize = 50;
+    for (PartitionKind kind : { PartitionKind::Sweep, PartitionKind::Cluster }) {
+        options.partition = kind;
+        options.pool = nullptr;
+        auto serial = solveDecomposed(instance.points, instance.graph, options);
+
+        ThreadPool pool(4);
+        options.pool = &pool;
+        EXPECT_EQ(solveDecomposed(instance.points, instance.graph, options), serial);
+    }
+}
+
+TEST(DecompositionTest, SinglePartitionIsPlainClarkeWright)
+{
+    const int n = 300;
+    Instance instance = makeInstance(n, 15.0, 12);
+    DecompositionOptions options = capacitated(n, 25.0);
+    options.partitions = 1;
+    auto routes = solveDecomposed(instance.points, instance.graph, options);
+
+    SavingsList list(instance.points, instance.graph, 0, n - 1);
+    RouteStore store;
+    store.reset(n, 0, n - 1, options.constraints.demands);
+    SavingsQueue queue;
+    queue.reset(list);
+    mergeRoutes(instance.graph, list, queue, options.constraints, store);
+
+    std::vector<std::vector<int>> expected;
+    std::vector<int> ids;
+    store.routes(ids);
+    for (int id : ids) store.materialize(id, expected.emplace_back());
+    EXPECT_EQ(nodeSets(routes), nodeSets(expected));
+}
+
+TEST(DecompositionTest, BoundaryMergeJoinsRoutesAcrossPartitions)
+{
+    const int n = 800;
+    Instance instance = makeInstance(n, 9.0, 21);
+    DecompositionOptions options = capacitated(n, 40.0);
+    options.partitions = 16;
+
+    options.boundaryMerge = false;
+    auto separate = solveDecomposed(instance.points, instance.graph, options);
+    double separateCost = expectValidRoutes(instance, options.constraints, separate);
+
+    options.boundaryMerge = true;
+    auto merged = solveDecomposed(instance.points, instance.graph, options);
+    double mergedCost = expectValidRoutes(instance, options.constraints, merged);
+
+    EXPECT_LT(merged.size(), separate.size());
+    EXPECT_LT(mergedCost, separateCost);
+}
+
+TEST(DecompositionTest, HonoursCustomTerminals)
+{
+    const int n = 300;
+    Instance instance = makeInstance(n, 12.0, 4);
+    DecompositionOptions options = capacitated(n, 20.0);
+    options.terminals = { 17, 17 };
+    options.partitions = 4;
+    auto routes = solveDecomposed(instance.points, instance.graph, options);
+    expectValidRoutes(instance, options.constraints, routes, options.terminals);
+}
+
+TEST(TerminalsTest, MultipleRoutesRunBetweenGivenTerminals)
+{
+    const int n = 120;
+    Instance instance = makeInstance(n, 20.0, 6);
+    MultiRouteOptions options;
+    options.seed = 9;
+    options.printRoutes = false;
+    options.terminals = { 40, 7 };
+    auto routes = solveMultipleRoutes(instance.points, instance.graph, 5, options);
+    ASSERT_FALSE(routes.empty());
+    for (const auto& route : routes) {
+        ASSERT_FALSE(route.empty());
+        EXPECT_EQ(route.front().first, 40);
+        EXPECT_EQ(route.back().second, 7);
+        for (const auto& [u, v] : route) EXPECT_TRUE(instance.graph.hasEdge(u, v));
+    }
+
+    auto path = findAlternativePath(instance.points, instance.graph, {}, 1.0, { 40, 7 });
+    ASSERT_FALSE(path.empty());
+    EXPECT_EQ(path.front().first, 40);
+    EXPECT_EQ(path.back().second, 7);
+}
+
+TEST(MultiDepotTest, ServesEveryCustomerFromItsNearestDepot)
+{
+    const int n = 500;
+    Instance instance = makeInstance(n, 10.0, 14);
+    const std::vector<Terminals> depots = { { 0, 0 }, { 10, 10 }, { 20, 30 }, { 40, 40 } };
+    MultiDepotOptions options;
+    options.constraints.demands.assign(n, 1.0);
+    options.constraints.capacity = 12.0;
+    options.constraints.maxLength = 300.0;
+    MultiDepotSolution solution = solveMultiDepot(instance.points, instance.graph, depots, options);
+    ASSERT_EQ(solution.routes.size(), depots.size());
+
+    std::vector<int> visits(n, 0);
+    for (std::size_t d = 0; d < depots.size(); ++d) {
+        std::vector<int> depotVisits(n, 0);
+        expectValidRoutes(instance, options.constraints, solution.routes[d], depots[d], depotVisits);
+        for (int v = 0; v < n; ++v) {
+            if (depotVisits[v] == 0) continue;
+            EXPECT_EQ(solution.depotOf[v], (int)d) << "node " << v;
+            visits[v] += depotVisits[v];
+        }
+    }
+
+    std::set<int> terminals;
+    for (const auto& depot : depots) terminals.insert({ depot.start, depot.end });
+    for (int v = 0; v < n; ++v) {
+        if (terminals.count(v)) {
+            EXPECT_EQ(solution.depotOf[v], -1);
+            EXPECT_EQ(visits[v], 0);
+            continue;
+        }
+        EXPECT_EQ(visits[v], 1) << "node " << v;
+        auto roundTrip = [&](const Terminals& depot) {
+            return euclidean(instance.points[depot.start], instance.points[v]) + euclidean(instance.points[v], instance.points[depot.end]);
+        };
+        for (const auto& depot : depots) EXPECT_LE(roundTrip(depots[solution.depotOf[v]]), roundTrip(depot) + 1e-9);
+    }
+}
+
+TEST(MultiDepotTest, SingleDepotMatchesDecomposedSolve)
+{
+    const int n = 300;
+    Instance instance = makeInstance(n, 15.0, 2);
+    DecompositionOptions single = capacitated(n, 25.0);
+    single.partitions = 1;
+
+    MultiDepotOptions options;
+    options.constraints = single.constraints;
+    const std::vector<Terminals> depots = { {} };
+    MultiDepotSolution solution = solveMultiDepot(instance.points, instance.graph, depots, options);
+    EXPECT_EQ(nodeSets(solution.routes[0]), nodeSets(solveDecomposed(instance.points, instance.graph, single)));
+}
+
+TEST(MultiDepotTest, ResultDoesNotDependOnThreads)
+{
+    const int n = 600;
+    Instance instance = makeInstance(n, 10.0, 19);
+    std::vector<Terminals> depots;
+    for (int d = 0; d < 12; ++d) depots.push_back({ d * 50, d * 50 });
+    MultiDepotOptions options;
+    options.constraints.demands.assign(n, 1.0);
+    options.constraints.capacity = 10.0;
+    MultiDepotSolution serial = solveMultiDepot(instance.points, instance.graph, depots, options);
+
+    ThreadPool pool(4);
+    options.pool = &pool;
+    MultiDepotSolution parallel = solveMultiDepot(instance.points, instance.graph, depots, options);
+    EXPECT_EQ(parallel.depotOf, serial.depotOf);
+    EXPECT_EQ(parallel.routes, serial.routes);
+}
+
+TEST(MultiDepotTest, RejectsInvalidDepots)
+{
+    Instance instance = makeInstance(10, 50.0, 1);
+    EXPECT_THROW(solveMultiDepot(instance.points, instance.graph, {}), std::invalid_argument);
+    const std::vector<Terminals> outside = { { 0, 10 } };
+    EXPECT_THROW(solveMultiDepot(instance.points, instance.graph, outside), std::invalid_argument);
+}
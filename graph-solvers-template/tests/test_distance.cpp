@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "common/distance.h"
+#include "common/graph.h"
+#include "model/savings.h"
+
+namespace {
+
+std::vector<Point> randomPoints(int n, unsigned seed)
+{
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> coord(0.0, 100.0);
+    std::vector<Point> points(n);
+    for (auto& p : points) p = { coord(gen), coord(gen) };
+    return points;
+}
+
+} // namespace
+
+TEST(DistanceTest, BackendsAgreeWithEuclidean) {
+    auto points = randomPoints(150, 3);
+    EuclideanDistances euclideanDistances(points);
+    DenseDistanceMatrix dense(euclideanDistances);
+    TiledDistanceCache tiled(euclideanDistances, 16, 4);
+
+    std::vector<double> row(points.size());
+    for (int i = 0; i < (int)points.size(); i += 7) {
+        tiled.row(i, row);
+        for (int j = 0; j < (int)points.size(); ++j) {
+            double expected = euclidean(points[i], points[j]);
+            EXPECT_DOUBLE_EQ(euclideanDistances.distance(i, j), expected);
+            EXPECT_FLOAT_EQ((float)dense.distance(j, i), (float)expected);
+            EXPECT_DOUBLE_EQ(tiled.distance(j, i), expected);
+            EXPECT_DOUBLE_EQ(row[j], expected);
+        }
+    }
+    EXPECT_LE(tiled.cachedTiles(), 4u);
+}
+
+TEST(DistanceTest, BatchedQueriesMatchSingleQueries) {
+    auto points = randomPoints(80, 5);
+    EuclideanDistances euclideanDistances(points);
+    DenseDistanceMatrix dense(euclideanDistances);
+    TiledDistanceCache tiled(euclideanDistances, 8, 2);
+
+    std::vector<int> targets = { 79, 0, 3, 41, 42, 8, 8, 15 };
+    std::vector<double> fromEuclidean(targets.size()), fromMatrix(targets.size()), fromTiles(targets.size());
+    euclideanDistances.distances(17, targets, fromEuclidean);
+    dense.distances(17, targets, fromMatrix);
+    tiled.distances(17, targets, fromTiles);
+    for (size_t k = 0; k < targets.size(); ++k) {
+        EXPECT_DOUBLE_EQ(fromEuclidean[k], euclideanDistances.distance(17, targets[k]));
+        EXPECT_FLOAT_EQ((float)fromMatrix[k], (float)fromEuclidean[k]);
+        EXPECT_DOUBLE_EQ(fromTiles[k], fromEuclidean[k]);
+    }
+}
+
+TEST(DistanceTest, CacheReusesTilesUntilEvicted) {
+    auto points = randomPoints(64, 7);
+    EuclideanDistances euclideanDistances(points);
+    TiledDistanceCache tiled(euclideanDistances, 16, 1);
+
+    tiled.distance(0, 1);
+    tiled.distance(2, 3);
+    EXPECT_EQ(tiled.misses(), 1u);
+    EXPECT_EQ(tiled.hits(), 1u);
+
+    tiled.distance(40, 40);
+    tiled.distance(0, 1);
+    EXPECT_EQ(tiled.misses(), 3u);
+    EXPECT_EQ(tiled.cachedTiles(), 1u);
+    EXPECT_EQ(tiled.memoryBytes(), euclideanDistances.memoryBytes() + 16 * 16 * sizeof(double));
+}
+
+TEST(DistanceTest, DefaultProviderMatchesEdgeCostsExactly) {
+    auto points = randomPoints(200, 9);
+    auto provider = makeDistanceProvider(points);
+    ASSERT_EQ(provider->size(), 200);
+    for (int i = 0; i < 200; i += 13) {
+        for (int j = 0; j < 200; ++j)
+            EXPECT_EQ(provider->distance(i, j), euclidean(points[i], points[j]));
+    }
+}
+
+TEST(DistanceTest, LargeInstancesGetTheTileCache) {
+    auto points = randomPoints(300, 11);
+    EXPECT_EQ(dynamic_cast<TiledDistanceCache*>(makeDistanceProvider(points).get()), nullptr);
+
+    auto provider = makeDistanceProvider(points, 300);
+    ASSERT_NE(dynamic_cast<TiledDistanceCache*>(provider.get()), nullptr);
+    for (int i = 0; i < 300; i += 17) {
+        for (int j = 0; j < 300; ++j)
+            EXPECT_EQ(provider->distance(i, j), euclidean(points[i], points[j]));
+    }
+}
+
+TEST(DistanceTest, EdgeCostsComeFromTheProvider) {
+    Graph graph(4, { { 0, 1, 0.0 }, { 1, 2, 0.0 }, { 0, 3, 0.0 }, { 2, 3, 0.0 } });
+    DenseDistanceMatrix matrix(4, {
+        0, 1, 9, 2,
+        5, 0, 3, 9,
+        9, 6, 0, 4,
+        7, 9, 8, 0 });
+    setEdgeCosts(graph, matrix);
+    EXPECT_DOUBLE_EQ(graph.cost(graph.edgeId(0, 1)), 1.0);
+    EXPECT_DOUBLE_EQ(graph.cost(graph.edgeId(1, 2)), 3.0);
+    EXPECT_DOUBLE_EQ(graph.cost(graph.edgeId(0, 3)), 2.0);
+    EXPECT_DOUBLE_EQ(graph.cost(graph.edgeId(2, 3)), 4.0);
+
+    EXPECT_THROW(setEdgeCosts(graph, DenseDistanceMatrix(2, { 0, 1, 1, 0 })), std::invalid_argument);
+}
+
+TEST(DistanceTest, DenseMatrixKeepsAsymmetricCosts) {
+    DenseDistanceMatrix matrix(2, { 0.0f, 5.0f, 7.0f, 0.0f });
+    EXPECT_DOUBLE_EQ(matrix.distance(0, 1), 5.0);
+    EXPECT_DOUBLE_EQ(matrix.distance(1, 0), 7.0);
+    EXPECT_THROW(DenseDistanceMatrix(3, { 1.0f }), std::invalid_argument);
+}
+
+TEST(DistanceTest, SavingsUseProviderDepotDistances) {
+    std::vector<Point> points = { { 0, 0 }, { 3, 4 }, { 6, 0 }, { 9, 9 } };
+    Graph graph(4, { { 1, 2, 5.0 }, { 0, 1, 5.0 }, { 2, 3, 9.0 } });
+
+    SavingsList fromPoints(points, graph, 0, 3);
+    SavingsList fromProvider(EuclideanDistances(points), graph, 0, 3);
+    ASSERT_EQ(fromPoints.size(), 1);
+    ASSERT_EQ(fromProvider.size(), 1);
+    EXPECT_DOUBLE_EQ(fromProvider[0].value, fromPoints[0].value);
+    EXPECT_DOUBLE_EQ(fromProvider[0].value, 5.0 + 6.0 - 5.0);
+}
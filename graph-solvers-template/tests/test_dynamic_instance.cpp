@@ -0,0 +1,273 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <set>
+
+#include "common/random.h"
+#include "common/dynamic_graph.h"
+#include "geometry/dynamic_triangulation.h"
+#include "model/dynamic_instance.h"
+
+namespace {
+
+using EdgeSet = std::set<std::pair<int, int>>;
+
+EdgeSet toSet(const std::vector<std::pair<int, int>>& edges)
+{
+    return { edges.begin(), edges.end() };
+}
+
+// Every route runs start..end over live graph edges, and its cached length matches the edges
+void expectValidRoutes(const DynamicInstance& instance)
+{
+    const auto& graph = instance.graph();
+    for (int r = 0; r < (int)instance.routes().size(); ++r) {
+        const auto& route = instance.routes()[r];
+        ASSERT_GE(route.size(), 2u);
+        EXPECT_EQ(route.front(), instance.start());
+        EXPECT_EQ(route.back(), instance.end());
+        double length = 0.0;
+        for (std::size_t k = 0; k + 1 < route.size(); ++k) {
+            ASSERT_TRUE(instance.contains(route[k]));
+            int e = graph.edgeId(route[k], route[k + 1]);
+            ASSERT_NE(e, DynamicGraph::npos) << "route " << r << " link " << route[k] << "-" << route[k + 1];
+            length += graph.cost(e);
+        }
+        EXPECT_NEAR(instance.routeLength(r), length, 1e-9 * std::max(1.0, length));
+    }
+}
+
+Point randomPoint(const CounterRng& rng, std::uint64_t index)
+{
+    auto u = rng.uniform2(index);
+    return { 40.0 * u[0], 40.0 * u[1] };
+}
+
+} // namespace
+
+TEST(DynamicInstanceTest, TriangulationDeltasTrackEdges) {
+    auto points = generateUniquePoints(500, 0.0, 0.0, 40.0, 40.0, 11);
+    DynamicTriangulation triangulation(points);
+    EdgeSet edges = toSet(triangulation.edges());
+    EXPECT_TRUE(triangulation.isDelaunay());
+
+    CounterRng rng(5);
+    DynamicTriangulation::Delta delta;
+    for (int step = 0; step < 600; ++step) {
+        if (step % 3 != 2) {
+            triangulation.insert(randomPoint(rng, step), delta);
+        }
+        else {
+            int id;
+            std::uint64_t draw = step;
+            do {
+                id = (int)(rng.bits(draw += 1000) % triangulation.idCount());
+            } while (!triangulation.contains(id));
+            triangulation.remove(id, delta);
+        }
+        for (const auto& e : delta.removed) EXPECT_EQ(edges.erase(e), 1u);
+        for (const auto& e : delta.added) EXPECT_TRUE(edges.insert(e).second);
+    }
+    auto current = triangulation.edges();
+    EXPECT_EQ(edges, toSet(current));
+    EXPECT_TRUE(triangulation.isDelaunay());
+
+    // Same edges as triangulating the surviving points from scratch
+    std::vector<Point> live;
+    std::vector<int> ids;
+    for (int id = 0; id < triangulation.idCount(); ++id) {
+        if (!triangulation.contains(id)) continue;
+        live.push_back(triangulation.point(id));
+        ids.push_back(id);
+    }
+    EdgeSet fresh;
+    for (auto [u, v] : DynamicTriangulation(live).edges()) fresh.insert({ ids[u], ids[v] });
+    EXPECT_EQ(fresh, edges);
+
+    // A point far outside rebuilds, and the delta still describes the change
+    triangulation.insert({ 500.0, 500.0 }, delta);
+    EXPECT_TRUE(delta.rebuilt);
+    for (const auto& e : delta.removed) edges.erase(e);
+    for (const auto& e : delta.added) edges.insert(e);
+    current = triangulation.edges();
+    EXPECT_EQ(edges, toSet(current));
+    EXPECT_THROW(triangulation.insert(triangulation.point(ids[0]), delta), std::invalid_argument);
+}
+
+TEST(DynamicInstanceTest, DynamicGraphAddsAndRemovesInPlace) {
+    Graph base(4, { { 0, 1, 1.0 }, { 1, 2, 2.0 }, { 2, 3, 3.0 } });
+    DynamicGraph graph(base);
+    EXPECT_EQ(graph.edgeId(1, 2), base.edgeId(1, 2));
+
+    // A hub collects enough edges to outgrow its block several times
+    EdgeSet expected = { { 0, 1 }, { 1, 2 }, { 2, 3 } };
+    for (int k = 0; k < 200; ++k) {
+        int v = graph.addVertex();
+        graph.addEdge(v, 0, 1.0 + v);
+        if (v > 5) graph.addEdge(v - 1, v, 0.5);
+        expected.insert({ 0, v });
+        if (v > 5) expected.insert({ v - 1, v });
+        if (k % 4 == 0) {
+            graph.removeEdge(graph.edgeId(0, v));
+            expected.erase({ 0, v });
+        }
+    }
+    EXPECT_EQ(graph.addEdge(1, 0, 9.0), graph.edgeId(0, 1));
+    EXPECT_EQ(graph.cost(graph.edgeId(0, 1)), 1.0);
+
+    EdgeSet actual;
+    for (int u = 0; u < graph.vertexCount(); ++u) {
+        auto adj = graph.neighbours(u);
+        EXPECT_TRUE(std::is_sorted(adj.begin(), adj.end()));
+        for (std::size_t k = 0; k < adj.size(); ++k) {
+            const Edge& e = graph.edge(graph.incidentEdges(u)[k]);
+            EXPECT_EQ(std::min(e.u, e.v), std::min(u, adj[k]));
+            if (u < adj[k]) actual.insert({ u, adj[k] });
+        }
+    }
+    EXPECT_EQ(actual, expected);
+    EXPECT_EQ(graph.edgeCount(), (int)expected.size());
+}
+
+TEST(DynamicInstanceTest, UpdatesRepairRoutesLocally) {
+    auto points = generateUniquePoints(400, 0.0, 0.0, 40.0, 40.0, 3);
+    DynamicInstance instance(points);
+    MultiRouteOptions options;
+    options.seed = 9;
+    instance.solve(4, options);
+    ASSERT_FALSE(instance.routes().empty());
+    expectValidRoutes(instance);
+
+    // A stop in the middle of a route link is picked up by that route
+    const auto& route = instance.routes()[0];
+    const Point& a = instance.point(route[route.size() / 2]);
+    const Point& b = instance.point(route[route.size() / 2 + 1]);
+    int stop = instance.insertPoint({ (a.x + b.x) / 2 + 1e-3, (a.y + b.y) / 2 });
+    EXPECT_TRUE(instance.lastUpdate().covered);
+    EXPECT_GT(instance.lastUpdate().routesRepaired, 0);
+    expectValidRoutes(instance);
+
+    // Cancelling a visited stop splices it out of every route
+    int visited = instance.routes()[0][2];
+    instance.removePoint(visited);
+    EXPECT_FALSE(instance.contains(visited));
+    for (const auto& r : instance.routes()) EXPECT_EQ(std::find(r.begin(), r.end(), visited), r.end());
+    expectValidRoutes(instance);
+    EXPECT_THROW(instance.removePoint(instance.start()), std::invalid_argument);
+
+    // Blocking a used road reroutes (or drops) every route over it
+    const auto& blocked = instance.routes()[0];
+    int u = blocked[1], v = blocked[2];
+    instance.setEdgeCost(u, v, std::numeric_limits<double>::infinity());
+    for (int r = 0; r < (int)instance.routes().size(); ++r) {
+        EXPECT_TRUE(std::isfinite(instance.routeLength(r)));
+    }
+    expectValidRoutes(instance);
+    EXPECT_THROW(instance.setEdgeCost(stop, stop, 1.0), std::invalid_argument);
+
+    // Many random updates keep the instance consistent with a snapshot
+    CounterRng rng(17);
+    for (int step = 0; step < 300; ++step) {
+        if (step % 2 == 0) {
+            instance.insertPoint(randomPoint(rng, step));
+        }
+        else {
+            int id;
+            std::uint64_t draw = step;
+            do {
+                id = (int)(rng.bits(draw += 1000) % instance.triangulation().idCount());
+            } while (!instance.contains(id) || id == instance.start() || id == instance.end());
+            instance.removePoint(id);
+        }
+        expectValidRoutes(instance);
+    }
+    auto snapshot = instance.snapshot();
+    EXPECT_EQ((int)snapshot.points.size(), instance.triangulation().size());
+    EXPECT_EQ(snapshot.graph.edgeCount(), instance.graph().edgeCount());
+    EXPECT_EQ(snapshot.ids.front(), instance.start());
+    EXPECT_EQ(snapshot.ids.back(), instance.end());
+}
+
+TEST(DynamicInstanceTest, RepairsRespectCapacity) {
+    auto points = generateUniquePoints(200, 0.0, 0.0, 40.0, 40.0, 8);
+    DynamicOptions options;
+    options.constraints.demands.assign(points.size(), 1.0);
+    options.constraints.capacity = 1e9;
+    DynamicInstance instance(points, options);
+    MultiRouteOptions solveOptions;
+    solveOptions.seed = 1;
+    instance.solve(2, solveOptions);
+    ASSERT_FALSE(instance.routes().empty());
+
+    // A stop too heavy for any route stays unserved instead of breaking the capacity
+    const auto& route = instance.routes()[0];
+    const Point& a = instance.point(route[1]);
+    const Point& b = instance.point(route[2]);
+    int heavy = instance.insertPoint({ (a.x + b.x) / 2 + 1e-3, (a.y + b.y) / 2 }, 2e9);
+    EXPECT_FALSE(instance.lastUpdate().covered);
+    for (const auto& r : instance.routes()) EXPECT_EQ(std::find(r.begin(), r.end(), heavy), r.end());
+    expectValidRoutes(instance);
+}
+
+TEST(DynamicInstanceTest, RepairsRespectTimeWindows) {
+    auto points = generateUniquePoints(300, 0.0, 0.0, 40.0, 40.0, 12);
+    const int n = (int)points.size();
+    DynamicOptions options;
+    auto& windows = options.constraints;
+    windows.readyTimes.assign(n, 0.0);
+    windows.dueTimes.assign(n, 1e6);
+    windows.serviceTimes.assign(n, 0.0);
+    CounterRng rng(4);
+    for (int v = 1; v < n - 1; ++v) {
+        double earliest = 2.0 * euclidean(points[0], points[v]);
+        windows.readyTimes[v] = 60.0 * rng.uniform2(v)[0];
+        windows.dueTimes[v] = std::max(windows.readyTimes[v], earliest) + 80.0;
+        windows.serviceTimes[v] = 1.0;
+    }
+    // Stops no route can reach in time; a solve that mixes up ids and indices visits them
+    for (int v = 65; v < n - 1; v += 25) windows.dueTimes[v] = 0.0;
+    DynamicOptions shorter = options;
+    shorter.constraints.dueTimes.resize(n - 1);
+    EXPECT_THROW(DynamicInstance(points, shorter), std::invalid_argument);
+
+    // Every route keeps the windows of its vertex ids; stops added later have none
+    auto expectWindowsKept = [&](const DynamicInstance& instance) {
+        const auto& graph = instance.graph();
+        auto segmentOf = [&](int v) { return v < n ? windows.segment(v) : TimeSegment{}; };
+        auto travel = [&](int u, int v) { return graph.cost(graph.edgeId(u, v)); };
+        for (const auto& route : instance.routes()) EXPECT_TRUE(fitsSchedule(route, segmentOf, travel));
+    };
+
+    // Removals before solving move the later ids away from their snapshot indices
+    DynamicInstance instance(points, options);
+    for (int v = 1; v < 60; v += 2) instance.removePoint(v);
+    MultiRouteOptions solveOptions;
+    solveOptions.seed = 5;
+    instance.solve(6, solveOptions);
+    ASSERT_FALSE(instance.routes().empty());
+    expectValidRoutes(instance);
+    expectWindowsKept(instance);
+
+    // Stops on route links, cancellations and slower roads; repairs that miss a window drop the route
+    for (int step = 0; step < 150 && !instance.routes().empty(); ++step) {
+        const auto& route = instance.routes()[step % instance.routes().size()];
+        if (route.size() < 3) continue;
+        int k = 1 + (int)(rng.bits(1000 + step) % (route.size() - 2));
+        if (step % 3 == 0) {
+            const Point& a = instance.point(route[k - 1]);
+            const Point& b = instance.point(route[k]);
+            instance.insertPoint({ (a.x + b.x) / 2 + 1e-3, (a.y + b.y) / 2 });
+        }
+        else if (step % 3 == 1) {
+            instance.removePoint(route[k]);
+        }
+        else {
+            int u = route[k - 1], v = route[k];
+            instance.setEdgeCost(u, v, 4.0 * instance.graph().cost(instance.graph().edgeId(u, v)));
+        }
+        expectValidRoutes(instance);
+        expectWindowsKept(instance);
+    }
+}
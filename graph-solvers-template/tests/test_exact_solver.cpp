@@ -0,0 +1,315 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <set>
+
+#include "common/graph.h"
+#include "model/exact_solver.h"
+#include "model/mip.h"
+#include "model/savings.h"
+#include "model/subsets.h"
+#include "test_instances.h"
+
+namespace {
+
+constexpr double kInf = std::numeric_limits<double>::infinity();
+
+using Instance = RadiusInstance;
+
+double demandOf(const ExactOptions& options, int node)
+{
+    return options.constraints.demands.empty() ? 0.0 : options.constraints.demands[node];
+}
+
+// Optimum by dynamic programming over subsets: best path per (set, last node), best single
+// route per set, then the best partition into at most maxRoutes routes
+double bruteForce(const Instance& instance, const ExactOptions& options)
+{
+    const int n = (int)instance.points.size(), k = n - 2, full = 1 << k;
+    const Graph& graph = instance.graph;
+    SavingsList list(instance.points, graph, 0, n - 1);
+    auto fromStart = list.depotDistances();
+    auto toEnd = list.endDistances();
+
+    std::vector<std::vector<double>> path(full, std::vector<double>(k, kInf));
+    for (int v = 0; v < k; ++v) {
+        if (!options.terminalEdgesOnly || graph.hasEdge(0, v + 1)) path[1 << v][v] = fromStart[v + 1];
+    }
+    for (int set = 1; set < full; ++set) {
+        for (int v = 0; v < k; ++v) {
+            if (path[set][v] == kInf) continue;
+            for (int w = 0; w < k; ++w) {
+                int id = graph.edgeId(v + 1, w + 1);
+                if ((set >> w & 1) || id == Graph::npos) continue;
+                double& next = path[set | 1 << w][w];
+                next = std::min(next, path[set][v] + graph.cost(id));
+            }
+        }
+    }
+
+    std::vector<double> route(full, kInf);
+    for (int set = 1; set < full; ++set) {
+        double demand = 0.0;
+        for (int v = 0; v < k; ++v) {
+            if (set >> v & 1) demand += demandOf(options, v + 1);
+        }
+        if (demand > options.constraints.capacity) continue;
+        for (int v = 0; v < k; ++v) {
+            if (path[set][v] == kInf || (options.terminalEdgesOnly && !graph.hasEdge(v + 1, n - 1))) continue;
+            double length = path[set][v] + toEnd[v + 1];
+            if (length <= options.constraints.maxLength) route[set] = std::min(route[set], length);
+        }
+    }
+
+    int maxRoutes = options.maxRoutes > 0 ? options.maxRoutes : k;
+    std::vector<double> cover(full, kInf), next(full);
+    cover[0] = 0.0;
+    double best = kInf;
+    for (int r = 1; r <= maxRoutes; ++r) {
+        std::fill(next.begin(), next.end(), kInf);
+        for (int set = 1; set < full; ++set) {
+            int lowest = set & -set;
+            for (int part = set; part != 0; part = (part - 1) & set) {
+                if ((part & lowest) && route[part] < kInf && cover[set ^ part] < kInf)
+                    next[set] = std::min(next[set], route[part] + cover[set ^ part]);
+            }
+        }
+        cover.swap(next);
+        best = std::min(best, cover[full - 1]);
+    }
+    return best;
+}
+
+// Checks that the routes cover every interior node once, follow graph edges, respect the
+// capacity and add up to the reported cost
+void expectValidRoutes(const Instance& instance, const ExactOptions& options, const ExactResult& result)
+{
+    const int n = (int)instance.points.size();
+    SavingsList list(instance.points, instance.graph, 0, n - 1);
+    auto fromStart = list.depotDistances();
+    auto toEnd = list.endDistances();
+
+    std::vector<int> visits(n, 0);
+    double total = 0.0;
+    for (const auto& route : result.routes) {
+        ASSERT_GE(route.size(), 3u);
+        EXPECT_EQ(route.front(), 0);
+        EXPECT_EQ(route.back(), n - 1);
+        double demand = 0.0;
+        total += fromStart[route[1]] + toEnd[route[route.size() - 2]];
+        for (std::size_t k = 1; k + 1 < route.size(); ++k) {
+            ++visits[route[k]];
+            demand += demandOf(options, route[k]);
+            if (k + 2 < route.size()) {
+                int id = instance.graph.edgeId(route[k], route[k + 1]);
+                ASSERT_NE(id, Graph::npos);
+                total += instance.graph.cost(id);
+            }
+        }
+        EXPECT_LE(demand, options.constraints.capacity + 1e-9);
+    }
+    for (int i = 1; i < n - 1; ++i) EXPECT_EQ(visits[i], 1) << "node " << i;
+    EXPECT_NEAR(total, result.cost, 1e-6 * std::max(1.0, total));
+}
+
+// Accepts everything; the model rows alone define the problem
+class NoSeparator : public MipSeparator
+{
+public:
+    void separateIntegral(std::span<const double>, std::vector<MipRow>&) override {}
+};
+
+} // namespace
+
+TEST(MipBackendTest, SolvesKnapsackWithFractionalRelaxation)
+{
+    // max 8a + 11b + 6c + 4d s.t. 5a + 7b + 4c + 3d <= 14: LP optimum 22, integer optimum 21
+    MipModel model;
+    for (double value : { 8.0, 11.0, 6.0, 4.0 }) model.addColumn(-value, 0.0, 1.0, true);
+    model.addRow({ { 0, 1, 2, 3 }, { 5.0, 7.0, 4.0, 3.0 }, -kInf, 14.0 });
+
+    NoSeparator separator;
+    MipResult result = makeBranchAndCutBackend()->solve(model, separator, {});
+    EXPECT_EQ(result.status, MipStatus::Optimal);
+    EXPECT_NEAR(result.objective, -21.0, 1e-9);
+    EXPECT_NEAR(result.bound, -21.0, 1e-6);
+    EXPECT_EQ(result.x, (std::vector<double>{ 0.0, 1.0, 1.0, 1.0 }));
+}
+
+TEST(MipBackendTest, ReportsInfeasibleModel)
+{
+    MipModel model;
+    model.addColumn(1.0, 0.0, 1.0, true);
+    model.addRow({ { 0 }, { 1.0 }, 0.3, 0.7 });
+
+    NoSeparator separator;
+    MipResult result = makeBranchAndCutBackend()->solve(model, separator, {});
+    EXPECT_EQ(result.status, MipStatus::Infeasible);
+    EXPECT_TRUE(result.x.empty());
+}
+
+TEST(MipBackendTest, FactoryKnowsBundledBackend)
+{
+    EXPECT_STREQ(makeMipBackend("bundled")->name(), "bundled");
+    EXPECT_NE(makeMipBackend(""), nullptr);
+    EXPECT_THROW(makeMipBackend("no-such-solver"), std::invalid_argument);
+
+    auto names = availableMipBackends();
+    EXPECT_NE(std::find(names.begin(), names.end(), "bundled"), names.end());
+}
+
+TEST(ExactSolverTest, MatchesBruteForceOnSmallInstances)
+{
+    for (unsigned seed = 0; seed < 60; ++seed) {
+        std::mt19937 rng(seed);
+        int n = 4 + (int)(rng() % 6);
+        Instance instance = makeRadiusInstance(n, 30.0 + rng() % 60, seed);
+
+        ExactOptions options;
+        options.backend = "bundled";
+        options.terminalEdgesOnly = rng() % 3 == 0;
+        options.warmStart = rng() % 2 == 0;
+        if (rng() % 2) {
+            options.constraints.demands.assign(n, 0.0);
+            for (int i = 1; i < n - 1; ++i) options.constraints.demands[i] = 1.0 + rng() % 5;
+            options.constraints.capacity = 5.0 + rng() % 10;
+        }
+        if (rng() % 3 == 0) options.constraints.maxLength = 150.0 + rng() % 150;
+        if (rng() % 3 == 0) options.maxRoutes = 1 + (int)(rng() % 3);
+
+        double expected = bruteForce(instance, options);
+        ExactResult result = solveRoutesExact(instance.points, instance.graph, options);
+        if (expected == kInf) {
+            EXPECT_EQ(result.status, MipStatus::Infeasible) << "seed " << seed;
+            continue;
+        }
+        ASSERT_EQ(result.status, MipStatus::Optimal) << "seed " << seed;
+        EXPECT_NEAR(result.cost, expected, 1e-6 * std::max(1.0, expected)) << "seed " << seed;
+        expectValidRoutes(instance, options, result);
+    }
+}
+
+TEST(ExactSolverTest, RoundTripsFromOneDepotMatchBruteForce)
+{
+    for (unsigned seed = 0; seed < 30; ++seed) {
+        std::mt19937 rng(seed);
+        int n = 4 + (int)(rng() % 5);
+        Instance instance = makeRadiusInstance(n, 30.0 + rng() % 60, seed);
+
+        ExactOptions options;
+        options.backend = "bundled";
+        options.terminals = { 0, 0 };
+        options.terminalEdgesOnly = rng() % 3 == 0;
+        options.constraints.demands.assign(n, 0.0);
+        for (int i = 1; i < n; ++i) options.constraints.demands[i] = 1.0 + rng() % 5;
+        options.constraints.capacity = 5.0 + rng() % 10;
+
+        // Round trips from depot 0 are paths from 0 to a copy of it appended as the end
+        Instance split = instance;
+        split.points.push_back(instance.points[0]);
+        std::vector<Edge> edges = instance.graph.edges();
+        for (int neighbour : instance.graph.neighbours(0))
+            edges.push_back({ neighbour, n, instance.graph.cost(instance.graph.edgeId(0, neighbour)) });
+        split.graph = Graph(n + 1, edges);
+        ExactOptions splitOptions = options;
+        splitOptions.terminals = {};
+        splitOptions.constraints.demands.push_back(0.0);
+        double expected = bruteForce(split, splitOptions);
+
+        ExactResult result = solveRoutesExact(instance.points, instance.graph, options);
+        if (expected == kInf) {
+            EXPECT_EQ(result.status, MipStatus::Infeasible) << "seed " << seed;
+            continue;
+        }
+        ASSERT_EQ(result.status, MipStatus::Optimal) << "seed " << seed;
+        EXPECT_NEAR(result.cost, expected, 1e-6 * std::max(1.0, expected)) << "seed " << seed;
+        std::vector<int> visits(n, 0);
+        for (const auto& route : result.routes) {
+            EXPECT_EQ(route.front(), 0);
+            EXPECT_EQ(route.back(), 0);
+            for (std::size_t k = 1; k + 1 < route.size(); ++k) ++visits[route[k]];
+        }
+        for (int i = 1; i < n; ++i) EXPECT_EQ(visits[i], 1) << "seed " << seed << ", node " << i;
+    }
+}
+
+TEST(ExactSolverTest, CertifiesCapacitatedInstance)
+{
+    const int n = 30;
+    Instance instance = makeRadiusInstance(n, 25.0, 7);
+    ExactOptions options;
+    options.backend = "bundled";
+    options.constraints.demands.assign(n, 1.0);
+    options.constraints.demands[0] = options.constraints.demands[n - 1] = 0.0;
+    options.constraints.capacity = 10.0;
+
+    ExactResult result = solveRoutesExact(instance.points, instance.graph, options);
+    ASSERT_EQ(result.status, MipStatus::Optimal);
+    EXPECT_LE(result.gap(), 1e-6);
+    EXPECT_LE(result.bound, result.cost + 1e-9);
+    EXPECT_GE(result.routes.size(), 3u);
+    EXPECT_EQ(result.backend, "bundled");
+    expectValidRoutes(instance, options, result);
+}
+
+TEST(ExactSolverTest, BoundStaysValidUnderTimeLimit)
+{
+    const int n = 60;
+    Instance instance = makeRadiusInstance(n, 25.0, 11);
+    ExactOptions options;
+    options.backend = "bundled";
+    options.constraints.demands.assign(n, 1.0);
+    options.constraints.demands[0] = options.constraints.demands[n - 1] = 0.0;
+    options.constraints.capacity = 10.0;
+    options.timeLimit = 1.0;
+
+    ExactResult result = solveRoutesExact(instance.points, instance.graph, options);
+    ASSERT_TRUE(result.status == MipStatus::Optimal || result.status == MipStatus::Feasible);
+    EXPECT_GT(result.bound, 0.0);
+    EXPECT_LE(result.bound, result.cost + 1e-9);
+    EXPECT_LT(result.gap(), 0.5);
+    expectValidRoutes(instance, options, result);
+}
+
+TEST(ExactSolverTest, DetectsTooFewRoutes)
+{
+    const int n = 12;
+    Instance instance = makeRadiusInstance(n, 40.0, 3);
+    ExactOptions options;
+    options.backend = "bundled";
+    options.constraints.demands.assign(n, 1.0);
+    options.constraints.demands[0] = options.constraints.demands[n - 1] = 0.0;
+    options.constraints.capacity = 4.0;  // 10 customers need 3 routes
+    options.maxRoutes = 2;
+
+    ExactResult result = solveRoutesExact(instance.points, instance.graph, options);
+    EXPECT_EQ(result.status, MipStatus::Infeasible);
+    EXPECT_TRUE(result.routes.empty());
+}
+
+TEST(SubsetsTest, GeneratorVisitsEveryNonTrivialSubsetOnce)
+{
+    SubsetGenerator generator(6);
+    EXPECT_EQ(generator.count(), 64u - 6u - 2u);
+
+    std::set<std::vector<int>> seen;
+    std::vector<int> subset;
+    while (generator.next(subset)) {
+        EXPECT_GE(subset.size(), 2u);
+        EXPECT_LE(subset.size(), 5u);
+        EXPECT_TRUE(std::is_sorted(subset.begin(), subset.end()));
+        EXPECT_TRUE(seen.insert(subset).second);
+    }
+    EXPECT_EQ(seen.size(), generator.count());
+    EXPECT_EQ(generateSubsets(6).size(), generator.count());
+}
+
+TEST(SubsetsTest, RefusesExponentialFamilies)
+{
+    EXPECT_THROW(generateSubsets(26), std::length_error);
+    EXPECT_THROW(SubsetGenerator(64), std::length_error);
+    EXPECT_EQ(SubsetGenerator(40).count(), (std::uint64_t(1) << 40) - 42);
+}
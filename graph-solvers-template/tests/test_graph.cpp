@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+
+#include "common/graph.h"
+
+TEST(GraphTest, BuildsSortedSymmetricAdjacency) {
+    Graph graph(4, { { 2, 0, 2.0 }, { 0, 1, 1.0 }, { 3, 1, 3.0 } });
+
+    ASSERT_EQ(graph.vertexCount(), 4);
+    ASSERT_EQ(graph.edgeCount(), 3);
+
+    auto n0 = graph.neighbours(0);
+    ASSERT_EQ(n0.size(), 2u);
+    EXPECT_EQ(n0[0], 1);
+    EXPECT_EQ(n0[1], 2);
+
+    // Edge ids follow (u, v) order with u < v.
+    EXPECT_EQ(graph.edge(0).u, 0);
+    EXPECT_EQ(graph.edge(0).v, 1);
+    EXPECT_EQ(graph.edge(2).u, 1);
+    EXPECT_EQ(graph.edge(2).v, 3);
+}
+
+TEST(GraphTest, LooksUpEdgesInBothDirections) {
+    Graph graph(4, { { 0, 1, 1.0 }, { 1, 2, 2.0 }, { 2, 3, 3.0 } });
+
+    EXPECT_EQ(graph.edgeId(1, 2), graph.edgeId(2, 1));
+    EXPECT_TRUE(graph.hasEdge(3, 2));
+    EXPECT_FALSE(graph.hasEdge(0, 3));
+    EXPECT_EQ(graph.edgeId(0, 7), Graph::npos);
+}
+
+TEST(GraphTest, DropsDuplicatesAndSelfLoops) {
+    Graph graph(3, { { 0, 1, 1.0 }, { 1, 0, 5.0 }, { 2, 2, 1.0 }, { 1, 2, 2.0 } });
+
+    EXPECT_EQ(graph.edgeCount(), 2);
+    EXPECT_DOUBLE_EQ(graph.cost(graph.edgeId(0, 1)), 1.0);
+    EXPECT_EQ(graph.degree(2), 1);
+}
+
+TEST(GraphTest, OverwritesCostsInPlace) {
+    Graph graph(3, { { 0, 1, 1.0 }, { 1, 2, 2.0 } });
+
+    int id = graph.edgeId(2, 1);
+    graph.setCost(id, 7.5);
+
+    EXPECT_DOUBLE_EQ(graph.cost(id), 7.5);
+    EXPECT_EQ(graph.edgeId(1, 2), id);
+}
+
+TEST(GraphTest, RejectsOutOfRangeEndpoints) {
+    EXPECT_THROW(Graph(2, { { 0, 2, 1.0 } }), std::invalid_argument);
+}
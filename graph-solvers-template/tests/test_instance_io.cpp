@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <filesystem>
+
+#include "common/instance_io.h"
+
+TEST(InstanceIoTest, ParsesCvrplib) {
+    const char* text =
+        "NAME : tiny-n4\n"
+        "TYPE : CVRP\n"
+        "DIMENSION : 4\n"
+        "EDGE_WEIGHT_TYPE : EUC_2D\n"
+        "CAPACITY : 10\n"
+        "NODE_COORD_SECTION\n"
+        " 1 0 0\n"
+        " 2 3.5 4\n"
+        " 3 -1 2e1\n"
+        " 4 7 7\n"
+        "DEMAND_SECTION\n"
+        "1 0\n2 4\n3 5\n4 1\n"
+        "DEPOT_SECTION\n"
+        " 1\n"
+        " -1\n"
+        "EOF\n";
+
+    Instance instance = parseInstance(text, InstanceFormat::Auto);
+
+    EXPECT_EQ(instance.name, "tiny-n4");
+    ASSERT_EQ(instance.size(), 4);
+    EXPECT_DOUBLE_EQ(instance.x[1], 3.5);
+    EXPECT_DOUBLE_EQ(instance.y[2], 20.0);
+    EXPECT_DOUBLE_EQ(instance.capacity, 10.0);
+    EXPECT_EQ(instance.demand, (std::vector<double>{ 0, 4, 5, 1 }));
+    EXPECT_EQ(instance.depots, (std::vector<int>{ 0 }));
+}
+
+TEST(InstanceIoTest, ParsesTimeWindowsAndServiceTimes) {
+    const char* text =
+        "NAME : tiny-tw\n"
+        "DIMENSION : 3\n"
+        "NODE_COORD_SECTION\n"
+        "1 0 0\n2 1 0\n3 0 1\n"
+        "TIME_WINDOW_SECTION\n"
+        "2 10 20\n3 5.5 8\n"
+        "SERVICE_TIME_SECTION\n"
+        "2 3\n"
+        "EOF\n";
+
+    Instance instance = parseInstance(text, InstanceFormat::Tsplib);
+
+    ASSERT_EQ(instance.readyTime.size(), 3u);
+    EXPECT_DOUBLE_EQ(instance.readyTime[1], 10.0);
+    EXPECT_DOUBLE_EQ(instance.dueTime[1], 20.0);
+    EXPECT_DOUBLE_EQ(instance.readyTime[2], 5.5);
+    EXPECT_TRUE(std::isinf(instance.dueTime[0]));
+    EXPECT_EQ(instance.serviceTime, (std::vector<double>{ 0, 3, 0 }));
+    EXPECT_THROW(parseInstance("DIMENSION : 1\nNODE_COORD_SECTION\n1 0 0\nTIME_WINDOW_SECTION\n2 0 1\n",
+        InstanceFormat::Tsplib), std::runtime_error);
+}
+
+TEST(InstanceIoTest, ParsesCsvWithHeaderAndDemands) {
+    Instance instance = parseInstance("x;y;demand\r\n1.5;2;3\r\n4;5;0\r\n", InstanceFormat::Csv);
+
+    ASSERT_EQ(instance.size(), 2);
+    EXPECT_DOUBLE_EQ(instance.x[0], 1.5);
+    EXPECT_EQ(instance.demand, (std::vector<double>{ 3, 0 }));
+}
+
+TEST(InstanceIoTest, RoundTripsBinaryFormat) {
+    Instance instance;
+    instance.x = { 0.0, 1.0, 2.5 };
+    instance.y = { 0.0, -1.0, 4.0 };
+    instance.demand = { 0.0, 2.0, 3.0 };
+    instance.depots = { 0 };
+    instance.capacity = 5.0;
+
+    auto path = (std::filesystem::temp_directory_path() / "cw_roundtrip.cwb").string();
+    saveBinaryInstance(instance, path);
+    Instance loaded = loadInstance(path);
+    std::filesystem::remove(path);
+
+    EXPECT_EQ(loaded.x, instance.x);
+    EXPECT_EQ(loaded.y, instance.y);
+    EXPECT_EQ(loaded.demand, instance.demand);
+    EXPECT_EQ(loaded.depots, instance.depots);
+    EXPECT_DOUBLE_EQ(loaded.capacity, 5.0);
+}
+
+TEST(InstanceIoTest, RejectsDuplicatePoints) {
+    EXPECT_THROW(parseInstance("1,2\n3,4\n1,2\n", InstanceFormat::Csv), std::runtime_error);
+    EXPECT_THROW(parseInstance("0,0\n-0,0\n", InstanceFormat::Csv), std::runtime_error);
+}
+
+TEST(InstanceIoTest, ReportsMalformedLines) {
+    EXPECT_THROW(parseInstance("1,2\n3\n", InstanceFormat::Csv), std::runtime_error);
+    EXPECT_THROW(parseInstance("DIMENSION : 1\nNODE_COORD_SECTION\n2 0 0\n", InstanceFormat::Tsplib), std::runtime_error);
+}
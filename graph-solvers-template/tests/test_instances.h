@@ -0,0 +1,61 @@
+#pragma once
+
+#include <optional>
+#include <random>
+#include <vector>
+
+#include "common/graph.h"
+#include "common/types.h"
+
+// Random instances shared by the solver tests. Everything is drawn from std::mt19937, so a
+// seed gives the same instance on every platform.
+
+/// @return @p n points with coordinates uniform in [0, 100), drawn from @p rng.
+inline std::vector<Point> randomPoints(int n, std::mt19937& rng)
+{
+    std::uniform_real_distribution<double> coord(0.0, 100.0);
+    std::vector<Point> points;
+    for (int i = 0; i < n; ++i) points.push_back({ coord(rng), coord(rng) });
+    return points;
+}
+
+/**
+ * @brief Joins every pair of @p points closer than @p radius by an edge of Euclidean cost.
+ *
+ * @param chain Also joins every pair (i, i + 1), so the graph is connected for any radius.
+ */
+inline Graph radiusGraph(const std::vector<Point>& points, double radius, bool chain = true)
+{
+    const int n = (int)points.size();
+    std::vector<Edge> edges;
+    for (int i = 0; i < n; ++i) {
+        for (int j = i + 1; j < n; ++j) {
+            double d = euclidean(points[i], points[j]);
+            if (d < radius || (chain && j == i + 1)) edges.push_back({ i, j, d });
+        }
+    }
+    return Graph(n, edges);
+}
+
+/// Random points and their radius graph.
+struct RadiusInstance
+{
+    std::vector<Point> points;
+    Graph graph;
+};
+
+/**
+ * @brief Random points joined by all edges shorter than @p radius plus the chain 0-1-...-(n-1).
+ *
+ * @param start If set, node 0 is moved there before the edges are built, e.g. to the middle
+ *              so that sweep sectors around it are meaningful.
+ */
+inline RadiusInstance makeRadiusInstance(int n, double radius, unsigned seed, std::optional<Point> start = std::nullopt)
+{
+    std::mt19937 rng(seed);
+    RadiusInstance instance;
+    instance.points = randomPoints(n, rng);
+    if (start) instance.points[0] = *start;
+    instance.graph = radiusGraph(instance.points, radius);
+    return instance;
+}
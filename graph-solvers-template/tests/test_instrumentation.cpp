@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <new>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include "common/instrumentation.h"
+
+namespace {
+
+std::string readFile(const std::string& path)
+{
+    std::ifstream in(path);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+} // namespace
+
+TEST(InstrumentationTest, CountsEvents) {
+    auto& instrumentation = Instrumentation::instance();
+    instrumentation.reset();
+
+    CW_COUNT(Attempts, 1);
+    CW_COUNT(Attempts, 2);
+    CW_COUNT(FallbackPaths, 1);
+
+    EXPECT_EQ(instrumentation.count(Counter::Attempts), 3u);
+    EXPECT_EQ(instrumentation.count(Counter::FallbackPaths), 1u);
+    EXPECT_EQ(instrumentation.count(Counter::Merges), 0u);
+}
+
+TEST(InstrumentationTest, ScopesReportTimeAndAllocatedBytes) {
+    auto& instrumentation = Instrumentation::instance();
+    instrumentation.reset();
+
+    for (int k = 0; k < 2; ++k) {
+        CW_PROFILE_SCOPE("allocating_stage");
+        std::vector<char> buffer(1 << 16);
+        buffer[k] = 1;
+    }
+
+    std::string report = instrumentation.reportJson();
+    EXPECT_NE(report.find("\"name\": \"allocating_stage\", \"calls\": 2"), std::string::npos) << report;
+    EXPECT_EQ(report.find("\"bytes\": 0 }"), std::string::npos) << report;
+    EXPECT_NE(report.find("\"attempts\": 0"), std::string::npos);
+}
+
+TEST(InstrumentationTest, CountsOverAlignedAllocations) {
+    struct alignas(128) Block { char bytes[200]; };
+
+    std::uint64_t before = Instrumentation::threadAllocatedBytes();
+    Block* block = new Block();
+    Block* blocks = new Block[3];
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(block) % 128, 0u);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(blocks) % 128, 0u);
+    EXPECT_GE(Instrumentation::threadAllocatedBytes() - before, 4 * sizeof(Block));
+    delete block;
+    delete[] blocks;
+
+    Block* optional = new (std::nothrow) Block();
+    ASSERT_NE(optional, nullptr);
+    delete optional;
+}
+
+TEST(InstrumentationTest, WritesChromeTrace) {
+    auto& instrumentation = Instrumentation::instance();
+    instrumentation.reset();
+    {
+        CW_PROFILE_SCOPE("outer");
+        CW_PROFILE_SCOPE("inner");
+    }
+    CW_COUNT(Merges, 5);
+
+    auto path = (std::filesystem::temp_directory_path() / "cw_trace.json").string();
+    instrumentation.writeChromeTrace(path);
+    std::string trace = readFile(path);
+    std::filesystem::remove(path);
+
+    EXPECT_EQ(trace.rfind("{\"traceEvents\":[", 0), 0u);
+    EXPECT_NE(trace.find("\"name\":\"outer\",\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"inner\",\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(trace.find("\"merges\":5"), std::string::npos);
+}
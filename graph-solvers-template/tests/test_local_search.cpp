@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+
+#include "common/graph.h"
+#include "common/thread_pool.h"
+#include "model/local_search.h"
+#include "test_instances.h"
+
+namespace {
+
+double routeCost(const Graph& graph, const std::vector<int>& route)
+{
+    double total = 0.0;
+    for (size_t k = 0; k + 1 < route.size(); ++k)
+        total += graph.cost(graph.edgeId(route[k], route[k + 1]));
+    return total;
+}
+
+// Random points with a chain 1-2-...-(n-2), both terminals linked to every node and short
+// extra edges, so that routes along the index order are valid but far from optimal.
+struct Instance
+{
+    std::vector<Point> points;
+    Graph graph;
+    std::vector<std::vector<int>> routes;
+};
+
+Instance makeInstance(int n, std::vector<int> sizes, unsigned seed)
+{
+    Instance instance;
+    std::mt19937 rng(seed);
+    instance.points = randomPoints(n, rng);
+
+    auto edge = [&](int u, int v) {
+        return Edge{ u, v, euclidean(instance.points[u], instance.points[v]) };
+    };
+    std::vector<Edge> edges;
+    for (int i = 1; i < n - 1; ++i) {
+        edges.push_back(edge(0, i));
+        edges.push_back(edge(i, n - 1));
+        for (int j = i + 1; j < n - 1; ++j) {
+            if (j == i + 1 || euclidean(instance.points[i], instance.points[j]) < 30.0)
+                edges.push_back(edge(i, j));
+        }
+    }
+    instance.graph = Graph(n, edges);
+
+    int next = 1;
+    for (int size : sizes) {
+        auto& route = instance.routes.emplace_back();
+        route.push_back(0);
+        for (int k = 0; k < size; ++k) route.push_back(next++);
+        route.push_back(n - 1);
+    }
+    return instance;
+}
+
+double totalCost(const Instance& instance)
+{
+    double total = 0.0;
+    for (const auto& route : instance.routes) total += routeCost(instance.graph, route);
+    return total;
+}
+
+} // namespace
+
+TEST(LocalSearchTest, TwoOptUncrossesRoute) {
+    Graph graph(4, { { 0, 1, 1.0 }, { 0, 2, 2.0 }, { 0, 3, 3.0 }, { 1, 2, 1.0 }, { 1, 3, 2.0 }, { 2, 3, 1.0 } });
+    std::vector<std::vector<int>> routes = { { 0, 2, 1, 3 } };
+
+    LocalSearchOptions options;
+    options.orOpt = false;
+    options.relocate = false;
+    options.swap = false;
+
+    LocalSearch search;
+    LocalSearchStats stats = search.run(graph, routes, {}, options);
+
+    EXPECT_EQ(routes[0], (std::vector<int>{ 0, 1, 2, 3 }));
+    EXPECT_GE(stats.twoOptMoves, 1);
+    EXPECT_DOUBLE_EQ(stats.gain, 2.0);
+}
+
+TEST(LocalSearchTest, KeepsRoutesOnGraphEdgesAndNodesCovered) {
+    Instance instance = makeInstance(60, { 14, 14, 15, 15 }, 7);
+    double before = totalCost(instance);
+
+    LocalSearchOptions options;
+    options.timeLimitMs = 0.0;
+    LocalSearch search;
+    LocalSearchStats stats = search.run(instance.graph, instance.routes, {}, options);
+
+    ASSERT_EQ(instance.routes.size(), 4u);
+    std::vector<int> seen;
+    for (const auto& route : instance.routes) {
+        ASSERT_GE(route.size(), 3u);
+        EXPECT_EQ(route.front(), 0);
+        EXPECT_EQ(route.back(), 59);
+        for (size_t k = 0; k + 1 < route.size(); ++k)
+            EXPECT_TRUE(instance.graph.hasEdge(route[k], route[k + 1]));
+        seen.insert(seen.end(), route.begin() + 1, route.end() - 1);
+    }
+    std::sort(seen.begin(), seen.end());
+    for (int i = 0; i < (int)seen.size(); ++i) EXPECT_EQ(seen[i], i + 1);
+    EXPECT_EQ(seen.size(), 58u);
+
+    double after = totalCost(instance);
+    EXPECT_GT(stats.gain, 0.0);
+    EXPECT_FALSE(stats.timedOut);
+    EXPECT_NEAR(before - after, stats.gain, 1e-6);
+}
+
+TEST(LocalSearchTest, RespectsCapacity) {
+    Instance instance = makeInstance(40, { 4, 8, 9, 17 }, 11);
+    RouteConstraints constraints;
+    constraints.demands.assign(40, 1.0);
+    constraints.capacity = 17.0;
+
+    LocalSearchOptions options;
+    options.timeLimitMs = 0.0;
+    LocalSearch search;
+    LocalSearchStats stats = search.run(instance.graph, instance.routes, constraints, options);
+
+    EXPECT_GT(stats.relocateMoves + stats.swapMoves, 0);
+    for (const auto& route : instance.routes)
+        EXPECT_LE(route.size() - 2, 17u);
+}
+
+TEST(LocalSearchTest, ParallelIntraPhaseMatchesSerial) {
+    Instance serial = makeInstance(80, { 20, 20, 19, 19 }, 3);
+    Instance parallel = serial;
+
+    LocalSearchOptions options;
+    options.timeLimitMs = 0.0;
+    LocalSearch search;
+    search.run(serial.graph, serial.routes, {}, options);
+
+    ThreadPool pool(4);
+    options.pool = &pool;
+    search.run(parallel.graph, parallel.routes, {}, options);
+
+    EXPECT_EQ(serial.routes, parallel.routes);
+}
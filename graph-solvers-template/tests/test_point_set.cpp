@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "common/distance.h"
+#include "common/point_set.h"
+#include "common/simd.h"
+#include "common/types.h"
+
+namespace {
+
+// Every level this machine can run, from scalar up
+std::vector<SimdLevel> supportedLevels()
+{
+    std::vector<SimdLevel> levels;
+    for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::Avx2, SimdLevel::Avx512 }) {
+        if ((int)level <= (int)detectSimdLevel()) levels.push_back(level);
+    }
+    return levels;
+}
+
+// Restores the detected level when a test ends
+struct LevelGuard
+{
+    ~LevelGuard() { setSimdLevel(detectSimdLevel()); }
+};
+
+// Edges between scattered vertices; the count is odd so the vector loops leave a tail
+std::vector<Edge> randomEdges(int n, int count)
+{
+    std::vector<Edge> edges;
+    for (int k = 0; k < count; ++k) {
+        int u = (int)((k * 7919ll) % n), v = (int)((k * 104729ll + 13) % n);
+        edges.push_back({ u, v, 0.25 * k });
+    }
+    return edges;
+}
+
+} // namespace
+
+TEST(PointSetTest, DoubleKernelsMatchEuclideanAtEveryLevel) {
+    LevelGuard guard;
+    auto points = generateUniquePoints(1003, 0.0, 0.0, 1000.0, 1000.0, 4);
+    PointSet set(points);
+    auto edges = randomEdges((int)points.size(), 517);
+    std::vector<int> targets;
+    for (const Edge& e : edges) targets.push_back(e.v);
+
+    for (SimdLevel level : supportedLevels()) {
+        SCOPED_TRACE(simdLevelName(level));
+        setSimdLevel(level);
+
+        std::vector<double> row(points.size()), gathered(targets.size()), lengths(edges.size());
+        set.distancesFrom(points[17], row);
+        set.distancesFrom(17, targets, gathered);
+        set.edgeLengths(edges, lengths);
+        for (std::size_t j = 0; j < points.size(); ++j)
+            ASSERT_EQ(row[j], euclidean(points[j], points[17]));
+        for (std::size_t k = 0; k < targets.size(); ++k)
+            ASSERT_EQ(gathered[k], euclidean(points[17], points[targets[k]]));
+        for (std::size_t k = 0; k < edges.size(); ++k)
+            ASSERT_EQ(lengths[k], euclidean(points[edges[k].u], points[edges[k].v]));
+    }
+}
+
+TEST(PointSetTest, SavingsMatchScalarFormula) {
+    LevelGuard guard;
+    auto points = generateUniquePoints(300, 0.0, 0.0, 40.0, 40.0, 9);
+    auto edges = randomEdges((int)points.size(), 301);
+    std::vector<double> depot(points.size());
+    PointSet(points).distancesFrom(points[0], depot);
+
+    for (SimdLevel level : supportedLevels()) {
+        SCOPED_TRACE(simdLevelName(level));
+        setSimdLevel(level);
+        std::vector<double> savings(edges.size());
+        computeSavings(depot, edges, savings);
+        for (std::size_t k = 0; k < edges.size(); ++k)
+            ASSERT_EQ(savings[k], depot[edges[k].u] + depot[edges[k].v] - edges[k].cost);
+    }
+}
+
+TEST(PointSetTest, SinglePrecisionStaysClose) {
+    LevelGuard guard;
+    auto points = generateUniquePoints(777, 0.0, 0.0, 40.0, 40.0, 2);
+    PointSet set(points, Precision::Single);
+    EXPECT_EQ(set.precision(), Precision::Single);
+    auto edges = randomEdges((int)points.size(), 333);
+
+    std::vector<double> reference(edges.size());
+    setSimdLevel(SimdLevel::Scalar);
+    set.edgeLengths(edges, reference);
+    for (SimdLevel level : supportedLevels()) {
+        SCOPED_TRACE(simdLevelName(level));
+        setSimdLevel(level);
+        std::vector<double> row(points.size()), lengths(edges.size());
+        set.distancesFrom(points[5], row);
+        set.edgeLengths(edges, lengths);
+        for (std::size_t j = 0; j < points.size(); ++j)
+            ASSERT_NEAR(row[j], euclidean(points[j], points[5]), 1e-5);
+        for (std::size_t k = 0; k < edges.size(); ++k) {
+            ASSERT_EQ(lengths[k], reference[k]);  // IEEE float ops: same at every level
+            ASSERT_NEAR(lengths[k], euclidean(points[edges[k].u], points[edges[k].v]), 1e-5);
+        }
+    }
+}
+
+TEST(PointSetTest, LevelSelection) {
+    LevelGuard guard;
+    setSimdLevel(SimdLevel::Avx512);
+    EXPECT_EQ(simdLevel(), detectSimdLevel());
+    setSimdLevel(SimdLevel::Scalar);
+    EXPECT_EQ(simdLevel(), SimdLevel::Scalar);
+    for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::Avx2, SimdLevel::Avx512 })
+        EXPECT_EQ(parseSimdLevel(simdLevelName(level)), level);
+    EXPECT_THROW(parseSimdLevel("sse9"), std::invalid_argument);
+
+    // EuclideanDistances answers columns through the same kernels
+    auto points = generateUniquePoints(50, 0.0, 0.0, 40.0, 40.0, 1);
+    EuclideanDistances distances(points);
+    std::vector<double> column(points.size());
+    distances.column(49, column);
+    for (int i = 0; i < 50; ++i) EXPECT_EQ(column[i], distances.distance(i, 49));
+}
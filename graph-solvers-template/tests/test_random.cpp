@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "common/random.h"
+#include "common/types.h"
+
+TEST(RandomTest, PhiloxMatchesKnownAnswers) {
+    // Known-answer vectors of the Random123 reference implementation (philox4x32_10)
+    EXPECT_EQ(Philox4x32::generate({ 0, 0, 0, 0 }, { 0, 0 }),
+        (Philox4x32::Counter{ 0x6627e8d5u, 0xe169c58du, 0xbc57ac4cu, 0x9b00dbd8u }));
+    EXPECT_EQ(Philox4x32::generate({ 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu }, { 0xffffffffu, 0xffffffffu }),
+        (Philox4x32::Counter{ 0x408f276du, 0x41c83b0eu, 0xa20bc7c6u, 0x6d5451fdu }));
+    EXPECT_EQ(Philox4x32::generate({ 0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u }, { 0xa4093822u, 0x299f31d0u }),
+        (Philox4x32::Counter{ 0xd16cfe09u, 0x94fdccebu, 0x5001e420u, 0x24126ea1u }));
+}
+
+TEST(RandomTest, FillMatchesPointwiseValues) {
+    CounterRng rng(12345, 7);
+    std::vector<double> a(1003), b(1003);
+    rng.fill(40, a, b);
+    for (int i = 0; i < 1003; ++i) {
+        auto u = rng.uniform2(40 + i);
+        ASSERT_EQ(a[i], u[0]);
+        ASSERT_EQ(b[i], u[1]);
+        EXPECT_GE(a[i], 0.0);
+        EXPECT_LT(a[i], 1.0);
+    }
+}
+
+TEST(RandomTest, StreamsAndSeedsAreIndependent) {
+    CounterRng base(1, 0), otherStream(1, 1), otherSeed(2, 0);
+    int sameStream = 0, sameSeed = 0;
+    double mean = 0.0;
+    for (int i = 0; i < 10000; ++i) {
+        sameStream += base.bits(i) == otherStream.bits(i);
+        sameSeed += base.bits(i) == otherSeed.bits(i);
+        mean += base.uniform(i);
+    }
+    EXPECT_EQ(sameStream, 0);
+    EXPECT_EQ(sameSeed, 0);
+    EXPECT_NEAR(mean / 10000, 0.5, 0.02);
+}
+
+TEST(RandomTest, EngineWalksTheStream) {
+    CounterEngine engine(99, 3);
+    CounterRng rng(99, 3);
+    for (int i = 0; i < 5; ++i) EXPECT_EQ(engine(), rng.bits(i));
+    EXPECT_EQ(engine.position(), 5u);
+
+    std::vector<int> a = { 1, 2, 3, 4, 5, 6, 7, 8 }, b = a;
+    std::shuffle(a.begin(), a.end(), CounterEngine(5));
+    std::shuffle(b.begin(), b.end(), CounterEngine(5));
+    EXPECT_EQ(a, b);
+}
+
+TEST(RandomTest, SeededPointsAreReproducible) {
+    auto a = generateUniquePoints(200, 0.0, 0.0, 40.0, 40.0, 42);
+    auto b = generateUniquePoints(200, 0.0, 0.0, 40.0, 40.0, 42);
+    auto c = generateUniquePoints(200, 0.0, 0.0, 40.0, 40.0, 43);
+    ASSERT_EQ(a.size(), 200u);
+    for (size_t i = 0; i < a.size(); ++i) {
+        EXPECT_EQ(a[i].x, b[i].x);
+        EXPECT_EQ(a[i].y, b[i].y);
+    }
+    EXPECT_NE(a[0].x, c[0].x);
+}
@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "common/graph.h"
+#include "common/simd.h"
+#include "model/route_fingerprint.h"
+#include "model/solver.h"
+
+namespace {
+
+using Route = std::vector<std::pair<int, int>>;
+
+// Complete graph on n nodes, so that every node pair is an edge
+Graph completeGraph(int n)
+{
+    std::vector<Edge> edges;
+    for (int i = 0; i < n; ++i) {
+        for (int j = i + 1; j < n; ++j) edges.push_back({ i, j, 1.0 });
+    }
+    return Graph(n, edges);
+}
+
+// Path through @p length distinct random nodes of [0, n)
+Route randomRoute(int n, int length, std::mt19937& rng)
+{
+    std::vector<int> nodes(n);
+    for (int i = 0; i < n; ++i) nodes[i] = i;
+    std::shuffle(nodes.begin(), nodes.end(), rng);
+    Route route;
+    for (int k = 0; k + 1 < length; ++k) route.emplace_back(nodes[k], nodes[k + 1]);
+    return route;
+}
+
+// Copy of @p route with @p changed of its edges replaced by other random edges
+Route perturb(const Route& route, int n, int changed, std::mt19937& rng)
+{
+    Route result = route;
+    std::uniform_int_distribution<int> node(0, n - 1);
+    for (int k = 0; k < changed && k < (int)result.size(); ++k) {
+        int u = node(rng), v = node(rng);
+        while (v == u) v = node(rng);
+        result[k] = { u, v };
+    }
+    return result;
+}
+
+// Jaccard similarity of the undirected edge sets, from std::set
+double referenceJaccard(const Route& a, const Route& b)
+{
+    auto edgeSet = [](const Route& route) {
+        std::set<std::pair<int, int>> edges;
+        for (auto [u, v] : route) edges.insert({ std::min(u, v), std::max(u, v) });
+        return edges;
+    };
+    auto ea = edgeSet(a), eb = edgeSet(b);
+    int common = 0;
+    for (const auto& edge : ea) common += (int)eb.count(edge);
+    int unionSize = (int)(ea.size() + eb.size()) - common;
+    return unionSize == 0 ? 0.0 : (double)common / unionSize;
+}
+
+} // namespace
+
+TEST(RouteFingerprintTest, RouteSimilarityIsExactJaccard) {
+    Route a = { { 0, 1 }, { 1, 2 }, { 2, 3 }, { 1, 2 } };
+    Route b = { { 1, 2 }, { 2, 3 }, { 3, 4 } };
+    EXPECT_DOUBLE_EQ(routeSimilarity(a, b), 2.0 / 4.0);
+    EXPECT_DOUBLE_EQ(routeSimilarity(a, a), 1.0);
+    EXPECT_DOUBLE_EQ(routeSimilarity({}, {}), 0.0);
+
+    // Edges are compared as given
+    Route reversed = { { 1, 0 }, { 2, 1 }, { 3, 2 } };
+    EXPECT_DOUBLE_EQ(routeSimilarity(a, reversed), 0.0);
+}
+
+TEST(RouteFingerprintTest, JaccardMatchesReferenceOnEveryKernel) {
+    const int n = 120;  // 7140 edges: windows of up to 112 words
+    Graph graph = completeGraph(n);
+    std::mt19937 rng(1);
+    const SimdLevel detected = detectSimdLevel();
+
+    for (int trial = 0; trial < 200; ++trial) {
+        Route a = randomRoute(n, 2 + trial % 60, rng);
+        Route b = trial % 3 == 0 ? randomRoute(n, 2 + trial % 40, rng) : perturb(a, n, trial % 7, rng);
+        RouteFingerprint fa(graph, a), fb(graph, b);
+        double expected = referenceJaccard(a, b);
+
+        setSimdLevel(SimdLevel::Scalar);
+        EXPECT_DOUBLE_EQ(jaccard(fa, fb), expected);
+        setSimdLevel(detected);
+        EXPECT_DOUBLE_EQ(jaccard(fa, fb), expected);
+        EXPECT_DOUBLE_EQ(jaccard(fb, fa), expected);
+    }
+    setSimdLevel(detected);
+}
+
+TEST(RouteFingerprintTest, IgnoresOrientationDuplicatesAndNonEdges) {
+    Graph graph(5, { { 0, 1, 1.0 }, { 1, 2, 1.0 }, { 2, 3, 1.0 } });
+    RouteFingerprint forward(graph, Route{ { 0, 1 }, { 1, 2 }, { 2, 3 } });
+    RouteFingerprint backward(graph, Route{ { 3, 2 }, { 2, 1 }, { 1, 0 }, { 1, 0 }, { 3, 4 } });
+    EXPECT_EQ(forward.edgeCount(), 3);
+    EXPECT_EQ(backward.edgeCount(), 3);
+    EXPECT_DOUBLE_EQ(jaccard(forward, backward), 1.0);
+    EXPECT_DOUBLE_EQ(estimateJaccard(forward, backward), 1.0);
+    EXPECT_DOUBLE_EQ(jaccard(RouteFingerprint(), RouteFingerprint()), 0.0);
+}
+
+TEST(RouteFingerprintTest, EdgeCountBoundSkipsOnlyDissimilarPairs) {
+    Graph graph = completeGraph(30);
+    std::vector<int> path(30);
+    for (int i = 0; i < 30; ++i) path[i] = i;
+    Route longRoute, shortRoute;
+    for (int k = 0; k + 1 < 30; ++k) longRoute.emplace_back(path[k], path[k + 1]);
+    shortRoute.assign(longRoute.begin(), longRoute.begin() + 5);
+
+    // The short route lies inside the long one: similarity 5/29, below any limit above it
+    DiversityFilter filter;
+    filter.add(RouteFingerprint(graph, longRoute));
+    EXPECT_TRUE(filter.isDifferent(RouteFingerprint(graph, shortRoute), 0.4));
+    EXPECT_FALSE(filter.isDifferent(RouteFingerprint(graph, shortRoute), 0.9));
+    EXPECT_FALSE(filter.isDifferent(RouteFingerprint(graph, longRoute), 0.4));
+}
+
+TEST(RouteFingerprintTest, ExactFilterMatchesBruteForce) {
+    const int n = 60;
+    Graph graph = completeGraph(n);
+    std::mt19937 rng(2);
+    DiversityFilter filter;
+    std::vector<Route> accepted;
+
+    for (int trial = 0; trial < 300 && (int)accepted.size() < 50; ++trial) {
+        Route candidate = accepted.empty() || trial % 2 ? randomRoute(n, 10 + trial % 20, rng)
+            : perturb(accepted[trial % accepted.size()], n, 1 + trial % 8, rng);
+        bool expected = std::all_of(accepted.begin(), accepted.end(),
+            [&](const Route& route) { return referenceJaccard(candidate, route) <= 0.6; });
+        RouteFingerprint print(graph, candidate);
+        ASSERT_EQ(filter.isDifferent(print, 0.4), expected);
+        if (expected) {
+            filter.add(print);
+            accepted.push_back(candidate);
+        }
+    }
+}
+
+TEST(RouteFingerprintTest, BandingIndexOnlyEverAcceptsMore) {
+    const int n = 200;
+    Graph graph = completeGraph(n);
+    std::mt19937 rng(3);
+    DiversityFilter banded(1), exact(1 << 30);
+    std::vector<Route> accepted;
+    for (int k = 0; k < 80; ++k) {
+        Route route = randomRoute(n, 20 + k % 30, rng);
+        accepted.push_back(route);
+        banded.add(RouteFingerprint(graph, route));
+        exact.add(RouteFingerprint(graph, route));
+    }
+
+    int rejectedNearDuplicates = 0, missed = 0;
+    for (int trial = 0; trial < 400; ++trial) {
+        Route candidate = perturb(accepted[trial % accepted.size()], n, trial % 25, rng);
+        RouteFingerprint print(graph, candidate);
+        bool fromIndex = banded.isDifferent(print, 0.4);
+        bool fromAll = exact.isDifferent(print, 0.4);
+
+        // The index may miss a too-similar route, never invent one
+        if (!fromAll && fromIndex) ++missed;
+        EXPECT_TRUE(fromIndex || !fromAll);
+        if (trial % 25 <= 1) {
+            EXPECT_FALSE(fromIndex) << "near-duplicate accepted at trial " << trial;
+            ++rejectedNearDuplicates;
+        }
+    }
+    EXPECT_GT(rejectedNearDuplicates, 0);
+    EXPECT_LT(missed, 40);
+}
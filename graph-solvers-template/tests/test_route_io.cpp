@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include "model/route_io.h"
+
+namespace {
+
+// Square 0-1-2-3 with one diagonal; routes run from 0 to 3
+struct Fixture
+{
+    std::vector<Point> points = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 } };
+    Graph graph = Graph(4, { { 0, 1, 1.0 }, { 1, 2, 1.0 }, { 2, 3, 1.0 }, { 0, 3, 1.0 }, { 0, 2, 1.5 } });
+    std::vector<std::vector<std::pair<int, int>>> routes = { { { 0, 1 }, { 1, 2 }, { 2, 3 } }, { { 0, 2 }, { 2, 3 } }, {} };
+};
+
+std::string render(const Fixture& f, RouteFormat format)
+{
+    std::ostringstream out;
+    RouteWriter writer(out, format, f.graph, &f.points);
+    for (const auto& route : f.routes) writer.write(route);
+    writer.finish();
+    EXPECT_EQ(writer.routesWritten(), 3);
+    return out.str();
+}
+
+} // namespace
+
+TEST(RouteIoTest, TextMatchesSolverListing) {
+    Fixture f;
+    EXPECT_EQ(render(f, RouteFormat::Text),
+        "\n=== ZNALEZIONE TRASY ===\n"
+        "Trasa 0: 0 -> 1 -> 2 -> 3 | Dlugosc: 3.00\n"
+        "Trasa 1: 0 -> 2 -> 3 | Dlugosc: 2.50\n"
+        "Trasa 2: PUSTA\n"
+        "========================\n\n");
+}
+
+TEST(RouteIoTest, JsonCsvAndGeoJson) {
+    Fixture f;
+    EXPECT_EQ(render(f, RouteFormat::Json),
+        "{\"routes\":[\n"
+        "{\"route\":0,\"length\":3,\"nodes\":[0,1,2,3]},\n"
+        "{\"route\":1,\"length\":2.5,\"nodes\":[0,2,3]},\n"
+        "{\"route\":2,\"length\":0,\"nodes\":[]}\n]}\n");
+    EXPECT_EQ(render(f, RouteFormat::Csv),
+        "route,length,nodes\n0,3,0 1 2 3\n1,2.5,0 2 3\n2,0,\n");
+
+    std::string geo = render(f, RouteFormat::GeoJson);
+    EXPECT_EQ(geo.rfind("{\"type\":\"FeatureCollection\"", 0), 0u);
+    EXPECT_NE(geo.find("\"coordinates\":[[0,0],[1,1],[0,1]]"), std::string::npos);
+
+    std::ostringstream out;
+    EXPECT_THROW({ RouteWriter writer(out, RouteFormat::GeoJson, f.graph); }, std::invalid_argument);
+}
+
+TEST(RouteIoTest, BinaryRoundTrips) {
+    Fixture f;
+    // A long route with large jumps exercises multi-byte and negative deltas
+    std::vector<std::pair<int, int>> jumps = { { 0, 100000 }, { 100000, 5 }, { 5, 70000 } };
+    f.routes[2] = jumps;
+
+    std::istringstream in(render(f, RouteFormat::Binary));
+    auto stored = readBinaryRoutes(in);
+
+    ASSERT_EQ(stored.size(), 3u);
+    EXPECT_EQ(stored[0].nodes, (std::vector<int>{ 0, 1, 2, 3 }));
+    EXPECT_DOUBLE_EQ(stored[0].length, 3.0);
+    EXPECT_EQ(stored[1].nodes, (std::vector<int>{ 0, 2, 3 }));
+    EXPECT_DOUBLE_EQ(stored[1].length, 2.5);
+    EXPECT_EQ(stored[2].nodes, (std::vector<int>{ 0, 100000, 5, 70000 }));
+
+    std::istringstream truncated(render(f, RouteFormat::Binary).substr(0, 10));
+    EXPECT_THROW(readBinaryRoutes(truncated), std::runtime_error);
+}
+
+TEST(RouteIoTest, FormatFromExtension) {
+    EXPECT_EQ(routeFormatFromPath("out.cwr"), RouteFormat::Binary);
+    EXPECT_EQ(routeFormatFromPath("out.JSON"), RouteFormat::Json);
+    EXPECT_EQ(routeFormatFromPath("out.geojson"), RouteFormat::GeoJson);
+    EXPECT_EQ(routeFormatFromPath("out.csv"), RouteFormat::Csv);
+    EXPECT_EQ(routeFormatFromPath("out.txt"), RouteFormat::Text);
+}
@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+
+#include "model/route_store.h"
+
+TEST(RouteStoreTest, StartsWithSingletonRoutes) {
+    RouteStore routes;
+    routes.reset(5, 0, 4);
+
+    EXPECT_EQ(routes.routeCount(), 3);
+    EXPECT_FALSE(routes.contains(0));
+    EXPECT_FALSE(routes.contains(4));
+    EXPECT_TRUE(routes.isFirst(2));
+    EXPECT_TRUE(routes.isLast(2));
+
+    std::vector<int> seq;
+    routes.materialize(routes.routeOf(2), seq);
+    EXPECT_EQ(seq, (std::vector<int>{ 0, 2, 4 }));
+}
+
+TEST(RouteStoreTest, MergesAndTracksEndpoints) {
+    RouteStore routes;
+    routes.reset(6, 0, 5);
+
+    routes.merge(1, 2);
+    routes.merge(3, 4);
+    int merged = routes.merge(2, 3);
+
+    EXPECT_EQ(routes.routeCount(), 1);
+    EXPECT_EQ(routes.routeOf(1), routes.routeOf(4));
+    EXPECT_EQ(routes.head(merged), 1);
+    EXPECT_EQ(routes.tail(merged), 4);
+    EXPECT_EQ(routes.size(merged), 4);
+    EXPECT_FALSE(routes.isLast(2));
+    EXPECT_FALSE(routes.isFirst(3));
+
+    std::vector<int> seq;
+    routes.materialize(merged, seq);
+    EXPECT_EQ(seq, (std::vector<int>{ 0, 1, 2, 3, 4, 5 }));
+}
+
+TEST(RouteStoreTest, ListsEachRouteOnce) {
+    RouteStore routes;
+    routes.reset(5, 0, 4);
+    routes.merge(3, 1);
+
+    std::vector<int> ids;
+    routes.routes(ids);
+    ASSERT_EQ(ids.size(), 2u);
+    EXPECT_EQ(ids[0], routes.routeOf(1));
+    EXPECT_EQ(ids[1], routes.routeOf(2));
+}
+
+TEST(RouteStoreTest, JoinsEndpointsInAnyOrientation) {
+    RouteStore routes;
+    routes.reset(6, 0, 5);
+
+    routes.merge(1, 2);
+    routes.merge(3, 4);
+    // Head of the first route to tail of the second: both routes are reversed.
+    int merged = routes.merge(1, 4);
+
+    std::vector<int> seq;
+    routes.materialize(merged, seq);
+    EXPECT_EQ(seq, (std::vector<int>{ 0, 2, 1, 4, 3, 5 }));
+
+    routes.reverse(merged);
+    routes.materialize(merged, seq);
+    EXPECT_EQ(seq, (std::vector<int>{ 0, 3, 4, 1, 2, 5 }));
+    EXPECT_TRUE(routes.isEndpoint(3));
+    EXPECT_FALSE(routes.isEndpoint(4));
+}
+
+TEST(RouteStoreTest, TracksLoadAndCost) {
+    std::vector<double> demands = { 0.0, 1.0, 2.0, 3.0, 0.0 };
+    RouteStore routes;
+    routes.reset(5, 0, 4, demands);
+
+    routes.merge(1, 2, 1.5);
+    int merged = routes.merge(3, 2, 2.5);
+
+    EXPECT_DOUBLE_EQ(routes.load(merged), 6.0);
+    EXPECT_DOUBLE_EQ(routes.cost(merged), 4.0);
+}
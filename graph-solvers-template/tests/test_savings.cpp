@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "common/graph.h"
+#include "model/savings.h"
+#include "test_instances.h"
+
+namespace {
+
+// Random points joined by all edges shorter than 35, with terminals 0 and n - 1
+using Instance = RadiusInstance;
+
+Instance makeInstance(int n, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    Instance instance;
+    instance.points = randomPoints(n, rng);
+    instance.graph = radiusGraph(instance.points, 35.0, false);
+    return instance;
+}
+
+std::vector<Saving> drain(SavingsQueue& queue)
+{
+    std::vector<Saving> popped;
+    Saving s;
+    while (queue.pop(s)) popped.push_back(s);
+    return popped;
+}
+
+} // namespace
+
+TEST(SavingsTest, BaseSavingsFollowDefinition) {
+    const int n = 50;
+    Instance instance = makeInstance(n, 1);
+    SavingsList list(instance.points, instance.graph, 0, n - 1);
+
+    int expected = 0;
+    for (int id = 0; id < instance.graph.edgeCount(); ++id) {
+        const Edge& e = instance.graph.edge(id);
+        if (e.u != 0 && e.v != 0 && e.u != n - 1 && e.v != n - 1) ++expected;
+    }
+    ASSERT_EQ(list.size(), expected);
+    for (int k = 0; k < list.size(); ++k) {
+        const Saving& s = list[k];
+        EXPECT_NE(s.i, 0);
+        EXPECT_NE(s.j, n - 1);
+        double c0i = euclidean(instance.points[0], instance.points[s.i]);
+        double c0j = euclidean(instance.points[0], instance.points[s.j]);
+        EXPECT_NEAR(s.value, c0i + c0j - instance.graph.cost(s.edge), 1e-9);
+        EXPECT_DOUBLE_EQ(list.edgeCost(k), instance.graph.cost(s.edge));
+    }
+}
+
+TEST(SavingsTest, QueuePopsPerturbedSavingsInNonIncreasingOrder) {
+    const int n = 60;
+    Instance instance = makeInstance(n, 2);
+    SavingsList list(instance.points, instance.graph, 0, n - 1);
+
+    std::mt19937 rng(9);
+    std::uniform_real_distribution<double> noise(0.8, 1.2);
+    std::vector<double> multipliers(list.size());
+    for (double& m : multipliers) m = noise(rng);
+
+    SavingsQueue queue;
+    queue.reset(list, [&](int k) { return multipliers[k]; });
+    auto popped = drain(queue);
+
+    ASSERT_EQ((int)popped.size(), list.size());
+    EXPECT_TRUE(queue.empty());
+    for (std::size_t k = 1; k < popped.size(); ++k) EXPECT_GE(popped[k - 1].value, popped[k].value);
+}
+
+TEST(SavingsTest, PerturbationMatchesRecomputedSavings) {
+    const int n = 40;
+    Instance instance = makeInstance(n, 3);
+    SavingsList list(instance.points, instance.graph, 0, n - 1);
+
+    // Multiplier per edge, applied once as a delta and once by rebuilding on scaled costs
+    std::mt19937 rng(4);
+    std::uniform_real_distribution<double> noise(0.5, 1.5);
+    std::vector<double> byEdge(instance.graph.edgeCount());
+    for (double& m : byEdge) m = noise(rng);
+
+    Graph scaled = instance.graph;
+    for (int id = 0; id < scaled.edgeCount(); ++id) scaled.setCost(id, scaled.cost(id) * byEdge[id]);
+    SavingsList recomputed(instance.points, scaled, 0, n - 1);
+
+    SavingsQueue queue;
+    queue.reset(list, [&](int k) { return byEdge[list[k].edge]; });
+    std::vector<double> value(instance.graph.edgeCount(), 0.0);
+    for (const Saving& s : drain(queue)) value[s.edge] = s.value;
+
+    ASSERT_EQ(recomputed.size(), list.size());
+    for (int k = 0; k < recomputed.size(); ++k)
+        EXPECT_NEAR(value[recomputed[k].edge], recomputed[k].value, 1e-9);
+}
+
+TEST(SavingsTest, ReusedQueueKeepsNoStaleEntries) {
+    Instance large = makeInstance(60, 5);
+    Instance small = makeInstance(20, 6);
+    SavingsList largeList(large.points, large.graph, 0, 59);
+    SavingsList smallList(small.points, small.graph, 0, 19);
+    ASSERT_GT(largeList.size(), smallList.size());
+
+    auto edgesOf = [](std::vector<Saving> savings) {
+        std::vector<int> edges;
+        for (const Saving& s : savings) edges.push_back(s.edge);
+        std::sort(edges.begin(), edges.end());
+        return edges;
+    };
+    std::vector<int> smallEdges;
+    for (int k = 0; k < smallList.size(); ++k) smallEdges.push_back(smallList[k].edge);
+    std::sort(smallEdges.begin(), smallEdges.end());
+
+    // A partly consumed attempt on the large list, then full attempts on the small one
+    SavingsQueue queue;
+    queue.reset(largeList);
+    Saving s;
+    for (int k = 0; k < 10; ++k) ASSERT_TRUE(queue.pop(s));
+
+    queue.reset(smallList, [](int) { return 1.1; });
+    EXPECT_EQ(edgesOf(drain(queue)), smallEdges);
+
+    // Unperturbed again: the 1.1 multiplier must not leak into the next attempt
+    queue.reset(smallList);
+    auto popped = drain(queue);
+    EXPECT_EQ(edgesOf(popped), smallEdges);
+    for (const Saving& saving : popped) {
+        EXPECT_NEAR(saving.value, euclidean(small.points[0], small.points[saving.i])
+            + euclidean(small.points[0], small.points[saving.j]) - small.graph.cost(saving.edge), 1e-9);
+    }
+    EXPECT_FALSE(queue.pop(s));
+}
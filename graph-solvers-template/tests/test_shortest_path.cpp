@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <queue>
+#include <random>
+#include <set>
+
+#include "common/graph.h"
+#include "model/shortest_path.h"
+
+namespace {
+
+// Plain Dijkstra used as the reference distance.
+double referenceDistance(const Graph& graph, int source, int target, const std::set<int>& blocked) {
+    std::vector<double> dist(graph.vertexCount(), std::numeric_limits<double>::infinity());
+    std::priority_queue<std::pair<double, int>, std::vector<std::pair<double, int>>, std::greater<>> pq;
+    dist[source] = 0;
+    pq.push({ 0, source });
+    while (!pq.empty()) {
+        auto [d, u] = pq.top();
+        pq.pop();
+        if (d > dist[u]) continue;
+        auto nbrs = graph.neighbours(u);
+        auto ids = graph.incidentEdges(u);
+        for (size_t k = 0; k < nbrs.size(); ++k) {
+            int v = nbrs[k];
+            if (blocked.count(v) && v != target) continue;
+            if (d + graph.cost(ids[k]) < dist[v]) {
+                dist[v] = d + graph.cost(ids[k]);
+                pq.push({ dist[v], v });
+            }
+        }
+    }
+    return dist[target];
+}
+
+struct RandomInstance {
+    std::vector<Point> points;
+    Graph graph;
+};
+
+RandomInstance makeInstance(int n, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> coord(0.0, 40.0);
+    std::uniform_real_distribution<double> detour(1.0, 1.5);
+    std::uniform_int_distribution<int> pick(0, n - 1);
+
+    RandomInstance instance;
+    for (int i = 0; i < n; ++i)
+        instance.points.push_back({ coord(gen), coord(gen) });
+
+    std::vector<Edge> edges;
+    for (int k = 0; k < 4 * n; ++k) {
+        int u = pick(gen), v = pick(gen);
+        edges.push_back({ u, v, euclidean(instance.points[u], instance.points[v]) * detour(gen) });
+    }
+    instance.graph = Graph(n, edges);
+    return instance;
+}
+
+double pathLength(const Graph& graph, const std::vector<int>& path) {
+    double length = 0.0;
+    for (size_t i = 0; i + 1 < path.size(); ++i) {
+        int id = graph.edgeId(path[i], path[i + 1]);
+        EXPECT_NE(id, Graph::npos);
+        length += graph.cost(id);
+    }
+    return length;
+}
+
+} // namespace
+
+TEST(ShortestPathTest, MatchesDijkstraWithBothHeaps) {
+    for (unsigned seed = 1; seed <= 20; ++seed) {
+        auto instance = makeInstance(120, seed);
+        ShortestPathEngine binary(instance.points, instance.graph, HeapKind::Binary);
+        ShortestPathEngine radix(instance.points, instance.graph, HeapKind::Radix);
+        std::set<int> blocked = { 5, 17, 42, 77 };
+
+        for (int query = 0; query < 10; ++query) {
+            int source = (int)(seed * 7 + query * 13) % 120;
+            int target = (int)(seed * 3 + query * 29 + 60) % 120;
+            double expected = referenceDistance(instance.graph, source, target, blocked);
+
+            for (auto* engine : { &binary, &radix }) {
+                std::vector<int> path;
+                bool found = engine->findPath(source, target, blocked, path);
+                ASSERT_EQ(found, expected != std::numeric_limits<double>::infinity());
+                if (!found) continue;
+
+                EXPECT_EQ(path.front(), source);
+                EXPECT_EQ(path.back(), target);
+                EXPECT_NEAR(engine->lastDistance(), expected, 1e-9);
+                EXPECT_NEAR(pathLength(instance.graph, path), expected, 1e-9);
+                for (size_t i = 1; i + 1 < path.size(); ++i)
+                    EXPECT_EQ(blocked.count(path[i]), 0u);
+            }
+        }
+    }
+}
+
+TEST(ShortestPathTest, ReportsMissingPath) {
+    std::vector<Point> points = { { 0, 0 }, { 1, 0 }, { 2, 0 } };
+    Graph graph(3, { { 0, 1, 1.0 }, { 1, 2, 1.0 } });
+    ShortestPathEngine engine(points, graph);
+
+    std::vector<int> path;
+    EXPECT_TRUE(engine.findPath(0, 2, path));
+    EXPECT_EQ(path, (std::vector<int>{ 0, 1, 2 }));
+    EXPECT_FALSE(engine.findPath(0, 2, std::vector<int>{ 1 }, path));
+    EXPECT_TRUE(path.empty());
+}
+
+TEST(ShortestPathTest, RadixHeapPopsInOrder) {
+    RadixHeap heap;
+    for (double key : { 5.0, 1.5, 3.25, 1.5, 8.0 })
+        heap.push(key, (int)key);
+
+    std::vector<double> popped;
+    while (!heap.empty()) {
+        popped.push_back(heap.minKey());
+        heap.pop();
+        if (popped.size() == 2) heap.push(2.0, 2);
+    }
+    EXPECT_EQ(popped, (std::vector<double>{ 1.5, 1.5, 2.0, 3.25, 5.0, 8.0 }));
+}
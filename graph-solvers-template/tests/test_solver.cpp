@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "common/thread_pool.h"
+#include "common/types.h"
+#include "geometry/triangulation.h"
+#include "model/solver.h"
+
+namespace {
+
+// Fixed-seed random points and their Delaunay graph
+struct Instance
+{
+    std::vector<Point> points;
+    Graph graph;
+};
+
+Instance makeInstance(int n, std::uint64_t seed)
+{
+    Instance instance;
+    instance.points = generateUniquePoints(n, 0.0, 0.0, 40.0, 40.0, seed);
+    instance.graph = buildDelaunayGraph(instance.points).graph;
+    return instance;
+}
+
+MultiRouteOptions quietOptions(std::uint64_t seed)
+{
+    MultiRouteOptions options;
+    options.seed = seed;
+    options.printRoutes = false;
+    options.localSearch.enabled = true;
+    options.localSearch.timeLimitMs = 0.0;  // a time limit would make the routes depend on timing
+    return options;
+}
+
+} // namespace
+
+TEST(MultiRouteTest, SameRoutesForAnyThreadCount) {
+    Instance instance = makeInstance(120, 21);
+
+    MultiRouteOptions options = quietOptions(77);
+    options.threads = 1;
+    auto serial = solveMultipleRoutes(instance.points, instance.graph, 12, options);
+    ASSERT_FALSE(serial.empty());
+
+    options.threads = 4;
+    EXPECT_EQ(solveMultipleRoutes(instance.points, instance.graph, 12, options), serial);
+
+    ThreadPool pool(3);
+    options.pool = &pool;
+    EXPECT_EQ(solveMultipleRoutes(instance.points, instance.graph, 12, options), serial);
+
+    // The batch size changes which attempts see which used nodes, the thread count does not
+    options.batchSize = 3;
+    auto smallBatches = solveMultipleRoutes(instance.points, instance.graph, 12, options);
+    options.pool = nullptr;
+    options.threads = 2;
+    EXPECT_EQ(solveMultipleRoutes(instance.points, instance.graph, 12, options), smallBatches);
+}
+
+TEST(MultiRouteTest, SeedReplaysRun) {
+    Instance instance = makeInstance(80, 5);
+    MultiRouteOptions options = quietOptions(3);
+    options.threads = 2;
+    auto first = solveMultipleRoutes(instance.points, instance.graph, 8, options);
+    EXPECT_EQ(solveMultipleRoutes(instance.points, instance.graph, 8, options), first);
+
+    options.seed = 4;
+    EXPECT_NE(solveMultipleRoutes(instance.points, instance.graph, 8, options), first);
+}
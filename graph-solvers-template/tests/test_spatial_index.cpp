@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+
+#include "common/graph.h"
+#include "geometry/spatial_index.h"
+
+namespace {
+
+std::vector<Point> randomPoints(int n, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> coord(0.0, 40.0);
+    std::vector<Point> points(n);
+    for (auto& p : points) p = { coord(gen), coord(gen) };
+    return points;
+}
+
+} // namespace
+
+TEST(SpatialGridTest, KNearestMatchesBruteForce) {
+    auto points = randomPoints(500, 3);
+    SpatialGrid grid(points);
+
+    std::vector<int> result;
+    for (int q = 0; q < 500; q += 7) {
+        std::vector<std::pair<double, int>> expected;
+        for (int i = 0; i < 500; ++i)
+            if (i != q) expected.push_back({ euclidean(points[q], points[i]), i });
+        std::sort(expected.begin(), expected.end());
+
+        grid.kNearest(points[q], 8, result, q);
+        ASSERT_EQ(result.size(), 8u);
+        for (int t = 0; t < 8; ++t)
+            EXPECT_DOUBLE_EQ(euclidean(points[q], points[result[t]]), expected[t].first);
+    }
+}
+
+TEST(SpatialGridTest, HandlesQueriesOutsideTheBoundingBox) {
+    auto points = randomPoints(200, 5);
+    SpatialGrid grid(points);
+
+    Point far = { -100.0, 75.0 };
+    int expected = 0;
+    for (int i = 1; i < 200; ++i)
+        if (euclidean(far, points[i]) < euclidean(far, points[expected])) expected = i;
+
+    EXPECT_EQ(grid.nearest(far), expected);
+}
+
+TEST(SpatialGridTest, RadiusQueryFindsExactlyThePointsInside) {
+    auto points = randomPoints(300, 9);
+    SpatialGrid grid(points);
+
+    std::vector<int> result;
+    grid.withinRadius({ 20.0, 20.0 }, 6.5, result);
+    std::sort(result.begin(), result.end());
+
+    std::vector<int> expected;
+    for (int i = 0; i < 300; ++i)
+        if (euclidean({ 20.0, 20.0 }, points[i]) <= 6.5) expected.push_back(i);
+
+    EXPECT_EQ(result, expected);
+}
+
+TEST(SpatialGridTest, BuildsConnectedCandidateGraph) {
+    auto points = randomPoints(400, 11);
+    SpatialGrid grid(points);
+    Graph graph((int)points.size(), nearestNeighbourEdges(points, grid, 6));
+
+    for (int u = 0; u < graph.vertexCount(); ++u)
+        EXPECT_GE(graph.degree(u), 6);
+}
+
+TEST(SpatialGridTest, AddsNearestNeighboursToCandidateGraph) {
+    auto points = randomPoints(300, 5);
+    std::vector<Edge> chain;
+    for (int i = 0; i + 1 < 300; ++i) chain.push_back({ i, i + 1, 1.0 });
+    Graph graph(300, chain);
+
+    Graph augmented = withNearestNeighbours(graph, points, 6);
+
+    // Existing edges keep their costs, and every point reaches its 6 nearest neighbours
+    for (int i = 0; i + 1 < 300; ++i) {
+        int id = augmented.edgeId(i, i + 1);
+        ASSERT_NE(id, Graph::npos);
+        EXPECT_DOUBLE_EQ(augmented.cost(id), 1.0);
+    }
+    SpatialGrid grid(points);
+    std::vector<int> nearest;
+    for (int i = 0; i < 300; ++i) {
+        grid.kNearest(points[i], 6, nearest, i);
+        for (int j : nearest) {
+            int id = augmented.edgeId(i, j);
+            ASSERT_NE(id, Graph::npos);
+            if (std::abs(i - j) == 1) continue;
+            EXPECT_DOUBLE_EQ(augmented.cost(id), euclidean(points[i], points[j]));
+        }
+    }
+    EXPECT_LE(augmented.edgeCount(), graph.edgeCount() + 300 * 6);
+    EXPECT_EQ(withNearestNeighbours(graph, points, 0).edgeCount(), graph.edgeCount());
+}
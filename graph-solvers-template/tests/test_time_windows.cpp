@@ -0,0 +1,278 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+#include "common/graph.h"
+#include "model/decomposition.h"
+#include "model/local_search.h"
+#include "model/route_store.h"
+#include "model/savings.h"
+#include "model/solver.h"
+#include "model/time_windows.h"
+#include "test_instances.h"
+
+namespace {
+
+// Random points on a complete graph with the start in the middle; customers get windows
+// of width @p width that a vehicle driving straight from the start can always meet
+struct Instance
+{
+    std::vector<Point> points;
+    Graph graph;
+    RouteConstraints constraints;
+};
+
+Instance makeInstance(int n, double width, unsigned seed)
+{
+    Instance instance;
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> ready(0.0, 300.0);
+    instance.points = randomPoints(n, rng);
+    instance.points[0] = { 50.0, 50.0 };
+    instance.graph = radiusGraph(instance.points, std::numeric_limits<double>::infinity());
+
+    auto& constraints = instance.constraints;
+    constraints.readyTimes.assign(n, 0.0);
+    constraints.dueTimes.assign(n, 1e6);
+    constraints.serviceTimes.assign(n, 0.0);
+    for (int i = 1; i < n - 1; ++i) {
+        double earliest = euclidean(instance.points[0], instance.points[i]);
+        constraints.readyTimes[i] = ready(rng);
+        constraints.dueTimes[i] = std::max(constraints.readyTimes[i], earliest) + width;
+        constraints.serviceTimes[i] = 5.0;
+    }
+    return instance;
+}
+
+// Drives @p sequence from the ready time of its first node, waiting where a node is not
+// ready yet; returns the end of the last service, or -1 when some due time is missed
+double simulate(const RouteConstraints& constraints, const std::vector<int>& sequence,
+    const std::function<double(int, int)>& travel)
+{
+    double time = constraints.readyTimes[sequence[0]];
+    for (std::size_t k = 0; k < sequence.size(); ++k) {
+        int node = sequence[k];
+        if (k > 0) time = std::max(time + travel(sequence[k - 1], node), constraints.readyTimes[node]);
+        if (time > constraints.dueTimes[node] + 1e-9) return -1.0;
+        time += constraints.serviceTimes[node];
+    }
+    return time;
+}
+
+bool keepsWindows(const Instance& instance, const std::vector<int>& route)
+{
+    return simulate(instance.constraints, route, [&](int u, int v) {
+        return euclidean(instance.points[u], instance.points[v]);
+    }) >= 0.0;
+}
+
+} // namespace
+
+TEST(TimeWindowsTest, ConcatenationMatchesSimulation) {
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> ready(0.0, 100.0), width(0.0, 40.0), service(0.0, 10.0), travel(1.0, 20.0);
+    int feasible = 0;
+    for (int trial = 0; trial < 500; ++trial) {
+        const int n = 2 + trial % 7;
+        RouteConstraints constraints;
+        std::vector<double> legs(n, 0.0);
+        std::vector<int> sequence(n);
+        for (int i = 0; i < n; ++i) {
+            constraints.readyTimes.push_back(ready(rng));
+            constraints.dueTimes.push_back(constraints.readyTimes[i] + width(rng));
+            constraints.serviceTimes.push_back(service(rng));
+            legs[i] = travel(rng);
+            sequence[i] = i;
+        }
+        auto leg = [&](int u, int) { return legs[u]; };
+
+        // Left fold, and the two halves around a random split joined last
+        TimeSegment folded = constraints.segment(0);
+        for (int i = 1; i < n; ++i) folded = concatenate(folded, legs[i - 1], constraints.segment(i));
+        int split = 1 + trial % (n - 1);
+        TimeSegment left = constraints.segment(0), right = constraints.segment(split);
+        for (int i = 1; i < split; ++i) left = concatenate(left, legs[i - 1], constraints.segment(i));
+        for (int i = split + 1; i < n; ++i) right = concatenate(right, legs[i - 1], constraints.segment(i));
+        TimeSegment joined = concatenate(left, legs[split - 1], right);
+
+        double finish = simulate(constraints, sequence, leg);
+        EXPECT_EQ(folded.feasible, finish >= 0.0);
+        EXPECT_EQ(joined.feasible, folded.feasible);
+        if (!folded.feasible) continue;
+        ++feasible;
+        EXPECT_NEAR(folded.earliest + folded.duration, finish, 1e-9);
+        EXPECT_NEAR(joined.earliest, folded.earliest, 1e-9);
+        EXPECT_NEAR(joined.latest, folded.latest, 1e-9);
+        EXPECT_NEAR(joined.duration, folded.duration, 1e-9);
+
+        // Starting at the latest start still keeps every window, a moment later does not
+        RouteConstraints shifted = constraints;
+        shifted.readyTimes[0] = folded.latest;
+        EXPECT_GE(simulate(shifted, sequence, leg), 0.0);
+        shifted.readyTimes[0] = folded.latest + 1e-3;
+        EXPECT_LT(simulate(shifted, sequence, leg), 0.0);
+    }
+    EXPECT_GT(feasible, 50);
+}
+
+TEST(TimeWindowsTest, RouteStoreTracksBothDirections) {
+    Instance instance = makeInstance(12, 1e5, 3);
+    RouteStore store;
+    store.reset(12, 0, 11, instance.constraints);
+    ASSERT_TRUE(store.timed());
+
+    auto cost = [&](int u, int v) { return instance.graph.cost(instance.graph.edgeId(u, v)); };
+    store.merge(1, 2, cost(1, 2));
+    store.merge(4, 3, cost(4, 3));
+    store.merge(1, 4, cost(1, 4));  // reverses the first route
+    store.merge(5, 6, cost(5, 6));
+    int merged = store.merge(6, 2, cost(6, 2));
+    store.reverse(merged);
+
+    std::vector<int> sequence;
+    store.materialize(merged, sequence);
+    std::vector<int> interior(sequence.begin() + 1, sequence.end() - 1);
+    TimeSegment forward = instance.constraints.segment(interior[0]);
+    for (std::size_t k = 1; k < interior.size(); ++k)
+        forward = concatenate(forward, cost(interior[k - 1], interior[k]), instance.constraints.segment(interior[k]));
+    std::reverse(interior.begin(), interior.end());
+    TimeSegment backward = instance.constraints.segment(interior[0]);
+    for (std::size_t k = 1; k < interior.size(); ++k)
+        backward = concatenate(backward, cost(interior[k - 1], interior[k]), instance.constraints.segment(interior[k]));
+
+    EXPECT_EQ(store.size(merged), 6);
+    EXPECT_NEAR(store.forward(merged).duration, forward.duration, 1e-9);
+    EXPECT_NEAR(store.forward(merged).latest, forward.latest, 1e-9);
+    EXPECT_EQ(store.forward(merged).feasible, forward.feasible);
+    EXPECT_NEAR(store.backward(merged).duration, backward.duration, 1e-9);
+    EXPECT_NEAR(store.backward(merged).earliest, backward.earliest, 1e-9);
+    EXPECT_EQ(store.backward(merged).feasible, backward.feasible);
+}
+
+TEST(TimeWindowsTest, RejectsMisSizedWindows) {
+    RouteConstraints constraints;
+    constraints.readyTimes.assign(4, 0.0);
+    constraints.dueTimes.assign(3, 1.0);
+    RouteStore store;
+    EXPECT_THROW(store.reset(4, 0, 3, constraints), std::invalid_argument);
+}
+
+TEST(TimeWindowsTest, MergeLoopKeepsEveryWindow) {
+    const int n = 80;
+    Instance instance = makeInstance(n, 40.0, 7);
+    SavingsList list(instance.points, instance.graph, 0, n - 1);
+    SavingsQueue queue;
+    RouteStore store;
+
+    // The store must carry the windows when the constraints have them
+    store.reset(n, 0, n - 1, instance.constraints.demands);
+    queue.reset(list);
+    EXPECT_THROW(mergeRoutes(instance.graph, list, queue, instance.constraints, store), std::invalid_argument);
+
+    store.reset(n, 0, n - 1, instance.constraints);
+    queue.reset(list);
+    mergeRoutes(instance.graph, list, queue, instance.constraints, store);
+    EXPECT_LT(store.routeCount(), n - 2);
+
+    std::vector<int> ids, sequence;
+    store.routes(ids);
+    for (int id : ids) {
+        store.materialize(id, sequence);
+        std::vector<int> reversed(sequence.rbegin(), sequence.rend());
+        std::swap(reversed.front(), reversed.back());
+        EXPECT_TRUE(keepsWindows(instance, sequence) || keepsWindows(instance, reversed));
+    }
+
+    // Without the windows the same savings produce fewer, window-breaking routes
+    RouteConstraints untimed;
+    store.reset(n, 0, n - 1, untimed);
+    queue.reset(list);
+    mergeRoutes(instance.graph, list, queue, untimed, store);
+    store.routes(ids);
+    int broken = 0;
+    for (int id : ids) {
+        store.materialize(id, sequence);
+        std::vector<int> reversed(sequence.rbegin(), sequence.rend());
+        std::swap(reversed.front(), reversed.back());
+        if (!keepsWindows(instance, sequence) && !keepsWindows(instance, reversed)) ++broken;
+    }
+    EXPECT_GT(broken, 0);
+}
+
+TEST(TimeWindowsTest, SolveProblemReturnsOnlyScheduledRoutes) {
+    const int n = 60;
+    Instance instance = makeInstance(n, 60.0, 11);
+    instance.constraints.readyTimes[0] = 20.0;  // the start opens late: some customers become unreachable
+    SavingsList list(instance.points, instance.graph, 0, n - 1);
+    SavingsQueue queue;
+    queue.reset(list);
+
+    LocalSearchOptions search;
+    search.enabled = true;
+    search.timeLimitMs = 0.0;
+    auto routes = solveProblem(instance.points, instance.graph, list, queue, n, instance.constraints, search);
+    ASSERT_FALSE(routes.empty());
+    for (const auto& edges : routes) {
+        std::vector<int> route{ edges.front().first };
+        for (const auto& edge : edges) route.push_back(edge.second);
+        EXPECT_EQ(route.front(), 0);
+        EXPECT_EQ(route.back(), n - 1);
+        EXPECT_TRUE(keepsWindows(instance, route));
+    }
+}
+
+TEST(TimeWindowsTest, LocalSearchKeepsWindows) {
+    const int n = 40;
+    Instance instance = makeInstance(n, 1e5, 13);
+
+    // Routes along the index order, with windows tight around the times they are served at
+    std::vector<std::vector<int>> routes;
+    for (int first = 1; first < n - 1; first += 10) {
+        auto& route = routes.emplace_back(1, 0);
+        for (int i = first; i < std::min(first + 10, n - 1); ++i) route.push_back(i);
+        route.push_back(n - 1);
+        double time = 0.0;
+        for (std::size_t k = 1; k + 1 < route.size(); ++k) {
+            time += euclidean(instance.points[route[k - 1]], instance.points[route[k]]);
+            instance.constraints.readyTimes[route[k]] = time - 15.0;
+            instance.constraints.dueTimes[route[k]] = time + 15.0;
+            time = std::max(time, instance.constraints.readyTimes[route[k]]) + instance.constraints.serviceTimes[route[k]];
+        }
+    }
+    for (const auto& route : routes) ASSERT_TRUE(keepsWindows(instance, route));
+
+    LocalSearchOptions options;
+    options.timeLimitMs = 0.0;
+    LocalSearch search;
+    auto timed = routes;
+    search.run(instance.graph, timed, instance.constraints, options);
+    for (const auto& route : timed) EXPECT_TRUE(keepsWindows(instance, route));
+
+    // The same search without windows breaks some of them
+    auto untimed = routes;
+    search.run(instance.graph, untimed, {}, options);
+    int broken = 0;
+    for (const auto& route : untimed) broken += keepsWindows(instance, route) ? 0 : 1;
+    EXPECT_GT(broken, 0);
+}
+
+TEST(TimeWindowsTest, DecomposedRoutesKeepWindows) {
+    const int n = 200;
+    Instance instance = makeInstance(n, 50.0, 17);
+    DecompositionOptions options;
+    options.partitions = 4;
+    options.constraints = instance.constraints;
+    auto routes = solveDecomposed(instance.points, instance.graph, options);
+
+    std::vector<int> visits(n, 0);
+    for (const auto& route : routes) {
+        EXPECT_TRUE(keepsWindows(instance, route));
+        for (std::size_t k = 1; k + 1 < route.size(); ++k) ++visits[route[k]];
+    }
+    for (int v = 1; v < n - 1; ++v) EXPECT_EQ(visits[v], 1) << "node " << v;
+    EXPECT_LT(routes.size(), (std::size_t)(n - 2));
+}
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+
+#include "common/thread_pool.h"
+#include "geometry/triangulation.h"
+
+namespace {
+
+std::vector<Point> randomPoints(int n, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> coord(0.0, 1000.0);
+    std::vector<Point> points(n);
+    for (auto& p : points) p = { coord(rng), coord(rng) };
+    return points;
+}
+
+std::vector<std::pair<int, int>> edgeSet(const Graph& graph)
+{
+    std::vector<std::pair<int, int>> edges;
+    for (const auto& e : graph.edges()) edges.emplace_back(e.u, e.v);
+    return edges;
+}
+
+} // namespace
+
+TEST(TriangulationTest, SquareHasFiveEdges) {
+    std::vector<Point> points = { { 0, 0 }, { 1, 0 }, { 1, 1.1 }, { 0, 1 } };
+    DelaunayGraph delaunay = buildDelaunayGraph(points);
+
+    EXPECT_EQ(delaunay.triangles.size(), 2u);
+    EXPECT_EQ(delaunay.graph.edgeCount(), 5);
+    int id = delaunay.graph.edgeId(0, 1);
+    ASSERT_NE(id, Graph::npos);
+    EXPECT_DOUBLE_EQ(delaunay.graph.cost(id), 1.0);
+}
+
+TEST(TriangulationTest, TiledMatchesSingleStrip) {
+    auto points = randomPoints(1500, 5);
+
+    TriangulationOptions single;
+    single.tiles = 1;
+    DelaunayGraph reference = buildDelaunayGraph(points, single);
+
+    TriangulationOptions tiled;
+    tiled.tiles = 6;
+    DelaunayGraph result = buildDelaunayGraph(points, tiled);
+
+    EXPECT_EQ(result.triangles.size(), reference.triangles.size());
+    EXPECT_EQ(edgeSet(result.graph), edgeSet(reference.graph));
+    for (int id = 0; id < result.graph.edgeCount(); ++id)
+        EXPECT_DOUBLE_EQ(result.graph.cost(id), reference.graph.cost(id));
+}
+
+TEST(TriangulationTest, TiledGridRetriesUntilConsistent) {
+    // Unit grid turned by 45 degrees: every cell is cocircular up to rounding, so the strips
+    // cannot certify their seam triangles with the first halo and have to widen it
+    const int side = 30;
+    const double h = std::sqrt(0.5);
+    std::vector<Point> points;
+    for (int i = 0; i < side; ++i) {
+        for (int j = 0; j < side; ++j) points.push_back({ (i - j) * h, (i + j) * h });
+    }
+
+    ThreadPool pool(3);
+    for (int tiles : { 2, 3, 4, 6 }) {
+        TriangulationOptions options;
+        options.tiles = tiles;
+        options.pool = &pool;
+        DelaunayGraph delaunay = buildDelaunayGraph(points, options);
+
+        // Two triangles per cell, one diagonal per cell
+        const long long cells = (long long)(side - 1) * (side - 1);
+        ASSERT_EQ((long long)delaunay.triangles.size(), 2 * cells) << "tiles " << tiles;
+        ASSERT_EQ(delaunay.graph.edgeCount(), 2 * side * (side - 1) + cells) << "tiles " << tiles;
+        for (const auto& e : delaunay.graph.edges()) {
+            double length = e.cost;
+            EXPECT_TRUE(std::abs(length - 1.0) < 1e-9 || std::abs(length - std::sqrt(2.0)) < 1e-9)
+                << "edge " << e.u << "-" << e.v << " of length " << length;
+        }
+    }
+}
+
+TEST(TriangulationTest, PoolDoesNotChangeResult) {
+    auto points = randomPoints(1200, 9);
+
+    TriangulationOptions options;
+    options.tiles = 4;
+    DelaunayGraph serial = buildDelaunayGraph(points, options);
+
+    ThreadPool pool(4);
+    options.pool = &pool;
+    DelaunayGraph parallel = buildDelaunayGraph(points, options);
+
+    EXPECT_EQ(serial.triangles, parallel.triangles);
+    EXPECT_EQ(edgeSet(serial.graph), edgeSet(parallel.graph));
+}
+
+TEST(TriangulationTest, EdgeListIsSortedAndUnique) {
+    auto points = randomPoints(300, 2);
+    auto [triangles, edges] = computeTriangulationAndEdges(points);
+
+    ASSERT_FALSE(edges.empty());
+    for (std::size_t i = 0; i < edges.size(); ++i) {
+        EXPECT_LT(edges[i].u, edges[i].v);
+        if (i > 0) {
+            EXPECT_TRUE(std::make_pair(edges[i - 1].u, edges[i - 1].v) < std::make_pair(edges[i].u, edges[i].v));
+        }
+    }
+    // Euler's formula for a triangulated point set: E = V + T - 1
+    EXPECT_EQ(edges.size(), points.size() + triangles.size() - 1);
+}
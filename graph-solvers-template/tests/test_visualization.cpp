@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <set>
+#include <sstream>
+
+#include "common/thread_pool.h"
+#include "geometry/visualization.h"
+
+namespace {
+
+std::string render(const SvgRenderer& renderer, const RouteEdges& routes)
+{
+    std::ostringstream out;
+    renderer.render(out, routes);
+    return out.str();
+}
+
+std::size_t count(const std::string& text, const std::string& pattern)
+{
+    std::size_t n = 0;
+    for (auto pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1)) ++n;
+    return n;
+}
+
+// Grid graph: node (i, j) at index i * side + j, linked to its right and upper neighbour
+Graph gridGraph(int side, std::vector<Point>& points)
+{
+    std::vector<Edge> edges;
+    for (int i = 0; i < side; ++i) {
+        for (int j = 0; j < side; ++j) {
+            points.push_back({ (double)i, (double)j });
+            int id = i * side + j;
+            if (i + 1 < side) edges.push_back({ id, id + side, 1.0 });
+            if (j + 1 < side) edges.push_back({ id, id + 1, 1.0 });
+        }
+    }
+    return Graph((int)points.size(), edges);
+}
+
+} // namespace
+
+TEST(VisualizationTest, DrawsEachEdgeOnceAndRouteLayers) {
+    std::vector<Point> points = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 } };
+    Graph graph(4, { { 0, 1, 1.0 }, { 1, 2, 1.0 }, { 2, 3, 1.0 }, { 0, 3, 1.0 }, { 0, 2, 1.0 } });
+    SvgRenderer renderer(points, graph);
+    EXPECT_EQ(renderer.backgroundEdges(), 5u);
+
+    std::string svg = render(renderer, { { { 0, 1 }, { 1, 2 } }, { { 0, 2 } } });
+    EXPECT_EQ(count(svg, "<path stroke='#cccccc'"), 1u);
+    EXPECT_EQ(count(svg, "stroke='#cccccc' stroke-width='1' fill='none' d='"), 1u);
+    EXPECT_NE(svg.find("<g id='route-0' stroke='red'"), std::string::npos);
+    EXPECT_NE(svg.find("<g id='route-1' stroke='blue'"), std::string::npos);
+    EXPECT_NE(svg.find("onclick='toggle(1)'"), std::string::npos);
+    EXPECT_EQ(count(svg, "<circle"), 4u);
+    // The first route is one continuous polyline
+    EXPECT_NE(svg.find("d='M50.0 75.0L75.0 75.0L75.0 50.0'"), std::string::npos);
+}
+
+TEST(VisualizationTest, SharedRouteEdgesAreOffset) {
+    std::vector<Point> points = { { 0, 0 }, { 1, 0 } };
+    Graph graph(2, { { 0, 1, 1.0 } });
+    SvgRenderer renderer(points, graph);
+
+    // Two routes on the same edge, in opposite directions, end up on opposite sides
+    std::string svg = render(renderer, { { { 0, 1 } }, { { 1, 0 } } });
+    EXPECT_NE(svg.find("<g id='route-0' stroke='red' stroke-width='3' fill='none' stroke-linejoin='round'><path d='M50.0 48.5L75.0 48.5'"), std::string::npos);
+    EXPECT_NE(svg.find("<g id='route-1' stroke='blue' stroke-width='3' fill='none' stroke-linejoin='round'><path d='M75.0 51.5L50.0 51.5'"), std::string::npos);
+}
+
+TEST(VisualizationTest, LevelOfDetailBoundsOutput) {
+    std::vector<Point> points;
+    Graph graph = gridGraph(150, points);
+
+    RenderOptions full;
+    full.maxDetailEdges = graph.edgeCount();
+    std::string detailed = render(SvgRenderer(points, graph, full), {});
+
+    RenderOptions coarse;
+    coarse.maxDetailEdges = 2000;
+    SvgRenderer decimated(points, graph, coarse);
+    std::string small = render(decimated, {});
+
+    EXPECT_LE(decimated.backgroundEdges(), 4000u);
+    EXPECT_GT(decimated.backgroundEdges(), 500u);
+    EXPECT_LT(small.size() * 5, detailed.size());
+    EXPECT_EQ(count(small, "<circle"), 0u);
+}
+
+TEST(VisualizationTest, LevelOfDetailKeepsEveryCellPair) {
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<double> coord(0.0, 100.0);
+    std::uniform_int_distribution<int> node(0, 2999);
+    std::vector<Point> points(3000);
+    for (auto& p : points) p = { coord(gen), coord(gen) };
+    std::vector<Edge> edges;
+    for (int i = 0; i < 3000; ++i) {
+        edges.push_back({ i, (i + 1) % 3000, 1.0 });
+        edges.push_back({ i, node(gen), 1.0 });
+    }
+    Graph graph(3000, edges);
+
+    RenderOptions options;
+    options.lodCellPixels = 25.0;
+    SvgRenderer renderer(points, graph, options);
+
+    // Same pixel mapping as the renderer: x from the left margin, y flipped from the top one
+    double minX = points[0].x, maxY = points[0].y;
+    for (const auto& p : points) minX = std::min(minX, p.x), maxY = std::max(maxY, p.y);
+    auto cell = [&](const Point& p) {
+        return std::make_pair((long long)std::floor(((p.x - minX) * options.scale + options.margin) / 25.0),
+            (long long)std::floor(((maxY - p.y) * options.scale + options.margin) / 25.0));
+    };
+    std::set<std::pair<std::pair<long long, long long>, std::pair<long long, long long>>> pairs;
+    for (const Edge& e : graph.edges()) {
+        auto a = cell(points[e.u]), b = cell(points[e.v]);
+        if (a != b) pairs.insert(std::minmax(a, b));
+    }
+    EXPECT_EQ(renderer.backgroundEdges(), pairs.size());
+}
+
+TEST(VisualizationTest, ParallelFilesAndTiles) {
+    std::vector<Point> points;
+    Graph graph = gridGraph(20, points);
+    RouteEdges routes = { { { 0, 1 }, { 1, 2 }, { 2, 22 } }, { { 0, 20 }, { 20, 40 } } };
+    auto dir = std::filesystem::temp_directory_path() / "cw_test_visualization";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+
+    ThreadPool pool(4);
+    RenderOptions options;
+    options.pool = &pool;
+    SvgRenderer renderer(points, graph, options);
+
+    std::vector<std::string> files;
+    std::vector<RouteEdges> sets;
+    for (int i = 0; i < 6; ++i) {
+        files.push_back((dir / ("f" + std::to_string(i) + ".svg")).string());
+        sets.push_back({ routes[i % 2] });
+    }
+    renderer.renderFiles(files, sets);
+    for (int i = 0; i < 6; ++i) {
+        std::ifstream in(files[i]);
+        std::stringstream content;
+        content << in.rdbuf();
+        EXPECT_EQ(content.str(), render(renderer, sets[i]));
+    }
+
+    TileOptions tiles;
+    tiles.levels = 3;
+    int written = renderer.renderTiles((dir / "tiles").string(), routes, tiles);
+    EXPECT_EQ(written, 1 + 4 + 16);
+    EXPECT_TRUE(std::filesystem::exists(dir / "tiles" / "2" / "3" / "0.svg"));
+    EXPECT_THROW(renderer.renderFiles(files, {}), std::invalid_argument);
+    std::filesystem::remove_all(dir);
+}